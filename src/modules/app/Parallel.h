@@ -0,0 +1,59 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "app/App.h"
+#include "core/Common.h"
+#include "core/SharedPtr.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Semaphore.h"
+#include "core/concurrent/ThreadPool.h"
+#include <functional>
+
+namespace app {
+
+/**
+ * @brief Executes the given function for each index in the range [0, n) on the calling thread and the workers of
+ * the app thread pool. Returns once all indices are processed.
+ *
+ * The indices are claimed one by one. The calling thread works on the indices, too, and only waits for indices
+ * that are already in progress on a worker - so this doesn't dead lock if it is called from within a task of the
+ * thread pool.
+ */
+inline void for_parallel(int n, const std::function<void(int)> &func) {
+	if (n <= 0) {
+		return;
+	}
+	core::ThreadPool &threadPool = app::App::getInstance()->threadPool();
+	const int workers = core_min((int)threadPool.size(), n - 1);
+	if (workers <= 0) {
+		for (int i = 0; i < n; ++i) {
+			func(i);
+		}
+		return;
+	}
+	// workers that are started after everything is done don't touch the function anymore
+	struct State {
+		core::AtomicInt next{0};
+		core::Semaphore done{0u};
+	};
+	const core::SharedPtr<State> state = core::make_shared<State>();
+	const std::function<void(int)> *funcPtr = &func;
+	auto work = [state, funcPtr, n]() {
+		for (int i = state->next.increment(); i < n; i = state->next.increment()) {
+			(*funcPtr)(i);
+			state->done.increase();
+		}
+	};
+	for (int i = 0; i < workers; ++i) {
+		threadPool.enqueue(work);
+	}
+	work();
+	for (int i = 0; i < n; ++i) {
+		state->done.waitAndDecrease();
+	}
+}
+
+} // namespace app
@@ -3,9 +3,6 @@
  */
 
 #include "attrib/ShadowAttributes.h"
-#if 0
-#include "voxelutil/AStarPathfinder.h"
-#endif
 #include "Npc.h"
 #include "ai/AICharacter.h"
 #include "ai/AI.h"
@@ -13,8 +10,13 @@
 #include "ai/common/Random.h"
 #include "backend/entity/ai/tree/TreeNode.h"
 #include "backend/world/Map.h"
+#include "app/App.h"
+#include "core/concurrent/ThreadPool.h"
 #include <glm/trigonometric.hpp>
 #include <glm/gtc/constants.hpp>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/norm.hpp>
+#include <chrono>
 
 namespace backend {
 
@@ -39,6 +41,9 @@ Npc::~Npc() {
 }
 
 void Npc::shutdown() {
+	if (_routeTask.valid()) {
+		_routeTask.wait();
+	}
 	Zone* zone = _ai->getZone();
 	if (zone != nullptr) {
 		zone->destroyAI(id());
@@ -61,6 +66,7 @@ void Npc::init(const glm::ivec3* pos) {
 	const glm::vec3 spawnPos(randomPos.x, randomPos.y, randomPos.z);
 	setHomePosition(spawnPos);
 	setTargetPosition(spawnPos);
+	_routeTarget = spawnPos;
 	_aiChr->setPosition(spawnPos);
 	init();
 }
@@ -99,6 +105,7 @@ bool Npc::update(long dt) {
 	_cooldowns.update();
 
 	updateFromAIState();
+	updateRoute();
 
 	moveToGround();
 
@@ -120,21 +127,71 @@ void Npc::updateAIState() {
 	}
 }
 
+glm::vec3 Npc::routeTargetPosition() const {
+	if (_nextWaypoint < (int)_waypoints.size()) {
+		const glm::ivec3& waypoint = _waypoints[_nextWaypoint];
+		return glm::vec3(waypoint.x, waypoint.y, waypoint.z);
+	}
+	return _routeTarget;
+}
+
 bool Npc::route(const glm::vec3& target) {
-#if 0
-	std::list<glm::ivec3> result;
+	if (target == _routeTarget && (_routeTask.valid() || _targetPosition == routeTargetPosition())) {
+		// already on the way
+		return true;
+	}
+	_routeTarget = target;
+	_waypoints.clear();
+	_nextWaypoint = 0;
+	// walk straight to the target until the route is known
+	setTargetPosition(target);
+
+	// only the route over the portals is computed - the legs between the waypoints are short enough to walk them
 	const glm::vec3& pos = _aiChr->getPosition();
 	const glm::ivec3 start(pos);
 	const glm::ivec3 end(target.x, target.y, target.z);
-	if (!_map->findPath(start, end, result)) {
-		return false;
-	}
-	// TODO: use the route
-	setTargetPosition(target);
-#endif
+	const MapPtr map = _map;
+	const std::shared_ptr<core::List<glm::ivec3>> waypoints = std::make_shared<core::List<glm::ivec3>>();
+	_routeResult = waypoints;
+	_routeTask = app::App::getInstance()->threadPool().enqueue([map, start, end, waypoints] () {
+		return map->findRoute(start, end, *waypoints);
+	});
 	return true;
 }
 
+void Npc::updateRoute() {
+	if (_routeTask.valid() && _routeTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		// the route is dropped if the target was changed in the meantime
+		if (_routeTask.get() && _targetPosition == _routeTarget) {
+			_waypoints.clear();
+			_waypoints.reserve(_routeResult->size());
+			for (const glm::ivec3& waypoint : *_routeResult) {
+				_waypoints.push_back(waypoint);
+			}
+			// the first waypoint is the start position
+			_nextWaypoint = 1;
+			setTargetPosition(routeTargetPosition());
+		} else {
+			Log::debug("No route found for npc %i - walk straight to the target", (int)id());
+		}
+		_routeResult.reset();
+	}
+	if (_nextWaypoint >= (int)_waypoints.size()) {
+		return;
+	}
+	if (_targetPosition != routeTargetPosition()) {
+		// someone else changed the target - stop following the route
+		_waypoints.clear();
+		_nextWaypoint = 0;
+		return;
+	}
+	const float waypointReachedDistance = 1.5f;
+	if (glm::distance2(pos(), routeTargetPosition()) < waypointReachedDistance * waypointReachedDistance) {
+		++_nextWaypoint;
+		setTargetPosition(routeTargetPosition());
+	}
+}
+
 void Npc::moveToGround() {
 	glm::vec3 pos = this->pos();
 	const voxelutil::FloorTraceResult& trace = _map->findFloor(pos);
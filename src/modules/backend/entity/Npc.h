@@ -12,8 +12,12 @@
 #include "backend/entity/EntityId.h"
 #include "backend/network/ServerMessageSender.h"
 #include "math/Random.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/List.h"
 
 #include <atomic>
+#include <future>
+#include <memory>
 
 namespace backend {
 
@@ -30,10 +34,25 @@ private:
 	AIPtr _ai;
 	AICharacterPtr _aiChr;
 
+	// the route of the last route() call - it is computed on the thread pool
+	glm::vec3 _routeTarget {0.0f};
+	std::future<bool> _routeTask;
+	std::shared_ptr<core::List<glm::ivec3>> _routeResult;
+	core::DynamicArray<glm::ivec3> _waypoints;
+	int _nextWaypoint = 0;
+
 	// cooldowns
 	cooldown::CooldownMgr _cooldowns;
 
 	void moveToGround();
+	/**
+	 * @brief Takes over the computed route and moves the target position along the waypoints
+	 */
+	void updateRoute();
+	/**
+	 * @return The position the npc must walk to for following the current route
+	 */
+	glm::vec3 routeTargetPosition() const;
 
 	// transfer from ai to npc state
 	void updateFromAIState();
@@ -59,6 +78,10 @@ public:
 	const glm::vec3& homePosition() const;
 	void setTargetPosition(const glm::vec3& pos);
 	const glm::vec3& targetPosition() const;
+	/**
+	 * @brief Walks to the given target. The npc walks straight to the target until the route over the waypoints was
+	 * computed in the background - or if no route could be found.
+	 */
 	bool route(const glm::vec3& target);
 	const AIPtr& ai();
 
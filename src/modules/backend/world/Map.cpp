@@ -134,6 +134,10 @@ bool Map::init() {
 	_pager->init(_voxelWorldMgr->volumeData(), worldParamData, biomesData);
 	_pager->setSeed(seed->uintVal());
 	_pager->setNoiseOffset(glm::vec2(0.0f));
+	voxelworld::HierarchicalPathfinder *pathfinder = _voxelWorldMgr->pathfinder();
+	_pager->setChunkListener([pathfinder] (const voxel::Region& region) {
+		pathfinder->invalidate(region);
+	});
 
 	_voxelWorldMgr->setSeed(seed->uintVal());
 	_zone = new Zone(core::string::format("Zone %i", _mapId));
@@ -149,6 +153,7 @@ void Map::shutdown() {
 	_attackMgr.shutdown();
 	_spawnMgr.shutdown();
 	if (_pager != nullptr) {
+		_pager->setChunkListener(voxelworld::WorldPager::ChunkListener());
 		_pager->shutdown();
 		_pager = voxelworld::WorldPagerPtr();
 	}
@@ -246,6 +251,10 @@ voxelutil::FloorTraceResult Map::findFloor(const glm::ivec3& pos, int maxDistanc
 	return _voxelWorldMgr->findWalkableFloor(pos, maxDistanceY);
 }
 
+bool Map::findRoute(const glm::ivec3& start, const glm::ivec3& end, core::List<glm::ivec3>& waypoints) const {
+	return _voxelWorldMgr->findRoute(start, end, waypoints);
+}
+
 glm::ivec3 Map::randomPos() const {
 	return _voxelWorldMgr->randomPos();
 }
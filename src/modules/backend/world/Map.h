@@ -9,6 +9,7 @@
 #include "math/Rect.h"
 #include "core/Common.h"
 #include "core/FourCC.h"
+#include "core/collection/List.h"
 #include "ai-shared/common/CharacterId.h"
 #include "voxelutil/FloorTraceResult.h"
 #include "core/IComponent.h"
@@ -132,6 +133,11 @@ public:
 	int userCount() const;
 
 	voxelutil::FloorTraceResult findFloor(const glm::ivec3& pos, int maxDistanceY = voxel::MAX_HEIGHT) const;
+	/**
+	 * @brief Computes the waypoints of a route through the world
+	 * @sa voxelworld::HierarchicalPathfinder::findRoute()
+	 */
+	bool findRoute(const glm::ivec3& start, const glm::ivec3& end, core::List<glm::ivec3>& waypoints) const;
 	glm::ivec3 randomPos() const;
 
 	const DBChunkPersisterPtr& chunkPersister();
@@ -5,6 +5,9 @@
 #pragma once
 
 #include <stdint.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace core {
 
@@ -13,4 +16,25 @@ constexpr uint32_t bits(uint32_t x, uint8_t offset, uint8_t len) {
 	return tmp & ((1u << len) - 1u);
 }
 
+/**
+ * @return The index of the lowest set bit
+ * @note The given value must not be @c 0
+ */
+inline int countTrailingZeros(uint64_t x) {
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, x);
+	return (int)index;
+#elif defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#else
+	int n = 0;
+	while ((x & 1u) == 0u) {
+		x >>= 1;
+		++n;
+	}
+	return n;
+#endif
+}
+
 } // namespace core
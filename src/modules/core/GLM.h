@@ -68,6 +68,16 @@ CORE_FORCE_INLINE constexpr void hash_combine(uint32_t &seed, uint32_t hash) {
 template<typename T>
 struct hash {};
 
+template<typename T, glm::qualifier Q>
+struct hash<glm::vec<2, T, Q>> {
+constexpr uint32_t operator()(const glm::vec<2, T, Q>& v) const {
+	uint32_t seed = 0u;
+	hash_combine(seed, core::hash((const void*)&v.x, (int)sizeof(v.x)));
+	hash_combine(seed, core::hash((const void*)&v.y, (int)sizeof(v.y)));
+	return seed;
+}
+};
+
 template<typename T, glm::qualifier Q>
 struct hash<glm::vec<3, T, Q>> {
 constexpr uint32_t operator()(const glm::vec<3, T, Q>& v) const {
@@ -76,6 +76,18 @@ constexpr const char *CorePath = "core_path";
 
 // The size of the chunk that is extracted with each step
 constexpr const char *VoxelMeshSize = "voxel_meshsize";
+// Use the bitmask based greedy mesher for the surface extraction
+constexpr const char *VoxelBinaryMesher = "voxel_binarymesher";
+// The distance at which the world chunks are extracted with a lower level of detail - 0 disables it
+constexpr const char *VoxelLodDistance = "voxel_loddistance";
+// Upload the world chunks in the packed vertex format
+constexpr const char *VoxelPackedVertices = "voxel_packedvertices";
+// Skip the world chunks that are hidden behind the solid parts of the closest chunks
+constexpr const char *VoxelOcclusionCulling = "voxel_occlusionculling";
+// Store the extracted world chunk meshes on disk and reuse them for chunks that weren't modified
+constexpr const char *VoxelMeshCache = "voxel_meshcache";
+// The size limit of the mesh cache in megabytes
+constexpr const char *VoxelMeshCacheSize = "voxel_meshcachesize";
 
 constexpr const char *DatabaseName = "db_name";
 constexpr const char *DatabaseHost = "db_host";
@@ -93,6 +93,14 @@ bool Filesystem::removeFile(const core::String &file) const {
 	return uv_fs_unlink(_loop, &req, file.c_str(), nullptr) == 0;
 }
 
+bool Filesystem::rename(const core::String &oldName, const core::String &newName) const {
+	if (oldName.empty() || newName.empty()) {
+		return false;
+	}
+	uv_fs_t req;
+	return uv_fs_rename(_loop, &req, oldName.c_str(), newName.c_str(), nullptr) == 0;
+}
+
 bool Filesystem::removeDir(const core::String &dir, bool recursive) const {
 	if (dir.empty()) {
 		return false;
@@ -282,6 +290,22 @@ core::String Filesystem::absolutePath(const core::String &path) {
 	return abspath;
 }
 
+bool Filesystem::stat(const core::String &path, FilesystemEntry &entry) {
+	uv_fs_t req;
+	if (uv_fs_stat(nullptr, &req, path.c_str(), nullptr) != 0) {
+		uv_fs_req_cleanup(&req);
+		return false;
+	}
+	const uv_stat_t *statbuf = uv_fs_get_statbuf(&req);
+	const bool dir = (statbuf->st_mode & S_IFDIR) != 0;
+	entry.name = core::string::extractFilenameWithExtension(path);
+	entry.type = dir ? FilesystemEntry::Type::dir : FilesystemEntry::Type::file;
+	entry.size = statbuf->st_size;
+	entry.mtime = (uint64_t)statbuf->st_mtim.tv_sec * 1000 + statbuf->st_mtim.tv_nsec / 1000000;
+	uv_fs_req_cleanup(&req);
+	return true;
+}
+
 bool Filesystem::isReadableDir(const core::String &name) {
 	uv_fs_t req;
 	if (uv_fs_access(nullptr, &req, name.c_str(), F_OK, nullptr) != 0) {
@@ -136,6 +136,11 @@ public:
 	 */
 	bool list(const core::String& directory, core::DynamicArray<FilesystemEntry>& entities, const core::String& filter = "") const;
 
+	/**
+	 * @brief Query the type, size and modification time of the given path
+	 * @return @c false if the path doesn't exist
+	 */
+	static bool stat(const core::String& path, FilesystemEntry& entry);
 	static bool isReadableDir(const core::String& name);
 	static bool isRelativePath(const core::String& name);
 
@@ -184,6 +189,10 @@ public:
 
 	bool removeDir(const core::String& dir, bool recursive = false) const;
 	bool removeFile(const core::String& file) const;
+	/**
+	 * @brief Renames the given file - an existing file with the new name is replaced
+	 */
+	bool rename(const core::String& oldName, const core::String& newName) const;
 private:
 	static bool _list(const core::String& directory, core::DynamicArray<FilesystemEntry>& entities, const core::String& filter = "");
 };
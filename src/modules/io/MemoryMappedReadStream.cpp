@@ -0,0 +1,156 @@
+/**
+ * @file
+ */
+
+#include "MemoryMappedReadStream.h"
+#include "core/Log.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include <SDL_platform.h>
+
+#if defined(__LINUX__) || defined(__MACOSX__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(__WINDOWS__)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+namespace io {
+
+MemoryMappedReadStream::MemoryMappedReadStream(const FilePtr &file) : MemoryReadStream(nullptr, 0), _file(file) {
+	core_trace_scoped(MemoryMappedReadStream);
+	if (!_file || !_file->exists()) {
+		return;
+	}
+	const FileMode mode = _file->mode();
+	if (mode != FileMode::Read && mode != FileMode::SysRead) {
+		Log::error("Can't map %s - the file is not opened for reading", _file->name().c_str());
+		return;
+	}
+	if (map(_file->name())) {
+		return;
+	}
+	// fall back to read the whole file into memory
+	const long length = _file->length();
+	if (length <= 0) {
+		return;
+	}
+	_ownBuf = (uint8_t *)core_malloc(length);
+	_file->seek(0, SEEK_SET);
+	if (_file->read(_ownBuf, (int)length) != (int)length) {
+		Log::error("Failed to read %s", _file->name().c_str());
+		core_free(_ownBuf);
+		_ownBuf = nullptr;
+		return;
+	}
+	_size = length;
+}
+
+MemoryMappedReadStream::~MemoryMappedReadStream() {
+	unmap();
+}
+
+#if defined(__LINUX__) || defined(__MACOSX__)
+
+bool MemoryMappedReadStream::map(const core::String &path) {
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == -1) {
+		Log::debug("Failed to open %s for mapping", path.c_str());
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		::close(fd);
+		return false;
+	}
+	void *mapping = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping stays valid after the descriptor is closed
+	::close(fd);
+	if (mapping == MAP_FAILED) {
+		Log::debug("Failed to map %s", path.c_str());
+		return false;
+	}
+	// the formats mostly read the file from front to back
+	madvise(mapping, (size_t)st.st_size, MADV_SEQUENTIAL);
+	_mapping = mapping;
+	_buf = (const uint8_t *)mapping;
+	_size = (int64_t)st.st_size;
+	return true;
+}
+
+void MemoryMappedReadStream::unmap() {
+	if (_mapping == nullptr) {
+		return;
+	}
+	munmap(_mapping, (size_t)_size);
+	_mapping = nullptr;
+	_buf = nullptr;
+}
+
+#elif defined(__WINDOWS__)
+
+bool MemoryMappedReadStream::map(const core::String &path) {
+	const int len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+	if (len <= 0) {
+		return false;
+	}
+	wchar_t *wpath = (wchar_t *)core_malloc(len * sizeof(wchar_t));
+	MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, wpath, len);
+	HANDLE file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+							  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	core_free(wpath);
+	if (file == INVALID_HANDLE_VALUE) {
+		Log::debug("Failed to open %s for mapping", path.c_str());
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	// the mapping object keeps a reference to the file
+	CloseHandle(file);
+	if (handle == nullptr) {
+		Log::debug("Failed to create the file mapping for %s", path.c_str());
+		return false;
+	}
+	void *mapping = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+	if (mapping == nullptr) {
+		Log::debug("Failed to map %s", path.c_str());
+		CloseHandle(handle);
+		return false;
+	}
+	_handle = handle;
+	_mapping = mapping;
+	_buf = (const uint8_t *)mapping;
+	_size = (int64_t)size.QuadPart;
+	return true;
+}
+
+void MemoryMappedReadStream::unmap() {
+	if (_mapping == nullptr) {
+		return;
+	}
+	UnmapViewOfFile(_mapping);
+	CloseHandle((HANDLE)_handle);
+	_mapping = nullptr;
+	_handle = nullptr;
+	_buf = nullptr;
+}
+
+#else
+
+bool MemoryMappedReadStream::map(const core::String &) {
+	return false;
+}
+
+void MemoryMappedReadStream::unmap() {
+}
+
+#endif
+
+} // namespace io
@@ -0,0 +1,47 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "io/MemoryReadStream.h"
+#include "io/File.h"
+
+namespace io {
+
+/**
+ * @brief Read only stream over a file that is mapped into memory.
+ *
+ * The pages of the file are loaded on demand by the operating system - there is no copy of the whole file on
+ * the heap like for File::read() or File::load(). If the platform doesn't support memory mapped files, the file
+ * content is read into memory.
+ *
+ * @note Only files that were opened for reading can get mapped.
+ * @ingroup IO
+ * @see FileStream
+ * @see MemoryReadStream
+ */
+class MemoryMappedReadStream : public MemoryReadStream {
+private:
+	FilePtr _file;
+	void *_mapping = nullptr;
+	void *_handle = nullptr;
+
+	bool map(const core::String &path);
+	void unmap();
+
+public:
+	MemoryMappedReadStream(const FilePtr &file);
+	virtual ~MemoryMappedReadStream();
+
+	/**
+	 * @return @c true if the file content is mapped into memory, @c false if it was read into a buffer
+	 */
+	bool mapped() const;
+};
+
+inline bool MemoryMappedReadStream::mapped() const {
+	return _mapping != nullptr;
+}
+
+} // namespace io
@@ -13,6 +13,10 @@ MemoryReadStream::MemoryReadStream(const void *buf, uint32_t size) : _buf((const
 }
 
 MemoryReadStream::MemoryReadStream(ReadStream &stream, uint32_t size) : _ownBuf((uint8_t*)core_malloc(size)), _size(size) {
+	if (stream.read(_ownBuf, size) != (int)size) {
+		Log::error("Failed to read %u bytes from the stream", size);
+		_size = 0;
+	}
 }
 
 MemoryReadStream::~MemoryReadStream() {
@@ -27,6 +27,7 @@ public:
 
 	int64_t size() const override;
 	int64_t pos() const override;
+	const uint8_t *data() const override;
 	int read(void *dataPtr, size_t dataSize) override;
 	int64_t seek(int64_t position, int whence = SEEK_SET) override;
 };
@@ -39,4 +40,11 @@ inline int64_t MemoryReadStream::pos() const {
 	return _pos;
 }
 
+inline const uint8_t *MemoryReadStream::data() const {
+	if (_ownBuf) {
+		return _ownBuf;
+	}
+	return _buf;
+}
+
 } // namespace io
@@ -151,6 +151,14 @@ public:
 	 * @sa seek()
 	 */
 	virtual int64_t pos() const = 0;
+	/**
+	 * @return The whole content of the stream if it is available in memory - @c nullptr otherwise. This allows to
+	 * parse the data without copying it into a buffer first.
+	 * @sa size()
+	 */
+	virtual const uint8_t *data() const {
+		return nullptr;
+	}
 
 	/**
 	 * @brief Advances the position in the stream without reading the bytes.
@@ -59,6 +59,42 @@ TEST_F(FilesystemTest, testFileExists) {
 	EXPECT_TRUE(fs.exists("iotest.txt"));
 }
 
+TEST_F(FilesystemTest, testStat) {
+	io::Filesystem fs;
+	EXPECT_TRUE(fs.init("test", "test")) << "Failed to initialize the filesystem";
+	EXPECT_TRUE(fs.createDir("stattest"));
+	EXPECT_TRUE(fs.syswrite("stattest/file", "123"));
+	io::FilesystemEntry entry;
+	ASSERT_TRUE(io::Filesystem::stat("stattest/file", entry));
+	EXPECT_EQ("file", entry.name);
+	EXPECT_EQ(io::FilesystemEntry::Type::file, entry.type);
+	EXPECT_EQ(3u, entry.size);
+	EXPECT_GT(entry.mtime, 0u);
+	ASSERT_TRUE(io::Filesystem::stat("stattest", entry));
+	EXPECT_EQ(io::FilesystemEntry::Type::dir, entry.type);
+	EXPECT_FALSE(io::Filesystem::stat("stattest/doesnotexist", entry));
+	fs.removeFile("stattest/file");
+	fs.removeDir("stattest");
+	fs.shutdown();
+}
+
+TEST_F(FilesystemTest, testRename) {
+	io::Filesystem fs;
+	EXPECT_TRUE(fs.init("test", "test")) << "Failed to initialize the filesystem";
+	EXPECT_TRUE(fs.createDir("renametest"));
+	EXPECT_TRUE(fs.syswrite("renametest/old", "123"));
+	EXPECT_TRUE(fs.syswrite("renametest/new", "1"));
+	EXPECT_TRUE(fs.rename("renametest/old", "renametest/new")) << "The existing file should get replaced";
+	io::FilesystemEntry entry;
+	EXPECT_FALSE(io::Filesystem::stat("renametest/old", entry));
+	ASSERT_TRUE(io::Filesystem::stat("renametest/new", entry));
+	EXPECT_EQ(3u, entry.size);
+	EXPECT_FALSE(fs.rename("renametest/old", "renametest/new"));
+	fs.removeFile("renametest/new");
+	fs.removeDir("renametest");
+	fs.shutdown();
+}
+
 TEST_F(FilesystemTest, testListDirectoryFilter) {
 	io::Filesystem fs;
 	EXPECT_TRUE(fs.init("test", "test")) << "Failed to initialize the filesystem";
@@ -0,0 +1,71 @@
+/**
+ * @file
+ */
+
+#include "io/MemoryMappedReadStream.h"
+#include "core/FourCC.h"
+#include "io/FileStream.h"
+#include "io/Filesystem.h"
+#include <SDL_platform.h>
+#include <gtest/gtest.h>
+
+namespace io {
+
+class MemoryMappedReadStreamTest : public testing::Test {
+protected:
+	io::Filesystem _fs;
+
+public:
+	void SetUp() override {
+		_fs.init("test", "test");
+	}
+
+	void TearDown() override {
+		_fs.shutdown();
+	}
+};
+
+TEST_F(MemoryMappedReadStreamTest, testInvalidFile) {
+	const FilePtr file;
+	MemoryMappedReadStream stream(file);
+	EXPECT_FALSE(stream.mapped());
+	EXPECT_TRUE(stream.empty());
+	EXPECT_EQ(0, stream.size());
+	int8_t val = 0;
+	EXPECT_EQ(-1, stream.readInt8(val));
+}
+
+TEST_F(MemoryMappedReadStreamTest, testRead) {
+	const FilePtr &file = _fs.open("iotest.txt");
+	ASSERT_TRUE(file->exists());
+
+	MemoryMappedReadStream stream(file);
+#if defined(__LINUX__) || defined(__MACOSX__) || defined(__WINDOWS__)
+	EXPECT_TRUE(stream.mapped());
+#endif
+	EXPECT_EQ((int64_t)file->length(), stream.size());
+
+	uint32_t magic;
+	EXPECT_EQ(0, stream.peekUInt32(magic));
+	EXPECT_EQ(0, stream.pos());
+	EXPECT_EQ(FourCC('W', 'i', 'n', 'd'), magic);
+
+	FileStream fileStream(file);
+	uint8_t expected;
+	uint8_t byte;
+	while (fileStream.readUInt8(expected) == 0) {
+		ASSERT_EQ(0, stream.readUInt8(byte));
+		EXPECT_EQ(expected, byte);
+	}
+	EXPECT_TRUE(stream.eos());
+	EXPECT_EQ(-1, stream.readUInt8(byte));
+}
+
+TEST_F(MemoryMappedReadStreamTest, testWriteModeIsNotMapped) {
+	const FilePtr &file = _fs.open("memorymappedtest.txt", FileMode::Write);
+	MemoryMappedReadStream stream(file);
+	EXPECT_FALSE(stream.mapped());
+	EXPECT_EQ(0, stream.size());
+}
+
+} // namespace io
@@ -0,0 +1,259 @@
+/**
+ * @file
+ */
+
+#include "SimplexBatch.h"
+#include "Simplex.h"
+#include <SDL_cpuinfo.h>
+
+namespace noise {
+
+#ifdef __SSE2__
+namespace details {
+
+// the skewing factors of Simplex.h - they are double values there, too
+static constexpr double F2 = 0.366025403;
+static constexpr double G2 = 0.211324865;
+static constexpr double F3 = 0.333333333;
+static constexpr double G3 = 0.166666667;
+
+/**
+ * The skew factors of the scalar implementation are double values - the intermediate results must be
+ * computed in double precision, too. Otherwise we would not get the same noise values.
+ */
+static inline __m128 mulDouble(__m128 a, double b) {
+	const __m128d factor = _mm_set1_pd(b);
+	const __m128d lo = _mm_mul_pd(_mm_cvtps_pd(a), factor);
+	const __m128d hi = _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(a, a)), factor);
+	return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
+static inline __m128 addDouble(__m128 a, double b) {
+	const __m128d summand = _mm_set1_pd(b);
+	const __m128d lo = _mm_add_pd(_mm_cvtps_pd(a), summand);
+	const __m128d hi = _mm_add_pd(_mm_cvtps_pd(_mm_movehl_ps(a, a)), summand);
+	return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
+/**
+ * @brief Same as FASTFLOOR - which means that negative integral values are off by one
+ */
+static inline __m128i fastFloor(__m128 v) {
+	const __m128i truncated = _mm_cvttps_epi32(v);
+	const __m128i positive = _mm_castps_si128(_mm_cmpgt_ps(v, _mm_setzero_ps()));
+	return _mm_add_epi32(truncated, _mm_andnot_si128(positive, _mm_set1_epi32(-1)));
+}
+
+static inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 negateIf(__m128 mask, __m128 v) {
+	return _mm_xor_ps(v, _mm_and_ps(mask, _mm_set1_ps(-0.0f)));
+}
+
+static inline __m128 hashBitSet(__m128i hash, int bit) {
+	const __m128i b = _mm_set1_epi32(bit);
+	return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hash, b), b));
+}
+
+static inline __m128 hashLess(__m128i hash, int value) {
+	return _mm_castsi128_ps(_mm_cmplt_epi32(hash, _mm_set1_epi32(value)));
+}
+
+static inline __m128 hashEqual(__m128i hash, int value) {
+	return _mm_castsi128_ps(_mm_cmpeq_epi32(hash, _mm_set1_epi32(value)));
+}
+
+static inline __m128 grad4(__m128i hash, __m128 x, __m128 y) {
+	const __m128i h = _mm_and_si128(hash, _mm_set1_epi32(7));
+	const __m128 lt4 = hashLess(h, 4);
+	const __m128 u = select(lt4, x, y);
+	const __m128 v = select(lt4, y, x);
+	return _mm_add_ps(negateIf(hashBitSet(h, 1), u), negateIf(hashBitSet(h, 2), _mm_mul_ps(_mm_set1_ps(2.0f), v)));
+}
+
+static inline __m128 grad4(__m128i hash, __m128 x, __m128 y, __m128 z) {
+	const __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+	const __m128 u = select(hashLess(h, 8), x, y);
+	const __m128 xz = select(_mm_or_ps(hashEqual(h, 12), hashEqual(h, 14)), x, z);
+	const __m128 v = select(hashLess(h, 4), y, xz);
+	return _mm_add_ps(negateIf(hashBitSet(h, 1), u), negateIf(hashBitSet(h, 2), v));
+}
+
+/**
+ * @brief The contribution of a simplex corner - zero if the corner is too far away
+ */
+static inline __m128 contribution(__m128 t, __m128 grad) {
+	const __m128 t2 = _mm_mul_ps(t, t);
+	const __m128 n = _mm_mul_ps(_mm_mul_ps(t2, t2), grad);
+	return _mm_andnot_ps(_mm_cmplt_ps(t, _mm_setzero_ps()), n);
+}
+
+// 2D simplex noise for four positions - see noise(const glm::vec2&)
+static __m128 noise4(__m128 x, __m128 y) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 s = mulDouble(_mm_add_ps(x, y), F2);
+	const __m128i i = fastFloor(_mm_add_ps(x, s));
+	const __m128i j = fastFloor(_mm_add_ps(y, s));
+	const __m128 t = mulDouble(_mm_cvtepi32_ps(_mm_add_epi32(i, j)), G2);
+	const __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+	const __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+
+	// lower triangle: (0,0)->(1,0)->(1,1) - upper triangle: (0,0)->(0,1)->(1,1)
+	const __m128 lower = _mm_cmpgt_ps(x0, y0);
+	const __m128 x1 = addDouble(_mm_sub_ps(x0, _mm_and_ps(lower, one)), G2);
+	const __m128 y1 = addDouble(_mm_sub_ps(y0, _mm_andnot_ps(lower, one)), G2);
+	const __m128 x2 = addDouble(_mm_sub_ps(x0, one), 2.0f * G2);
+	const __m128 y2 = addDouble(_mm_sub_ps(y0, one), 2.0f * G2);
+
+	// the permutation table lookups can't be vectorized with sse2
+	alignas(16) int32_t iv[4], jv[4], h0[4], h1[4], h2[4];
+	_mm_store_si128((__m128i *)iv, i);
+	_mm_store_si128((__m128i *)jv, j);
+	const int lowerMask = _mm_movemask_ps(lower);
+	for (int lane = 0; lane < 4; ++lane) {
+		const int ii = iv[lane] & 0xff;
+		const int jj = jv[lane] & 0xff;
+		const int i1 = (lowerMask >> lane) & 1;
+		const int j1 = 1 - i1;
+		h0[lane] = perm[ii + perm[jj]];
+		h1[lane] = perm[ii + i1 + perm[jj + j1]];
+		h2[lane] = perm[ii + 1 + perm[jj + 1]];
+	}
+
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 n0 = contribution(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0)),
+								   grad4(_mm_load_si128((const __m128i *)h0), x0, y0));
+	const __m128 n1 = contribution(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1)),
+								   grad4(_mm_load_si128((const __m128i *)h1), x1, y1));
+	const __m128 n2 = contribution(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x2, x2)), _mm_mul_ps(y2, y2)),
+								   grad4(_mm_load_si128((const __m128i *)h2), x2, y2));
+	return _mm_mul_ps(_mm_set1_ps(40.0f), _mm_add_ps(_mm_add_ps(n0, n1), n2));
+}
+
+static inline __m128 falloff(__m128 x, __m128 y, __m128 z) {
+	const __m128 t = _mm_sub_ps(_mm_set1_ps(0.6f), _mm_mul_ps(x, x));
+	return _mm_sub_ps(_mm_sub_ps(t, _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+}
+
+// 3D simplex noise for four positions - see noise(const glm::vec3&)
+static __m128 noise4(__m128 x, __m128 y, __m128 z) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 s = mulDouble(_mm_add_ps(_mm_add_ps(x, y), z), F3);
+	const __m128i i = fastFloor(_mm_add_ps(x, s));
+	const __m128i j = fastFloor(_mm_add_ps(y, s));
+	const __m128i k = fastFloor(_mm_add_ps(z, s));
+	const __m128 t = mulDouble(_mm_cvtepi32_ps(_mm_add_epi32(_mm_add_epi32(i, j), k)), G3);
+	const __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+	const __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+	const __m128 z0 = _mm_sub_ps(z, _mm_sub_ps(_mm_cvtepi32_ps(k), t));
+
+	// the branchless version of the simplex selection in noise(const glm::vec3&)
+	const __m128 xy = _mm_cmpge_ps(x0, y0);
+	const __m128 yz = _mm_cmpge_ps(y0, z0);
+	const __m128 xz = _mm_cmpge_ps(x0, z0);
+	const __m128 i1 = _mm_and_ps(xy, xz);
+	const __m128 j1 = _mm_andnot_ps(xy, yz);
+	const __m128 k1 = _mm_andnot_ps(_mm_or_ps(xz, yz), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+	const __m128 i2 = _mm_or_ps(xy, xz);
+	const __m128 j2 = _mm_or_ps(_mm_andnot_ps(xy, _mm_castsi128_ps(_mm_set1_epi32(-1))), yz);
+	const __m128 k2 = _mm_andnot_ps(_mm_and_ps(xz, yz), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+
+	const __m128 x1 = addDouble(_mm_sub_ps(x0, _mm_and_ps(i1, one)), G3);
+	const __m128 y1 = addDouble(_mm_sub_ps(y0, _mm_and_ps(j1, one)), G3);
+	const __m128 z1 = addDouble(_mm_sub_ps(z0, _mm_and_ps(k1, one)), G3);
+	const __m128 x2 = addDouble(_mm_sub_ps(x0, _mm_and_ps(i2, one)), 2.0f * G3);
+	const __m128 y2 = addDouble(_mm_sub_ps(y0, _mm_and_ps(j2, one)), 2.0f * G3);
+	const __m128 z2 = addDouble(_mm_sub_ps(z0, _mm_and_ps(k2, one)), 2.0f * G3);
+	const __m128 x3 = addDouble(_mm_sub_ps(x0, one), 3.0f * G3);
+	const __m128 y3 = addDouble(_mm_sub_ps(y0, one), 3.0f * G3);
+	const __m128 z3 = addDouble(_mm_sub_ps(z0, one), 3.0f * G3);
+
+	// the permutation table lookups can't be vectorized with sse2
+	alignas(16) int32_t iv[4], jv[4], kv[4], h0[4], h1[4], h2[4], h3[4];
+	_mm_store_si128((__m128i *)iv, i);
+	_mm_store_si128((__m128i *)jv, j);
+	_mm_store_si128((__m128i *)kv, k);
+	const int i1Mask = _mm_movemask_ps(i1);
+	const int j1Mask = _mm_movemask_ps(j1);
+	const int k1Mask = _mm_movemask_ps(k1);
+	const int i2Mask = _mm_movemask_ps(i2);
+	const int j2Mask = _mm_movemask_ps(j2);
+	const int k2Mask = _mm_movemask_ps(k2);
+	for (int lane = 0; lane < 4; ++lane) {
+		const int ii = iv[lane] & 0xff;
+		const int jj = jv[lane] & 0xff;
+		const int kk = kv[lane] & 0xff;
+		const int li1 = (i1Mask >> lane) & 1;
+		const int lj1 = (j1Mask >> lane) & 1;
+		const int lk1 = (k1Mask >> lane) & 1;
+		const int li2 = (i2Mask >> lane) & 1;
+		const int lj2 = (j2Mask >> lane) & 1;
+		const int lk2 = (k2Mask >> lane) & 1;
+		h0[lane] = perm[ii + perm[jj + perm[kk]]];
+		h1[lane] = perm[ii + li1 + perm[jj + lj1 + perm[kk + lk1]]];
+		h2[lane] = perm[ii + li2 + perm[jj + lj2 + perm[kk + lk2]]];
+		h3[lane] = perm[ii + 1 + perm[jj + 1 + perm[kk + 1]]];
+	}
+
+	const __m128 n0 = contribution(falloff(x0, y0, z0), grad4(_mm_load_si128((const __m128i *)h0), x0, y0, z0));
+	const __m128 n1 = contribution(falloff(x1, y1, z1), grad4(_mm_load_si128((const __m128i *)h1), x1, y1, z1));
+	const __m128 n2 = contribution(falloff(x2, y2, z2), grad4(_mm_load_si128((const __m128i *)h2), x2, y2, z2));
+	const __m128 n3 = contribution(falloff(x3, y3, z3), grad4(_mm_load_si128((const __m128i *)h3), x3, y3, z3));
+	return _mm_mul_ps(_mm_set1_ps(32.0f), _mm_add_ps(_mm_add_ps(_mm_add_ps(n0, n1), n2), n3));
+}
+
+} // namespace details
+#endif
+
+void fBmBatch(const glm::vec2 *positions, float *out, int amount, uint8_t octaves, float lacunarity, float gain) {
+	int i = 0;
+#ifdef __SSE2__
+	for (; i + 4 <= amount; i += 4) {
+		const __m128 x = _mm_setr_ps(positions[i].x, positions[i + 1].x, positions[i + 2].x, positions[i + 3].x);
+		const __m128 y = _mm_setr_ps(positions[i].y, positions[i + 1].y, positions[i + 2].y, positions[i + 3].y);
+		__m128 sum = _mm_setzero_ps();
+		float freq = 1.0f;
+		float amp = 0.5f;
+		for (uint8_t o = 0; o < octaves; ++o) {
+			const __m128 f = _mm_set1_ps(freq);
+			const __m128 n = details::noise4(_mm_mul_ps(x, f), _mm_mul_ps(y, f));
+			sum = _mm_add_ps(sum, _mm_mul_ps(n, _mm_set1_ps(amp)));
+			freq *= lacunarity;
+			amp *= gain;
+		}
+		_mm_storeu_ps(&out[i], sum);
+	}
+#endif
+	for (; i < amount; ++i) {
+		out[i] = fBm(positions[i], octaves, lacunarity, gain);
+	}
+}
+
+void fBmBatch(const glm::vec3 *positions, float *out, int amount, uint8_t octaves, float lacunarity, float gain) {
+	int i = 0;
+#ifdef __SSE2__
+	for (; i + 4 <= amount; i += 4) {
+		const __m128 x = _mm_setr_ps(positions[i].x, positions[i + 1].x, positions[i + 2].x, positions[i + 3].x);
+		const __m128 y = _mm_setr_ps(positions[i].y, positions[i + 1].y, positions[i + 2].y, positions[i + 3].y);
+		const __m128 z = _mm_setr_ps(positions[i].z, positions[i + 1].z, positions[i + 2].z, positions[i + 3].z);
+		__m128 sum = _mm_setzero_ps();
+		float freq = 1.0f;
+		float amp = 0.5f;
+		for (uint8_t o = 0; o < octaves; ++o) {
+			const __m128 f = _mm_set1_ps(freq);
+			const __m128 n = details::noise4(_mm_mul_ps(x, f), _mm_mul_ps(y, f), _mm_mul_ps(z, f));
+			sum = _mm_add_ps(sum, _mm_mul_ps(n, _mm_set1_ps(amp)));
+			freq *= lacunarity;
+			amp *= gain;
+		}
+		_mm_storeu_ps(&out[i], sum);
+	}
+#endif
+	for (; i < amount; ++i) {
+		out[i] = fBm(positions[i], octaves, lacunarity, gain);
+	}
+}
+
+} // namespace noise
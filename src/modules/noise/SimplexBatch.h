@@ -0,0 +1,32 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include <glm/fwd.hpp>
+#include <stdint.h>
+
+namespace noise {
+
+/**
+ * @brief Evaluates @c noise::fBm() for @c amount 2d positions at once.
+ *
+ * Four positions are evaluated in parallel with SSE2 if available. The results are bit-identical to
+ * calling the scalar @c noise::fBm() for each position - this is needed to get the same terrain heights
+ * no matter whether a chunk was generated in batches or a single height was queried.
+ *
+ * @param[in] positions The noise positions
+ * @param[out] out Receives @c amount noise values
+ */
+extern void fBmBatch(const glm::vec2 *positions, float *out, int amount, uint8_t octaves = 4,
+					 float lacunarity = 2.0f, float gain = 0.5f);
+
+/**
+ * @brief Evaluates @c noise::fBm() for @c amount 3d positions at once.
+ * @sa fBmBatch(const glm::vec2*, float*, int, uint8_t, float, float)
+ */
+extern void fBmBatch(const glm::vec3 *positions, float *out, int amount, uint8_t octaves = 4,
+					 float lacunarity = 2.0f, float gain = 0.5f);
+
+} // namespace noise
@@ -0,0 +1,49 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "noise/Simplex.h"
+#include "noise/SimplexBatch.h"
+#include <random>
+
+namespace noise {
+
+class SimplexBatchTest: public app::AbstractTest {
+protected:
+	static constexpr int Amount = 1027;
+};
+
+TEST_F(SimplexBatchTest, testSame2d) {
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+	glm::vec2 positions[Amount];
+	for (int i = 0; i < Amount; ++i) {
+		positions[i] = glm::vec2(dist(rng), dist(rng));
+	}
+	// integral values hit the FASTFLOOR edge cases
+	positions[0] = glm::vec2(-2.0f, 0.0f);
+	positions[1] = glm::vec2(0.0f, -3.0f);
+	float out[Amount];
+	fBmBatch(positions, out, Amount, 4, 2.1f, 0.6f);
+	for (int i = 0; i < Amount; ++i) {
+		ASSERT_EQ(fBm(positions[i], 4, 2.1f, 0.6f), out[i]) << "position " << i;
+	}
+}
+
+TEST_F(SimplexBatchTest, testSame3d) {
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+	glm::vec3 positions[Amount];
+	for (int i = 0; i < Amount; ++i) {
+		positions[i] = glm::vec3(dist(rng), dist(rng), dist(rng));
+	}
+	positions[0] = glm::vec3(-1.0f, 0.0f, 2.0f);
+	float out[Amount];
+	fBmBatch(positions, out, Amount, 3, 2.0f, 0.5f);
+	for (int i = 0; i < Amount; ++i) {
+		ASSERT_EQ(fBm(positions[i], 3, 2.0f, 0.5f), out[i]) << "position " << i;
+	}
+}
+
+}
@@ -219,6 +219,24 @@ bool Buffer::update(int32_t idx, const void* data, size_t size, bool orphaning)
 	return true;
 }
 
+bool Buffer::updateRange(int32_t idx, size_t offset, const void* data, size_t size) {
+	if (!isValid(idx)) {
+		return false;
+	}
+	if (offset + size > _size[idx]) {
+		return false;
+	}
+	if (size == 0u) {
+		return true;
+	}
+	core_assert(video::boundVertexArray() == InvalidId);
+#if VIDEO_BUFFER_HASH_COMPARE
+	_hash[idx] = 0u;
+#endif
+	video::bufferSubData(_handles[idx], _targets[idx], (intptr_t)offset, data, size);
+	return true;
+}
+
 int32_t Buffer::create(const void* data, size_t size, BufferType target) {
 	if (_handleIdx >= MAX_HANDLES) {
 		return -1;
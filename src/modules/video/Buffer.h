@@ -77,6 +77,13 @@ public:
 	 */
 	void destroyVertexArray();
 	bool update(int32_t idx, const void* data, size_t size, bool orphaning = false);
+	/**
+	 * @brief Uploads a range of an already allocated buffer without touching the rest of the data
+	 * @param[in] offset The offset in bytes
+	 * @return @c false if the range doesn't fit into the current size of the buffer - use update() to
+	 * resize the buffer in that case
+	 */
+	bool updateRange(int32_t idx, size_t offset, const void* data, size_t size);
 
 	/**
 	 * @return -1 on error - otherwise the index [0,n) of the created buffer (not the Id)
@@ -0,0 +1,284 @@
+/**
+ * @file
+ */
+
+#include "BinaryCubicSurfaceExtractor.h"
+#include "core/Assert.h"
+#include "core/Bits.h"
+#include "core/StandardLib.h"
+
+namespace voxel {
+
+static constexpr int TileColumns = BinaryMeshTile::TileSize * BinaryMeshTile::TileSize;
+static constexpr int PaddedVoxels = BinaryMeshTile::PaddedSize * BinaryMeshTile::PaddedSize * BinaryMeshTile::PaddedSize;
+/** the lower 16 bits of a face key are the voxel, the upper bits are the ambient occlusion values */
+static constexpr uint32_t FaceKeyVoxelMask = 0xFFFFu;
+
+/**
+ * @brief The two axes that span the planes of the given axis
+ */
+static constexpr int PlaneAxisU[3] = {1, 0, 0};
+static constexpr int PlaneAxisV[3] = {2, 2, 1};
+
+static inline uint64_t bitRange(int start, int width) {
+	const uint64_t bits = width >= 64 ? ~(uint64_t)0 : (((uint64_t)1 << width) - 1u);
+	return bits << start;
+}
+
+static inline Voxel faceKeyVoxel(uint32_t key) {
+	return Voxel((VoxelType)((key >> 11) & 0x1F), (uint8_t)(key & 0xFF), (uint8_t)((key >> 8) & 0x7));
+}
+
+static inline uint8_t faceKeyAmbientOcclusion(uint32_t key, int corner) {
+	return (uint8_t)((key >> (16 + corner * 2)) & 0x3);
+}
+
+BinaryMeshTile::BinaryMeshTile() {
+	_voxels = (Voxel *)core_malloc(PaddedVoxels * sizeof(Voxel));
+	_opaque = (uint8_t *)core_malloc(PaddedVoxels);
+	for (int i = 0; i < 3; ++i) {
+		_columns[i] = (uint64_t *)core_malloc(TileColumns * sizeof(uint64_t));
+		_columnsLow[i] = (uint8_t *)core_malloc(TileColumns);
+	}
+	_planeRows = (uint64_t *)core_malloc(TileSize * TileSize * sizeof(uint64_t));
+	_faceKeys = (uint32_t *)core_malloc(TileColumns * sizeof(uint32_t));
+}
+
+BinaryMeshTile::~BinaryMeshTile() {
+	core_free(_voxels);
+	core_free(_opaque);
+	for (int i = 0; i < 3; ++i) {
+		core_free(_columns[i]);
+		core_free(_columnsLow[i]);
+	}
+	core_free(_planeRows);
+	core_free(_faceKeys);
+}
+
+void BinaryMeshTile::reset(const glm::ivec3 &size) {
+	core_assert(size.x >= 1 && size.y >= 1 && size.z >= 1);
+	core_assert(size.x <= TileSize && size.y <= TileSize && size.z <= TileSize);
+	_size = size;
+	_solidVoxels = 0;
+}
+
+void BinaryMeshTile::buildColumns() {
+	core_trace_scoped(BuildColumns);
+	for (int i = 0; i < 3; ++i) {
+		core_memset(_columns[i], 0, TileColumns * sizeof(uint64_t));
+		core_memset(_columnsLow[i], 0, TileColumns);
+	}
+	uint64_t *columnsX = _columns[0];
+	uint64_t *columnsY = _columns[1];
+	uint64_t *columnsZ = _columns[2];
+	for (int z = 0; z <= _size.z; ++z) {
+		for (int y = 0; y <= _size.y; ++y) {
+			const uint8_t *opaque = &_opaque[z * StrideZ + y * StrideY];
+			for (int x = 0; x <= _size.x; ++x) {
+				if (!opaque[x]) {
+					continue;
+				}
+				// the border voxels behind the tile are only needed for the ambient occlusion
+				const int bx = x - 1;
+				const int by = y - 1;
+				const int bz = z - 1;
+				if (by >= 0 && bz >= 0) {
+					if (bx >= 0) {
+						columnsX[bz * TileSize + by] |= (uint64_t)1 << bx;
+					} else {
+						_columnsLow[0][bz * TileSize + by] = 1;
+					}
+				}
+				if (bx >= 0 && bz >= 0) {
+					if (by >= 0) {
+						columnsY[bz * TileSize + bx] |= (uint64_t)1 << by;
+					} else {
+						_columnsLow[1][bz * TileSize + bx] = 1;
+					}
+				}
+				if (bx >= 0 && by >= 0) {
+					if (bz >= 0) {
+						columnsZ[by * TileSize + bx] |= (uint64_t)1 << bz;
+					} else {
+						_columnsLow[2][by * TileSize + bx] = 1;
+					}
+				}
+			}
+		}
+	}
+}
+
+uint32_t BinaryMeshTile::faceKey(int axis, bool negative, int plane, int u, int v) const {
+	static constexpr int strides[3] = {1, StrideY, StrideZ};
+	const int strideA = strides[axis];
+	const int strideU = strides[PlaneAxisU[axis]];
+	const int strideV = strides[PlaneAxisV[axis]];
+	// a negative face belongs to the voxel on the plane and looks into the voxel in front of it, a positive
+	// face belongs to the voxel in front of the plane
+	const int solidA = negative ? plane + 1 : plane;
+	const int openA = negative ? plane : plane + 1;
+	const int cell = (u + 1) * strideU + (v + 1) * strideV;
+	const Voxel &voxel = _voxels[solidA * strideA + cell];
+	const int open = openA * strideA + cell;
+
+	uint32_t key = (uint32_t)voxel.getColor() | ((uint32_t)voxel.getFlags() << 8) | ((uint32_t)voxel.getMaterial() << 11);
+	for (int corner = 0; corner < 4; ++corner) {
+		const int du = (corner & 1) ? strideU : -strideU;
+		const int dv = (corner & 2) ? strideV : -strideV;
+		const uint8_t ao = vertexAmbientOcclusion(_opaque[open + du], _opaque[open + dv], _opaque[open + du + dv]);
+		key |= (uint32_t)ao << (16 + corner * 2);
+	}
+	return key;
+}
+
+IndexType BinaryMeshTile::addVertex(bool reuseVertices, const glm::ivec3 &lattice, const Voxel &voxel,
+									uint8_t ambientOcclusion, const glm::ivec3 &offset, Mesh *result) {
+	int32_t *head = nullptr;
+	if (reuseVertices) {
+		head = &_vertexHeads[(lattice.z * (_size.y + 1) + lattice.y) * (_size.x + 1) + lattice.x];
+		for (int32_t e = *head; e != -1; e = _vertexEntries[e].next) {
+			const VertexEntry &entry = _vertexEntries[e];
+			if (entry.ambientOcclusion == ambientOcclusion && entry.voxel.getFlags() == voxel.getFlags() &&
+				entry.voxel.isSame(voxel)) {
+				return entry.index;
+			}
+		}
+	}
+
+	VoxelVertex vertex;
+	vertex.position = lattice + offset;
+	vertex.colorIndex = voxel.getColor();
+	vertex.ambientOcclusion = ambientOcclusion;
+	vertex.flags = voxel.getFlags();
+	vertex.padding = 0u;
+	const IndexType index = result->addVertex(vertex);
+	if (reuseVertices) {
+		_vertexEntries.push_back(VertexEntry{*head, index, voxel, ambientOcclusion});
+		*head = (int32_t)_vertexEntries.size() - 1;
+	}
+	return index;
+}
+
+void BinaryMeshTile::extractFaces(int axis, bool negative, const glm::ivec3 &offset, Mesh *result,
+								  bool mergeQuads, bool reuseVertices, bool ambientOcclusion) {
+	core_trace_scoped(ExtractFaces);
+	const int axisU = PlaneAxisU[axis];
+	const int axisV = PlaneAxisV[axis];
+	const int planes = _size[axis];
+	const int sizeU = _size[axisU];
+	const int sizeV = _size[axisV];
+	const uint64_t validPlanes = bitRange(0, planes);
+	const uint32_t keyMask = ambientOcclusion ? ~0u : FaceKeyVoxelMask;
+	// the quad vertices must be in the same order as in extractCubicMesh()
+	const bool alongV = negative != (axis == 1);
+
+	core_memset(_planeRows, 0, planes * TileSize * sizeof(uint64_t));
+	const uint64_t *columns = _columns[axis];
+	const uint8_t *columnsLow = _columnsLow[axis];
+	bool anyFace = false;
+	for (int v = 0; v < sizeV; ++v) {
+		for (int u = 0; u < sizeU; ++u) {
+			const int column = v * TileSize + u;
+			const uint64_t solid = columns[column];
+			const uint64_t solidBefore = (solid << 1) | columnsLow[column];
+			uint64_t faces = (negative ? solid & ~solidBefore : solidBefore & ~solid) & validPlanes;
+			anyFace |= faces != 0u;
+			while (faces != 0u) {
+				const int plane = core::countTrailingZeros(faces);
+				faces &= faces - 1u;
+				_planeRows[plane * TileSize + v] |= (uint64_t)1 << u;
+			}
+		}
+	}
+	if (!anyFace) {
+		return;
+	}
+
+	for (int plane = 0; plane < planes; ++plane) {
+		uint64_t *rows = &_planeRows[plane * TileSize];
+		for (int v = 0; v < sizeV; ++v) {
+			uint64_t bits = rows[v];
+			while (bits != 0u) {
+				const int u = core::countTrailingZeros(bits);
+				bits &= bits - 1u;
+				_faceKeys[v * TileSize + u] = faceKey(axis, negative, plane, u, v);
+			}
+		}
+
+		for (int v0 = 0; v0 < sizeV; ++v0) {
+			while (rows[v0] != 0u) {
+				const int u0 = core::countTrailingZeros(rows[v0]);
+				const uint32_t *keys = &_faceKeys[v0 * TileSize];
+				const uint32_t key = keys[u0];
+				int u1 = u0 + 1;
+				if (mergeQuads) {
+					while (u1 < sizeU && (rows[v0] & ((uint64_t)1 << u1)) != 0u && ((keys[u1] ^ key) & keyMask) == 0u) {
+						++u1;
+					}
+				}
+				const uint64_t run = bitRange(u0, u1 - u0);
+				rows[v0] &= ~run;
+
+				int v1 = v0 + 1;
+				if (mergeQuads) {
+					for (; v1 < sizeV; ++v1) {
+						if ((rows[v1] & run) != run) {
+							break;
+						}
+						const uint32_t *nextKeys = &_faceKeys[v1 * TileSize];
+						int u = u0;
+						while (u < u1 && ((nextKeys[u] ^ key) & keyMask) == 0u) {
+							++u;
+						}
+						if (u != u1) {
+							break;
+						}
+						rows[v1] &= ~run;
+					}
+				}
+
+				// corners in the order (u0,v0), (u1,v0), (u0,v1), (u1,v1) - the ambient occlusion of each corner
+				// is taken from the face that touches it
+				const uint32_t cornerKeys[4] = {key, keys[u1 - 1], _faceKeys[(v1 - 1) * TileSize + u0],
+												_faceKeys[(v1 - 1) * TileSize + u1 - 1]};
+				const Voxel voxel = faceKeyVoxel(key);
+				IndexType indices[4];
+				for (int corner = 0; corner < 4; ++corner) {
+					glm::ivec3 lattice;
+					lattice[axis] = plane;
+					lattice[axisU] = (corner & 1) ? u1 : u0;
+					lattice[axisV] = (corner & 2) ? v1 : v0;
+					indices[corner] = addVertex(reuseVertices, lattice, voxel,
+												faceKeyAmbientOcclusion(cornerKeys[corner], corner), offset, result);
+				}
+				if (alongV) {
+					addQuad(result, Quad(indices[0], indices[2], indices[3], indices[1]));
+				} else {
+					addQuad(result, Quad(indices[0], indices[1], indices[3], indices[2]));
+				}
+			}
+		}
+	}
+}
+
+void BinaryMeshTile::extract(Mesh *result, const glm::ivec3 &offset, bool mergeQuads, bool reuseVertices,
+							 bool ambientOcclusion) {
+	core_trace_scoped(ExtractTile);
+	if (_solidVoxels == 0) {
+		return;
+	}
+	buildColumns();
+	if (reuseVertices) {
+		const int latticePoints = (_size.x + 1) * (_size.y + 1) * (_size.z + 1);
+		_vertexHeads.clear();
+		_vertexHeads.insert(latticePoints, -1);
+		_vertexEntries.clear();
+		_vertexEntries.reserve(latticePoints);
+	}
+	for (int axis = 0; axis < 3; ++axis) {
+		extractFaces(axis, true, offset, result, mergeQuads, reuseVertices, ambientOcclusion);
+		extractFaces(axis, false, offset, result, mergeQuads, reuseVertices, ambientOcclusion);
+	}
+}
+
+}
@@ -0,0 +1,154 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "CubicSurfaceExtractor.h"
+#include "Mesh.h"
+#include "Region.h"
+#include "Voxel.h"
+#include "core/GLM.h"
+#include "core/NonCopyable.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include <glm/common.hpp>
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+/**
+ * @brief Scratch memory and the meshing logic for one tile of the binary greedy mesher.
+ *
+ * The voxels of a tile are stored with a border of one voxel around it. The border is needed for the face
+ * culling of the lower planes and for the ambient occlusion of the vertices on the tile borders.
+ *
+ * The solid state of every voxel column along each axis is stored as bits in a 64 bit word. The faces of a column are
+ * found by shifting the column by one bit and masking it with the inverted neighbour column. The faces of each
+ * plane are then transposed into per-plane bit rows which are merged greedily by testing whole runs of bits
+ * at once.
+ *
+ * @sa extractBinaryCubicMesh()
+ */
+class BinaryMeshTile : public core::NonCopyable {
+public:
+	static constexpr int TileSize = 64;
+	static constexpr int PaddedSize = TileSize + 2;
+
+private:
+	static constexpr int StrideY = PaddedSize;
+	static constexpr int StrideZ = PaddedSize * PaddedSize;
+
+	struct VertexEntry {
+		int32_t next;
+		IndexType index;
+		Voxel voxel;
+		uint8_t ambientOcclusion;
+	};
+
+	Voxel *_voxels;
+	uint8_t *_opaque;
+	/** solid bits of each column along the x, y and z axis */
+	uint64_t *_columns[3];
+	/** solid state of the voxel in front of the first bit of each column */
+	uint8_t *_columnsLow[3];
+	/** face bits of each plane - transposed from the columns */
+	uint64_t *_planeRows;
+	uint32_t *_faceKeys;
+	core::DynamicArray<int32_t> _vertexHeads;
+	core::DynamicArray<VertexEntry> _vertexEntries;
+	glm::ivec3 _size { 0 };
+	int _solidVoxels = 0;
+
+	IndexType addVertex(bool reuseVertices, const glm::ivec3 &lattice, const Voxel &voxel, uint8_t ambientOcclusion,
+						const glm::ivec3 &offset, Mesh *result);
+	uint32_t faceKey(int axis, bool negative, int plane, int u, int v) const;
+	void buildColumns();
+	void extractFaces(int axis, bool negative, const glm::ivec3 &offset, Mesh *result, bool mergeQuads,
+					  bool reuseVertices, bool ambientOcclusion);
+
+public:
+	BinaryMeshTile();
+	~BinaryMeshTile();
+
+	/**
+	 * @brief Prepares the tile for a new region
+	 * @param[in] size The size of the tile in voxels without the border. Each component must be in the
+	 * range [1,TileSize]
+	 */
+	void reset(const glm::ivec3 &size);
+
+	/**
+	 * @param x,y,z The position in the tile - including the border. This means that @c 0 is the border voxel
+	 * in front of the first voxel of the tile.
+	 */
+	inline void setVoxel(int x, int y, int z, const Voxel &voxel) {
+		const int idx = z * StrideZ + y * StrideY + x;
+		_voxels[idx] = voxel;
+		const VoxelType material = voxel.getMaterial();
+		const bool opaque = !isAir(material) && !isTransparent(material);
+		_opaque[idx] = opaque;
+		_solidVoxels += opaque;
+	}
+
+	/**
+	 * @brief Adds the quads of the tile to the given mesh
+	 * @param[in] offset The vertex offset of the first voxel of the tile
+	 */
+	void extract(Mesh *result, const glm::ivec3 &offset, bool mergeQuads, bool reuseVertices, bool ambientOcclusion);
+};
+
+/**
+ * @brief Alternative to @c extractCubicMesh() that is using per-column bitmasks for the face culling and
+ * merges the quads greedily on 64 bit words.
+ *
+ * The resulting mesh is the same surface with the same colors and ambient occlusion values as the one
+ * produced by @c extractCubicMesh() with @c IsQuadNeeded. The region is processed in tiles of
+ * @c BinaryMeshTile::TileSize voxels - quads are not merged and vertices are not shared across tile
+ * borders.
+ *
+ * @note Only opaque voxels produce faces - this matches the rules of @c IsQuadNeeded. Custom quad rules
+ * must still use @c extractCubicMesh().
+ */
+template<typename VolumeType>
+void extractBinaryCubicMesh(VolumeType *volData, const Region &region, Mesh *result, const glm::ivec3 &translate,
+							bool mergeQuads = true, bool reuseVertices = true, bool ambientOcclusion = true) {
+	core_trace_scoped(ExtractBinaryCubicMesh);
+
+	result->clear();
+	const glm::ivec3 &lower = region.getLowerCorner();
+	const glm::ivec3 &upper = region.getUpperCorner();
+	result->setOffset(lower);
+
+	BinaryMeshTile tile;
+	typename VolumeType::Sampler volumeSampler(volData);
+	for (int32_t tileZ = lower.z; tileZ <= upper.z; tileZ += BinaryMeshTile::TileSize) {
+		for (int32_t tileY = lower.y; tileY <= upper.y; tileY += BinaryMeshTile::TileSize) {
+			for (int32_t tileX = lower.x; tileX <= upper.x; tileX += BinaryMeshTile::TileSize) {
+				const glm::ivec3 tileLower(tileX, tileY, tileZ);
+				const glm::ivec3 tileUpper = glm::min(tileLower + (BinaryMeshTile::TileSize - 1), upper);
+				const glm::ivec3 tileSize = tileUpper - tileLower + 1;
+				tile.reset(tileSize);
+				{
+					core_trace_scoped(FillTile);
+					for (int32_t z = 0; z < tileSize.z + 2; ++z) {
+						for (int32_t x = 0; x < tileSize.x + 2; ++x) {
+							volumeSampler.setPosition(tileLower.x + x - 1, tileLower.y - 1, tileLower.z + z - 1);
+							for (int32_t y = 0; y < tileSize.y + 2; ++y) {
+								tile.setVoxel(x, y, z, volumeSampler.voxel());
+								if (core_likely(y != tileSize.y + 1)) {
+									volumeSampler.movePositiveY();
+								}
+							}
+						}
+					}
+				}
+				tile.extract(result, tileLower - lower + translate, mergeQuads, reuseVertices, ambientOcclusion);
+			}
+		}
+	}
+
+	result->compressIndices();
+}
+
+}
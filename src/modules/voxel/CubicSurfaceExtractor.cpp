@@ -97,17 +97,6 @@ static bool performQuadMerging(QuadList& quads, Mesh* meshCurrent, bool ambientO
 	return didMerge;
 }
 
-/**
- * @brief We are checking the voxels above us. There are four possible ambient occlusion values
- * for a vertex.
- */
-SDL_FORCE_INLINE uint8_t vertexAmbientOcclusion(bool side1, bool side2, bool corner) {
-	if (side1 && side2) {
-		return 0;
-	}
-	return 3 - (side1 + side2 + corner);
-}
-
 /**
  * @note Notice that the ambient occlusion is different for the vertices on the side than it is for the
  * vertices on the top and bottom. To fix this, we just need to pick a consistent orientation for
@@ -118,6 +107,25 @@ SDL_FORCE_INLINE bool isQuadFlipped(const VoxelVertex& v00, const VoxelVertex& v
 	return v00.ambientOcclusion + v11.ambientOcclusion > v01.ambientOcclusion + v10.ambientOcclusion;
 }
 
+void addQuad(Mesh* result, const Quad& quad) {
+	const IndexType i0 = quad.vertices[0];
+	const IndexType i1 = quad.vertices[1];
+	const IndexType i2 = quad.vertices[2];
+	const IndexType i3 = quad.vertices[3];
+	const VoxelVertex& v00 = result->getVertex(i3);
+	const VoxelVertex& v01 = result->getVertex(i0);
+	const VoxelVertex& v10 = result->getVertex(i2);
+	const VoxelVertex& v11 = result->getVertex(i1);
+
+	if (isQuadFlipped(v00, v01, v10, v11)) {
+		result->addTriangle(i1, i2, i3);
+		result->addTriangle(i1, i3, i0);
+	} else {
+		result->addTriangle(i0, i1, i2);
+		result->addTriangle(i0, i2, i3);
+	}
+}
+
 void meshify(Mesh* result, bool mergeQuads, bool ambientOcclusion, QuadListVector& vecListQuads) {
 	core_trace_scoped(GenerateMeshify);
 	for (QuadList& listQuads : vecListQuads) {
@@ -130,22 +138,7 @@ void meshify(Mesh* result, bool mergeQuads, bool ambientOcclusion, QuadListVecto
 		}
 
 		for (const Quad& quad : listQuads) {
-			const IndexType i0 = quad.vertices[0];
-			const IndexType i1 = quad.vertices[1];
-			const IndexType i2 = quad.vertices[2];
-			const IndexType i3 = quad.vertices[3];
-			const VoxelVertex& v00 = result->getVertex(i3);
-			const VoxelVertex& v01 = result->getVertex(i0);
-			const VoxelVertex& v10 = result->getVertex(i2);
-			const VoxelVertex& v11 = result->getVertex(i1);
-
-			if (isQuadFlipped(v00, v01, v10, v11)) {
-				result->addTriangle(i1, i2, i3);
-				result->addTriangle(i1, i3, i0);
-			} else {
-				result->addTriangle(i0, i1, i2);
-				result->addTriangle(i0, i2, i3);
-			}
+			addQuad(result, quad);
 		}
 	}
 }
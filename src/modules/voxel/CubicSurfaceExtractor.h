@@ -95,9 +95,26 @@ typedef std::vector<QuadList> QuadListVector;
  * @section Surface extraction
  */
 
+/**
+ * @brief We are checking the voxels above us. There are four possible ambient occlusion values
+ * for a vertex.
+ */
+inline uint8_t vertexAmbientOcclusion(bool side1, bool side2, bool corner) {
+	if (side1 && side2) {
+		return 0;
+	}
+	return 3 - (side1 + side2 + corner);
+}
+
 extern IndexType addVertex(bool reuseVertices, uint32_t x, uint32_t y, uint32_t z, const Voxel& materialIn, Array& existingVertices,
 		Mesh* meshCurrent, const VoxelType face1, const VoxelType face2, const VoxelType corner, const glm::ivec3& offset);
 
+/**
+ * @brief Adds the two triangles of the given quad. The diagonal is chosen by the ambient occlusion values
+ * of the quad vertices.
+ */
+extern void addQuad(Mesh* result, const Quad& quad);
+
 extern void meshify(Mesh* result, bool mergeQuads, bool ambientOcclusion, QuadListVector& vecListQuads);
 
 /**
@@ -378,7 +395,7 @@ void extractCubicMesh(VolumeType* volData, const Region& region, Mesh* result, I
 
 				// Z [F] BEHIND
 				if (isQuadNeeded(voxelBeforeMaterial, voxelCurrentMaterial, FaceNames::PositiveZ)) {
-					const VoxelType _voxelRightBehind      = volumeSampler.peekVoxel1px0py1pz().getMaterial();
+					const VoxelType _voxelRightBehind      = volumeSampler.peekVoxel1px0py0pz().getMaterial();
 					const VoxelType _voxelAboveBehind      = volumeSampler.peekVoxel0px1py0pz().getMaterial();
 					const VoxelType _voxelAboveRightBehind = volumeSampler.peekVoxel1px1py0pz().getMaterial();
 					const VoxelType _voxelBelowRightBehind = volumeSampler.peekVoxel1px1ny0pz().getMaterial();
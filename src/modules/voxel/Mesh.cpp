@@ -214,4 +214,16 @@ bool Mesh::operator<(const Mesh& rhs) const {
 	return glm::all(glm::lessThan(getOffset(), rhs.getOffset()));
 }
 
+bool packVertices(const Mesh& mesh, PackedVertexArray& out) {
+	const VertexArray& vertices = mesh.getVertexVector();
+	const glm::ivec3& offset = mesh.getOffset();
+	out.resize(vertices.size());
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		if (!packVertex(vertices[i], offset, out[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
 }
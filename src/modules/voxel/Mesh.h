@@ -11,6 +11,7 @@ namespace voxel {
 
 using VertexArray = core::DynamicArray<voxel::VoxelVertex>;
 using IndexArray = core::DynamicArray<voxel::IndexType>;
+using PackedVertexArray = core::DynamicArray<voxel::PackedVoxelVertex>;
 
 /**
  * @brief A simple and general-purpose mesh class to represent the data returned by the surface extraction functions.
@@ -63,6 +64,13 @@ private:
 	bool _mayGetResized;
 };
 
+/**
+ * @brief Converts the vertices of the mesh into the packed vertex format relative to the mesh offset
+ * @return @c false if the mesh exceeds the limits of the packed vertex format - @c out is not usable then
+ * @sa PackedVoxelVertex
+ */
+bool packVertices(const Mesh& mesh, PackedVertexArray& out);
+
 inline const uint8_t* Mesh::compressedIndices() const {
 	return _compressedIndices;
 }
@@ -7,6 +7,7 @@
 #include "core/Log.h"
 #include "core/Common.h"
 #include "core/Trace.h"
+#include "core/concurrent/ThreadPool.h"
 #include "math/Functions.h"
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtc/round.hpp>
@@ -23,7 +24,8 @@ namespace voxel {
  * more of them meaning voxel access could be slower.
  */
 PagedVolume::PagedVolume(Pager* pager, uint32_t targetMemoryUsageInBytes, uint16_t chunkSideLength) :
-		_chunkSideLength(chunkSideLength), _pager(pager), _region(0, 0, 0, -1, -1, -1) {
+		_maxChunkCount(maxChunkCount(targetMemoryUsageInBytes, chunkSideLength)), _targetMemoryUsageInBytes(targetMemoryUsageInBytes),
+		_chunks((int)_maxChunkCount + 1), _chunkSideLength(chunkSideLength), _pager(pager), _region(0, 0, 0, -1, -1, -1) {
 	// Validation of parameters
 	core_assert_msg(_pager, "You must provide a valid pager when constructing a PagedVolume");
 	core_assert_msg(targetMemoryUsageInBytes >= 1 * 1024 * 1024, "Target memory usage is too small to be practical");
@@ -36,23 +38,33 @@ PagedVolume::PagedVolume(Pager* pager, uint32_t targetMemoryUsageInBytes, uint16
 	// Use to perform modulo by bit operations
 	_chunkMask = _chunkSideLength - 1;
 
-	// Calculate the number of chunks based on the memory limit and the size of each chunk.
+	// Calculate the number of chunks based on the memory limit and the uncompressed size of each chunk. This limit
+	// is raised as soon as we know how much memory the palette compressed chunks are really using.
 	uint32_t chunkSizeInBytes = PagedVolume::Chunk::calculateSizeInBytes(_chunkSideLength);
 	_chunkCountLimit = targetMemoryUsageInBytes / chunkSizeInBytes;
 
 	// Enforce sensible limits on the number of chunks.
-	const uint32_t minPracticalNoOfChunks = 32; // Enough to make sure a chunks and it's neighbours can be loaded, with a few to spare.
-	if (_chunkCountLimit < minPracticalNoOfChunks) {
+	if (_chunkCountLimit < MinPracticalNoOfChunks) {
 		Log::warn("Requested memory usage limit of %uMb is too low and cannot be adhered to. Chunk limit is at %i, Chunk size: %uKb",
 				targetMemoryUsageInBytes / (1024 * 1024), _chunkCountLimit, chunkSizeInBytes / 1024);
 	}
-	_chunkCountLimit = core_max(_chunkCountLimit, minPracticalNoOfChunks);
+	_chunkCountLimit = core_max(_chunkCountLimit, MinPracticalNoOfChunks);
 
 	// Inform the user about the chosen memory configuration.
 	Log::debug("Memory usage limit for volume now set to %uMb (%u chunks of %uKb each).",
 			(_chunkCountLimit * chunkSizeInBytes) / (1024 * 1024), _chunkCountLimit, chunkSizeInBytes / 1024);
 }
 
+/**
+ * The palette compression allows us to keep a lot more chunks in memory than the uncompressed chunk size would allow. But
+ * the chunk map needs an upper limit.
+ */
+uint32_t PagedVolume::maxChunkCount(uint32_t targetMemoryUsageInBytes, uint16_t chunkSideLength) {
+	const uint32_t chunkSizeInBytes = PagedVolume::Chunk::calculateSizeInBytes(chunkSideLength);
+	const uint32_t maxChunks = targetMemoryUsageInBytes / chunkSizeInBytes * MaxCompressionFactor;
+	return core_max(maxChunks, MinPracticalNoOfChunks);
+}
+
 /**
  * Destroys the volume The destructor will call flushAll() to ensure that a paging volume has the chance to save it's
  * data via the dataOverflowHandler() if desired.
@@ -169,6 +181,7 @@ void PagedVolume::setVoxels(int32_t uXPos, int32_t uYPos, int32_t uZPos, int nx,
  * Removes all voxels from memory by removing all chunks. The application has the chance to persist the data via @c Pager::pageOut
  */
 void PagedVolume::flushAll() {
+	abortPrefetch();
 	core::ScopedWriteLock writeLock(_volumeLock);
 	_chunks.clear();
 }
@@ -184,26 +197,33 @@ void PagedVolume::deleteOldestChunkIfNeeded() const {
 	core_trace_scoped(DeleteOldestChunk);
 	ChunkMap::iterator oldestChunk = _chunks.end();
 	uint32_t oldestChunkTimestamp = _timestamper;
+	uint64_t memoryUsageInBytes = 0u;
 	for (ChunkMap::iterator i = _chunks.begin(); i != _chunks.end(); ++i) {
 		const ChunkPtr& chunk = i->second;
-		if (chunk->_chunkLastAccessed < oldestChunkTimestamp) {
+		memoryUsageInBytes += chunk->memoryUsageInBytes();
+		// chunks that are currently paged in are not deleted
+		if (chunk->_chunkLastAccessed < oldestChunkTimestamp && chunk->_pagedIn) {
 			oldestChunkTimestamp = chunk->_chunkLastAccessed;
 			oldestChunk = i;
 		}
 	}
+	// adapt the limit to the memory the compressed chunks are really using
+	const uint64_t averageChunkSize = core_max(memoryUsageInBytes / (uint64_t)_chunks.size(), (uint64_t)1u);
+	const uint32_t chunkCountLimit = (uint32_t)core_min((uint64_t)_targetMemoryUsageInBytes / averageChunkSize, (uint64_t)_maxChunkCount);
+	_chunkCountLimit = core_max(chunkCountLimit, MinPracticalNoOfChunks);
+	if (_chunks.size() < _chunkCountLimit) {
+		return;
+	}
 	if (oldestChunk != _chunks.end()) {
 		Log::debug("delete oldest chunk - reached %u", _chunkCountLimit);
 		_chunks.erase(oldestChunk);
 	}
 }
 
-PagedVolume::ChunkPtr PagedVolume::createNewChunk(int32_t chunkX, int32_t chunkY, int32_t chunkZ) const {
-	core_trace_scoped(CreateNewChunk);
-	// The chunk was not found so we will create a new one.
-	glm::ivec3 pos(chunkX, chunkY, chunkZ);
-	Log::debug("create new chunk at %i:%i:%i", chunkX, chunkY, chunkZ);
-	ChunkPtr chunk = core::make_shared<Chunk>(pos, _chunkSideLength, _pager);
-	chunk->_chunkLastAccessed = ++_timestamper; // Important, as we may soon delete the oldest chunk
+void PagedVolume::pageIn(const ChunkPtr& chunk) const {
+	core_trace_scoped(PageInChunk);
+	const glm::ivec3& pos = chunk->chunkPos();
+	Log::debug("create new chunk at %i:%i:%i", pos.x, pos.y, pos.z);
 
 	// Pass the chunk to the Pager to give it a chance to initialise it with any data
 	// From the coordinates of the chunk we deduce the coordinates of the contained voxels.
@@ -215,29 +235,121 @@ PagedVolume::ChunkPtr PagedVolume::createNewChunk(int32_t chunkX, int32_t chunkY
 
 	// Page the data in
 	// We'll use this later to decide if data needs to be paged out again.
-	chunk->_dataModified = _pager->pageIn(pctx);
-	Log::debug("finished creating new chunk at %i:%i:%i", chunkX, chunkY, chunkZ);
-
-	return chunk;
+	if (_pager->concurrentPageIn()) {
+		chunk->_dataModified = _pager->pageIn(pctx);
+	} else {
+		core::ScopedLock pagerLock(_pagerLock);
+		chunk->_dataModified = _pager->pageIn(pctx);
+	}
+	{
+		core::ScopedLock lock(_pageInLock);
+		chunk->_pagedIn = true;
+	}
+	_pageInCondition.notify_all();
+	Log::debug("finished creating new chunk at %i:%i:%i", pos.x, pos.y, pos.z);
 }
 
+/**
+ * The page-in is performed outside of the volume lock - lookups of other chunks don't have to wait for it. Only
+ * lookups of the same chunk are blocked until the chunk is ready.
+ */
 PagedVolume::ChunkPtr PagedVolume::chunk(int32_t chunkX, int32_t chunkY, int32_t chunkZ) const {
 	core_trace_scoped(PagedVolumeChunk);
-	core::ScopedWriteLock chunkWriteLock(_volumeLock);
 	const glm::ivec3 pos(chunkX, chunkY, chunkZ);
-	auto i = _chunks.find(pos);
-	if (i == _chunks.end()) {
-		const ChunkPtr& chunk = createNewChunk(chunkX, chunkY, chunkZ);
-		_chunks.put(pos, chunk);
-		const size_t chunkCount = _chunks.size();
-		if (chunkCount >= _chunkCountLimit) {
-			deleteOldestChunkIfNeeded();
+	ChunkPtr chunk;
+	bool created = false;
+	{
+		core::ScopedWriteLock chunkWriteLock(_volumeLock);
+		auto i = _chunks.find(pos);
+		if (i != _chunks.end()) {
+			chunk = i->second;
+			chunk->_chunkLastAccessed = ++_timestamper;
+		} else {
+			// The chunk was not found so we will create a new one.
+			core_trace_scoped(CreateNewChunk);
+			chunk = core::make_shared<Chunk>(pos, _chunkSideLength, _pager);
+			chunk->_chunkLastAccessed = ++_timestamper; // Important, as we may soon delete the oldest chunk
+			_chunks.put(pos, chunk);
+			created = true;
+			const size_t chunkCount = _chunks.size();
+			if (chunkCount >= _chunkCountLimit) {
+				deleteOldestChunkIfNeeded();
+			}
 		}
-		return chunk;
 	}
-	const ChunkPtr& chunk = i->second;
-	chunk->_chunkLastAccessed = ++_timestamper;
+	if (created) {
+		pageIn(chunk);
+	} else if (!chunk->_pagedIn) {
+		core_trace_scoped(WaitForChunkPageIn);
+		core::ScopedLock lock(_pageInLock);
+		_pageInCondition.wait(_pageInLock, [&] () { return (bool)chunk->_pagedIn; });
+	}
 	return chunk;
 }
 
+void PagedVolume::setThreadPool(core::ThreadPool* threadPool) {
+	abortPrefetch();
+	_threadPool = threadPool;
+}
+
+void PagedVolume::prefetchChunk() {
+	PrefetchRequest request;
+	if (!_prefetchRequests.pop(request)) {
+		return;
+	}
+	core_trace_scoped(PrefetchChunk);
+	chunk(request.chunkPos.x, request.chunkPos.y, request.chunkPos.z);
+}
+
+bool PagedVolume::prefetchRegion(const Region& region, int priority) {
+	if (_threadPool == nullptr) {
+		return false;
+	}
+	core_trace_scoped(PrefetchRegion);
+	const glm::ivec3& mins = chunkPos(region.getLowerCorner());
+	const glm::ivec3& maxs = chunkPos(region.getUpperCorner());
+	int requests = 0;
+	for (int32_t z = mins.z; z <= maxs.z; ++z) {
+		for (int32_t y = mins.y; y <= maxs.y; ++y) {
+			for (int32_t x = mins.x; x <= maxs.x; ++x) {
+				const glm::ivec3 pos(x, y, z);
+				{
+					core::ScopedReadLock readLock(_volumeLock);
+					if (_chunks.find(pos) != _chunks.end()) {
+						continue;
+					}
+				}
+				_prefetchRequests.push(PrefetchRequest{pos, priority});
+				++requests;
+			}
+		}
+	}
+
+	core::ScopedLock lock(_prefetchLock);
+	for (size_t i = 0; i < _prefetchTasks.size();) {
+		if (_prefetchTasks[i].wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+			_prefetchTasks.erase(i);
+		} else {
+			++i;
+		}
+	}
+	// every task pages in the request with the highest priority at the time it is executed - not the one that
+	// was pushed together with the task
+	for (int i = 0; i < requests; ++i) {
+		_prefetchTasks.emplace_back(_threadPool->enqueue([this] () { prefetchChunk(); }));
+	}
+	return true;
+}
+
+void PagedVolume::abortPrefetch() {
+	_prefetchRequests.clear();
+	core::ScopedLock lock(_prefetchLock);
+	for (std::future<void>& task : _prefetchTasks) {
+		if (task.valid()) {
+			task.wait();
+		}
+	}
+	_prefetchTasks.clear();
+}
+
 }
@@ -11,8 +11,18 @@
 #include "core/Assert.h"
 #include "core/concurrent/ReadWriteLock.h"
 #include "core/concurrent/Atomic.h"
+#include "core/concurrent/ConditionVariable.h"
+#include "core/concurrent/Lock.h"
+#include "core/collection/ConcurrentPriorityQueue.h"
+#include "core/collection/DynamicArray.h"
 #include "core/collection/Map.h"
 #include "core/SharedPtr.h"
+#include "core/Trace.h"
+#include <future>
+
+namespace core {
+class ThreadPool;
+}
 
 namespace voxel {
 
@@ -37,18 +47,48 @@ public:
 	/// The Pager class is responsible for the loading and unloading of Chunks, and can be subclassed by the user.
 	class Pager;
 
+	/**
+	 * @brief The voxels of a chunk are stored as bit-indices into a small per-chunk palette.
+	 *
+	 * The size of the indices is widened (0, 1, 2, 4 and 8 bits) as soon as more distinct voxels are put into the chunk.
+	 * A chunk that only consists of one voxel doesn't need any index memory at all. If there are more than
+	 * @c MaxPaletteEntries distinct voxels, the chunk falls back to an uncompressed voxel array.
+	 *
+	 * @note Palette entries are not removed when they are no longer used - @c setData() rebuilds the palette.
+	 */
 	class Chunk {
 		friend class PagedVolume;
 		friend class PagedVolumeWrapper;
 
 	public:
+		static constexpr int MaxPaletteEntries = 256;
+
 		Chunk(const glm::ivec3& pos, uint16_t sideLength, Pager* pager);
 		~Chunk();
 
+		/**
+		 * @param voxels The uncompressed voxels in morton order
+		 */
 		bool setData(const Voxel* voxels, size_t sizeInBytes);
-		Voxel* data() const;
+		/**
+		 * @brief Uncompress the voxels of the chunk into the given buffer
+		 * @param[out] voxels The uncompressed voxels in morton order
+		 */
+		bool data(Voxel* voxels, size_t sizeInBytes) const;
+		/**
+		 * @return The size of the uncompressed voxel data
+		 */
 		uint32_t dataSizeInBytes() const;
+		/**
+		 * @return The memory the chunk is really using for its voxels
+		 */
+		uint32_t memoryUsageInBytes() const;
 		uint32_t voxels() const;
+		/**
+		 * @return The amount of bits that are used per voxel. @c 0 for chunks that only consist of one voxel.
+		 */
+		int bitsPerVoxel() const;
+		int paletteSize() const;
 
 		const Voxel& voxel(uint32_t x, uint32_t y, uint32_t z) const;
 		const Voxel& voxel(const glm::i16vec3& pos) const;
@@ -64,11 +104,32 @@ public:
 	private:
 		// This is updated by the PagedVolume and used to discard the least recently used chunks.
 		uint32_t _chunkLastAccessed = 0u;
+		// Set by the PagedVolume as soon as the pager has filled the chunk
+		core::AtomicBool _pagedIn { false };
 
 		static uint32_t calculateSizeInBytes(uint32_t sideLength);
 
+		/**
+		 * @param index The morton index of the voxel
+		 */
+		inline const Voxel& voxelByIndex(uint32_t index) const;
+		void setVoxelByIndex(uint32_t index, const Voxel& value);
+		int findPaletteEntry(const Voxel& value);
+		void resizeIndices(uint8_t indexBitsPower);
+		void convertToUncompressed();
+		void reset(const Voxel& value);
+
+		Voxel _palette[MaxPaletteEntries];
+		// the palette indices - nullptr if all voxels are the first palette entry
+		uint32_t* _indices = nullptr;
+		// only used if there are too many different voxels for the palette
 		Voxel* _data = nullptr;
 		uint16_t _sideLength = 0u;
+		uint16_t _paletteSize = 1u;
+		uint16_t _lastPaletteEntry = 0u;
+		// the bits per index as power of two
+		uint8_t _indexBitsPower = 0u;
+		uint32_t _indexMask = 0u;
 
 		// This is so we can tell whether a uncompressed chunk has to be recompressed and whether
 		// a compressed chunk has to be paged back to disk, or whether they can just be discarded.
@@ -104,9 +165,18 @@ public:
 
 		/**
 		 * @return @c true if the chunk was modified (created), @c false if it was just loaded
+		 * @note The pager must not access other chunks of the volume that are not yet paged in
 		 */
 		virtual bool pageIn(PagerContext& ctx) = 0;
 		virtual void pageOut(Chunk* chunk) = 0;
+
+		/**
+		 * @return @c true if @c pageIn() may be called for different chunks from several threads at the same
+		 * time. Otherwise the calls are serialized.
+		 */
+		virtual bool concurrentPageIn() const {
+			return false;
+		}
 	};
 
 	typedef core::SharedPtr<Pager> PagerPtr;
@@ -199,7 +269,7 @@ public:
 		int32_t _zPosInVolume = 0;
 
 		//Other current position information
-		Voxel* _currentVoxel = nullptr;
+		uint32_t _currentIndex = 0u;
 		ChunkPtr _currentChunk;
 		mutable ChunkPtr _cachedChunk;
 
@@ -237,6 +307,23 @@ public:
 	/** @brief Removes all voxels from memory */
 	void flushAll();
 
+	/**
+	 * @brief The thread pool that is used to page in the chunks for @c prefetchRegion()
+	 */
+	void setThreadPool(core::ThreadPool* threadPool);
+	/**
+	 * @brief Pages in the chunks of the given region on the worker threads of the thread pool. A lookup
+	 * for one of these chunks only blocks if the chunk is not yet ready.
+	 * @param priority The chunks of the requests with the highest priority are paged in first
+	 * @return @c false if there is no thread pool set
+	 * @sa setThreadPool()
+	 */
+	bool prefetchRegion(const Region& region, int priority = 0);
+	/**
+	 * @brief Removes the pending prefetch requests and waits for the ones that are currently executed
+	 */
+	void abortPrefetch();
+
 	ChunkPtr chunk(const glm::ivec3& pos) const;
 
 	glm::ivec3 chunkPos(int x, int y, int z) const;
@@ -258,12 +345,22 @@ protected:
 
 private:
 	ChunkPtr chunk(int32_t uChunkX, int32_t uChunkY, int32_t uChunkZ) const;
-	ChunkPtr createNewChunk(int32_t uChunkX, int32_t uChunkY, int32_t uChunkZ) const;
+	void pageIn(const ChunkPtr& chunk) const;
+	void prefetchChunk();
 	void deleteOldestChunkIfNeeded() const;
+	static uint32_t maxChunkCount(uint32_t targetMemoryUsageInBytes, uint16_t chunkSideLength);
+
+	// Enough to make sure a chunks and it's neighbours can be loaded, with a few to spare.
+	static constexpr uint32_t MinPracticalNoOfChunks = 32u;
+	// The max amount of chunks compared to the amount of uncompressed chunks that fit into the memory limit
+	static constexpr uint32_t MaxCompressionFactor = 16u;
 
 	mutable int32_t _timestamper = 0;
 
-	uint32_t _chunkCountLimit = 0u;
+	// This is adapted to the memory the (compressed) chunks are really using
+	mutable uint32_t _chunkCountLimit = 0u;
+	uint32_t _maxChunkCount;
+	uint32_t _targetMemoryUsageInBytes;
 
 	typedef core::Map<glm::ivec3, ChunkPtr, 64, glm::hash<glm::ivec3>> ChunkMap;
 	mutable ChunkMap _chunks core_thread_guarded_by(_volumeLock);
@@ -278,10 +375,40 @@ private:
 	Region _region;
 
 	mutable core::ReadWriteLock _volumeLock{"pagedvolume"};
+
+	struct PrefetchRequest {
+		glm::ivec3 chunkPos { 0 };
+		int priority = 0;
+
+		inline bool operator<(const PrefetchRequest& rhs) const {
+			return priority < rhs.priority;
+		}
+	};
+	core::ThreadPool* _threadPool = nullptr;
+	core::ConcurrentPriorityQueue<PrefetchRequest> _prefetchRequests;
+	core_trace_mutex(core::Lock, _prefetchLock, "PagedVolumePrefetch");
+	core::DynamicArray<std::future<void>> _prefetchTasks core_thread_guarded_by(_prefetchLock);
+
+	// used to wait for chunks that are paged in by another thread
+	mutable core_trace_mutex(core::Lock, _pageInLock, "PagedVolumePageIn");
+	mutable core::ConditionVariable _pageInCondition;
+	// serializes the page-in calls if the pager doesn't support concurrent calls
+	mutable core_trace_mutex(core::Lock, _pagerLock, "PagedVolumePager");
 };
 
+inline const Voxel& PagedVolume::Chunk::voxelByIndex(uint32_t index) const {
+	if (_indices != nullptr) {
+		const uint32_t bit = index << _indexBitsPower;
+		return _palette[(_indices[bit >> 5u] >> (bit & 31u)) & _indexMask];
+	}
+	if (_data != nullptr) {
+		return _data[index];
+	}
+	return _palette[0];
+}
+
 inline const Voxel& PagedVolume::Sampler::voxel() const {
-	return *_currentVoxel;
+	return _currentChunk->voxelByIndex(_currentIndex);
 }
 
 inline void PagedVolume::Sampler::setPosition(const glm::ivec3& v3dNewPos) {
@@ -330,186 +457,186 @@ static const int32_t deltaZ[256] = { 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 22
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1nx1ny1nz() const {
 	if (CAN_GO_NEG_X(this->_xPosInChunk) && CAN_GO_NEG_Y(this->_yPosInChunk) && CAN_GO_NEG_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + NEG_X_DELTA + NEG_Y_DELTA + NEG_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_X_DELTA + NEG_Y_DELTA + NEG_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume - 1, this->_yPosInVolume - 1, this->_zPosInVolume - 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1nx1ny0pz() const {
 	if (CAN_GO_NEG_X(this->_xPosInChunk) && CAN_GO_NEG_Y(this->_yPosInChunk)) {
-		return *(_currentVoxel + NEG_X_DELTA + NEG_Y_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_X_DELTA + NEG_Y_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume - 1, this->_yPosInVolume - 1, this->_zPosInVolume);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1nx1ny1pz() const {
 	if (CAN_GO_NEG_X(this->_xPosInChunk) && CAN_GO_NEG_Y(this->_yPosInChunk) && CAN_GO_POS_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + NEG_X_DELTA + NEG_Y_DELTA + POS_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_X_DELTA + NEG_Y_DELTA + POS_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume - 1, this->_yPosInVolume - 1, this->_zPosInVolume + 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1nx0py1nz() const {
 	if (CAN_GO_NEG_X(this->_xPosInChunk) && CAN_GO_NEG_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + NEG_X_DELTA + NEG_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_X_DELTA + NEG_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume - 1, this->_yPosInVolume, this->_zPosInVolume - 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1nx0py0pz() const {
 	if (CAN_GO_NEG_X(this->_xPosInChunk)) {
-		return *(_currentVoxel + NEG_X_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_X_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume - 1, this->_yPosInVolume, this->_zPosInVolume);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1nx0py1pz() const {
 	if (CAN_GO_NEG_X(this->_xPosInChunk) && CAN_GO_POS_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + NEG_X_DELTA + POS_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_X_DELTA + POS_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume - 1, this->_yPosInVolume, this->_zPosInVolume + 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1nx1py1nz() const {
 	if (CAN_GO_NEG_X(this->_xPosInChunk) && CAN_GO_POS_Y(this->_yPosInChunk) && CAN_GO_NEG_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + NEG_X_DELTA + POS_Y_DELTA + NEG_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_X_DELTA + POS_Y_DELTA + NEG_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume - 1, this->_yPosInVolume + 1, this->_zPosInVolume - 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1nx1py0pz() const {
 	if (CAN_GO_NEG_X(this->_xPosInChunk) && CAN_GO_POS_Y(this->_yPosInChunk)) {
-		return *(_currentVoxel + NEG_X_DELTA + POS_Y_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_X_DELTA + POS_Y_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume - 1, this->_yPosInVolume + 1, this->_zPosInVolume);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1nx1py1pz() const {
 	if (CAN_GO_NEG_X(this->_xPosInChunk) && CAN_GO_POS_Y(this->_yPosInChunk) && CAN_GO_POS_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + NEG_X_DELTA + POS_Y_DELTA + POS_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_X_DELTA + POS_Y_DELTA + POS_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume - 1, this->_yPosInVolume + 1, this->_zPosInVolume + 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel0px1ny1nz() const {
 	if (CAN_GO_NEG_Y(this->_yPosInChunk) && CAN_GO_NEG_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + NEG_Y_DELTA + NEG_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_Y_DELTA + NEG_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume, this->_yPosInVolume - 1, this->_zPosInVolume - 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel0px1ny0pz() const {
 	if (CAN_GO_NEG_Y(this->_yPosInChunk)) {
-		return *(_currentVoxel + NEG_Y_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_Y_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume, this->_yPosInVolume - 1, this->_zPosInVolume);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel0px1ny1pz() const {
 	if (CAN_GO_NEG_Y(this->_yPosInChunk) && CAN_GO_POS_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + NEG_Y_DELTA + POS_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_Y_DELTA + POS_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume, this->_yPosInVolume - 1, this->_zPosInVolume + 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel0px0py1nz() const {
 	if (CAN_GO_NEG_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + NEG_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + NEG_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume, this->_yPosInVolume, this->_zPosInVolume - 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel0px0py0pz() const {
-	return *_currentVoxel;
+	return _currentChunk->voxelByIndex(_currentIndex);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel0px0py1pz() const {
 	if (CAN_GO_POS_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + POS_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume, this->_yPosInVolume, this->_zPosInVolume + 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel0px1py1nz() const {
 	if (CAN_GO_POS_Y(this->_yPosInChunk) && CAN_GO_NEG_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + POS_Y_DELTA + NEG_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_Y_DELTA + NEG_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume, this->_yPosInVolume + 1, this->_zPosInVolume - 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel0px1py0pz() const {
 	if (CAN_GO_POS_Y(this->_yPosInChunk)) {
-		return *(_currentVoxel + POS_Y_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_Y_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume, this->_yPosInVolume + 1, this->_zPosInVolume);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel0px1py1pz() const {
 	if (CAN_GO_POS_Y(this->_yPosInChunk) && CAN_GO_POS_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + POS_Y_DELTA + POS_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_Y_DELTA + POS_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume, this->_yPosInVolume + 1, this->_zPosInVolume + 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1px1ny1nz() const {
 	if (CAN_GO_POS_X(this->_xPosInChunk) && CAN_GO_NEG_Y(this->_yPosInChunk) && CAN_GO_NEG_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + POS_X_DELTA + NEG_Y_DELTA + NEG_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_X_DELTA + NEG_Y_DELTA + NEG_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume + 1, this->_yPosInVolume - 1, this->_zPosInVolume - 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1px1ny0pz() const {
 	if (CAN_GO_POS_X(this->_xPosInChunk) && CAN_GO_NEG_Y(this->_yPosInChunk)) {
-		return *(_currentVoxel + POS_X_DELTA + NEG_Y_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_X_DELTA + NEG_Y_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume + 1, this->_yPosInVolume - 1, this->_zPosInVolume);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1px1ny1pz() const {
 	if (CAN_GO_POS_X(this->_xPosInChunk) && CAN_GO_NEG_Y(this->_yPosInChunk) && CAN_GO_POS_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + POS_X_DELTA + NEG_Y_DELTA + POS_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_X_DELTA + NEG_Y_DELTA + POS_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume + 1, this->_yPosInVolume - 1, this->_zPosInVolume + 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1px0py1nz() const {
 	if (CAN_GO_POS_X(this->_xPosInChunk) && CAN_GO_NEG_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + POS_X_DELTA + NEG_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_X_DELTA + NEG_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume + 1, this->_yPosInVolume, this->_zPosInVolume - 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1px0py0pz() const {
 	if (CAN_GO_POS_X(this->_xPosInChunk)) {
-		return *(_currentVoxel + POS_X_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_X_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume + 1, this->_yPosInVolume, this->_zPosInVolume);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1px0py1pz() const {
 	if (CAN_GO_POS_X(this->_xPosInChunk) && CAN_GO_POS_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + POS_X_DELTA + POS_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_X_DELTA + POS_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume + 1, this->_yPosInVolume, this->_zPosInVolume + 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1px1py1nz() const {
 	if (CAN_GO_POS_X(this->_xPosInChunk) && CAN_GO_POS_Y(this->_yPosInChunk) && CAN_GO_NEG_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + POS_X_DELTA + POS_Y_DELTA + NEG_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_X_DELTA + POS_Y_DELTA + NEG_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume + 1, this->_yPosInVolume + 1, this->_zPosInVolume - 1);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1px1py0pz() const {
 	if (CAN_GO_POS_X(this->_xPosInChunk) && CAN_GO_POS_Y(this->_yPosInChunk)) {
-		return *(_currentVoxel + POS_X_DELTA + POS_Y_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_X_DELTA + POS_Y_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume + 1, this->_yPosInVolume + 1, this->_zPosInVolume);
 }
 
 inline const Voxel& PagedVolume::Sampler::peekVoxel1px1py1pz() const {
 	if (CAN_GO_POS_X(this->_xPosInChunk) && CAN_GO_POS_Y(this->_yPosInChunk) && CAN_GO_POS_Z(this->_zPosInChunk)) {
-		return *(_currentVoxel + POS_X_DELTA + POS_Y_DELTA + POS_Z_DELTA);
+		return _currentChunk->voxelByIndex(_currentIndex + POS_X_DELTA + POS_Y_DELTA + POS_Z_DELTA);
 	}
 	return this->voxelAt(this->_xPosInVolume + 1, this->_yPosInVolume + 1, this->_zPosInVolume + 1);
 }
@@ -7,9 +7,14 @@
 #include "math/Functions.h"
 #include "core/Common.h"
 #include "core/StandardLib.h"
+#include "core/Trace.h"
 
 namespace voxel {
 
+static inline bool isSameVoxel(const Voxel& voxel1, const Voxel& voxel2) {
+	return voxel1.isSame(voxel2) && voxel1.getFlags() == voxel2.getFlags();
+}
+
 PagedVolume::Chunk::Chunk(const glm::ivec3& pos, uint16_t sideLength, Pager* pager) :
 		_pager(pager), _chunkSpacePosition(pos) {
 	core_assert_msg(_pager, "No valid pager supplied to chunk constructor.");
@@ -19,10 +24,8 @@ PagedVolume::Chunk::Chunk(const glm::ivec3& pos, uint16_t sideLength, Pager* pag
 	_sideLength = sideLength;
 	_sideLengthPower = math::logBase2(sideLength);
 
-	// Allocate the data
-	const uint32_t uNoOfVoxels = _sideLength * _sideLength * _sideLength;
-	_data = (Voxel*)core_malloc(uNoOfVoxels * sizeof(Voxel));
-	core_memset(_data, 0, uNoOfVoxels * sizeof(Voxel));
+	// A new chunk is made of air only - this doesn't need any index data
+	reset(Voxel());
 }
 
 PagedVolume::Chunk::~Chunk() {
@@ -30,41 +33,174 @@ PagedVolume::Chunk::~Chunk() {
 		_pager->pageOut(this);
 	}
 
+	core_free(_indices);
+	_indices = nullptr;
+	core_free(_data);
+	_data = nullptr;
+}
+
+void PagedVolume::Chunk::reset(const Voxel& value) {
+	core_free(_indices);
+	_indices = nullptr;
 	core_free(_data);
 	_data = nullptr;
+	_palette[0] = value;
+	_paletteSize = 1u;
+	_lastPaletteEntry = 0u;
+	_indexBitsPower = 0u;
+	_indexMask = 0u;
 }
 
 bool PagedVolume::Chunk::setData(const Voxel* voxels, size_t sizeInBytes) {
 	if (sizeInBytes != dataSizeInBytes()) {
 		return false;
 	}
+	core_trace_scoped(ChunkSetData);
+	reset(voxels[0]);
+	const uint32_t amount = this->voxels();
+	for (uint32_t i = 1u; i < amount; ++i) {
+		setVoxelByIndex(i, voxels[i]);
+	}
 	_dataModified = true;
-	core_memcpy((uint8_t*)_data, (const uint8_t*)voxels, sizeInBytes);
 	return true;
 }
 
-Voxel* PagedVolume::Chunk::data() const {
-	return _data;
+bool PagedVolume::Chunk::data(Voxel* voxels, size_t sizeInBytes) const {
+	if (sizeInBytes != dataSizeInBytes()) {
+		return false;
+	}
+	if (_data != nullptr) {
+		core_memcpy((uint8_t*)voxels, (const uint8_t*)_data, sizeInBytes);
+		return true;
+	}
+	const uint32_t amount = this->voxels();
+	for (uint32_t i = 0u; i < amount; ++i) {
+		voxels[i] = voxelByIndex(i);
+	}
+	return true;
 }
 
 uint32_t PagedVolume::Chunk::dataSizeInBytes() const {
 	return voxels() * sizeof(Voxel);
 }
 
+uint32_t PagedVolume::Chunk::memoryUsageInBytes() const {
+	uint32_t size = sizeof(*this);
+	if (_data != nullptr) {
+		size += dataSizeInBytes();
+	} else if (_indices != nullptr) {
+		size += ((voxels() << _indexBitsPower) + 31u) / 32u * sizeof(uint32_t);
+	}
+	return size;
+}
+
 uint32_t PagedVolume::Chunk::voxels() const {
 	return _sideLength * _sideLength * _sideLength;
 }
 
+int PagedVolume::Chunk::bitsPerVoxel() const {
+	if (_data != nullptr) {
+		return (int)sizeof(Voxel) * 8;
+	}
+	if (_indices == nullptr) {
+		return 0;
+	}
+	return 1 << _indexBitsPower;
+}
+
+int PagedVolume::Chunk::paletteSize() const {
+	if (_data != nullptr) {
+		return 0;
+	}
+	return _paletteSize;
+}
+
+int PagedVolume::Chunk::findPaletteEntry(const Voxel& value) {
+	// voxels are usually set in runs of the same value
+	if (isSameVoxel(_palette[_lastPaletteEntry], value)) {
+		return _lastPaletteEntry;
+	}
+	for (uint16_t i = 0u; i < _paletteSize; ++i) {
+		if (isSameVoxel(_palette[i], value)) {
+			_lastPaletteEntry = i;
+			return i;
+		}
+	}
+	return -1;
+}
+
+void PagedVolume::Chunk::resizeIndices(uint8_t indexBitsPower) {
+	core_trace_scoped(ChunkResizeIndices);
+	const uint32_t amount = voxels();
+	const uint32_t words = ((amount << indexBitsPower) + 31u) / 32u;
+	uint32_t* indices = (uint32_t*)core_malloc(words * sizeof(uint32_t));
+	core_memset(indices, 0, words * sizeof(uint32_t));
+	if (_indices != nullptr) {
+		for (uint32_t i = 0u; i < amount; ++i) {
+			const uint32_t oldBit = i << _indexBitsPower;
+			const uint32_t entry = (_indices[oldBit >> 5u] >> (oldBit & 31u)) & _indexMask;
+			const uint32_t bit = i << indexBitsPower;
+			indices[bit >> 5u] |= entry << (bit & 31u);
+		}
+		core_free(_indices);
+	}
+	_indices = indices;
+	_indexBitsPower = indexBitsPower;
+	_indexMask = (1u << (1u << indexBitsPower)) - 1u;
+}
+
+void PagedVolume::Chunk::convertToUncompressed() {
+	core_trace_scoped(ChunkConvertToUncompressed);
+	const uint32_t amount = voxels();
+	Voxel* data = (Voxel*)core_malloc(amount * sizeof(Voxel));
+	for (uint32_t i = 0u; i < amount; ++i) {
+		data[i] = voxelByIndex(i);
+	}
+	core_free(_indices);
+	_indices = nullptr;
+	_data = data;
+}
+
+void PagedVolume::Chunk::setVoxelByIndex(uint32_t index, const Voxel& value) {
+	_dataModified = true;
+	if (_data != nullptr) {
+		_data[index] = value;
+		return;
+	}
+	int entry = findPaletteEntry(value);
+	if (entry == -1) {
+		if (_paletteSize == MaxPaletteEntries) {
+			convertToUncompressed();
+			_data[index] = value;
+			return;
+		}
+		if (_indices == nullptr) {
+			resizeIndices(0u);
+		} else if (_paletteSize > _indexMask) {
+			resizeIndices(_indexBitsPower + 1u);
+		}
+		entry = _paletteSize++;
+		_palette[entry] = value;
+		_lastPaletteEntry = entry;
+	} else if (_indices == nullptr) {
+		// a uniform chunk that stays uniform
+		return;
+	}
+	const uint32_t bit = index << _indexBitsPower;
+	uint32_t& word = _indices[bit >> 5u];
+	const uint32_t shift = bit & 31u;
+	word = (word & ~(_indexMask << shift)) | ((uint32_t)entry << shift);
+}
+
 const Voxel& PagedVolume::Chunk::voxel(uint32_t x, uint32_t y, uint32_t z) const {
 	// This code is not usually expected to be called by the user, with the exception of when implementing paging
 	// of uncompressed data. It's a performance critical code path
 	core_assert_msg(x < _sideLength, "Supplied position is outside of the chunk. asserted %u > %u", x, _sideLength);
 	core_assert_msg(y < _sideLength, "Supplied position is outside of the chunk. asserted %u > %u", y, _sideLength);
 	core_assert_msg(z < _sideLength, "Supplied position is outside of the chunk. asserted %u > %u", z, _sideLength);
-	core_assert_msg(_data, "No uncompressed data - chunk must be decompressed before accessing voxels.");
 
 	const uint32_t index = morton256_x[x] | morton256_y[y] | morton256_z[z];
-	return _data[index];
+	return voxelByIndex(index);
 }
 
 const Voxel& PagedVolume::Chunk::voxel(const glm::i16vec3& pos) const {
@@ -77,11 +213,9 @@ void PagedVolume::Chunk::setVoxel(uint32_t x, uint32_t y, uint32_t z, const Voxe
 	core_assert_msg(x < _sideLength, "Supplied position is outside of the chunk");
 	core_assert_msg(y < _sideLength, "Supplied position is outside of the chunk");
 	core_assert_msg(z < _sideLength, "Supplied position is outside of the chunk");
-	core_assert_msg(_data, "No uncompressed data - chunk must be decompressed before accessing voxels.");
 
 	const uint32_t index = morton256_x[x] | morton256_y[y] | morton256_z[z];
-	_data[index] = value;
-	_dataModified = true;
+	setVoxelByIndex(index, value);
 }
 
 void PagedVolume::Chunk::setVoxels(uint32_t x, uint32_t z, const Voxel* values, int amount) {
@@ -95,11 +229,10 @@ void PagedVolume::Chunk::setVoxels(uint32_t x, uint32_t y, uint32_t z, const Vox
 	core_assert_msg(x < _sideLength, "Supplied x position is outside of the chunk");
 	core_assert_msg(y < _sideLength, "Supplied y position is outside of the chunk");
 	core_assert_msg(z < _sideLength, "Supplied z position is outside of the chunk");
-	core_assert_msg(_data, "No uncompressed data - chunk must be decompressed before accessing voxels.");
 
 	for (int i = y; i < amount; ++i) {
 		const uint32_t index = morton256_x[x] | morton256_y[i] | morton256_z[z];
-		_data[index] = values[i];
+		setVoxelByIndex(index, values[i]);
 	}
 	_dataModified = true;
 }
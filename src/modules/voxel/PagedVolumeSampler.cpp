@@ -54,12 +54,12 @@ const Voxel& PagedVolume::Sampler::voxelAt(int x, int y, int z) const {
 void PagedVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
 	core_trace_scoped(SetSamplerPosition);
 
-	// Then we update the voxel pointer
+	// Then we update the voxel index
 	const int32_t xChunk = xPos >> _volume->_chunkSideLengthPower;
 	const int32_t yChunk = yPos >> _volume->_chunkSideLengthPower;
 	const int32_t zChunk = zPos >> _volume->_chunkSideLengthPower;
 
-	if (_currentVoxel == nullptr || _lastXChunk != xChunk || _lastYChunk != yChunk || _lastZChunk != zChunk) {
+	if (!_currentChunk || _lastXChunk != xChunk || _lastYChunk != yChunk || _lastZChunk != zChunk) {
 		if (_cachedChunk) {
 			const glm::ivec3& chunkPos = _cachedChunk->chunkPos();
 			if (chunkPos.x == xChunk && chunkPos.y == yChunk && chunkPos.z == zChunk) {
@@ -85,28 +85,26 @@ void PagedVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos)
 	_yPosInChunk = static_cast<uint32_t>(yPos & _volume->_chunkMask);
 	_zPosInChunk = static_cast<uint32_t>(zPos & _volume->_chunkMask);
 
-	const uint32_t voxelIndexInChunk = morton256_x[_xPosInChunk] | morton256_y[_yPosInChunk] | morton256_z[_zPosInChunk];
-	_currentVoxel = _currentChunk->_data + voxelIndexInChunk;
+	_currentIndex = morton256_x[_xPosInChunk] | morton256_y[_yPosInChunk] | morton256_z[_zPosInChunk];
 }
 
 bool PagedVolume::Sampler::setVoxel(const Voxel& voxel) {
-	if (_currentVoxel == nullptr) {
+	if (!_currentChunk) {
 		return false;
 	}
-	//Need to think what effect this has on any existing iterators.
 	//core_assert_msg(false, "This function cannot be used on PagedVolume samplers.");
 	//TODO: the region is not updated properly - but we might not need this for paged volumes.
-	*_currentVoxel = voxel;
+	_currentChunk->setVoxelByIndex(_currentIndex, voxel);
 	return true;
 }
 
 void PagedVolume::Sampler::movePositiveX() {
 	_xPosInVolume++;
 
-	// Then we update the voxel pointer
+	// Then we update the voxel index
 	if (CAN_GO_POS_X(_xPosInChunk)) {
 		//No need to compute new chunk.
-		_currentVoxel += POS_X_DELTA;
+		_currentIndex += POS_X_DELTA;
 		_xPosInChunk++;
 	} else {
 		//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
@@ -117,10 +115,10 @@ void PagedVolume::Sampler::movePositiveX() {
 void PagedVolume::Sampler::movePositiveY() {
 	_yPosInVolume++;
 
-	// Then we update the voxel pointer
+	// Then we update the voxel index
 	if (CAN_GO_POS_Y(_yPosInChunk)) {
 		//No need to compute new chunk.
-		_currentVoxel += POS_Y_DELTA;
+		_currentIndex += POS_Y_DELTA;
 		_yPosInChunk++;
 	} else {
 		//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
@@ -131,10 +129,10 @@ void PagedVolume::Sampler::movePositiveY() {
 void PagedVolume::Sampler::movePositiveZ() {
 	_zPosInVolume++;
 
-	// Then we update the voxel pointer
+	// Then we update the voxel index
 	if (CAN_GO_POS_Z(_zPosInChunk)) {
 		//No need to compute new chunk.
-		_currentVoxel += POS_Z_DELTA;
+		_currentIndex += POS_Z_DELTA;
 		_zPosInChunk++;
 	} else {
 		//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
@@ -145,10 +143,10 @@ void PagedVolume::Sampler::movePositiveZ() {
 void PagedVolume::Sampler::moveNegativeX() {
 	_xPosInVolume--;
 
-	// Then we update the voxel pointer
+	// Then we update the voxel index
 	if (CAN_GO_NEG_X(_xPosInChunk)) {
 		//No need to compute new chunk.
-		_currentVoxel += NEG_X_DELTA;
+		_currentIndex += NEG_X_DELTA;
 		_xPosInChunk--;
 	} else {
 		//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
@@ -159,10 +157,10 @@ void PagedVolume::Sampler::moveNegativeX() {
 void PagedVolume::Sampler::moveNegativeY() {
 	_yPosInVolume--;
 
-	// Then we update the voxel pointer
+	// Then we update the voxel index
 	if (CAN_GO_NEG_Y(_yPosInChunk)) {
 		//No need to compute new chunk.
-		_currentVoxel += NEG_Y_DELTA;
+		_currentIndex += NEG_Y_DELTA;
 		_yPosInChunk--;
 	} else {
 		//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
@@ -173,10 +171,10 @@ void PagedVolume::Sampler::moveNegativeY() {
 void PagedVolume::Sampler::moveNegativeZ() {
 	_zPosInVolume--;
 
-	// Then we update the voxel pointer
+	// Then we update the voxel index
 	if (CAN_GO_NEG_Z(_zPosInChunk)) {
 		//No need to compute new chunk.
-		_currentVoxel += NEG_Z_DELTA;
+		_currentIndex += NEG_Z_DELTA;
 		_zPosInChunk--;
 	} else {
 		//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
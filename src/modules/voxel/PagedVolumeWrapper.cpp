@@ -23,7 +23,7 @@ void PagedVolumeWrapper::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_
 	_yPosInVolume = yPos;
 	_zPosInVolume = zPos;
 
-	// Then we update the voxel pointer
+	// Then we update the voxel index
 	const int32_t xChunk = _xPosInVolume >> _volume->_chunkSideLengthPower;
 	const int32_t yChunk = _yPosInVolume >> _volume->_chunkSideLengthPower;
 	const int32_t zChunk = _zPosInVolume >> _volume->_chunkSideLengthPower;
@@ -31,7 +31,6 @@ void PagedVolumeWrapper::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_
 	_xPosInChunk = static_cast<uint16_t>(_xPosInVolume - (xChunk << _volume->_chunkSideLengthPower));
 	_yPosInChunk = static_cast<uint16_t>(_yPosInVolume - (yChunk << _volume->_chunkSideLengthPower));
 	_zPosInChunk = static_cast<uint16_t>(_zPosInVolume - (zChunk << _volume->_chunkSideLengthPower));
-	const uint32_t voxelIndexInChunk = morton256_x[_xPosInChunk] | morton256_y[_yPosInChunk] | morton256_z[_zPosInChunk];
 
 	const glm::ivec3& p = _chunk->_chunkSpacePosition;
 	if (p.x == xChunk && p.y == yChunk && p.z == zChunk) {
@@ -40,7 +39,7 @@ void PagedVolumeWrapper::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_
 		_currentChunk = _volume->chunk(xChunk, yChunk, zChunk);
 	}
 
-	_currentVoxel = _currentChunk->_data + voxelIndexInChunk;
+	_currentIndex = morton256_x[_xPosInChunk] | morton256_y[_yPosInChunk] | morton256_z[_zPosInChunk];
 }
 
 PagedVolumeWrapper::PagedVolumeWrapper(PagedVolume* voxelStorage, const PagedVolume::ChunkPtr& chunk, const Region& region) :
@@ -0,0 +1,95 @@
+/**
+ * @file
+ */
+
+#include "PaletteLookup.h"
+#include "core/Log.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/Lock.h"
+#include <float.h>
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+namespace {
+// the tables of the most recently used palettes
+constexpr size_t MaxCachedLUTs = 8;
+}
+
+PaletteLUT::PaletteLUT(const voxel::Palette &palette) : _colorCount(palette.colorCount) {
+	core_trace_scoped(PaletteLUT);
+	core_memcpy(_colors, palette.colors, sizeof(_colors));
+
+	glm::vec3 hsb[PaletteMaxColors];
+	for (int i = 0; i < _colorCount; ++i) {
+		core::Color::getHSB(core::Color::fromRGBA(_colors[i]), hsb[i].x, hsb[i].y, hsb[i].z);
+	}
+
+	// same weights as core::Color::getDistance()
+	const float weightHue = 0.8f;
+	const float weightSaturation = 0.1f;
+	const float weightValue = 0.1f;
+	constexpr int halfCell = 1 << (Shift - 1);
+	for (int r = 0; r < Size; ++r) {
+		for (int g = 0; g < Size; ++g) {
+			for (int b = 0; b < Size; ++b) {
+				const core::RGBA center((r << Shift) + halfCell, (g << Shift) + halfCell, (b << Shift) + halfCell, 255);
+				float hue;
+				float saturation;
+				float brightness;
+				core::Color::getHSB(core::Color::fromRGBA(center), hue, saturation, brightness);
+				float minDistance = FLT_MAX;
+				int minIndex = 0;
+				for (int i = 0; i < _colorCount; ++i) {
+					const float dH = hsb[i].x - hue;
+					const float dS = hsb[i].y - saturation;
+					const float dV = hsb[i].z - brightness;
+					const float val = weightHue * dH * dH + weightValue * dV * dV + weightSaturation * dS * dS;
+					if (val < minDistance) {
+						minDistance = val;
+						minIndex = i;
+					}
+				}
+				_indices[index(center)] = (uint8_t)minIndex;
+			}
+		}
+	}
+}
+
+bool PaletteLUT::matches(const voxel::Palette &palette) const {
+	if (palette.colorCount != _colorCount) {
+		return false;
+	}
+	return core_memcmp(_colors, palette.colors, _colorCount * sizeof(core::RGBA)) == 0;
+}
+
+core::SharedPtr<PaletteLUT> PaletteLUT::get(const voxel::Palette &palette) {
+	static core_trace_mutex(core::Lock, lock, "PaletteLUT");
+	static core::DynamicArray<core::SharedPtr<PaletteLUT>> cache;
+
+	core::ScopedLock scoped(lock);
+	for (size_t i = 0; i < cache.size(); ++i) {
+		if (cache[i]->matches(palette)) {
+			return cache[i];
+		}
+	}
+	Log::debug("Build color lookup table for palette with %i colors", palette.colorCount);
+	if (cache.size() >= MaxCachedLUTs) {
+		cache.erase(0);
+	}
+	const core::SharedPtr<PaletteLUT> &lut = core::make_shared<PaletteLUT>(palette);
+	cache.push_back(lut);
+	return lut;
+}
+
+void PaletteLookup::initLUT() {
+	_lut = PaletteLUT::get(_palette);
+	// the exact matches - the first entry wins like in Palette::getClosestMatch()
+	for (int i = _palette.colorCount - 1; i >= 0; --i) {
+		_paletteMap.put(_palette.colors[i], (uint8_t)i);
+	}
+}
+
+} // namespace voxel
@@ -5,16 +5,65 @@
 #pragma once
 
 #include "core/Color.h"
+#include "core/SharedPtr.h"
 #include "core/collection/Map.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/Palette.h"
 
 namespace voxel {
 
+/**
+ * @brief Precomputed closest palette index for all colors quantized to 5 bits per channel
+ *
+ * The lookup table is immutable once it is built - use get() to share the table for the same palette colors
+ * between several threads and lookups.
+ */
+class PaletteLUT {
+public:
+	static constexpr int Bits = 5;
+	static constexpr int Shift = 8 - Bits;
+	static constexpr int Size = 1 << Bits;
+
+private:
+	PaletteColorArray _colors{};
+	int _colorCount = 0;
+	uint8_t _indices[Size * Size * Size];
+
+	static inline int index(core::RGBA rgba) {
+		return ((rgba.r >> Shift) << (Bits * 2)) | ((rgba.g >> Shift) << Bits) | (rgba.b >> Shift);
+	}
+
+public:
+	PaletteLUT(const voxel::Palette &palette);
+
+	/**
+	 * @return @c true if this table was built for the colors of the given palette
+	 */
+	bool matches(const voxel::Palette &palette) const;
+
+	/**
+	 * @brief Returns the palette index of the color with the smallest distance to the center of the cell
+	 * of the given color
+	 * @sa Palette::getClosestMatch()
+	 */
+	inline uint8_t closest(core::RGBA rgba) const {
+		return _indices[index(rgba)];
+	}
+
+	/**
+	 * @brief Returns a cached lookup table for the colors of the given palette or builds a new one
+	 * @note This is threadsafe
+	 */
+	static core::SharedPtr<PaletteLUT> get(const voxel::Palette &palette);
+};
+
 class PaletteLookup {
 private:
 	voxel::Palette _palette;
 	core::Map<core::RGBA, uint8_t, 521> _paletteMap;
+	core::SharedPtr<PaletteLUT> _lut;
+
+	void initLUT();
 public:
 	PaletteLookup(const voxel::Palette &palette, int maxSize = 32768) : _palette(palette), _paletteMap(maxSize) {
 		if (_palette.colorCount <= 0) {
@@ -44,17 +93,20 @@ public:
 
 	/**
 	 * @brief Find the closed index in the currently in-use palette for the given color
+	 *
+	 * Colors that are part of the palette are resolved exactly, all other colors are looked up in the
+	 * quantized PaletteLUT. The table is built on the first call - don't modify the palette afterwards.
 	 * @sa core::Color::getClosestMatch()
 	 */
 	uint8_t findClosestIndex(core::RGBA rgba) {
+		if (!_lut) {
+			initLUT();
+		}
 		uint8_t paletteIndex = 0;
-		if (!_paletteMap.get(rgba, paletteIndex)) {
-			paletteIndex = _palette.getClosestMatch(rgba);
-			if (_paletteMap.size() < _paletteMap.capacity()) {
-				_paletteMap.put(rgba, paletteIndex);
-			}
+		if (_paletteMap.get(rgba, paletteIndex)) {
+			return paletteIndex;
 		}
-		return paletteIndex;
+		return _lut->closest(rgba);
 	}
 };
 
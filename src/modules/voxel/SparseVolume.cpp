@@ -0,0 +1,227 @@
+/**
+ * @file
+ */
+
+#include "SparseVolume.h"
+#include "RawVolume.h"
+#include "core/Assert.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+
+namespace voxel {
+
+SparseVolume::SparseVolume(const Region &region) : _region(region) {
+	core_assert_msg(_region.isValid(), "Invalid region: %s", _region.toString().c_str());
+	_bricks = (_region.getDimensionsInVoxels() + BrickMask) >> BrickSizePower;
+	const size_t size = (size_t)_bricks.x * (size_t)_bricks.y * (size_t)_bricks.z * sizeof(Brick *);
+	_brickTable = (Brick **)core_malloc(size);
+	core_memset(_brickTable, 0, size);
+}
+
+SparseVolume::SparseVolume(const RawVolume &volume) : SparseVolume(volume.region()) {
+	core_trace_scoped(SparseVolumeFromRawVolume);
+	_borderVoxel = volume.borderValue();
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	const glm::ivec3 &upper = _region.getUpperCorner();
+	for (int32_t z = lower.z; z <= upper.z; ++z) {
+		for (int32_t y = lower.y; y <= upper.y; ++y) {
+			// the voxels of a row are stored next to each other in the RawVolume
+			const Voxel *row = &volume.voxel(lower.x, y, z);
+			for (int32_t x = lower.x; x <= upper.x; ++x) {
+				const Voxel &v = row[x - lower.x];
+				if (!isEmpty(v)) {
+					setVoxel(x, y, z, v);
+				}
+			}
+		}
+	}
+}
+
+SparseVolume::~SparseVolume() {
+	clear();
+	core_free(_brickTable);
+}
+
+void SparseVolume::clear() {
+	const int n = _bricks.x * _bricks.y * _bricks.z;
+	for (int i = 0; i < n; ++i) {
+		delete _brickTable[i];
+		_brickTable[i] = nullptr;
+	}
+	_allocatedBricks = 0u;
+}
+
+size_t SparseVolume::memoryUsageInBytes() const {
+	const size_t tableSize = (size_t)_bricks.x * (size_t)_bricks.y * (size_t)_bricks.z * sizeof(Brick *);
+	return sizeof(*this) + tableSize + _allocatedBricks * sizeof(Brick);
+}
+
+void SparseVolume::setBorderValue(const Voxel &voxel) {
+	_borderVoxel = voxel;
+}
+
+bool SparseVolume::setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel) {
+	if (!_region.containsPoint(x, y, z)) {
+		return false;
+	}
+	Brick *&brick = _brickTable[brickIndex(x, y, z)];
+	const bool empty = isEmpty(voxel);
+	if (brick == nullptr) {
+		if (empty) {
+			return true;
+		}
+		brick = new Brick();
+		++_allocatedBricks;
+	}
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	Voxel &current = brick->voxels[brickVoxelIndex((x - lower.x) & BrickMask, (y - lower.y) & BrickMask, (z - lower.z) & BrickMask)];
+	const bool wasEmpty = isEmpty(current);
+	current = voxel;
+	if (wasEmpty && !empty) {
+		++brick->used;
+	} else if (!wasEmpty && empty) {
+		core_assert(brick->used > 0u);
+		if (--brick->used == 0u) {
+			delete brick;
+			brick = nullptr;
+			--_allocatedBricks;
+		}
+	}
+	return true;
+}
+
+RawVolume *SparseVolume::toRawVolume() const {
+	return toRawVolume(_region);
+}
+
+RawVolume *SparseVolume::toRawVolume(const Region &region) const {
+	core_trace_scoped(SparseVolumeToRawVolume);
+	RawVolume *volume = new RawVolume(region);
+	volume->setBorderValue(_borderVoxel);
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	// only the allocated bricks have to be copied - the new volume is already empty
+	for (int bz = 0; bz < _bricks.z; ++bz) {
+		for (int by = 0; by < _bricks.y; ++by) {
+			for (int bx = 0; bx < _bricks.x; ++bx) {
+				const Brick *brick = _brickTable[bx + (by + bz * _bricks.y) * _bricks.x];
+				if (brick == nullptr) {
+					continue;
+				}
+				const glm::ivec3 brickLower = lower + glm::ivec3(bx, by, bz) * BrickSize;
+				for (int z = 0; z < BrickSize; ++z) {
+					for (int y = 0; y < BrickSize; ++y) {
+						for (int x = 0; x < BrickSize; ++x) {
+							const Voxel &v = brick->voxels[brickVoxelIndex(x, y, z)];
+							if (isEmpty(v)) {
+								continue;
+							}
+							const glm::ivec3 pos = brickLower + glm::ivec3(x, y, z);
+							if (region.containsPoint(pos)) {
+								volume->setVoxel(pos, v);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	return volume;
+}
+
+SparseVolume::Sampler::Sampler(const SparseVolume *volume) : _volume(const_cast<SparseVolume *>(volume)) {
+}
+
+SparseVolume::Sampler::Sampler(const SparseVolume &volume) : _volume(const_cast<SparseVolume *>(&volume)) {
+}
+
+bool SparseVolume::Sampler::setPosition(int32_t x, int32_t y, int32_t z) {
+	_posInVolume.x = x;
+	_posInVolume.y = y;
+	_posInVolume.z = z;
+	const Region &region = _volume->_region;
+	if (!region.containsPoint(x, y, z)) {
+		_currentPositionInvalid = true;
+		_currentBrick = nullptr;
+		return false;
+	}
+	_currentPositionInvalid = false;
+	const glm::ivec3 &lower = region.getLowerCorner();
+	_posInBrick.x = (x - lower.x) & BrickMask;
+	_posInBrick.y = (y - lower.y) & BrickMask;
+	_posInBrick.z = (z - lower.z) & BrickMask;
+	_currentIndex = brickVoxelIndex(_posInBrick.x, _posInBrick.y, _posInBrick.z);
+	_currentBrick = _volume->_brickTable[_volume->brickIndex(x, y, z)];
+	return true;
+}
+
+bool SparseVolume::Sampler::setVoxel(const Voxel &voxel) {
+	if (_currentPositionInvalid) {
+		return false;
+	}
+	const bool success = _volume->setVoxel(_posInVolume, voxel);
+	// the brick might have been allocated or freed
+	_currentBrick = _volume->_brickTable[_volume->brickIndex(_posInVolume.x, _posInVolume.y, _posInVolume.z)];
+	return success;
+}
+
+void SparseVolume::Sampler::movePositiveX() {
+	++_posInVolume.x;
+	if (!_currentPositionInvalid && _posInBrick.x < BrickMask && _posInVolume.x <= _volume->_region.getUpperX()) {
+		++_posInBrick.x;
+		++_currentIndex;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+void SparseVolume::Sampler::movePositiveY() {
+	++_posInVolume.y;
+	if (!_currentPositionInvalid && _posInBrick.y < BrickMask && _posInVolume.y <= _volume->_region.getUpperY()) {
+		++_posInBrick.y;
+		_currentIndex += BrickSize;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+void SparseVolume::Sampler::movePositiveZ() {
+	++_posInVolume.z;
+	if (!_currentPositionInvalid && _posInBrick.z < BrickMask && _posInVolume.z <= _volume->_region.getUpperZ()) {
+		++_posInBrick.z;
+		_currentIndex += BrickSize * BrickSize;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+void SparseVolume::Sampler::moveNegativeX() {
+	--_posInVolume.x;
+	if (!_currentPositionInvalid && _posInBrick.x > 0) {
+		--_posInBrick.x;
+		--_currentIndex;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+void SparseVolume::Sampler::moveNegativeY() {
+	--_posInVolume.y;
+	if (!_currentPositionInvalid && _posInBrick.y > 0) {
+		--_posInBrick.y;
+		_currentIndex -= BrickSize;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+void SparseVolume::Sampler::moveNegativeZ() {
+	--_posInVolume.z;
+	if (!_currentPositionInvalid && _posInBrick.z > 0) {
+		--_posInBrick.z;
+		_currentIndex -= BrickSize * BrickSize;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+} // namespace voxel
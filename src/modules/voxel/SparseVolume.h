@@ -0,0 +1,284 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Voxel.h"
+#include "Region.h"
+#include "core/NonCopyable.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * @brief Volume implementation that only allocates the bricks of @c BrickSize^3 voxels that contain at
+ * least one voxel that is not the default (air) voxel.
+ *
+ * Imported scenes are often mostly air - this volume only needs the memory for the occupied bricks and one
+ * pointer per brick of the region. The sampler is compatible with the templates that work on the
+ * @c RawVolume::Sampler like @c extractCubicMesh() or the visitors in @c voxelutil.
+ *
+ * @sa RawVolume
+ */
+class SparseVolume : public core::NonCopyable {
+public:
+	static constexpr int BrickSizePower = 4;
+	static constexpr int BrickSize = 1 << BrickSizePower;
+	static constexpr int BrickMask = BrickSize - 1;
+	static constexpr int BrickVoxels = BrickSize * BrickSize * BrickSize;
+
+private:
+	struct Brick {
+		Voxel voxels[BrickVoxels];
+		/** the amount of voxels that are not the default voxel - the brick is freed if this drops to zero */
+		uint32_t used = 0u;
+	};
+
+	static inline bool isEmpty(const Voxel &voxel) {
+		return isAir(voxel.getMaterial()) && voxel.getColor() == 0u && voxel.getFlags() == 0u;
+	}
+
+	static inline int brickVoxelIndex(int x, int y, int z) {
+		return x + (y << BrickSizePower) + (z << (2 * BrickSizePower));
+	}
+
+	/**
+	 * @return The index into the brick table - the position must be inside the region
+	 */
+	inline int brickIndex(int32_t x, int32_t y, int32_t z) const {
+		const glm::ivec3 &lower = _region.getLowerCorner();
+		const int bx = (x - lower.x) >> BrickSizePower;
+		const int by = (y - lower.y) >> BrickSizePower;
+		const int bz = (z - lower.z) >> BrickSizePower;
+		return bx + (by + bz * _bricks.y) * _bricks.x;
+	}
+
+	Region _region;
+	/** the amount of bricks on each axis */
+	glm::ivec3 _bricks;
+	Brick **_brickTable = nullptr;
+	size_t _allocatedBricks = 0u;
+	Voxel _borderVoxel;
+	const Voxel _emptyVoxel;
+
+public:
+	class Sampler {
+	public:
+		Sampler(const SparseVolume &volume);
+		Sampler(const SparseVolume *volume);
+		virtual ~Sampler() {}
+
+		const Voxel &voxel() const;
+		virtual const Region region() const;
+
+		bool currentPositionValid() const;
+
+		bool setPosition(const glm::ivec3 &pos);
+		bool setPosition(int32_t x, int32_t y, int32_t z);
+		virtual bool setVoxel(const Voxel &voxel);
+		const glm::ivec3 &position() const;
+
+		void movePositiveX();
+		void movePositiveY();
+		void movePositiveZ();
+
+		void moveNegativeX();
+		void moveNegativeY();
+		void moveNegativeZ();
+
+		const Voxel &peekVoxel1nx1ny1nz() const { return peek(-1, -1, -1); }
+		const Voxel &peekVoxel1nx1ny0pz() const { return peek(-1, -1, 0); }
+		const Voxel &peekVoxel1nx1ny1pz() const { return peek(-1, -1, 1); }
+		const Voxel &peekVoxel1nx0py1nz() const { return peek(-1, 0, -1); }
+		const Voxel &peekVoxel1nx0py0pz() const { return peek(-1, 0, 0); }
+		const Voxel &peekVoxel1nx0py1pz() const { return peek(-1, 0, 1); }
+		const Voxel &peekVoxel1nx1py1nz() const { return peek(-1, 1, -1); }
+		const Voxel &peekVoxel1nx1py0pz() const { return peek(-1, 1, 0); }
+		const Voxel &peekVoxel1nx1py1pz() const { return peek(-1, 1, 1); }
+
+		const Voxel &peekVoxel0px1ny1nz() const { return peek(0, -1, -1); }
+		const Voxel &peekVoxel0px1ny0pz() const { return peek(0, -1, 0); }
+		const Voxel &peekVoxel0px1ny1pz() const { return peek(0, -1, 1); }
+		const Voxel &peekVoxel0px0py1nz() const { return peek(0, 0, -1); }
+		const Voxel &peekVoxel0px0py0pz() const { return voxel(); }
+		const Voxel &peekVoxel0px0py1pz() const { return peek(0, 0, 1); }
+		const Voxel &peekVoxel0px1py1nz() const { return peek(0, 1, -1); }
+		const Voxel &peekVoxel0px1py0pz() const { return peek(0, 1, 0); }
+		const Voxel &peekVoxel0px1py1pz() const { return peek(0, 1, 1); }
+
+		const Voxel &peekVoxel1px1ny1nz() const { return peek(1, -1, -1); }
+		const Voxel &peekVoxel1px1ny0pz() const { return peek(1, -1, 0); }
+		const Voxel &peekVoxel1px1ny1pz() const { return peek(1, -1, 1); }
+		const Voxel &peekVoxel1px0py1nz() const { return peek(1, 0, -1); }
+		const Voxel &peekVoxel1px0py0pz() const { return peek(1, 0, 0); }
+		const Voxel &peekVoxel1px0py1pz() const { return peek(1, 0, 1); }
+		const Voxel &peekVoxel1px1py1nz() const { return peek(1, 1, -1); }
+		const Voxel &peekVoxel1px1py0pz() const { return peek(1, 1, 0); }
+		const Voxel &peekVoxel1px1py1pz() const { return peek(1, 1, 1); }
+
+	protected:
+		/**
+		 * @brief Lookup of a neighbour voxel - only leaves the current brick if needed
+		 */
+		const Voxel &peek(int dx, int dy, int dz) const;
+
+		SparseVolume *_volume;
+
+		// The current position in the volume
+		glm::ivec3 _posInVolume{0, 0, 0};
+		// The position inside the current brick
+		glm::ivec3 _posInBrick{0, 0, 0};
+		// The current brick - nullptr if the brick only contains empty voxels
+		Brick *_currentBrick = nullptr;
+		int _currentIndex = 0;
+
+		/** Whether the current position is inside the volume */
+		bool _currentPositionInvalid = false;
+	};
+
+	/// Constructor for creating a fixed size volume - all voxels are empty.
+	SparseVolume(const Region &region);
+	/**
+	 * @brief Converts the given RawVolume - only the bricks with non-empty voxels are allocated
+	 */
+	explicit SparseVolume(const RawVolume &volume);
+	~SparseVolume();
+
+	/**
+	 * @brief Copies the voxels of the given region into a new RawVolume
+	 * @note It's the callers responsibility to delete the returned volume
+	 */
+	RawVolume *toRawVolume(const Region &region) const;
+	RawVolume *toRawVolume() const;
+
+	/**
+	 * The border value is returned whenever an attempt is made to read a voxel which
+	 * is outside the extents of the volume.
+	 * @return The value used for voxels outside of the volume
+	 */
+	const Voxel &borderValue() const;
+	void setBorderValue(const Voxel &voxel);
+
+	/**
+	 * @return A Region representing the extent of the volume.
+	 */
+	const Region &region() const;
+
+	int32_t width() const;
+	int32_t height() const;
+	int32_t depth() const;
+
+	const Voxel &voxel(int32_t x, int32_t y, int32_t z) const;
+	const Voxel &voxel(const glm::ivec3 &pos) const;
+
+	/**
+	 * @return @c false if the position is outside of the volume
+	 */
+	bool setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel);
+	bool setVoxel(const glm::ivec3 &pos, const Voxel &voxel);
+
+	/**
+	 * @brief Resets all voxels to empty voxels and frees all bricks
+	 */
+	void clear();
+
+	/**
+	 * @return The amount of bricks that contain non-empty voxels
+	 */
+	size_t allocatedBricks() const;
+	size_t memoryUsageInBytes() const;
+};
+
+inline const Region &SparseVolume::region() const {
+	return _region;
+}
+
+inline const Voxel &SparseVolume::borderValue() const {
+	return _borderVoxel;
+}
+
+inline int32_t SparseVolume::width() const {
+	return _region.getWidthInVoxels();
+}
+
+inline int32_t SparseVolume::height() const {
+	return _region.getHeightInVoxels();
+}
+
+inline int32_t SparseVolume::depth() const {
+	return _region.getDepthInVoxels();
+}
+
+inline size_t SparseVolume::allocatedBricks() const {
+	return _allocatedBricks;
+}
+
+inline const Voxel &SparseVolume::voxel(int32_t x, int32_t y, int32_t z) const {
+	if (!_region.containsPoint(x, y, z)) {
+		return _borderVoxel;
+	}
+	const Brick *brick = _brickTable[brickIndex(x, y, z)];
+	if (brick == nullptr) {
+		return _emptyVoxel;
+	}
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	return brick->voxels[brickVoxelIndex((x - lower.x) & BrickMask, (y - lower.y) & BrickMask, (z - lower.z) & BrickMask)];
+}
+
+inline const Voxel &SparseVolume::voxel(const glm::ivec3 &pos) const {
+	return voxel(pos.x, pos.y, pos.z);
+}
+
+inline bool SparseVolume::setVoxel(const glm::ivec3 &pos, const Voxel &voxel) {
+	return setVoxel(pos.x, pos.y, pos.z, voxel);
+}
+
+inline const Region SparseVolume::Sampler::region() const {
+	return _volume->region();
+}
+
+inline const glm::ivec3 &SparseVolume::Sampler::position() const {
+	return _posInVolume;
+}
+
+inline bool SparseVolume::Sampler::currentPositionValid() const {
+	return !_currentPositionInvalid;
+}
+
+inline bool SparseVolume::Sampler::setPosition(const glm::ivec3 &pos) {
+	return setPosition(pos.x, pos.y, pos.z);
+}
+
+inline const Voxel &SparseVolume::Sampler::voxel() const {
+	if (_currentPositionInvalid) {
+		return _volume->_borderVoxel;
+	}
+	if (_currentBrick == nullptr) {
+		return _volume->_emptyVoxel;
+	}
+	return _currentBrick->voxels[_currentIndex];
+}
+
+inline const Voxel &SparseVolume::Sampler::peek(int dx, int dy, int dz) const {
+	const int x = _posInBrick.x + dx;
+	const int y = _posInBrick.y + dy;
+	const int z = _posInBrick.z + dz;
+	// the brick table covers the whole region - so a position inside of the current brick is also inside
+	// of the region if the brick is not cut by the upper corner of the region
+	if (!_currentPositionInvalid && ((x | y | z) & ~BrickMask) == 0) {
+		const glm::ivec3 pos(_posInVolume.x + dx, _posInVolume.y + dy, _posInVolume.z + dz);
+		const Region &region = _volume->_region;
+		if (pos.x <= region.getUpperX() && pos.y <= region.getUpperY() && pos.z <= region.getUpperZ()) {
+			if (_currentBrick == nullptr) {
+				return _volume->_emptyVoxel;
+			}
+			return _currentBrick->voxels[_currentIndex + dx + dy * BrickSize + dz * BrickSize * BrickSize];
+		}
+	}
+	return _volume->voxel(_posInVolume.x + dx, _posInVolume.y + dy, _posInVolume.z + dz);
+}
+
+} // namespace voxel
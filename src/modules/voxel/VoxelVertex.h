@@ -28,6 +28,53 @@ struct VoxelVertex {
 };
 static_assert(sizeof(VoxelVertex) == 8, "Unexpected size of the vertex struct");
 
+/**
+ * @brief Compressed variant of @c VoxelVertex for meshes of a limited size. The position is stored relative
+ * to the mesh offset (see @c Mesh::getOffset()) and everything is packed into one 32 bit word:
+ * x (7 bits), y (8 bits), z (7 bits), ambient occlusion (2 bits) and the color index (8 bits).
+ *
+ * @note There is no normal or face index - the shaders calculate the normal from the screen space derivatives
+ * of the position. The voxel flags are not part of the packed vertex either.
+ * @sa packVertex()
+ */
+struct PackedVoxelVertex {
+	uint32_t data;
+};
+static_assert(sizeof(PackedVoxelVertex) == 4, "Unexpected size of the packed vertex struct");
+
+constexpr int PackedVertexMaxXZ = (1 << 7) - 1;
+constexpr int PackedVertexMaxY = (1 << 8) - 1;
+
+/**
+ * @param[in] offset The mesh offset the packed position is relative to
+ * @return @c false if the position relative to the given offset can't be represented by a packed vertex
+ */
+inline bool packVertex(const VoxelVertex &vertex, const glm::ivec3 &offset, PackedVoxelVertex &packed) {
+	const glm::ivec3 pos = glm::ivec3(vertex.position) - offset;
+	if (pos.x < 0 || pos.x > PackedVertexMaxXZ || pos.y < 0 || pos.y > PackedVertexMaxY || pos.z < 0 ||
+		pos.z > PackedVertexMaxXZ) {
+		return false;
+	}
+	packed.data = (uint32_t)pos.x | ((uint32_t)pos.y << 7) | ((uint32_t)pos.z << 15) |
+				  ((uint32_t)vertex.ambientOcclusion << 22) | ((uint32_t)vertex.colorIndex << 24);
+	return true;
+}
+
+/**
+ * @return The position relative to the mesh offset
+ */
+inline glm::ivec3 packedVertexPosition(const PackedVoxelVertex &packed) {
+	return glm::ivec3(packed.data & 0x7F, (packed.data >> 7) & 0xFF, (packed.data >> 15) & 0x7F);
+}
+
+inline uint8_t packedVertexAmbientOcclusion(const PackedVoxelVertex &packed) {
+	return (uint8_t)((packed.data >> 22) & 0x3);
+}
+
+inline uint8_t packedVertexColorIndex(const PackedVoxelVertex &packed) {
+	return (uint8_t)(packed.data >> 24);
+}
+
 // TODO: maybe reduce to uint16_t and use glDrawElementsBaseVertex
 typedef uint32_t IndexType;
 
@@ -3,6 +3,7 @@
  */
 
 #include "app/benchmark/AbstractBenchmark.h"
+#include "voxel/BinaryCubicSurfaceExtractor.h"
 #include "voxel/CubicSurfaceExtractor.h"
 #include "voxel/IsQuadNeeded.h"
 #include "voxel/MaterialColor.h"
@@ -133,6 +134,50 @@ BENCHMARK_DEFINE_F(CubicSurfaceExtractorBenchmark, PagedVolumeExtractEmpty)(benc
 	}
 }
 
+BENCHMARK_DEFINE_F(CubicSurfaceExtractorBenchmark, RawVolumeExtractBinaryGreedy)(benchmark::State &state) {
+	const voxel::Region region(glm::ivec3(0), glm::ivec3(state.range(0), meshSize, state.range(0)));
+	const voxel::Region volumeRegion(0, MAX_BENCHMARK_VOLUME_SIZE);
+	voxel::RawVolume volume(volumeRegion);
+	fill(region, &volume);
+	voxel::Mesh mesh(1024 * 1024, 1024 * 1024, false);
+	for (auto _ : state) {
+		voxel::extractBinaryCubicMesh(&volume, region, &mesh, region.getLowerCorner(), true, true);
+	}
+}
+
+BENCHMARK_DEFINE_F(CubicSurfaceExtractorBenchmark, RawVolumeExtractBinary)(benchmark::State &state) {
+	const voxel::Region region(glm::ivec3(0), glm::ivec3(state.range(0), meshSize, state.range(0)));
+	const voxel::Region volumeRegion(0, MAX_BENCHMARK_VOLUME_SIZE);
+	voxel::RawVolume volume(volumeRegion);
+	fill(region, &volume);
+	voxel::Mesh mesh(1024 * 1024, 1024 * 1024, false);
+	for (auto _ : state) {
+		voxel::extractBinaryCubicMesh(&volume, region, &mesh, region.getLowerCorner(), false, false);
+	}
+}
+
+BENCHMARK_DEFINE_F(CubicSurfaceExtractorBenchmark, PagedVolumeExtractBinaryGreedy)(benchmark::State &state) {
+	const voxel::Region region(glm::ivec3(0), glm::ivec3(state.range(0), meshSize, state.range(0)));
+	BenchmarkPager pager;
+	voxel::PagedVolume volume(&pager, 1024 * 1024 * 1024, 256);
+	fill(region, &volume);
+	voxel::Mesh mesh(1024 * 1024, 1024 * 1024, false);
+	for (auto _ : state) {
+		voxel::extractBinaryCubicMesh(&volume, region, &mesh, region.getLowerCorner(), true, true);
+	}
+}
+
+BENCHMARK_DEFINE_F(CubicSurfaceExtractorBenchmark, PagedVolumeExtractBinary)(benchmark::State &state) {
+	const voxel::Region region(glm::ivec3(0), glm::ivec3(state.range(0), meshSize, state.range(0)));
+	BenchmarkPager pager;
+	voxel::PagedVolume volume(&pager, 1024 * 1024 * 1024, 256);
+	fill(region, &volume);
+	voxel::Mesh mesh(1024 * 1024, 1024 * 1024, false);
+	for (auto _ : state) {
+		voxel::extractBinaryCubicMesh(&volume, region, &mesh, region.getLowerCorner(), false, false);
+	}
+}
+
 BENCHMARK_REGISTER_F(CubicSurfaceExtractorBenchmark, RawVolumeExtractGreedy)->RangeMultiplier(2)->Range(16, MAX_BENCHMARK_VOLUME_SIZE);
 BENCHMARK_REGISTER_F(CubicSurfaceExtractorBenchmark, RawVolumeExtract)->RangeMultiplier(2)->Range(16, MAX_BENCHMARK_VOLUME_SIZE);
 BENCHMARK_REGISTER_F(CubicSurfaceExtractorBenchmark, RawVolumeExtractGreedyEmpty)->RangeMultiplier(2)->Range(16, MAX_BENCHMARK_VOLUME_SIZE);
@@ -143,4 +188,9 @@ BENCHMARK_REGISTER_F(CubicSurfaceExtractorBenchmark, PagedVolumeExtract)->RangeM
 BENCHMARK_REGISTER_F(CubicSurfaceExtractorBenchmark, PagedVolumeExtractGreedyEmpty)->RangeMultiplier(2)->Range(16, MAX_BENCHMARK_VOLUME_SIZE);
 BENCHMARK_REGISTER_F(CubicSurfaceExtractorBenchmark, PagedVolumeExtractEmpty)->RangeMultiplier(2)->Range(16, MAX_BENCHMARK_VOLUME_SIZE);
 
+BENCHMARK_REGISTER_F(CubicSurfaceExtractorBenchmark, RawVolumeExtractBinaryGreedy)->RangeMultiplier(2)->Range(16, MAX_BENCHMARK_VOLUME_SIZE);
+BENCHMARK_REGISTER_F(CubicSurfaceExtractorBenchmark, RawVolumeExtractBinary)->RangeMultiplier(2)->Range(16, MAX_BENCHMARK_VOLUME_SIZE);
+BENCHMARK_REGISTER_F(CubicSurfaceExtractorBenchmark, PagedVolumeExtractBinaryGreedy)->RangeMultiplier(2)->Range(16, MAX_BENCHMARK_VOLUME_SIZE);
+BENCHMARK_REGISTER_F(CubicSurfaceExtractorBenchmark, PagedVolumeExtractBinary)->RangeMultiplier(2)->Range(16, MAX_BENCHMARK_VOLUME_SIZE);
+
 BENCHMARK_MAIN();
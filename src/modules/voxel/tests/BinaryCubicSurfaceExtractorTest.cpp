@@ -0,0 +1,129 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxel/BinaryCubicSurfaceExtractor.h"
+#include "voxel/CubicSurfaceExtractor.h"
+#include "voxel/IsQuadNeeded.h"
+#include "voxel/RawVolume.h"
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace voxel {
+
+class BinaryCubicSurfaceExtractorTest : public app::AbstractTest {
+protected:
+	static constexpr int MeshCapacity = 4 * 1024 * 1024;
+	typedef std::tuple<int, int, int, uint8_t, uint8_t> VertexTuple;
+	typedef std::tuple<VertexTuple, VertexTuple, VertexTuple> TriangleTuple;
+
+	void fill(RawVolume &volume, int airFactor) const {
+		const Region &region = volume.region();
+		const int groundLevel = region.getLowerY() + region.getHeightInVoxels() / 4;
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					if (y < groundLevel) {
+						// large solid areas that can get merged
+						volume.setVoxel(x, y, z, createVoxel(VoxelType::Rock, 4));
+						continue;
+					}
+					const uint32_t hash = (uint32_t)(x * 73856093) ^ (uint32_t)(y * 19349663) ^ (uint32_t)(z * 83492791);
+					const uint32_t value = hash % (3 + airFactor);
+					if (value == 0) {
+						volume.setVoxel(x, y, z, createVoxel(VoxelType::Generic, 1));
+					} else if (value == 1) {
+						volume.setVoxel(x, y, z, createVoxel(VoxelType::Grass, 2));
+					} else if (value == 2) {
+						volume.setVoxel(x, y, z, createVoxel(VoxelType::Water, 3));
+					}
+				}
+			}
+		}
+	}
+
+	static VertexTuple vertexTuple(const Mesh &mesh, IndexType index) {
+		const VoxelVertex &v = mesh.getVertex(index);
+		return VertexTuple(v.position.x, v.position.y, v.position.z, v.colorIndex, v.info);
+	}
+
+	static std::vector<TriangleTuple> triangles(const Mesh &mesh) {
+		std::vector<TriangleTuple> tris;
+		const IndexArray &indices = mesh.getIndexVector();
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			tris.emplace_back(vertexTuple(mesh, indices[i]), vertexTuple(mesh, indices[i + 1]),
+							  vertexTuple(mesh, indices[i + 2]));
+		}
+		std::sort(tris.begin(), tris.end());
+		return tris;
+	}
+
+	static int64_t doubleArea(const Mesh &mesh) {
+		int64_t area = 0;
+		const IndexArray &indices = mesh.getIndexVector();
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const glm::ivec3 p0 = mesh.getVertex(indices[i]).position;
+			const glm::ivec3 p1 = mesh.getVertex(indices[i + 1]).position;
+			const glm::ivec3 p2 = mesh.getVertex(indices[i + 2]).position;
+			const glm::ivec3 c = glm::abs(glm::cross(glm::vec3(p1 - p0), glm::vec3(p2 - p0)));
+			area += c.x + c.y + c.z;
+		}
+		return area;
+	}
+};
+
+TEST_F(BinaryCubicSurfaceExtractorTest, testSameTrianglesWithoutMerge) {
+	RawVolume volume(Region(-3, 40));
+	fill(volume, 2);
+	const Region region(glm::ivec3(-2, 0, 1), glm::ivec3(37, 40, 30));
+	Mesh expected(MeshCapacity, MeshCapacity, true);
+	extractCubicMesh(&volume, region, &expected, IsQuadNeeded(), region.getLowerCorner(), false, true);
+	Mesh mesh(MeshCapacity, MeshCapacity, true);
+	extractBinaryCubicMesh(&volume, region, &mesh, region.getLowerCorner(), false, true);
+	ASSERT_FALSE(expected.isEmpty());
+	EXPECT_EQ(expected.getNoOfVertices(), mesh.getNoOfVertices());
+	ASSERT_EQ(expected.getNoOfIndices(), mesh.getNoOfIndices());
+	EXPECT_EQ(triangles(expected), triangles(mesh));
+	EXPECT_EQ(expected.getOffset(), mesh.getOffset());
+}
+
+TEST_F(BinaryCubicSurfaceExtractorTest, testSameAreaWithMerge) {
+	RawVolume volume(Region(0, 31));
+	fill(volume, 20);
+	const Region &region = volume.region();
+	Mesh expected(MeshCapacity, MeshCapacity, true);
+	extractCubicMesh(&volume, region, &expected, IsQuadNeeded(), region.getLowerCorner());
+	Mesh unmerged(MeshCapacity, MeshCapacity, true);
+	extractBinaryCubicMesh(&volume, region, &unmerged, region.getLowerCorner(), false);
+	Mesh mesh(MeshCapacity, MeshCapacity, true);
+	extractBinaryCubicMesh(&volume, region, &mesh, region.getLowerCorner());
+	ASSERT_FALSE(expected.isEmpty());
+	EXPECT_EQ(doubleArea(expected), doubleArea(mesh));
+	EXPECT_LT(mesh.getNoOfIndices(), unmerged.getNoOfIndices());
+}
+
+TEST_F(BinaryCubicSurfaceExtractorTest, testMultipleTiles) {
+	RawVolume volume(Region(0, 79));
+	fill(volume, 10);
+	const Region &region = volume.region();
+	Mesh expected(MeshCapacity, MeshCapacity, true);
+	extractCubicMesh(&volume, region, &expected, IsQuadNeeded(), region.getLowerCorner(), false);
+	Mesh mesh(MeshCapacity, MeshCapacity, true);
+	extractBinaryCubicMesh(&volume, region, &mesh, region.getLowerCorner(), false);
+	EXPECT_EQ(triangles(expected), triangles(mesh));
+
+	Mesh merged(MeshCapacity, MeshCapacity, true);
+	extractBinaryCubicMesh(&volume, region, &merged, region.getLowerCorner());
+	EXPECT_EQ(doubleArea(expected), doubleArea(merged));
+}
+
+TEST_F(BinaryCubicSurfaceExtractorTest, testEmpty) {
+	RawVolume volume(Region(0, 15));
+	Mesh mesh;
+	extractBinaryCubicMesh(&volume, volume.region(), &mesh, glm::ivec3(0));
+	EXPECT_TRUE(mesh.isEmpty());
+}
+
+} // namespace voxel
@@ -0,0 +1,54 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxel/Mesh.h"
+
+namespace voxel {
+
+class MeshTest : public app::AbstractTest {
+protected:
+	static VoxelVertex vertex(const glm::ivec3 &pos, uint8_t ambientOcclusion, uint8_t colorIndex) {
+		VoxelVertex v;
+		v.position = pos;
+		v.info = 0u;
+		v.ambientOcclusion = ambientOcclusion;
+		v.colorIndex = colorIndex;
+		return v;
+	}
+};
+
+TEST_F(MeshTest, testPackVertices) {
+	const glm::ivec3 offset(-64, 0, 128);
+	Mesh mesh;
+	mesh.setOffset(offset);
+	mesh.addVertex(vertex(offset, 0, 0));
+	mesh.addVertex(vertex(offset + glm::ivec3(PackedVertexMaxXZ, PackedVertexMaxY, PackedVertexMaxXZ), 3, 255));
+	mesh.addVertex(vertex(offset + glm::ivec3(5, 100, 17), 2, 42));
+
+	PackedVertexArray packed;
+	ASSERT_TRUE(packVertices(mesh, packed));
+	ASSERT_EQ(mesh.getNoOfVertices(), packed.size());
+	for (size_t i = 0; i < packed.size(); ++i) {
+		const VoxelVertex &v = mesh.getVertex((IndexType)i);
+		EXPECT_EQ(glm::ivec3(v.position) - offset, packedVertexPosition(packed[i])) << "vertex " << i;
+		EXPECT_EQ(v.ambientOcclusion, packedVertexAmbientOcclusion(packed[i])) << "vertex " << i;
+		EXPECT_EQ(v.colorIndex, packedVertexColorIndex(packed[i])) << "vertex " << i;
+	}
+}
+
+TEST_F(MeshTest, testPackVerticesOutOfRange) {
+	Mesh mesh;
+	mesh.setOffset(glm::ivec3(10));
+	mesh.addVertex(vertex(glm::ivec3(10), 0, 1));
+	mesh.addVertex(vertex(glm::ivec3(9, 10, 10), 0, 1));
+	PackedVertexArray packed;
+	EXPECT_FALSE(packVertices(mesh, packed));
+
+	Mesh large;
+	large.addVertex(vertex(glm::ivec3(PackedVertexMaxXZ + 1, 0, 0), 0, 1));
+	EXPECT_FALSE(packVertices(large, packed));
+}
+
+} // namespace voxel
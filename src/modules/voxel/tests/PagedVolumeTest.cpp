@@ -0,0 +1,144 @@
+/**
+ * @file
+ */
+
+#include "AbstractVoxelTest.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ThreadPool.h"
+#include <memory>
+
+namespace voxel {
+
+class PagedVolumeTest: public AbstractVoxelTest {
+protected:
+	core::AtomicInt _pageIns { 0 };
+
+	bool pageIn(const voxel::Region& region, const PagedVolume::ChunkPtr& chunk) override {
+		++_pageIns;
+		chunk->setVoxel(0, 0, 0, createVoxel(VoxelType::Rock, 1));
+		return false;
+	}
+
+	static Voxel voxelForIndex(int i) {
+		return Voxel(VoxelType::Generic, (uint8_t)(i % 256), (uint8_t)((i / 256) % 8));
+	}
+};
+
+TEST_F(PagedVolumeTest, testUniformChunk) {
+	PagedVolume::Chunk chunk(glm::ivec3(0), 32, &_pager);
+	EXPECT_EQ(0, chunk.bitsPerVoxel());
+	EXPECT_EQ(1, chunk.paletteSize());
+	EXPECT_EQ(VoxelType::Air, chunk.voxel(31, 31, 31).getMaterial());
+	chunk.setVoxel(1, 2, 3, Voxel());
+	EXPECT_EQ(0, chunk.bitsPerVoxel()) << "Setting the same voxel must keep the chunk uniform";
+	EXPECT_LT(chunk.memoryUsageInBytes(), chunk.dataSizeInBytes());
+}
+
+TEST_F(PagedVolumeTest, testWidenIndices) {
+	PagedVolume::Chunk chunk(glm::ivec3(0), 32, &_pager);
+	const int expectedBits[] = {1, 2, 4, 4, 8};
+	const int paletteSizes[] = {2, 3, 5, 16, 17};
+	int n = 0;
+	for (int i = 0; i < lengthof(paletteSizes); ++i) {
+		for (; n < paletteSizes[i] - 1; ++n) {
+			chunk.setVoxel(n % 32, n / 32, 5, voxelForIndex(n));
+		}
+		EXPECT_EQ(paletteSizes[i], chunk.paletteSize());
+		EXPECT_EQ(expectedBits[i], chunk.bitsPerVoxel());
+		for (int j = 0; j < n; ++j) {
+			ASSERT_TRUE(voxelForIndex(j).isSame(chunk.voxel(j % 32, j / 32, 5))) << "voxel " << j << " palette size " << paletteSizes[i];
+		}
+		EXPECT_EQ(VoxelType::Air, chunk.voxel(0, 0, 0).getMaterial());
+	}
+}
+
+TEST_F(PagedVolumeTest, testUncompressedFallback) {
+	PagedVolume::Chunk chunk(glm::ivec3(0), 32, &_pager);
+	const int amount = PagedVolume::Chunk::MaxPaletteEntries + 10;
+	for (int i = 0; i < amount; ++i) {
+		chunk.setVoxel(i % 32, (i / 32) % 32, 1, voxelForIndex(i));
+	}
+	EXPECT_EQ((int)sizeof(Voxel) * 8, chunk.bitsPerVoxel());
+	for (int i = 0; i < amount; ++i) {
+		const Voxel& voxel = chunk.voxel(i % 32, (i / 32) % 32, 1);
+		ASSERT_TRUE(voxelForIndex(i).isSame(voxel)) << "voxel " << i;
+		ASSERT_EQ(voxelForIndex(i).getFlags(), voxel.getFlags()) << "voxel " << i;
+	}
+}
+
+TEST_F(PagedVolumeTest, testSetData) {
+	PagedVolume::Chunk chunk(glm::ivec3(0), 16, &_pager);
+	const uint32_t voxels = chunk.voxels();
+	std::unique_ptr<Voxel[]> data(new Voxel[voxels]);
+	for (uint32_t i = 0u; i < voxels; ++i) {
+		data[i] = voxelForIndex(i % 3);
+	}
+	ASSERT_TRUE(chunk.setData(data.get(), chunk.dataSizeInBytes()));
+	EXPECT_EQ(2, chunk.bitsPerVoxel());
+	EXPECT_EQ(3, chunk.paletteSize());
+
+	std::unique_ptr<Voxel[]> out(new Voxel[voxels]);
+	ASSERT_TRUE(chunk.data(out.get(), chunk.dataSizeInBytes()));
+	for (uint32_t i = 0u; i < voxels; ++i) {
+		ASSERT_TRUE(data[i].isSame(out[i])) << "voxel " << i;
+	}
+	EXPECT_EQ(VoxelType::Generic, chunk.voxel(0, 0, 0).getMaterial());
+	EXPECT_FALSE(chunk.setData(data.get(), chunk.dataSizeInBytes() - 1));
+}
+
+TEST_F(PagedVolumeTest, testSamplerOnCompressedChunk) {
+	PagedVolume::Sampler sampler(&_volData);
+	_volData.setVoxel(1, 1, 1, createVoxel(VoxelType::Rock, 1));
+	_volData.setVoxel(1, 2, 1, createVoxel(VoxelType::Grass, 2));
+	sampler.setPosition(1, 1, 1);
+	EXPECT_EQ(VoxelType::Rock, sampler.voxel().getMaterial());
+	EXPECT_EQ(VoxelType::Grass, sampler.peekVoxel0px1py0pz().getMaterial());
+	EXPECT_EQ(VoxelType::Air, sampler.peekVoxel0px1ny0pz().getMaterial());
+	EXPECT_TRUE(sampler.setVoxel(createVoxel(VoxelType::Sand, 3)));
+	EXPECT_EQ(VoxelType::Sand, _volData.voxel(1, 1, 1).getMaterial());
+	sampler.movePositiveY();
+	EXPECT_EQ(VoxelType::Grass, sampler.voxel().getMaterial());
+	EXPECT_EQ(VoxelType::Sand, sampler.peekVoxel0px1ny0pz().getMaterial());
+}
+
+TEST_F(PagedVolumeTest, testMoreChunksInMemoryLimit) {
+	const uint32_t memoryLimit = 4 * 1024 * 1024;
+	PagedVolume volume(&_pager, memoryLimit, 32);
+	const int uncompressedChunks = (int)(memoryLimit / (32 * 32 * 32 * sizeof(Voxel)));
+	const int chunks = uncompressedChunks * 4;
+	_pageIns = 0;
+	for (int i = 0; i < chunks; ++i) {
+		volume.chunk(glm::ivec3(i * 32, 0, 0));
+	}
+	ASSERT_EQ(chunks, (int)_pageIns);
+	// the uniform chunks are still in memory - they don't have to be paged in again
+	for (int i = 0; i < chunks; ++i) {
+		EXPECT_EQ(1, volume.chunk(glm::ivec3(i * 32, 0, 0))->bitsPerVoxel());
+	}
+	EXPECT_EQ(chunks, (int)_pageIns);
+}
+
+TEST_F(PagedVolumeTest, testPrefetchRegion) {
+	PagedVolume volume(&_pager, 4 * 1024 * 1024, 16);
+	const Region region(-16, 47);
+	EXPECT_FALSE(volume.prefetchRegion(region)) << "No thread pool was set";
+
+	core::ThreadPool threadPool(2, "PagedVolTest");
+	threadPool.init();
+	volume.setThreadPool(&threadPool);
+	_pageIns = 0;
+	ASSERT_TRUE(volume.prefetchRegion(region, 1));
+	// a lookup of a chunk that is currently paged in waits for it - every chunk is only paged in once
+	for (int z = -16; z < 48; z += 16) {
+		for (int y = -16; y < 48; y += 16) {
+			for (int x = -16; x < 48; x += 16) {
+				EXPECT_EQ(VoxelType::Rock, volume.voxel(x, y, z).getMaterial());
+			}
+		}
+	}
+	volume.setThreadPool(nullptr);
+	EXPECT_EQ(4 * 4 * 4, (int)_pageIns);
+	threadPool.shutdown();
+}
+
+}
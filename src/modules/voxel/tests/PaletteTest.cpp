@@ -6,6 +6,7 @@
 #include "app/tests/AbstractTest.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/PaletteLookup.h"
+#include <glm/vec3.hpp>
 
 namespace voxel {
 
@@ -18,6 +19,40 @@ TEST_F(PaletteTest, testPaletteLookup) {
 	EXPECT_EQ(0, pal.findClosestIndex(rgba));
 }
 
+TEST_F(PaletteTest, testPaletteLookupExactColors) {
+	Palette pal;
+	pal.nippon();
+	PaletteLookup palLookup(pal);
+	for (int i = 0; i < pal.colorCount; ++i) {
+		EXPECT_EQ(pal.getClosestMatch(pal.colors[i]), palLookup.findClosestIndex(pal.colors[i]));
+	}
+}
+
+TEST_F(PaletteTest, testPaletteLUT) {
+	Palette pal;
+	pal.nippon();
+	const core::SharedPtr<PaletteLUT> &lut = PaletteLUT::get(pal);
+	ASSERT_TRUE(lut);
+	EXPECT_TRUE(lut->matches(pal));
+	EXPECT_EQ(lut.get(), PaletteLUT::get(pal).get()) << "The table should be shared for the same palette";
+
+	// the cell centers are resolved exactly
+	const int halfCell = 1 << (PaletteLUT::Shift - 1);
+	for (int c = 0; c < PaletteLUT::Size; ++c) {
+		const glm::ivec3 cell(c, PaletteLUT::Size - 1 - c, c / 2);
+		const glm::ivec3 center = (cell << PaletteLUT::Shift) + halfCell;
+		const glm::ivec3 color = (cell << PaletteLUT::Shift) + 1;
+		const core::RGBA rgba((uint8_t)color.r, (uint8_t)color.g, (uint8_t)color.b, 255);
+		const glm::vec4 centerColor(glm::vec3(center) / 255.0f, 1.0f);
+		EXPECT_EQ(pal.getClosestMatch(centerColor), lut->closest(rgba));
+	}
+
+	Palette other;
+	other.magicaVoxel();
+	EXPECT_FALSE(lut->matches(other));
+	EXPECT_NE(lut.get(), PaletteLUT::get(other).get());
+}
+
 TEST_F(PaletteTest, testGimpPalette) {
 	Palette pal;
 	pal.nippon();
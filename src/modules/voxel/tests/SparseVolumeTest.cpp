@@ -0,0 +1,135 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxel/SparseVolume.h"
+#include "voxel/CubicSurfaceExtractor.h"
+#include "voxel/IsQuadNeeded.h"
+#include "voxel/RawVolume.h"
+#include <memory>
+
+namespace voxel {
+
+class SparseVolumeTest : public app::AbstractTest {
+protected:
+	void fill(RawVolume &volume) const {
+		const Region &region = volume.region();
+		for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					const uint32_t hash = (uint32_t)(x * 73856093) ^ (uint32_t)(y * 19349663) ^ (uint32_t)(z * 83492791);
+					// leave some bricks completely empty
+					if (x > region.getLowerX() + 20 && x < region.getLowerX() + 40) {
+						continue;
+					}
+					if (hash % 5 == 0) {
+						volume.setVoxel(x, y, z, createVoxel(VoxelType::Generic, (uint8_t)(1 + hash % 100)));
+					}
+				}
+			}
+		}
+	}
+};
+
+TEST_F(SparseVolumeTest, testSetVoxel) {
+	SparseVolume volume(Region(-10, 40));
+	EXPECT_EQ(0u, volume.allocatedBricks());
+	EXPECT_TRUE(volume.setVoxel(0, 0, 0, Voxel()));
+	EXPECT_EQ(0u, volume.allocatedBricks()) << "Empty voxels must not allocate a brick";
+	EXPECT_TRUE(volume.setVoxel(1, 2, 3, createVoxel(VoxelType::Generic, 1)));
+	EXPECT_TRUE(volume.setVoxel(2, 2, 3, createVoxel(VoxelType::Generic, 2)));
+	EXPECT_EQ(1u, volume.allocatedBricks());
+	EXPECT_EQ(1, volume.voxel(1, 2, 3).getColor());
+	EXPECT_EQ(2, volume.voxel(2, 2, 3).getColor());
+	EXPECT_EQ(VoxelType::Air, volume.voxel(3, 2, 3).getMaterial());
+	EXPECT_FALSE(volume.setVoxel(41, 0, 0, createVoxel(VoxelType::Generic, 1)));
+
+	EXPECT_TRUE(volume.setVoxel(1, 2, 3, Voxel()));
+	EXPECT_EQ(1u, volume.allocatedBricks());
+	EXPECT_TRUE(volume.setVoxel(2, 2, 3, Voxel()));
+	EXPECT_EQ(0u, volume.allocatedBricks()) << "The brick should get freed if it only contains empty voxels";
+}
+
+TEST_F(SparseVolumeTest, testRawVolumeConversion) {
+	RawVolume raw(Region(glm::ivec3(-5, 0, 3), glm::ivec3(60, 37, 40)));
+	fill(raw);
+	SparseVolume sparse(raw);
+	EXPECT_GT(sparse.allocatedBricks(), 0u);
+	std::unique_ptr<RawVolume> copy(sparse.toRawVolume());
+	ASSERT_EQ(raw.region(), copy->region());
+	const Region &region = raw.region();
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				ASSERT_TRUE(raw.voxel(x, y, z).isSame(sparse.voxel(x, y, z))) << x << ":" << y << ":" << z;
+				ASSERT_TRUE(raw.voxel(x, y, z).isSame(copy->voxel(x, y, z))) << x << ":" << y << ":" << z;
+			}
+		}
+	}
+}
+
+TEST_F(SparseVolumeTest, testSampler) {
+	RawVolume raw(Region(0, 35));
+	fill(raw);
+	SparseVolume sparse(raw);
+	RawVolume::Sampler rawSampler(raw);
+	SparseVolume::Sampler sparseSampler(sparse);
+	// walk over the brick and volume borders
+	for (int32_t z = -1; z <= 36; z += 3) {
+		for (int32_t x = -1; x <= 36; x += 2) {
+			rawSampler.setPosition(x, -1, z);
+			sparseSampler.setPosition(x, -1, z);
+			for (int32_t y = -1; y <= 36; ++y) {
+				ASSERT_EQ(rawSampler.position(), sparseSampler.position());
+				ASSERT_EQ(rawSampler.currentPositionValid(), sparseSampler.currentPositionValid());
+				ASSERT_TRUE(rawSampler.voxel().isSame(sparseSampler.voxel()));
+				ASSERT_TRUE(rawSampler.peekVoxel1nx1ny1nz().isSame(sparseSampler.peekVoxel1nx1ny1nz()));
+				ASSERT_TRUE(rawSampler.peekVoxel1px0py1nz().isSame(sparseSampler.peekVoxel1px0py1nz()));
+				ASSERT_TRUE(rawSampler.peekVoxel0px1py1pz().isSame(sparseSampler.peekVoxel0px1py1pz()));
+				ASSERT_TRUE(rawSampler.peekVoxel1px1py1pz().isSame(sparseSampler.peekVoxel1px1py1pz()));
+				ASSERT_TRUE(rawSampler.peekVoxel0px1ny0pz().isSame(sparseSampler.peekVoxel0px1ny0pz()));
+				rawSampler.movePositiveY();
+				sparseSampler.movePositiveY();
+			}
+		}
+	}
+
+	sparseSampler.setPosition(16, 16, 16);
+	sparseSampler.moveNegativeX();
+	sparseSampler.moveNegativeZ();
+	EXPECT_EQ(glm::ivec3(15, 16, 15), sparseSampler.position());
+	EXPECT_TRUE(raw.voxel(15, 16, 15).isSame(sparseSampler.voxel()));
+	EXPECT_TRUE(sparseSampler.setVoxel(createVoxel(VoxelType::Generic, 42)));
+	EXPECT_EQ(42, sparse.voxel(15, 16, 15).getColor());
+}
+
+TEST_F(SparseVolumeTest, testExtractCubicMesh) {
+	RawVolume raw(Region(0, 40));
+	fill(raw);
+	SparseVolume sparse(raw);
+	const Region region(1, 38);
+	Mesh expected;
+	extractCubicMesh(&raw, region, &expected, IsQuadNeeded(), region.getLowerCorner());
+	Mesh mesh;
+	extractCubicMesh(&sparse, region, &mesh, IsQuadNeeded(), region.getLowerCorner());
+	ASSERT_FALSE(expected.isEmpty());
+	ASSERT_EQ(expected.getNoOfVertices(), mesh.getNoOfVertices());
+	ASSERT_EQ(expected.getNoOfIndices(), mesh.getNoOfIndices());
+	for (size_t i = 0; i < expected.getNoOfIndices(); ++i) {
+		ASSERT_EQ(expected.getIndex((IndexType)i), mesh.getIndex((IndexType)i));
+	}
+}
+
+TEST_F(SparseVolumeTest, testMemoryUsage) {
+	const Region region(0, 511);
+	SparseVolume sparse(region);
+	for (int i = 0; i < 512; i += 64) {
+		sparse.setVoxel(i, i, i, createVoxel(VoxelType::Generic, 1));
+	}
+	EXPECT_EQ(8u, sparse.allocatedBricks());
+	const size_t rawSize = (size_t)region.voxels() * sizeof(Voxel);
+	EXPECT_LT(sparse.memoryUsageInBytes() * 100, rawSize);
+}
+
+} // namespace voxel
@@ -12,7 +12,7 @@
 #include "core/collection/DynamicArray.h"
 #include "core/collection/StringMap.h"
 #include "io/File.h"
-#include "io/FileStream.h"
+#include "io/MemoryMappedReadStream.h"
 #include "io/Filesystem.h"
 #include "io/MemoryReadStream.h"
 #include "io/ZipReadStream.h"
@@ -108,7 +108,7 @@ bool DatFormat::loadGroupsPalette(const core::String &filename, io::SeekableRead
 			continue;
 		}
 		futures.emplace_back(threadPool.enqueue([file]() {
-			io::FileStream stream(file);
+			io::MemoryMappedReadStream stream(file);
 			SceneGraph newSceneGraph;
 			if (stream.size() <= 2l * MCRFormat::SECTOR_BYTES) {
 				Log::debug("Skip empty region file %s", file->name().c_str());
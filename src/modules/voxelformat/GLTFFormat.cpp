@@ -14,7 +14,6 @@
 #include "core/Var.h"
 #include "core/collection/DynamicArray.h"
 #include "core/concurrent/Lock.h"
-#include "core/concurrent/ThreadPool.h"
 #include "engine-config.h"
 #include "image/Image.h"
 #include "io/Filesystem.h"
@@ -29,7 +28,6 @@
 #include "voxelformat/SceneGraphNode.h"
 #include "voxelutil/VoxelUtil.h"
 
-#include <future>
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -794,18 +792,21 @@ bool GLTFFormat::loadGlftAttributes(const core::String &filename, core::StringMa
 	return foundPosition;
 }
 
-bool GLTFFormat::subdivideShape(SceneGraphNode &node, const tinygltf::Model &model,
-								const core::DynamicArray<uint32_t> &indices,
-								const core::DynamicArray<GltfVertex> &vertices,
-								const core::StringMap<image::ImagePtr> &textures, const glm::vec3 offset,
-								const bool naiveImport) const {
+bool GLTFFormat::voxelizeShape(SceneGraphNode &node, const tinygltf::Model &model,
+							   const core::DynamicArray<uint32_t> &indices,
+							   const core::DynamicArray<GltfVertex> &vertices,
+							   const core::StringMap<image::ImagePtr> &textures, const glm::vec3 offset,
+							   const bool naiveImport) const {
 
 	const glm::vec3 &scale = getScale();
 	if (indices.size() % 3 != 0) {
 		Log::error("Unexpected amount of indices %i", (int)indices.size());
 		return false;
 	}
-	auto func = [&indices, &vertices, &textures, &scale, &offset, &naiveImport](size_t indexOffset) {
+	const size_t maxN = indices.size();
+	TriCollection tris;
+	tris.reserve(maxN / 3);
+	for (size_t indexOffset = 0; indexOffset < maxN; indexOffset += 3) {
 		Tri tri;
 		for (size_t i = 0; i < 3; ++i) {
 			const size_t idx = indices[i + indexOffset];
@@ -826,58 +827,34 @@ bool GLTFFormat::subdivideShape(SceneGraphNode &node, const tinygltf::Model &mod
 		} else {
 			Log::debug("No texture for vertex found");
 		}
-		TriCollection subdivided;
-
-		if (naiveImport) {
-			subdivided.push_back(tri);
-		} else {
-			subdivideTri(tri, subdivided);
-		}
-
-		return core::move(subdivided);
-	};
-
-	core::ThreadPool &threadPool = app::App::getInstance()->threadPool();
-	const bool fillHollow = core::Var::getSafe(cfg::VoxformatFillHollow)->boolVal();
-	const size_t maxN = indices.size();
-	core::DynamicArray<std::future<TriCollection>> futures;
-	futures.reserve(maxN / 3);
-	threadPool.reserve(futures.size());
-	for (size_t indexOffset = 0; indexOffset < maxN; indexOffset += 3) {
-		futures.emplace_back(threadPool.enqueue(func, indexOffset));
+		tris.push_back(tri);
 	}
 
+	const bool fillHollow = core::Var::getSafe(cfg::VoxformatFillHollow)->boolVal();
 	voxel::Palette palette;
 	voxel::RawVolume *volume = node.volume();
-	int n = 0;
-
-	for (auto &f : futures) {
-		const TriCollection &tris = f.get();
-		if (!tris.empty()) {
-			PosMap posMap;
-
-			if (naiveImport) {
-				glm::vec3 triMins = glm::round(tris[0].mins());
-				glm::vec3 triMaxs = glm::round(tris[0].maxs());
-				glm::ivec3 triDimensions = glm::max(glm::abs(triMaxs - triMins), 1.0f);
-				posMap = PosMap(triDimensions.x * triDimensions.y * triDimensions.z);
-				transformTrisNaive(tris, posMap);
-			} else {
-				posMap = PosMap((int)tris.size() * 3);
-				transformTris(tris, posMap);
-			}
+	auto setVoxel = [&palette, volume](const glm::ivec3 &pos, const glm::vec4 &color) {
+		int addedPaletteIndex;
+		palette.addColorToPalette(core::Color::getRGBA(color), false, addedPaletteIndex);
+		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, addedPaletteIndex);
+		volume->setVoxel(pos, voxel);
+	};
 
+	if (naiveImport) {
+		for (const Tri &tri : tris) {
+			const glm::vec3 triMins = glm::round(tri.mins());
+			const glm::vec3 triMaxs = glm::round(tri.maxs());
+			const glm::ivec3 triDimensions = glm::max(glm::abs(triMaxs - triMins), 1.0f);
+			PosMap posMap(triDimensions.x * triDimensions.y * triDimensions.z);
+			TriCollection single;
+			single.push_back(tri);
+			transformTrisNaive(single, posMap);
 			for (const auto &entry : posMap) {
-				const PosSampling &pos = entry->second;
-				const glm::vec4 &color = pos.avgColor();
-				int addedPaletteIndex;
-				palette.addColorToPalette(core::Color::getRGBA(color), false, addedPaletteIndex);
-				const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, addedPaletteIndex);
-				volume->setVoxel(entry->first, voxel);
+				setVoxel(entry->first, entry->second.avgColor());
 			}
 		}
-		++n;
-		Log::debug("%i/%i", n, (int)maxN / 3);
+	} else {
+		rasterizeTris(volume->region(), tris, setVoxel);
 	}
 	node.setPalette(palette);
 	if (fillHollow) {
@@ -1144,8 +1121,8 @@ bool GLTFFormat::loadGltfNode_r(const core::String &filename, SceneGraph &sceneG
 	voxel::RawVolume *volume = new voxel::RawVolume(region);
 	node.setVolume(volume, true);
 	int newParent = parentNodeId;
-	if (!subdivideShape(node, model, indices, vertices, textures, regionOffset, naiveImport)) {
-		Log::error("Failed to subdivide node %i", gltfNodeIdx);
+	if (!voxelizeShape(node, model, indices, vertices, textures, regionOffset, naiveImport)) {
+		Log::error("Failed to voxelize node %i", gltfNodeIdx);
 	} else {
 		newParent = sceneGraph.emplace(core::move(node), parentNodeId);
 		if (newParent == -1) {
@@ -1164,11 +1141,17 @@ bool GLTFFormat::loadGroups(const core::String &filename, io::SeekableReadStream
 	uint32_t magic;
 	stream.peekUInt32(magic);
 	const int64_t size = stream.size();
-	uint8_t *data = (uint8_t *)core_malloc(size);
-	if (stream.read(data, size) == -1) {
-		Log::error("Failed to read gltf stream");
-		core_free(data);
-		return false;
+	// memory streams are parsed without copying the data
+	const uint8_t *data = stream.data();
+	uint8_t *ownData = nullptr;
+	if (data == nullptr) {
+		ownData = (uint8_t *)core_malloc(size);
+		if (stream.read(ownData, size) == -1) {
+			Log::error("Failed to read gltf stream");
+			core_free(ownData);
+			return false;
+		}
+		data = ownData;
 	}
 
 	std::string err;
@@ -1192,7 +1175,7 @@ bool GLTFFormat::loadGroups(const core::String &filename, io::SeekableReadStream
 			Log::error("Failed to load ascii gltf file: %s", err.c_str());
 		}
 	}
-	core_free(data);
+	core_free(ownData);
 	if (!state) {
 		return false;
 	}
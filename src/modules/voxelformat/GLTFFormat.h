@@ -60,10 +60,10 @@ private:
 	size_t getGltfAccessorSize(const tinygltf::Accessor &accessor) const;
 	const tinygltf::Accessor *getGltfAccessor(const tinygltf::Model &model, int id) const;
 
-	bool subdivideShape(SceneGraphNode &node, const tinygltf::Model &model, const core::DynamicArray<uint32_t> &indices,
-						const core::DynamicArray<GltfVertex> &vertices,
-						const core::StringMap<image::ImagePtr> &textures, const glm::vec3 offset,
-						const bool naiveImport) const;
+	bool voxelizeShape(SceneGraphNode &node, const tinygltf::Model &model, const core::DynamicArray<uint32_t> &indices,
+					   const core::DynamicArray<GltfVertex> &vertices,
+					   const core::StringMap<image::ImagePtr> &textures, const glm::vec3 offset,
+					   const bool naiveImport) const;
 	void calculateAABB(const core::DynamicArray<GltfVertex> &vertices, glm::vec3 &mins, glm::vec3 &maxs) const;
 
 public:
@@ -3,10 +3,13 @@
  */
 
 #include "MCRFormat.h"
+#include "app/Parallel.h"
 #include "core/Color.h"
 #include "core/Common.h"
 #include "core/Log.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
+#include "core/concurrent/Atomic.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/StringMap.h"
 #include "io/File.h"
@@ -90,6 +93,9 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, io::SeekableRead
 }
 
 bool MCRFormat::loadMinecraftRegion(SceneGraph &sceneGraph, io::SeekableReadStream &stream, const voxel::Palette &palette) {
+	// the compressed chunks are read sequentially - decompressing and parsing them is done in parallel
+	core::DynamicArray<Chunk> chunks;
+	chunks.reserve(SECTOR_INTS);
 	for (int i = 0; i < SECTOR_INTS; ++i) {
 		if (_offsets[i].sectorCount == 0u || _offsets[i].offset < sizeof(_offsets)) {
 			continue;
@@ -100,16 +106,57 @@ bool MCRFormat::loadMinecraftRegion(SceneGraph &sceneGraph, io::SeekableReadStre
 		if (stream.seek(_offsets[i].offset) == -1) {
 			continue;
 		}
-		if (!readCompressedNBT(sceneGraph, stream, i, palette)) {
+		Chunk chunk;
+		chunk.sector = i;
+		if (!readCompressedNBT(stream, chunk)) {
 			Log::error("Failed to load minecraft chunk section %i for offset %u", i, (int)_offsets[i].offset);
 			return false;
 		}
+		if (chunk.data.empty()) {
+			continue;
+		}
+		chunks.emplace_back(core::move(chunk));
 	}
 
+	if (!parseChunks(chunks)) {
+		for (Chunk &chunk : chunks) {
+			delete chunk.volume;
+		}
+		return false;
+	}
+
+	for (Chunk &chunk : chunks) {
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		node.setVolume(chunk.volume, true);
+		node.setPalette(palette);
+		sceneGraph.emplace(core::move(node));
+	}
 	return true;
 }
 
-bool MCRFormat::readCompressedNBT(SceneGraph &sceneGraph, io::SeekableReadStream &stream, int sector, const voxel::Palette &palette) {
+bool MCRFormat::parseChunks(core::DynamicArray<Chunk> &chunks) {
+	core_trace_scoped(MCRParseChunks);
+	const int n = (int)chunks.size();
+	if (n == 0) {
+		return true;
+	}
+	core::AtomicBool failed{false};
+	Chunk *data = chunks.data();
+	app::for_parallel(n, [this, &failed, data](int i) {
+		if (failed) {
+			return;
+		}
+		Chunk &chunk = data[i];
+		chunk.volume = parseCompressedNBT(chunk);
+		if (chunk.volume == nullptr) {
+			Log::error("Failed to parse minecraft chunk section %i", chunk.sector);
+			failed = true;
+		}
+	});
+	return !failed;
+}
+
+bool MCRFormat::readCompressedNBT(io::SeekableReadStream &stream, Chunk &chunk) {
 	uint32_t nbtSize;
 	wrap(stream.readUInt32BE(nbtSize));
 	if (nbtSize == 0) {
@@ -132,35 +179,32 @@ bool MCRFormat::readCompressedNBT(SceneGraph &sceneGraph, io::SeekableReadStream
 	// the version is included in the length
 	--nbtSize;
 
-	io::ZipReadStream zipStream(stream, (int)nbtSize);
+	chunk.data.resize(nbtSize);
+	if (stream.read(chunk.data.data(), nbtSize) != (int)nbtSize) {
+		Log::error("Failed to read %u bytes of compressed nbt data", nbtSize);
+		return false;
+	}
+	return true;
+}
+
+voxel::RawVolume *MCRFormat::parseCompressedNBT(const Chunk &chunk) {
+	io::MemoryReadStream stream(chunk.data.data(), (uint32_t)chunk.data.size());
+	io::ZipReadStream zipStream(stream, (int)stream.size());
 	priv::NamedBinaryTagContext ctx;
 	ctx.stream = &zipStream;
 	const priv::NamedBinaryTag &root = priv::NamedBinaryTag::parse(ctx);
 	if (!root.valid()) {
 		Log::error("Could not parse nbt structure");
-		return false;
+		return nullptr;
 	}
 
-	voxel::RawVolume *volume;
 	// https://minecraft.fandom.com/wiki/Data_version
 	const int32_t dataVersion = root.get("DataVersion").int32();
 	Log::debug("Found data version %i", dataVersion);
 	if (dataVersion >= 2844) {
-		volume = parseSections(dataVersion, root, sector);
-		if (volume == nullptr) {
-			return false;
-		}
-	} else {
-		volume = parseLevelCompound(dataVersion, root, sector);
-		if (volume == nullptr) {
-			return false;
-		}
+		return parseSections(dataVersion, root, chunk.sector);
 	}
-	SceneGraphNode node(SceneGraphNodeType::Model);
-	node.setVolume(volume, true);
-	node.setPalette(palette);
-	sceneGraph.emplace(core::move(node));
-	return true;
+	return parseLevelCompound(dataVersion, root, chunk.sector);
 }
 
 int MCRFormat::getVoxel(int dataVersion, const priv::NamedBinaryTag &data, const glm::ivec3 &pos) {
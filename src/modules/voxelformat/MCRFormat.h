@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Format.h"
+#include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
 
 namespace io {
@@ -100,7 +101,18 @@ private:
 	// old version (< 2844)
 	voxel::RawVolume* parseLevelCompound(int dataVersion, const priv::NamedBinaryTag &root, int sector);
 
-	bool readCompressedNBT(SceneGraph& sceneGraph, io::SeekableReadStream &stream, int sector, const voxel::Palette &palette);
+	struct Chunk {
+		int sector = 0;
+		// the zlib or gzip compressed nbt data
+		core::Buffer<uint8_t> data;
+		voxel::RawVolume *volume = nullptr;
+	};
+	bool readCompressedNBT(io::SeekableReadStream &stream, Chunk &chunk);
+	voxel::RawVolume *parseCompressedNBT(const Chunk &chunk);
+	/**
+	 * @brief Decompresses and parses the chunks in parallel
+	 */
+	bool parseChunks(core::DynamicArray<Chunk> &chunks);
 	bool loadMinecraftRegion(SceneGraph& sceneGraph, io::SeekableReadStream &stream, const voxel::Palette &palette);
 
 	bool saveSections(const voxelformat::SceneGraph &sceneGraph, priv::NBTList &sections, int sector);
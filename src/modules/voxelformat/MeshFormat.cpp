@@ -4,17 +4,20 @@
 
 #include "MeshFormat.h"
 #include "app/App.h"
+#include "app/Parallel.h"
+#include "core/Assert.h"
 #include "core/Color.h"
 #include "core/GLM.h"
 #include "core/GameConfig.h"
 #include "core/Log.h"
+#include "core/NonCopyable.h"
 #include "core/Var.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/Map.h"
-#include "core/concurrent/Lock.h"
 #include "core/concurrent/ThreadPool.h"
 #include "voxel/CubicSurfaceExtractor.h"
 #include "voxel/IsQuadNeeded.h"
+#include "voxel/BinaryCubicSurfaceExtractor.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/PaletteLookup.h"
 #include "voxel/RawVolume.h"
@@ -22,9 +25,10 @@
 #include "voxelformat/SceneGraphNode.h"
 #include "voxelformat/private/Tri.h"
 #include "voxelutil/VoxelUtil.h"
-#include <SDL_timer.h>
 #include <glm/ext/scalar_constants.hpp>
 #include <glm/gtc/epsilon.hpp>
+#include <future>
+#include <unordered_map>
 
 namespace voxelformat {
 
@@ -56,53 +60,11 @@ glm::vec3 MeshFormat::getScale() {
 	return {scaleX, scaleY, scaleZ};
 }
 
-void MeshFormat::subdivideTri(const Tri &tri, TriCollection &tinyTris) {
+void MeshFormat::transformTrisNaive(const TriCollection &tris, PosMap &posMap) {
 	if (stopExecution()) {
 		return;
 	}
-	const glm::vec3 &mins = tri.mins();
-	const glm::vec3 &maxs = tri.maxs();
-	const glm::vec3 size = maxs - mins;
-	if (glm::any(glm::greaterThan(size, glm::vec3(1.0f)))) {
-		Tri out[4];
-		tri.subdivide(out);
-		for (int i = 0; i < lengthof(out); ++i) {
-			subdivideTri(out[i], tinyTris);
-		}
-		return;
-	}
-	tinyTris.push_back(tri);
-}
-
-void MeshFormat::transformTris(const TriCollection &subdivided, PosMap &posMap) {
-	if (stopExecution()) {
-		return;
-	}
-	Log::debug("subdivided into %i triangles", (int)subdivided.size());
-	for (const Tri &tri : subdivided) {
-		const glm::vec2 &uv = tri.centerUV();
-		const core::RGBA rgba = tri.colorAt(uv);
-		const float area = tri.area();
-		const glm::vec4 &color = core::Color::fromRGBA(rgba);
-		for (int v = 0; v < 3; v++) {
-			const glm::ivec3 p(glm::round(tri.vertices[v]));
-			auto iter = posMap.find(p);
-			if (iter == posMap.end()) {
-				posMap.emplace(p, {area, color});
-			} else if (iter->value.entries.size() < 4) {
-				PosSampling &pos = iter->value;
-				pos.entries.emplace_back(area, color);
-			}
-		}
-	}
-}
-
-void MeshFormat::transformTrisNaive(const TriCollection &subdivided, PosMap &posMap) {
-	if (stopExecution()) {
-		return;
-	}
-	Log::debug("subdivided into %i triangles", (int)subdivided.size());
-	for (const Tri &tri : subdivided) {
+	for (const Tri &tri : tris) {
 		const glm::vec2 &uv = tri.centerUV();
 		const core::RGBA rgba = tri.colorAt(uv);
 		const float area = tri.area();
@@ -143,20 +105,262 @@ void MeshFormat::transformTrisNaive(const TriCollection &subdivided, PosMap &pos
 	}
 }
 
-void MeshFormat::voxelizeTris(voxelformat::SceneGraphNode &node, const PosMap &posMap, bool fillHollow) {
+namespace {
+
+/**
+ * @brief Accumulates the colors of the triangles per voxel. The memory is only allocated for the bricks that are
+ * touched by a triangle.
+ */
+class VoxelizeGrid : public core::NonCopyable {
+private:
+	static constexpr int BrickBits = 4;
+	static constexpr int BrickSize = 1 << BrickBits;
+	static constexpr int BrickMask = BrickSize - 1;
+
+	struct Sample {
+		glm::vec4 color{0.0f};
+		float weight = 0.0f;
+	};
+	struct Brick {
+		Sample samples[BrickSize * BrickSize * BrickSize];
+	};
+
+	const voxel::Region _region;
+	const glm::ivec3 _bricks;
+	core::DynamicArray<Brick *> _data;
+
+	inline int brickIndex(const glm::ivec3 &brick) const {
+		return (brick.z * _bricks.y + brick.y) * _bricks.x + brick.x;
+	}
+
+	static inline int sampleIndex(const glm::ivec3 &local) {
+		return (((local.z & BrickMask) << BrickBits) + (local.y & BrickMask)) * BrickSize + (local.x & BrickMask);
+	}
+
+public:
+	VoxelizeGrid(const voxel::Region &region)
+		: _region(region), _bricks((region.getDimensionsInVoxels() + BrickMask) / BrickSize) {
+		_data.resize((size_t)_bricks.x * _bricks.y * _bricks.z);
+	}
+
+	~VoxelizeGrid() {
+		for (Brick *brick : _data) {
+			delete brick;
+		}
+	}
+
+	inline const voxel::Region &region() const {
+		return _region;
+	}
+
+	void add(const glm::ivec3 &pos, const glm::vec4 &color, float weight) {
+		const glm::ivec3 local = pos - _region.getLowerCorner();
+		Brick *&brick = _data[brickIndex(local >> BrickBits)];
+		if (brick == nullptr) {
+			brick = new Brick();
+		}
+		Sample &sample = brick->samples[sampleIndex(local)];
+		sample.color += color * weight;
+		sample.weight += weight;
+	}
+
+	/**
+	 * @brief Adds the samples of the given grid - the bricks that only exist in the other grid are moved over
+	 */
+	void merge(VoxelizeGrid &other) {
+		core_assert(_region == other._region);
+		for (size_t i = 0; i < _data.size(); ++i) {
+			Brick *src = other._data[i];
+			if (src == nullptr) {
+				continue;
+			}
+			if (_data[i] == nullptr) {
+				_data[i] = src;
+				other._data[i] = nullptr;
+				continue;
+			}
+			Brick *dst = _data[i];
+			for (int s = 0; s < lengthof(dst->samples); ++s) {
+				dst->samples[s].color += src->samples[s].color;
+				dst->samples[s].weight += src->samples[s].weight;
+			}
+		}
+	}
+
+	void visit(const MeshFormat::VoxelizeFunc &func) const {
+		const glm::ivec3 &mins = _region.getLowerCorner();
+		for (int i = 0; i < (int)_data.size(); ++i) {
+			const Brick *brick = _data[i];
+			if (brick == nullptr) {
+				continue;
+			}
+			const glm::ivec3 brickPos(i % _bricks.x, (i / _bricks.x) % _bricks.y, i / (_bricks.x * _bricks.y));
+			const glm::ivec3 brickMins = mins + brickPos * BrickSize;
+			for (int z = 0; z < BrickSize; ++z) {
+				for (int y = 0; y < BrickSize; ++y) {
+					for (int x = 0; x < BrickSize; ++x) {
+						const Sample &sample = brick->samples[sampleIndex(glm::ivec3(x, y, z))];
+						if (sample.weight <= 0.0f) {
+							continue;
+						}
+						glm::vec4 color = sample.color / sample.weight;
+						color.a = 1.0f;
+						func(brickMins + glm::ivec3(x, y, z), color);
+					}
+				}
+			}
+		}
+	}
+};
+
+/**
+ * @brief Separating axis test of a triangle against the unit box around the origin (Akenine-Moeller). The
+ * plane of the triangle is not tested here - the caller only visits voxels that intersect the plane.
+ * @param[in] v The triangle vertices relative to the center of the box
+ */
+bool triUnitBoxOverlap(const glm::vec3 v[3]) {
+	constexpr float halfSize = 0.5f;
+	// the face normals of the box
+	for (int i = 0; i < 3; ++i) {
+		const float mins = core_min(v[0][i], core_min(v[1][i], v[2][i]));
+		const float maxs = core_max(v[0][i], core_max(v[1][i], v[2][i]));
+		if (mins > halfSize || maxs < -halfSize) {
+			return false;
+		}
+	}
+	// the cross products of the triangle edges and the box axes
+	const glm::vec3 edges[3]{v[1] - v[0], v[2] - v[1], v[0] - v[2]};
+	for (int e = 0; e < 3; ++e) {
+		const glm::vec3 &edge = edges[e];
+		const glm::vec3 axes[3]{glm::vec3(0.0f, -edge.z, edge.y), glm::vec3(edge.z, 0.0f, -edge.x),
+								glm::vec3(-edge.y, edge.x, 0.0f)};
+		for (int a = 0; a < 3; ++a) {
+			const glm::vec3 &axis = axes[a];
+			const float p0 = glm::dot(axis, v[0]);
+			const float p1 = glm::dot(axis, v[1]);
+			const float p2 = glm::dot(axis, v[2]);
+			const float radius = halfSize * (glm::abs(axis.x) + glm::abs(axis.y) + glm::abs(axis.z));
+			if (core_min(p0, core_min(p1, p2)) > radius || core_max(p0, core_max(p1, p2)) < -radius) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void rasterizeTri(const Tri &tri, VoxelizeGrid &grid) {
+	const voxel::Region &region = grid.region();
+	const glm::vec3 &normal = tri.normal();
+	const glm::vec3 absNormal = glm::abs(normal);
+	// the voxel at the integer position p covers [p - 0.5, p + 0.5]
+	const glm::ivec3 mins = glm::max(glm::ivec3(glm::ceil(tri.mins() - 0.5f)), region.getLowerCorner());
+	const glm::ivec3 maxs = glm::min(glm::ivec3(glm::floor(tri.maxs() + 0.5f)), region.getUpperCorner());
+	if (glm::any(glm::greaterThan(mins, maxs))) {
+		return;
+	}
+	const glm::vec4 &triColor = core::Color::fromRGBA(tri.color);
+	auto colorAt = [&tri, &triColor](const glm::vec3 &pos) {
+		if (tri.texture == nullptr) {
+			return triColor;
+		}
+		return core::Color::fromRGBA(tri.colorAt(tri.uvAt(pos)));
+	};
+
+	const float maxAxis = core_max(absNormal.x, core_max(absNormal.y, absNormal.z));
+	if (maxAxis <= glm::epsilon<float>()) {
+		// degenerated triangle - only the vertices are set
+		for (int i = 0; i < 3; ++i) {
+			const glm::ivec3 pos(glm::round(tri.vertices[i]));
+			if (region.containsPoint(pos)) {
+				grid.add(pos, colorAt(tri.vertices[i]), 1.0f);
+			}
+		}
+		return;
+	}
+
+	// walk the columns along the dominant axis of the normal - the plane of the triangle only crosses a few
+	// voxels of each column
+	const int d = absNormal.x == maxAxis ? 0 : (absNormal.y == maxAxis ? 1 : 2);
+	const int u = (d + 1) % 3;
+	const int w = (d + 2) % 3;
+	const float planeDist = glm::dot(normal, tri.vertices[0]);
+	const float stepU = -normal[u] / normal[d];
+	const float stepW = -normal[w] / normal[d];
+	// the extent of the plane along the dominant axis over the footprint of a column
+	const float extent = 0.5f * (glm::abs(stepU) + glm::abs(stepW));
+
+	glm::ivec3 pos;
+	glm::vec3 v[3];
+	for (pos[u] = mins[u]; pos[u] <= maxs[u]; ++pos[u]) {
+		for (pos[w] = mins[w]; pos[w] <= maxs[w]; ++pos[w]) {
+			const float center = planeDist / normal[d] + stepU * (float)pos[u] + stepW * (float)pos[w];
+			const int first = core_max(mins[d], (int)glm::ceil(center - extent - 0.5f));
+			const int last = core_min(maxs[d], (int)glm::floor(center + extent + 0.5f));
+			for (pos[d] = first; pos[d] <= last; ++pos[d]) {
+				const glm::vec3 voxelCenter(pos);
+				for (int i = 0; i < 3; ++i) {
+					v[i] = tri.vertices[i] - voxelCenter;
+				}
+				if (!triUnitBoxOverlap(v)) {
+					continue;
+				}
+				grid.add(pos, colorAt(voxelCenter), 1.0f);
+			}
+		}
+	}
+}
+
+} // namespace
+
+void MeshFormat::rasterizeTris(const voxel::Region &region, const TriCollection &tris, const VoxelizeFunc &func) {
+	if (tris.empty() || !region.isValid()) {
+		return;
+	}
+	core::ThreadPool &threadPool = app::App::getInstance()->threadPool();
+	const size_t batches =
+		core_max((size_t)1, core_min(threadPool.size(), (tris.size() + RasterizeBatchSize - 1) / RasterizeBatchSize));
+	const size_t batchSize = (tris.size() + batches - 1) / batches;
+	Log::debug("rasterize %i triangles in %i batches", (int)tris.size(), (int)batches);
+
+	auto rasterizeBatch = [&tris, &region, batchSize](size_t batch) {
+		VoxelizeGrid *grid = new VoxelizeGrid(region);
+		const size_t end = core_min(tris.size(), (batch + 1) * batchSize);
+		for (size_t i = batch * batchSize; i < end; ++i) {
+			if ((i & 255) == 0 && stopExecution()) {
+				break;
+			}
+			rasterizeTri(tris[i], *grid);
+		}
+		return grid;
+	};
+	core::DynamicArray<std::future<VoxelizeGrid *>> futures;
+	futures.reserve(batches - 1);
+	for (size_t batch = 1; batch < batches; ++batch) {
+		futures.emplace_back(threadPool.enqueue(rasterizeBatch, batch));
+	}
+	// the first batch is handled by the calling thread
+	VoxelizeGrid *grid = rasterizeBatch(0);
+	for (size_t i = 0; i < futures.size(); ++i) {
+		std::future<VoxelizeGrid *> &future = futures[i];
+		// the thread pool might already be shut down
+		VoxelizeGrid *batchGrid = future.valid() ? future.get() : rasterizeBatch(i + 1);
+		grid->merge(*batchGrid);
+		delete batchGrid;
+	}
+	if (!stopExecution()) {
+		grid->visit(func);
+	}
+	delete grid;
+}
+
+void MeshFormat::voxelizeTris(voxelformat::SceneGraphNode &node, const TriCollection &tris, bool fillHollow) {
 	Log::debug("create voxels");
 	voxel::RawVolume *volume = node.volume();
 	voxel::PaletteLookup palLookup;
-	for (const auto &entry : posMap) {
-		if (stopExecution()) {
-			return;
-		}
-		const PosSampling &pos = entry->second;
-		const glm::vec4 &color = pos.avgColor();
+	rasterizeTris(volume->region(), tris, [&] (const glm::ivec3 &pos, const glm::vec4 &color) {
 		const uint8_t index = palLookup.findClosestIndex(color);
-		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, index);
-		volume->setVoxel(entry->first, voxel);
-	}
+		volume->setVoxel(pos, voxel::createVoxel(voxel::VoxelType::Generic, index));
+	});
 	node.setPalette(palLookup.palette());
 	if (fillHollow) {
 		Log::debug("fill hollows");
@@ -165,6 +369,74 @@ void MeshFormat::voxelizeTris(voxelformat::SceneGraphNode &node, const PosMap &p
 	}
 }
 
+void MeshFormat::splitRegion(const voxel::Region &region, int tileSize, core::DynamicArray<voxel::Region> &tiles) {
+	const glm::ivec3 &lower = region.getLowerCorner();
+	const glm::ivec3 &upper = region.getUpperCorner();
+	for (int32_t z = lower.z; z <= upper.z; z += tileSize) {
+		for (int32_t y = lower.y; y <= upper.y; y += tileSize) {
+			for (int32_t x = lower.x; x <= upper.x; x += tileSize) {
+				const glm::ivec3 tileLower(x, y, z);
+				const glm::ivec3 tileUpper = glm::min(tileLower + (tileSize - 1), upper);
+				tiles.emplace_back(tileLower, tileUpper);
+			}
+		}
+	}
+}
+
+void MeshFormat::mergeMeshes(const core::DynamicArray<voxel::Mesh *> &tiles, voxel::Mesh &out, bool reuseVertices) {
+	size_t vertices = 0u;
+	size_t indices = 0u;
+	for (const voxel::Mesh *tile : tiles) {
+		vertices += tile->getNoOfVertices();
+		indices += tile->getNoOfIndices();
+	}
+	out.getVertexVector().reserve(vertices);
+	out.getIndexVector().reserve(indices);
+
+	// the tiles don't overlap - so only the vertices on the bounds of a tile can also exist in another tile
+	std::unordered_map<uint64_t, voxel::IndexType> borderVertices;
+	core::DynamicArray<voxel::IndexType> remap;
+	for (const voxel::Mesh *tile : tiles) {
+		const size_t tileVertices = tile->getNoOfVertices();
+		if (tileVertices == 0u) {
+			continue;
+		}
+		glm::ivec3 mins(tile->getVertex(0).position);
+		glm::ivec3 maxs(mins);
+		for (size_t i = 1; i < tileVertices; ++i) {
+			const glm::ivec3 pos(tile->getVertex((voxel::IndexType)i).position);
+			mins = glm::min(mins, pos);
+			maxs = glm::max(maxs, pos);
+		}
+		remap.resize(tileVertices);
+		for (size_t i = 0; i < tileVertices; ++i) {
+			const voxel::VoxelVertex &vertex = tile->getVertex((voxel::IndexType)i);
+			const glm::ivec3 pos(vertex.position);
+			const bool border = glm::any(glm::equal(pos, mins)) || glm::any(glm::equal(pos, maxs));
+			if (!reuseVertices || !border) {
+				remap[i] = out.addVertex(vertex);
+				continue;
+			}
+			const uint64_t key = (uint64_t)(uint16_t)vertex.position.x | ((uint64_t)(uint16_t)vertex.position.y << 16) |
+								 ((uint64_t)(uint16_t)vertex.position.z << 32) | ((uint64_t)vertex.info << 48) |
+								 ((uint64_t)vertex.colorIndex << 56);
+			auto iter = borderVertices.find(key);
+			if (iter != borderVertices.end()) {
+				remap[i] = iter->second;
+				continue;
+			}
+			remap[i] = out.addVertex(vertex);
+			borderVertices.emplace(key, remap[i]);
+		}
+		const size_t tileIndices = tile->getNoOfIndices();
+		for (size_t i = 0; i + 2 < tileIndices; i += 3) {
+			out.addTriangle(remap[tile->getIndex((voxel::IndexType)i)], remap[tile->getIndex((voxel::IndexType)(i + 1))],
+							remap[tile->getIndex((voxel::IndexType)(i + 2))]);
+		}
+	}
+	out.compressIndices();
+}
+
 MeshFormat::MeshExt::MeshExt(voxel::Mesh *_mesh, const SceneGraphNode &node, bool _applyTransform)
 	: mesh(_mesh), name(node.name()), applyTransform(_applyTransform) {
 	size = node.region().getDimensionsInVoxels();
@@ -181,6 +453,7 @@ bool MeshFormat::saveGroups(const SceneGraph &sceneGraph, const core::String &fi
 	const bool mergeQuads = core::Var::getSafe(cfg::VoxformatMergequads)->boolVal();
 	const bool reuseVertices = core::Var::getSafe(cfg::VoxformatReusevertices)->boolVal();
 	const bool ambientOcclusion = core::Var::getSafe(cfg::VoxformatAmbientocclusion)->boolVal();
+	const bool binaryMesher = core::Var::getSafe(cfg::VoxelBinaryMesher)->boolVal();
 
 	const glm::vec3 &scale = getScale();
 
@@ -189,33 +462,70 @@ bool MeshFormat::saveGroups(const SceneGraph &sceneGraph, const core::String &fi
 	const bool withTexCoords = core::Var::getSafe(cfg::VoxformatWithtexcoords)->boolVal();
 	const bool applyTransform = core::Var::getSafe(cfg::VoxformatTransform)->boolVal();
 
-	const size_t models = sceneGraph.size();
-	core::ThreadPool &threadPool = app::App::getInstance()->threadPool();
-	Meshes meshes;
-	core::Map<int, int> meshIdxNodeMap;
-	core_trace_mutex(core::Lock, lock, "MeshFormat");
+	// the tiles of all nodes are extracted at once - a single big node is extracted on all cores, too
+	struct TileJob {
+		voxel::RawVolume *volume;
+		voxel::Region tile;
+		glm::ivec3 translate;
+	};
+	core::DynamicArray<const SceneGraphNode *> nodes;
+	core::DynamicArray<int> nodeTiles;
+	core::DynamicArray<TileJob> jobs;
+	core::DynamicArray<voxel::Region> tiles;
 	for (const SceneGraphNode &node : sceneGraph) {
-		auto lambda = [&]() {
-			voxel::Mesh *mesh = new voxel::Mesh();
-			voxel::Region region = node.region();
-			region.shiftUpperCorner(1, 1, 1);
-			voxel::extractCubicMesh(node.volume(), region, mesh, voxel::IsQuadNeeded(), glm::ivec3(0), mergeQuads,
+		voxel::Region region = node.region();
+		region.shiftUpperCorner(1, 1, 1);
+		tiles.clear();
+		splitRegion(region, ExtractionTileSize, tiles);
+		// decode a lazy loaded volume here - not concurrently in the tile tasks
+		voxel::RawVolume *volume = node.volume();
+		for (const voxel::Region &tile : tiles) {
+			// all tiles of a node are extracted relative to the lower corner of the node region
+			jobs.push_back(TileJob{volume, tile, tile.getLowerCorner() - region.getLowerCorner()});
+		}
+		nodes.push_back(&node);
+		nodeTiles.push_back((int)tiles.size());
+	}
+
+	// the calling thread extracts tiles, too - this is also called from within tasks of the thread pool (autosave)
+	// and must not wait for tasks that might never get a free worker
+	core::DynamicArray<voxel::Mesh *> extracted;
+	extracted.resize(jobs.size());
+	app::for_parallel((int)jobs.size(), [&](int i) {
+		const TileJob &job = jobs[i];
+		voxel::Mesh *mesh = new voxel::Mesh();
+		if (binaryMesher) {
+			voxel::extractBinaryCubicMesh(job.volume, job.tile, mesh, job.translate, mergeQuads, reuseVertices,
+										  ambientOcclusion);
+		} else {
+			voxel::extractCubicMesh(job.volume, job.tile, mesh, voxel::IsQuadNeeded(), job.translate, mergeQuads,
 									reuseVertices, ambientOcclusion);
-			core::ScopedLock scoped(lock);
-			meshes.emplace_back(mesh, node, applyTransform);
-			meshIdxNodeMap.put(node.id(), (int)meshes.size() - 1);
-		};
-		threadPool.enqueue(lambda);
-	}
-	for (;;) {
-		lock.lock();
-		const size_t size = meshes.size();
-		lock.unlock();
-		if (size < models) {
-			SDL_Delay(10);
+		}
+		extracted[i] = mesh;
+	});
+
+	Meshes meshes;
+	core::Map<int, int> meshIdxNodeMap;
+	core::DynamicArray<voxel::Mesh *> tileMeshes;
+	size_t tileIdx = 0;
+	for (size_t n = 0; n < nodes.size(); ++n) {
+		tileMeshes.clear();
+		for (int i = 0; i < nodeTiles[n]; ++i) {
+			tileMeshes.push_back(extracted[tileIdx++]);
+		}
+		voxel::Mesh *mesh;
+		if (tileMeshes.size() == 1) {
+			mesh = tileMeshes[0];
 		} else {
-			break;
+			mesh = new voxel::Mesh();
+			mergeMeshes(tileMeshes, *mesh, reuseVertices);
+			mesh->setOffset(nodes[n]->region().getLowerCorner());
+			for (voxel::Mesh *tileMesh : tileMeshes) {
+				delete tileMesh;
+			}
 		}
+		meshes.emplace_back(mesh, *nodes[n], applyTransform);
+		meshIdxNodeMap.put(nodes[n]->id(), (int)meshes.size() - 1);
 	}
 	Log::debug("Save meshes");
 	const bool state =
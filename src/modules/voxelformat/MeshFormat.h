@@ -7,6 +7,7 @@
 #include "Format.h"
 #include "private/Tri.h"
 #include <glm/geometric.hpp>
+#include <functional>
 
 namespace voxelformat {
 
@@ -35,6 +36,23 @@ protected:
 	static glm::vec3 getScale();
 
 public:
+	/**
+	 * @brief Volumes that are bigger than this on any axis are split into tiles that are extracted in parallel
+	 * @sa saveGroups()
+	 */
+	static constexpr int ExtractionTileSize = 128;
+
+	/**
+	 * @brief Splits the given region into tiles with at most @c tileSize voxels on each axis
+	 */
+	static void splitRegion(const voxel::Region &region, int tileSize, core::DynamicArray<voxel::Region> &tiles);
+	/**
+	 * @brief Appends the vertices and indices of the given tile meshes to the given mesh. The tiles must
+	 * have been extracted with the same translation relative to the origin of @c out.
+	 * @param[in] reuseVertices Merge the vertices on the borders of the tiles that are equal
+	 */
+	static void mergeMeshes(const core::DynamicArray<voxel::Mesh *> &tiles, voxel::Mesh &out, bool reuseVertices);
+
 	using TriCollection = core::DynamicArray<Tri, 512>;
 
 	struct PosSamplingEntry {
@@ -73,12 +91,31 @@ public:
 	typedef core::Map<glm::ivec3, PosSampling, 64, glm::hash<glm::ivec3>> PosMap;
 
 	/**
-	 * Subdivide until we brought the triangles down to the size of 1 or smaller
+	 * @brief Amount of triangles that are at least rasterized by one task of the thread pool
+	 * @sa rasterizeTris()
+	 */
+	static constexpr size_t RasterizeBatchSize = 1024;
+
+	/**
+	 * @param[in] pos The position of the voxel
+	 * @param[in] color The averaged color of all triangles that touch the voxel
+	 */
+	using VoxelizeFunc = std::function<void(const glm::ivec3 &pos, const glm::vec4 &color)>;
+
+	/**
+	 * @brief Conservative rasterization of the triangles into the given region. A voxel is set if the unit box
+	 * around its position overlaps a triangle (separating axis test). The colors are accumulated per voxel in a
+	 * sparse brick grid - the triangles are rasterized in batches in parallel.
+	 * @note Don't call this from a task of the thread pool - it waits for the batches that are queued there.
+	 * @param[in] func Called once for every voxel that is touched by at least one triangle
+	 */
+	static void rasterizeTris(const voxel::Region &region, const TriCollection &tris, const VoxelizeFunc &func);
+	/**
+	 * @brief Rasterizes the triangles into the volume of the given node and assigns the closest palette colors
+	 * @sa rasterizeTris()
 	 */
-	static void subdivideTri(const Tri &tri, TriCollection &tinyTris);
-	static void voxelizeTris(voxelformat::SceneGraphNode &node, const PosMap &posMap, bool hillHollow);
-	static void transformTris(const TriCollection &subdivided, PosMap &posMap);
-	static void transformTrisNaive(const TriCollection &subdivided, PosMap &posMap);
+	static void voxelizeTris(voxelformat::SceneGraphNode &node, const TriCollection &tris, bool fillHollow);
+	static void transformTrisNaive(const TriCollection &tris, PosMap &posMap);
 
 	bool loadGroups(const core::String &filename, io::SeekableReadStream &file, SceneGraph &sceneGraph) override;
 	bool saveGroups(const SceneGraph &sceneGraph, const core::String &filename,
@@ -8,7 +8,6 @@
 #include "core/Log.h"
 #include "core/SharedPtr.h"
 #include "core/StringUtil.h"
-#include "core/concurrent/ThreadPool.h"
 #include "core/Var.h"
 #include "core/collection/StringMap.h"
 #include "core/collection/DynamicArray.h"
@@ -199,9 +198,9 @@ bool OBJFormat::saveMeshes(const core::Map<int, int> &, const SceneGraph &sceneG
 
 #undef wrapBool
 
-void OBJFormat::subdivideShape(const tinyobj::mesh_t &mesh, const core::StringMap<image::ImagePtr> &textures,
-							  const tinyobj::attrib_t &attrib, const std::vector<tinyobj::material_t> &materials,
-							  TriCollection &subdivided) {
+void OBJFormat::collectTris(const tinyobj::mesh_t &mesh, const core::StringMap<image::ImagePtr> &textures,
+							const tinyobj::attrib_t &attrib, const std::vector<tinyobj::material_t> &materials,
+							TriCollection &tris) {
 	const glm::vec3 &scale = getScale();
 	int indexOffset = 0;
 	for (size_t faceNum = 0; faceNum < mesh.num_face_vertices.size(); ++faceNum) {
@@ -235,7 +234,7 @@ void OBJFormat::subdivideShape(const tinyobj::mesh_t &mesh, const core::StringMa
 		}
 
 		indexOffset += faceVertices;
-		subdivideTri(tri, subdivided);
+		tris.push_back(tri);
 	}
 }
 
@@ -337,45 +336,30 @@ bool OBJFormat::loadGroups(const core::String &filename, io::SeekableReadStream
 		}
 	}
 
-	core::DynamicArray<std::future<SceneGraphNode>> futures;
-	futures.reserve(shapes.size());
-
-	core::ThreadPool &threadPool = app::App::getInstance()->threadPool();
+	// the shapes are voxelized one after another - the triangles of each shape are rasterized in parallel
 	const bool fillHollow = core::Var::getSafe(cfg::VoxformatFillHollow)->boolVal();
 	for (tinyobj::shape_t &shape : shapes) {
-		auto func = [&shape, attrib, materials, &textures](bool fillHollow) {
-			glm::vec3 mins;
-			glm::vec3 maxs;
-			calculateAABB(shape.mesh, attrib, mins, maxs);
-			voxel::Region region(glm::floor(mins), glm::ceil(maxs));
-			const glm::ivec3 &vdim = region.getDimensionsInVoxels();
-			if (glm::any(glm::greaterThan(vdim, glm::ivec3(512)))) {
-				Log::warn("Large meshes will take a lot of time and use a lot of memory. Consider scaling the mesh! "
-						  "(%i:%i:%i)",
-						  vdim.x, vdim.y, vdim.z);
-			}
+		glm::vec3 mins;
+		glm::vec3 maxs;
+		calculateAABB(shape.mesh, attrib, mins, maxs);
+		voxel::Region region(glm::floor(mins), glm::ceil(maxs));
+		const glm::ivec3 &vdim = region.getDimensionsInVoxels();
+		if (glm::any(glm::greaterThan(vdim, glm::ivec3(512)))) {
+			Log::warn("Large meshes will take a lot of time and use a lot of memory. Consider scaling the mesh! "
+					  "(%i:%i:%i)",
+					  vdim.x, vdim.y, vdim.z);
+		}
 
-			voxel::RawVolume *volume = new voxel::RawVolume(region);
-			SceneGraphNode node;
-			node.setVolume(volume, true);
-			node.setName(shape.name.c_str());
-			TriCollection subdivided;
-			subdivideShape(shape.mesh, textures, attrib, materials, subdivided);
-			if (!subdivided.empty()) {
-				PosMap posMap((int)subdivided.size() * 3);
-				transformTris(subdivided, posMap);
-				voxelizeTris(node, posMap, fillHollow);
-			}
-			return core::move(node);
-		};
-		if (shapes.size() > 1) {
-			futures.emplace_back(threadPool.enqueue(func, fillHollow));
-		} else {
-			sceneGraph.emplace(func(fillHollow));
+		voxel::RawVolume *volume = new voxel::RawVolume(region);
+		SceneGraphNode node;
+		node.setVolume(volume, true);
+		node.setName(shape.name.c_str());
+		TriCollection tris;
+		collectTris(shape.mesh, textures, attrib, materials, tris);
+		if (!tris.empty()) {
+			voxelizeTris(node, tris, fillHollow);
 		}
-	}
-	for (auto & f : futures) {
-		sceneGraph.emplace(core::move(f.get()));
+		sceneGraph.emplace(core::move(node));
 	}
 
 	sceneGraph.updateTransforms();
@@ -12,6 +12,8 @@
 #include "core/Assert.h"
 #include "io/FileStream.h"
 #include "io/BufferedZipReadStream.h"
+#include "io/MemoryReadStream.h"
+#include "core/SharedPtr.h"
 #include "voxel/MaterialColor.h"
 #include "core/Log.h"
 #include "voxel/Palette.h"
@@ -48,6 +50,12 @@ const int NODE_TYPE_COMPOUND = 2;
 		return false; \
 	}
 
+#define wrapVolume(read) \
+	if ((read) != 0) { \
+		Log::error("Could not load qbt matrix: Not enough data in stream " CORE_STRINGIFY(read) " (line %i)", (int)__LINE__); \
+		return nullptr; \
+	}
+
 #define wrapBool(read) \
 	if ((read) == false) { \
 		Log::error("Could not load qbt file: Not enough data in stream " CORE_STRINGIFY(read) " (line %i)", (int)__LINE__); \
@@ -346,31 +354,53 @@ bool QBTFormat::loadMatrix(io::SeekableReadStream& stream, SceneGraph& sceneGrap
 		Log::warn("Size of matrix results in empty space");
 		return false;
 	}
-	const uint32_t voxelDataSizeDecompressed = size.x * size.y * size.z * sizeof(uint32_t);
-	io::BufferedZipReadStream zipStream(stream, voxelDataSize, voxelDataSizeDecompressed * 2);
-
 	const voxel::Region region(glm::ivec3(0), glm::ivec3(size) - 1);
 	if (!region.isValid()) {
 		Log::error("Invalid region");
 		return false;
 	}
+	// only the compressed voxel data is kept in memory - it's decompressed when the volume is accessed
+	const core::SharedPtr<io::MemoryReadStream> voxelData = core::make_shared<io::MemoryReadStream>(stream, voxelDataSize);
+	if (voxelData->size() != (int64_t)voxelDataSize) {
+		Log::error("Failed to read the voxel data of matrix %s", name);
+		return false;
+	}
+	voxel::PaletteLookup palLookup(palette);
+	SceneGraphNode node;
+	node.setVolumeLoader(region, [voxelData, voxelDataSize, region, palette]() {
+		return loadMatrixVolume(*voxelData.get(), voxelDataSize, region, palette);
+	});
+	node.setName(name);
+	node.setPalette(palLookup.palette());
+	node.setTransform(0, transform);
+	const int id = sceneGraph.emplace(core::move(node), parent);
+	return id != -1;
+}
+
+voxel::RawVolume *QBTFormat::loadMatrixVolume(io::SeekableReadStream &stream, uint32_t voxelDataSize,
+										   const voxel::Region &region, const voxel::Palette &palette) {
+	const glm::ivec3 &size = region.getDimensionsInVoxels();
+	const uint32_t voxelDataSizeDecompressed = size.x * size.y * size.z * sizeof(uint32_t);
+	stream.seek(0);
+	io::BufferedZipReadStream zipStream(stream, voxelDataSize, voxelDataSizeDecompressed * 2);
+	const bool colorMap = palette.colorCount > 0;
 	voxel::PaletteLookup palLookup(palette);
 	core::ScopedPtr<voxel::RawVolume> volume(new voxel::RawVolume(region));
-	for (int32_t x = 0; x < (int)size.x; x++) {
-		for (int32_t z = 0; z < (int)size.z; z++) {
-			for (int32_t y = 0; y < (int)size.y; y++) {
+	for (int32_t x = 0; x < size.x; x++) {
+		for (int32_t z = 0; z < size.z; z++) {
+			for (int32_t y = 0; y < size.y; y++) {
 				uint8_t red;
-				wrap(zipStream.readUInt8(red))
+				wrapVolume(zipStream.readUInt8(red))
 				uint8_t green;
-				wrap(zipStream.readUInt8(green))
+				wrapVolume(zipStream.readUInt8(green))
 				uint8_t blue;
-				wrap(zipStream.readUInt8(blue))
+				wrapVolume(zipStream.readUInt8(blue))
 				uint8_t mask;
-				wrap(zipStream.readUInt8(mask))
+				wrapVolume(zipStream.readUInt8(mask))
 				if (mask == 0u) {
 					continue;
 				}
-				if (palette.colorCount > 0) {
+				if (colorMap) {
 					const voxel::Voxel& voxel = voxel::createVoxel(voxel::VoxelType::Generic, red);
 					volume->setVoxel(x, y, z, voxel);
 				} else {
@@ -382,13 +412,7 @@ bool QBTFormat::loadMatrix(io::SeekableReadStream& stream, SceneGraph& sceneGrap
 			}
 		}
 	}
-	SceneGraphNode node;
-	node.setVolume(volume.release(), true);
-	node.setName(name);
-	node.setPalette(palLookup.palette());
-	node.setTransform(0, transform);
-	const int id = sceneGraph.emplace(core::move(node), parent);
-	return id != -1;
+	return volume.release();
 }
 
 /**
@@ -563,6 +587,7 @@ bool QBTFormat::loadGroupsPalette(const core::String &filename, io::SeekableRead
 #undef wrapSave
 #undef wrapSaveFree
 #undef wrap
+#undef wrapVolume
 #undef wrapBool
 
 }
@@ -23,6 +23,11 @@ class QBTFormat : public PaletteFormat {
 private:
 	bool skipNode(io::SeekableReadStream& stream);
 	bool loadMatrix(io::SeekableReadStream& stream, SceneGraph &sceneGraph, int parent, voxel::Palette &palette);
+	/**
+	 * @brief Decompresses the voxel data of a matrix - called on the first access to the volume of the node
+	 */
+	static voxel::RawVolume *loadMatrixVolume(io::SeekableReadStream &stream, uint32_t voxelDataSize,
+											  const voxel::Region &region, const voxel::Palette &palette);
 	bool loadCompound(io::SeekableReadStream& stream, SceneGraph &sceneGraph, int parent, voxel::Palette &palette);
 	bool loadModel(io::SeekableReadStream& stream, SceneGraph &sceneGraph, int parent, voxel::Palette &palette);
 	bool loadNode(io::SeekableReadStream& stream, SceneGraph &sceneGraph, int parent, voxel::Palette &palette);
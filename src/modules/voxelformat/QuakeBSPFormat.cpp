@@ -3,7 +3,6 @@
  */
 
 #include "QuakeBSPFormat.h"
-#include "app/App.h"
 #include "core/Trace.h"
 #include "core/collection/Buffer.h"
 #include "image/Image.h"
@@ -15,18 +14,12 @@
 #include "core/StandardLib.h"
 #include "core/StringUtil.h"
 #include "core/Var.h"
-#include "core/collection/ConcurrentQueue.h"
 #include "core/collection/DynamicArray.h"
-#include "core/concurrent/Concurrency.h"
-#include "core/concurrent/Lock.h"
-#include "core/concurrent/ThreadPool.h"
 #include "voxel/PaletteLookup.h"
 #include "voxel/RawVolume.h"
 #include "voxel/RawVolumeWrapper.h"
 #include "voxelformat/SceneGraphNode.h"
 #include "voxelutil/VoxelUtil.h"
-#include <SDL_timer.h>
-#include <future>
 
 namespace voxelformat {
 
@@ -711,65 +704,27 @@ bool QuakeBSPFormat::voxelize(const core::DynamicArray<Texture> &textures, const
 	node.setVolume(volume, true);
 	node.setName(name);
 
-	core::ConcurrentQueue<Tri> producerTris(10000);
-	core_trace_mutex(core::Lock, voxelLock, "trilock");
-
+	TriCollection tris;
+	tris.reserve(numIndices / 3);
 	for (int i = 0; i < numIndices; i += 3) {
 		Tri tri;
 		for (int k = 0; k < 3; ++k) {
 			const int idx = indices[i + k];
-			tri.vertices[k] = verts[idx] * scale;
+			const glm::vec3 &vert = verts[idx] * scale;
+			// the region is already in the swapped coordinate system
+			tri.vertices[k] = glm::vec3(vert.x, vert.z, vert.y);
 			tri.uv[k] = texcoords[idx];
 		}
 		const int textureIdx = textureIndices[indices[i]];
 		const Texture &texture = textures[textureIdx];
 		tri.texture = texture.image.get();
-		producerTris.push(tri);
-	}
-
-	auto func = [&producerTris, &palLookup, volume, &voxelLock] () {
-		Tri tri;
-		while (producerTris.pop(tri)) {
-			TriCollection subdiv;
-			subdiv.reserve(1024);
-			subdivideTri(tri, subdiv);
-			if (subdiv.empty()) {
-				continue;
-			}
-			PosMap posMap((int)subdiv.size() * 3);
-			transformTris(subdiv, posMap);
-			Log::debug("assembling volume (%i)", (int)posMap.size());
-			core::ScopedLock<core::Lock> scoped(voxelLock);
-			for (const auto &entry : posMap) {
-				const PosSampling &pos = entry->second;
-				const glm::vec4 &color = pos.avgColor();
-				const uint8_t index = palLookup.findClosestIndex(color);
-				const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, index);
-				const glm::ivec3 &vpos = entry->first;
-				volume->setVoxel(vpos.x, vpos.z, vpos.y, voxel);
-			}
-			Log::debug("assembling volume done");
-		}
-	};
-
-	core::ThreadPool &threadPool = app::App::getInstance()->threadPool();
-	core::DynamicArray<std::future<void>> futures;
-	for (uint32_t i = 0; i < core::cpus(); ++i) {
-		futures.emplace_back(threadPool.enqueue(func));
+		tris.push_back(tri);
 	}
 
-	while (!producerTris.empty()) {
-		SDL_Delay(1000);
-		Log::debug("%i tris left", (int)producerTris.size());
-		if (stopExecution()) {
-			break;
-		}
-	}
-
-	for (auto &f : futures) {
-		f.get();
-	}
-	futures.clear();
+	rasterizeTris(region, tris, [&palLookup, volume](const glm::ivec3 &pos, const glm::vec4 &color) {
+		const uint8_t index = palLookup.findClosestIndex(color);
+		volume->setVoxel(pos, voxel::createVoxel(voxel::VoxelType::Generic, index));
+	});
 
 	node.setPalette(palLookup.palette());
 	if (fillHollow) {
@@ -17,7 +17,7 @@ namespace priv {
 static constexpr const size_t BinaryHeaderSize = 80;
 }
 
-void STLFormat::subdivideShape(const core::DynamicArray<Face> &faces, TriCollection &subdivided) {
+void STLFormat::collectTris(const core::DynamicArray<Face> &faces, TriCollection &tris) {
 	const glm::vec3 &scale = getScale();
 
 	for (const Face &face : faces) {
@@ -28,8 +28,7 @@ void STLFormat::subdivideShape(const core::DynamicArray<Face> &faces, TriCollect
 			tri.vertices[i].z = face.tri[i].z * scale.z;
 			tri.uv[i] = glm::vec2(0.0f);
 		}
-
-		subdivideTri(tri, subdivided);
+		tris.push_back(tri);
 	}
 }
 
@@ -178,16 +177,14 @@ bool STLFormat::loadGroups(const core::String &filename, io::SeekableReadStream
 	SceneGraphNode node;
 	node.setVolume(volume, true);
 	node.setName(filename);
-	TriCollection subdivided;
-	subdivideShape(faces, subdivided);
-	if (subdivided.empty()) {
+	TriCollection tris;
+	collectTris(faces, tris);
+	if (tris.empty()) {
 		Log::warn("Empty volume");
 		return false;
 	}
-	PosMap posMap((int)subdivided.size() * 3);
-	transformTris(subdivided, posMap);
 	const bool fillHollow = core::Var::getSafe(cfg::VoxformatFillHollow)->boolVal();
-	voxelizeTris(node, posMap, fillHollow);
+	voxelizeTris(node, tris, fillHollow);
 	sceneGraph.emplace(core::move(node));
 	sceneGraph.updateTransforms();
 	return true;
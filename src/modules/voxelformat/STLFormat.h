@@ -37,7 +37,7 @@ private:
 	};
 
 	static void calculateAABB(const core::DynamicArray<Face> &faces, glm::vec3 &mins, glm::vec3 &maxs);
-	static void subdivideShape(const core::DynamicArray<Face> &faces, TriCollection &subdivided);
+	static void collectTris(const core::DynamicArray<Face> &faces, TriCollection &tris);
 
 	bool writeVertex(io::SeekableWriteStream &stream, const MeshExt &meshExt, const voxel::VoxelVertex &v1, const SceneGraphTransform &transform, const glm::vec3 &scale);
 
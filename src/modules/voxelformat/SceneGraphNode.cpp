@@ -6,6 +6,7 @@
 #include "core/Assert.h"
 #include "core/Log.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include <glm/gtc/epsilon.hpp>
 #include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
@@ -279,6 +280,9 @@ glm::vec3 SceneGraphTransform::apply(const glm::vec3 &pos, const glm::vec3 &size
 SceneGraphNode::SceneGraphNode(SceneGraphNode &&move) noexcept {
 	_volume = move._volume;
 	move._volume = nullptr;
+	_volumeLoader = core::move(move._volumeLoader);
+	move._volumeLoader = nullptr;
+	_volumeRegion = move._volumeRegion;
 	_name = core::move(move._name);
 	_id = move._id;
 	move._id = -1;
@@ -300,6 +304,9 @@ SceneGraphNode &SceneGraphNode::operator=(SceneGraphNode &&move) noexcept {
 	}
 	setVolume(move._volume, move._flags & VolumeOwned);
 	move._volume = nullptr;
+	_volumeLoader = core::move(move._volumeLoader);
+	move._volumeLoader = nullptr;
+	_volumeRegion = move._volumeRegion;
 	_name = core::move(move._name);
 	_id = move._id;
 	move._id = -1;
@@ -344,6 +351,7 @@ void SceneGraphNode::release() {
 		delete _volume;
 	}
 	_volume = nullptr;
+	_volumeLoader = nullptr;
 }
 
 void SceneGraphNode::releaseOwnership() {
@@ -370,8 +378,41 @@ void SceneGraphNode::setVolume(const voxel::RawVolume *volume, bool transferOwne
 	_volume = (voxel::RawVolume *)volume;
 }
 
+void SceneGraphNode::setVolumeLoader(const voxel::Region &region, VolumeLoader &&loader) {
+	release();
+	_flags |= VolumeOwned;
+	_volumeRegion = region;
+	_volumeLoader = core::move(loader);
+}
+
+void SceneGraphNode::takeVolume(SceneGraphNode &source) {
+	core_assert(source.hasPendingVolume() || source.owns());
+	if (source.hasPendingVolume()) {
+		setVolumeLoader(source._volumeRegion, core::move(source._volumeLoader));
+		source._volumeLoader = nullptr;
+		return;
+	}
+	setVolume(source._volume, true);
+	source.releaseOwnership();
+}
+
+void SceneGraphNode::loadVolume() const {
+	core_trace_scoped(SceneGraphNodeLoadVolume);
+	const VolumeLoader loader = core::move(_volumeLoader);
+	_volumeLoader = nullptr;
+	_volume = loader();
+	if (_volume == nullptr) {
+		Log::error("Failed to load the volume of node '%s'", _name.c_str());
+		return;
+	}
+	core_assert_msg(_volume->region() == _volumeRegion, "The loaded volume doesn't match the announced region");
+}
+
 const voxel::Region &SceneGraphNode::region() const {
 	if (_volume == nullptr) {
+		if (_volumeLoader) {
+			return _volumeRegion;
+		}
 		return voxel::Region::InvalidRegion;
 	}
 	return _volume->region();
@@ -18,6 +18,7 @@
 #include <glm/vec3.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
+#include <functional>
 
 namespace voxel {
 class RawVolume;
@@ -182,6 +183,12 @@ public:
 	SceneGraphNode(SceneGraphNode &&move) noexcept;
 	SceneGraphNode &operator=(SceneGraphNode &&move) noexcept;
 
+	/**
+	 * @brief Decodes the voxels of a node on first access
+	 * @sa setVolumeLoader()
+	 */
+	using VolumeLoader = std::function<voxel::RawVolume *()>;
+
 protected:
 	/**
 	 * this will ensure that we are releasing the volume memory in this instance
@@ -198,7 +205,9 @@ protected:
 	core::RGBA _color;
 
 	core::String _name;
-	voxel::RawVolume *_volume = nullptr;
+	mutable voxel::RawVolume *_volume = nullptr;
+	mutable VolumeLoader _volumeLoader;
+	voxel::Region _volumeRegion;
 	SceneGraphKeyFrames _keyFrames;
 	core::Buffer<int, 32> _children;
 	core::StringMap<core::String> _properties;
@@ -208,6 +217,7 @@ protected:
 	 * @brief Called in emplace() if a parent id is given
 	 */
 	void setParent(int id);
+	void loadVolume() const;
 
 public:
 	~SceneGraphNode() { release(); }
@@ -284,6 +294,25 @@ public:
 	 * you are going to manage the instance on your own.
 	 */
 	void setVolume(const voxel::RawVolume *volume, bool transferOwnership);
+	/**
+	 * @brief Defers the decoding of the voxels until the volume is accessed for the first time. This allows to
+	 * inspect the scene graph without paying the memory for the volumes that are never used. The node takes the
+	 * ownership of the decoded volume.
+	 * @param region The region of the volume that the loader returns - available without decoding the voxels
+	 * @note The loader is executed by the thread that accesses the volume first - if several threads might access
+	 * a node with a pending volume, fetch the volume before handing the node over.
+	 * @note voxelformat::loadFormat() decodes the volumes before it returns - unless the caller opts into lazy volumes
+	 */
+	void setVolumeLoader(const voxel::Region &region, VolumeLoader &&loader);
+	/**
+	 * @brief Takes over the volume and its ownership from the given node. A volume that was not yet decoded
+	 * is handed over as pending volume.
+	 */
+	void takeVolume(SceneGraphNode &source);
+	/**
+	 * @return @c true if the voxels of this node were not yet decoded
+	 */
+	bool hasPendingVolume() const;
 
 	void translate(const glm::ivec3 &v, FrameIndex frameIdx = -1);
 
@@ -379,6 +408,9 @@ inline voxel::RawVolume *SceneGraphNode::volume() const {
 	if (_type != SceneGraphNodeType::Model) {
 		return nullptr;
 	}
+	if (_volume == nullptr && _volumeLoader) {
+		loadVolume();
+	}
 	return _volume;
 }
 
@@ -386,9 +418,16 @@ inline voxel::RawVolume *SceneGraphNode::volume() {
 	if (_type != SceneGraphNodeType::Model) {
 		return nullptr;
 	}
+	if (_volume == nullptr && _volumeLoader) {
+		loadVolume();
+	}
 	return _volume;
 }
 
+inline bool SceneGraphNode::hasPendingVolume() const {
+	return _volume == nullptr && _volumeLoader;
+}
+
 inline const core::String &SceneGraphNode::name() const {
 	return _name;
 }
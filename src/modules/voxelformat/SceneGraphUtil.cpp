@@ -25,7 +25,8 @@ static void copy(const SceneGraphNode &node, SceneGraphNode &target) {
 	target.addProperties(node.properties());
 	target.setPalette(node.palette());
 	if (node.type() == SceneGraphNodeType::Model) {
-		core_assert(node.volume() != nullptr);
+		// don't decode a pending volume just for the check
+		core_assert(node.hasPendingVolume() || node.volume() != nullptr);
 	} else {
 		core_assert(node.volume() == nullptr);
 	}
@@ -54,9 +55,7 @@ int addNodeToSceneGraph(SceneGraph &sceneGraph, SceneGraphNode &node, int parent
 	SceneGraphNode newNode(node.type());
 	copy(node, newNode);
 	if (newNode.type() == SceneGraphNodeType::Model) {
-		core_assert(node.owns());
-		newNode.setVolume(node.volume(), true);
-		node.releaseOwnership();
+		newNode.takeVolume(node);
 	}
 	return addToGraph(sceneGraph, core::move(newNode), parent);
 }
@@ -88,4 +87,31 @@ int addSceneGraphNodes(SceneGraph &target, SceneGraph &source, int parent) {
 	return nodesAdded;
 }
 
+static int copySceneGraphNode_r(SceneGraph &target, const SceneGraph &source, const SceneGraphNode &sourceNode, int parent) {
+	const int newNodeId = addNodeToSceneGraph(target, sourceNode, parent);
+	if (newNodeId == -1) {
+		Log::error("Failed to add node to the scene graph");
+		return 0;
+	}
+
+	int nodesAdded = sourceNode.type() == SceneGraphNodeType::Model ? 1 : 0;
+	for (int sourceNodeIdx : sourceNode.children()) {
+		core_assert(source.hasNode(sourceNodeIdx));
+		const SceneGraphNode &sourceChildNode = source.node(sourceNodeIdx);
+		nodesAdded += copySceneGraphNode_r(target, source, sourceChildNode, newNodeId);
+	}
+
+	return nodesAdded;
+}
+
+int copySceneGraph(SceneGraph &target, const SceneGraph &source) {
+	const SceneGraphNode &sourceRoot = source.root();
+	int nodesAdded = 0;
+	target.node(target.root().id()).addProperties(sourceRoot.properties());
+	for (int sourceNodeId : sourceRoot.children()) {
+		nodesAdded += copySceneGraphNode_r(target, source, source.node(sourceNodeId), target.root().id());
+	}
+	return nodesAdded;
+}
+
 } // namespace voxel
@@ -18,4 +18,7 @@ int addNodeToSceneGraph(SceneGraph &sceneGraph, SceneGraphNode &node, int parent
 
 int addSceneGraphNodes(SceneGraph& target, SceneGraph& source, int parent);
 
+// this makes a copy of all nodes of the source scene graph including their volumes
+int copySceneGraph(SceneGraph& target, const SceneGraph& source);
+
 } // namespace voxel
@@ -10,11 +10,14 @@
 #include "core/StandardLib.h"
 #include "core/StringUtil.h"
 #include "core/Log.h"
+#include "core/ScopedPtr.h"
+#include "core/SharedPtr.h"
 #include "core/collection/DynamicArray.h"
 #include <glm/gtx/transform.hpp>
 #include "io/File.h"
 #include "io/Filesystem.h"
 #include "io/FileStream.h"
+#include "io/MemoryReadStream.h"
 #include "io/Stream.h"
 #include "voxel/MaterialColor.h"
 #include "core/collection/Buffer.h"
@@ -30,6 +33,12 @@ namespace voxelformat {
 		return false; \
 	}
 
+#define wrapVolume(read) \
+	if ((read) != 0) { \
+		Log::error("Error: " CORE_STRINGIFY(read) " at " SDL_FILE ":%i", SDL_LINE); \
+		return nullptr; \
+	}
+
 #define wrapBool(read) \
 	if (!(read)) { \
 		Log::error("Error: " CORE_STRINGIFY(read) " at " SDL_FILE ":%i", SDL_LINE); \
@@ -254,7 +263,8 @@ bool VXLFormat::readNode(io::SeekableReadStream& stream, VXLModel& mdl, uint32_t
 		return false;
 	}
 
-	// Count the voxels in this node
+	// Walk the spans of this node to find the end of the span data
+	uint64_t dataEnd = dataStart;
 	for (uint32_t i = 0u; i < baseSize; ++i) {
 		if (colStart[i] == EmptyColumn || colEnd[i] == EmptyColumn) {
 			continue;
@@ -270,12 +280,24 @@ bool VXLFormat::readNode(io::SeekableReadStream& stream, VXLModel& mdl, uint32_t
 			z += v;
 			stream.skip(2 * v + 1);
 		} while (z < footer.zsize);
+		dataEnd = core_max(dataEnd, (uint64_t)stream.pos());
+	}
+
+	// only the span data is kept in memory - the voxels are decoded when the volume is accessed
+	wrap(stream.seek(dataStart))
+	const uint32_t dataSize = (uint32_t)(dataEnd - dataStart);
+	const core::SharedPtr<io::MemoryReadStream> spanData = core::make_shared<io::MemoryReadStream>(stream, dataSize);
+	if (spanData->size() != (int64_t)dataSize) {
+		Log::error("Failed to read the span data of node %u", nodeIdx);
+		return false;
 	}
 
 	// switch axis
-	voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region{0, 0, 0, footer.xsize - 1, footer.zsize - 1, footer.ysize - 1});
+	const voxel::Region region{0, 0, 0, footer.xsize - 1, footer.zsize - 1, footer.ysize - 1};
 	SceneGraphNode node;
-	node.setVolume(volume, true);
+	node.setVolumeLoader(region, [spanData, colStart = core::move(colStart), colEnd = core::move(colEnd), footer, region]() {
+		return readNodeVolume(*spanData.get(), colStart, colEnd, footer, region);
+	});
 	node.setName(header.name);
 	if (palette.colorCount > 0) {
 		node.setPalette(palette);
@@ -286,28 +308,39 @@ bool VXLFormat::readNode(io::SeekableReadStream& stream, VXLModel& mdl, uint32_t
 	// transform.setLocalScale(footer.scale); // TODO
 	const KeyFrameIndex keyFrameIdx = 0;
 	node.setTransform(keyFrameIdx, transform);
+	sceneGraph.emplace(core::move(node));
+	return true;
+}
 
+voxel::RawVolume *VXLFormat::readNodeVolume(io::SeekableReadStream &stream, const core::Buffer<int32_t> &colStart,
+											const core::Buffer<int32_t> &colEnd, const VXLNodeFooter &footer,
+											const voxel::Region &region) {
+	core::ScopedPtr<voxel::RawVolume> volume(new voxel::RawVolume(region));
+	const uint32_t baseSize = footer.xsize * footer.ysize;
 	for (uint32_t i = 0u; i < baseSize; ++i) {
 		if (colStart[i] == EmptyColumn || colEnd[i] == EmptyColumn) {
 			continue;
 		}
 
-		wrap(stream.seek(dataStart + colStart[i]))
+		if (stream.seek(colStart[i]) == -1) {
+			Log::error("Failed to seek to the span of column %u", i);
+			return nullptr;
+		}
 
 		const uint8_t x = (uint8_t)(i % footer.xsize);
 		const uint8_t y = (uint8_t)(i / footer.xsize);
 		uint8_t z = 0;
 		do {
 			uint8_t skipCount;
-			wrap(stream.readUInt8(skipCount))
+			wrapVolume(stream.readUInt8(skipCount))
 			z += skipCount;
 			uint8_t voxelCount;
-			wrap(stream.readUInt8(voxelCount))
+			wrapVolume(stream.readUInt8(voxelCount))
 			for (uint8_t j = 0u; j < voxelCount; ++j) {
 				uint8_t color;
-				wrap(stream.readUInt8(color))
+				wrapVolume(stream.readUInt8(color))
 				uint8_t normal;
-				wrap(stream.readUInt8(normal))
+				wrapVolume(stream.readUInt8(normal))
 				const voxel::Voxel v = voxel::createVoxel(voxel::VoxelType::Generic, color);
 				volume->setVoxel(x, z, y, v);
 				++z;
@@ -317,8 +350,7 @@ bool VXLFormat::readNode(io::SeekableReadStream& stream, VXLModel& mdl, uint32_t
 			stream.skip(1);
 		} while (z < footer.zsize);
 	}
-	sceneGraph.emplace(core::move(node));
-	return true;
+	return volume.release();
 }
 
 bool VXLFormat::readNodes(io::SeekableReadStream& stream, VXLModel& mdl, SceneGraph& sceneGraph, const voxel::Palette &palette) const {
@@ -661,6 +693,7 @@ bool VXLFormat::loadGroupsPalette(const core::String &filename, io::SeekableRead
 }
 
 #undef wrap
+#undef wrapVolume
 #undef wrapBool
 
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Format.h"
+#include "core/collection/Buffer.h"
 
 namespace voxelformat {
 
@@ -115,6 +116,13 @@ private:
 	bool readNodeHeader(io::SeekableReadStream& stream, VXLModel& mdl, uint32_t nodeIdx) const;
 	bool readNodeFooter(io::SeekableReadStream& stream, VXLModel& mdl, uint32_t nodeIdx) const;
 	bool readNode(io::SeekableReadStream& stream, VXLModel& mdl, uint32_t nodeIdx, SceneGraph& sceneGraph, const voxel::Palette &palette) const;
+	/**
+	 * @brief Decodes the spans of a node - called on the first access to the volume of the node
+	 * @param stream The span data of the node - the column offsets are relative to the start of the stream
+	 */
+	static voxel::RawVolume *readNodeVolume(io::SeekableReadStream &stream, const core::Buffer<int32_t> &colStart,
+											const core::Buffer<int32_t> &colEnd, const VXLNodeFooter &footer,
+											const voxel::Region &region);
 	bool readNodes(io::SeekableReadStream& stream, VXLModel& mdl, SceneGraph& sceneGraph, const voxel::Palette &palette) const;
 	bool readNodeFooters(io::SeekableReadStream& stream, VXLModel& mdl) const;
 	bool readNodeHeaders(io::SeekableReadStream& stream, VXLModel& mdl) const;
@@ -3,7 +3,7 @@
  */
 
 #include "VolumeCache.h"
-#include "io/FileStream.h"
+#include "io/MemoryMappedReadStream.h"
 #include "voxelformat/VolumeFormat.h"
 #include "voxelformat/Format.h"
 #include "io/Filesystem.h"
@@ -40,7 +40,7 @@ voxel::RawVolume* VolumeCache::loadVolume(const core::String &filename) {
 		return nullptr;
 	}
 	SceneGraph sceneGraph;
-	io::FileStream stream(file);
+	io::MemoryMappedReadStream stream(file);
 	if (!voxelformat::loadFormat(file->name(), stream, sceneGraph)) {
 		Log::error("Failed to load %s", file->name().c_str());
 		core::ScopedLock lock(_mutex);
@@ -307,7 +307,19 @@ size_t loadPalette(const core::String &filename, io::SeekableReadStream &stream,
 	return 0;
 }
 
-bool loadFormat(const core::String &filename, io::SeekableReadStream &stream, SceneGraph &newSceneGraph) {
+bool loadVolumes(SceneGraph &sceneGraph) {
+	core_trace_scoped(LoadVolumes);
+	for (SceneGraphNode &node : sceneGraph) {
+		if (node.hasPendingVolume() && node.volume() == nullptr) {
+			Log::error("Failed to decode the volume of node '%s'", node.name().c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+bool loadFormat(const core::String &filename, io::SeekableReadStream &stream, SceneGraph &newSceneGraph,
+				bool lazyVolumes) {
 	core_trace_scoped(LoadVolumeFormat);
 	const uint32_t magic = loadMagic(stream);
 	const core::String &fileext = core::string::extractExtension(filename);
@@ -330,6 +342,12 @@ bool loadFormat(const core::String &filename, io::SeekableReadStream &stream, Sc
 		Log::error("Failed to load model file %s. Scene graph doesn't contain models.", filename.c_str());
 		return false;
 	}
+	// decode the volumes on the loading thread - and report broken volume data as load failure
+	if (!lazyVolumes && !loadVolumes(newSceneGraph)) {
+		Log::error("Failed to load model file %s. The volumes could not get decoded.", filename.c_str());
+		newSceneGraph.clear();
+		return false;
+	}
 	// newSceneGraph.node(newSceneGraph.root().id()).setProperty("Type", desc->name);
 	Log::info("Load model file %s with %i layers", filename.c_str(), (int)newSceneGraph.size());
 	return true;
@@ -31,7 +31,19 @@ extern bool importPalette(const core::String &filename, voxel::Palette &palette)
  */
 extern size_t loadPalette(const core::String &filename, io::SeekableReadStream &stream, voxel::Palette &palette);
 extern image::ImagePtr loadScreenshot(const core::String &filename, io::SeekableReadStream &stream);
-extern bool loadFormat(const core::String &filename, io::SeekableReadStream &stream, SceneGraph &sceneGraph);
+/**
+ * @param lazyVolumes Keep the volumes of the formats that support it undecoded until they are accessed - this allows
+ * to inspect the regions of the nodes before the memory for the voxels is allocated. The caller has to decode them
+ * with loadVolumes() - otherwise a volume that fails to decode is only noticed as @c nullptr volume later on.
+ * @sa SceneGraphNode::setVolumeLoader()
+ */
+extern bool loadFormat(const core::String &filename, io::SeekableReadStream &stream, SceneGraph &sceneGraph,
+					   bool lazyVolumes = false);
+/**
+ * @brief Decodes the pending volumes of all model nodes
+ * @return @c false if one of the volumes could not get decoded
+ */
+extern bool loadVolumes(SceneGraph &sceneGraph);
 
 /**
  * @brief Save both to volume or to mesh - depends on the given file extension
@@ -52,13 +52,19 @@ VoxFormat::VoxFormat() {
 
 size_t VoxFormat::loadPalette(const core::String &filename, io::SeekableReadStream &stream, voxel::Palette &palette) {
 	const size_t size = stream.size();
-	uint8_t *buffer = (uint8_t *)core_malloc(size);
-	if (stream.read(buffer, size) == -1) {
-		core_free(buffer);
-		return 0;
+	// memory streams are parsed without copying the data
+	const uint8_t *buffer = stream.data();
+	uint8_t *ownBuffer = nullptr;
+	if (buffer == nullptr) {
+		ownBuffer = (uint8_t *)core_malloc(size);
+		if (stream.read(ownBuffer, size) == -1) {
+			core_free(ownBuffer);
+			return 0;
+		}
+		buffer = ownBuffer;
 	}
 	const ogt_vox_scene *scene = ogt_vox_read_scene_with_flags(buffer, size, 0);
-	core_free(buffer);
+	core_free(ownBuffer);
 	if (scene == nullptr) {
 		Log::error("Could not load scene %s", filename.c_str());
 		return 0;
@@ -233,14 +239,20 @@ bool VoxFormat::addGroup(const ogt_vox_scene *scene, uint32_t ogt_parentGroupIdx
 
 bool VoxFormat::loadGroupsPalette(const core::String &filename, io::SeekableReadStream &stream, SceneGraph &sceneGraph, voxel::Palette &palette) {
 	const size_t size = stream.size();
-	uint8_t *buffer = (uint8_t *)core_malloc(size);
-	if (stream.read(buffer, size) == -1) {
-		core_free(buffer);
-		return false;
+	// memory streams are parsed without copying the data
+	const uint8_t *buffer = stream.data();
+	uint8_t *ownBuffer = nullptr;
+	if (buffer == nullptr) {
+		ownBuffer = (uint8_t *)core_malloc(size);
+		if (stream.read(ownBuffer, size) == -1) {
+			core_free(ownBuffer);
+			return false;
+		}
+		buffer = ownBuffer;
 	}
 	const uint32_t ogt_vox_flags = k_read_scene_flags_groups | k_read_scene_flags_keyframes | k_read_scene_flags_keep_empty_models_instances;
 	const ogt_vox_scene *scene = ogt_vox_read_scene_with_flags(buffer, size, ogt_vox_flags);
-	core_free(buffer);
+	core_free(ownBuffer);
 	if (scene == nullptr) {
 		Log::error("Could not load scene %s", filename.c_str());
 		return false;
@@ -39,6 +39,24 @@ core::RGBA Tri::colorAt(const glm::vec2 &uv) const {
 	return color;
 }
 
+glm::vec2 Tri::uvAt(const glm::vec3 &pos) const {
+	const glm::vec3 &n = normal();
+	const float area2 = glm::dot(n, n);
+	if (area2 <= 0.0f) {
+		return centerUV();
+	}
+	// barycentric coordinates of the position projected onto the plane of the triangle
+	float b0 = glm::dot(n, glm::cross(vertices[2] - vertices[1], pos - vertices[1])) / area2;
+	float b1 = glm::dot(n, glm::cross(vertices[0] - vertices[2], pos - vertices[2])) / area2;
+	float b2 = 1.0f - b0 - b1;
+	// positions outside of the triangle get the texture coordinates of the nearby edge
+	b0 = core_max(b0, 0.0f);
+	b1 = core_max(b1, 0.0f);
+	b2 = core_max(b2, 0.0f);
+	const float sum = b0 + b1 + b2;
+	return (uv[0] * b0 + uv[1] * b1 + uv[2] * b2) / sum;
+}
+
 // Sierpinski gasket with keeping the middle
 void Tri::subdivide(Tri out[4]) const {
 	const glm::vec3 midv[]{glm::mix(vertices[0], vertices[1], 0.5f), glm::mix(vertices[1], vertices[2], 0.5f),
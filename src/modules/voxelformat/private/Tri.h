@@ -32,6 +32,11 @@ struct Tri {
 	glm::vec3 mins() const;
 	glm::vec3 maxs() const;
 	core::RGBA colorAt(const glm::vec2 &uv) const;
+	/**
+	 * @brief Interpolates the texture coordinates for the given position. Positions that are not on the
+	 * triangle are projected onto it.
+	 */
+	glm::vec2 uvAt(const glm::vec3 &pos) const;
 
 	// Sierpinski gasket with keeping the middle
 	void subdivide(Tri out[4]) const;
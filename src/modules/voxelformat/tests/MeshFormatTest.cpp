@@ -4,19 +4,116 @@
 
 #include "voxelformat/MeshFormat.h"
 #include "app/tests/AbstractTest.h"
+#include "voxel/CubicSurfaceExtractor.h"
+#include "voxel/IsQuadNeeded.h"
+#include "voxel/RawVolume.h"
 
 namespace voxelformat {
 
 class MeshFormatTest : public app::AbstractTest {};
 
-TEST_F(MeshFormatTest, testSubdivide) {
-	MeshFormat::TriCollection tinyTris;
+TEST_F(MeshFormatTest, testRasterizeTris) {
+	MeshFormat::TriCollection tris;
 	Tri tri;
 	tri.vertices[0] = glm::vec3(-8.77272797, -11.43335, -0.154544264);
 	tri.vertices[1] = glm::vec3(-8.77272701, 11.1000004, -0.154543981);
 	tri.vertices[2] = glm::vec3(8.77272701, 11.1000004, -0.154543981);
-	MeshFormat::subdivideTri(tri, tinyTris);
-	EXPECT_EQ(1024u, tinyTris.size());
+	tri.color = core::RGBA(255, 0, 0, 255);
+	tris.push_back(tri);
+	const voxel::Region region(-10, 12);
+	int voxels = 0;
+	MeshFormat::rasterizeTris(region, tris, [&](const glm::ivec3 &pos, const glm::vec4 &color) {
+		EXPECT_TRUE(region.containsPoint(pos));
+		EXPECT_EQ(0, pos.z) << "The triangle is parallel to the xy plane";
+		EXPECT_FLOAT_EQ(1.0f, color.r);
+		EXPECT_FLOAT_EQ(0.0f, color.g);
+		++voxels;
+	});
+	// the voxels that are cut by the hypotenuse are included
+	EXPECT_GT(voxels, 18 * 23 / 2);
+	EXPECT_LT(voxels, 19 * 24);
+}
+
+TEST_F(MeshFormatTest, testRasterizeTrisBatches) {
+	// a closed box that is made of more triangles than fit into one batch
+	MeshFormat::TriCollection tris;
+	const int size = 20;
+	for (int i = 0; i < size; ++i) {
+		for (int j = 0; j < size; ++j) {
+			const float a = (float)i;
+			const float b = (float)j;
+			for (float c : {0.0f, (float)size}) {
+				Tri tri;
+				tri.vertices[0] = glm::vec3(a, b, c);
+				tri.vertices[1] = glm::vec3(a + 1.0f, b, c);
+				tri.vertices[2] = glm::vec3(a + 1.0f, b + 1.0f, c);
+				tris.push_back(tri);
+				tri.vertices[0] = glm::vec3(c, a, b);
+				tri.vertices[1] = glm::vec3(c, a + 1.0f, b);
+				tri.vertices[2] = glm::vec3(c, a + 1.0f, b + 1.0f);
+				tris.push_back(tri);
+				tri.vertices[0] = glm::vec3(b, c, a);
+				tri.vertices[1] = glm::vec3(b, c, a + 1.0f);
+				tri.vertices[2] = glm::vec3(b + 1.0f, c, a + 1.0f);
+				tris.push_back(tri);
+			}
+		}
+	}
+	ASSERT_GT(tris.size(), MeshFormat::RasterizeBatchSize);
+	const voxel::Region region(0, size);
+	voxel::RawVolume volume(region);
+	int voxels = 0;
+	MeshFormat::rasterizeTris(region, tris, [&](const glm::ivec3 &pos, const glm::vec4 &) {
+		EXPECT_TRUE(volume.voxel(pos).getMaterial() == voxel::VoxelType::Air) << "Voxel was reported twice";
+		volume.setVoxel(pos, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		++voxels;
+	});
+	// the triangles cover the half of each face - the conservative rasterization still sets the whole shell
+	const int inner = size - 1;
+	EXPECT_EQ((size + 1) * (size + 1) * (size + 1) - inner * inner * inner, voxels);
+}
+
+TEST_F(MeshFormatTest, testSplitRegion) {
+	core::DynamicArray<voxel::Region> tiles;
+	MeshFormat::splitRegion(voxel::Region(glm::ivec3(-5, 0, 0), glm::ivec3(20, 9, 9)), 10, tiles);
+	ASSERT_EQ(3u, tiles.size());
+	EXPECT_EQ(voxel::Region(glm::ivec3(-5, 0, 0), glm::ivec3(4, 9, 9)), tiles[0]);
+	EXPECT_EQ(voxel::Region(glm::ivec3(5, 0, 0), glm::ivec3(14, 9, 9)), tiles[1]);
+	EXPECT_EQ(voxel::Region(glm::ivec3(15, 0, 0), glm::ivec3(20, 9, 9)), tiles[2]);
+}
+
+TEST_F(MeshFormatTest, testMergeMeshes) {
+	voxel::RawVolume volume(voxel::Region(0, 30));
+	const voxel::Region &volumeRegion = volume.region();
+	for (int32_t z = 0; z <= volumeRegion.getUpperZ(); ++z) {
+		for (int32_t y = 0; y <= volumeRegion.getUpperY(); ++y) {
+			for (int32_t x = 0; x <= volumeRegion.getUpperX(); ++x) {
+				if ((x * 7 + y * 13 + z * 5) % 3 == 0) {
+					volume.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+				}
+			}
+		}
+	}
+	voxel::Region region = volumeRegion;
+	region.shiftUpperCorner(1, 1, 1);
+	voxel::Mesh expected;
+	voxel::extractCubicMesh(&volume, region, &expected, voxel::IsQuadNeeded(), glm::ivec3(0), false, true, true);
+
+	core::DynamicArray<voxel::Region> tiles;
+	MeshFormat::splitRegion(region, 8, tiles);
+	core::DynamicArray<voxel::Mesh *> tileMeshes;
+	for (const voxel::Region &tile : tiles) {
+		voxel::Mesh *mesh = new voxel::Mesh();
+		voxel::extractCubicMesh(&volume, tile, mesh, voxel::IsQuadNeeded(), tile.getLowerCorner() - region.getLowerCorner(), false, true, true);
+		tileMeshes.push_back(mesh);
+	}
+	voxel::Mesh merged;
+	MeshFormat::mergeMeshes(tileMeshes, merged, true);
+	for (voxel::Mesh *mesh : tileMeshes) {
+		delete mesh;
+	}
+	EXPECT_EQ(expected.getNoOfIndices(), merged.getNoOfIndices());
+	EXPECT_EQ(expected.getNoOfVertices(), merged.getNoOfVertices()) << "The vertices on the tile borders should be merged";
 }
 
 } // namespace voxelformat
@@ -4,6 +4,7 @@
 
 #include "voxelformat/OBJFormat.h"
 #include "AbstractVoxFormatTest.h"
+#include "core/concurrent/ThreadPool.h"
 #include "io/File.h"
 #include "voxelformat/QBFormat.h"
 
@@ -38,4 +39,28 @@ TEST_F(OBJFormatTest, testExportMesh) {
 	EXPECT_TRUE(f.saveGroups(sceneGraph, outFilename, outStream));
 }
 
+TEST_F(OBJFormatTest, testExportMeshFromThreadPoolTask) {
+	SceneGraph sceneGraph;
+	{
+		QBFormat sourceFormat;
+		const core::String filename = "rgb.qb";
+		const io::FilePtr &file = open(filename);
+		io::FileStream stream(file);
+		EXPECT_TRUE(sourceFormat.loadGroups(filename, stream, sceneGraph));
+	}
+	ASSERT_TRUE(sceneGraph.size() > 0);
+	core::ThreadPool &threadPool = _testApp->threadPool();
+	ASSERT_EQ(1u, threadPool.size());
+	// the task occupies the only worker - the tiles must be extracted without waiting for other tasks
+	std::future<bool> future = threadPool.enqueue([&sceneGraph, this]() {
+		OBJFormat f;
+		const core::String outFilename = "exportrgbtask.obj";
+		const io::FilePtr &outFile = open(outFilename, io::FileMode::SysWrite);
+		io::FileStream outStream(outFile);
+		return f.saveGroups(sceneGraph, outFilename, outStream);
+	});
+	ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(30))) << "The save dead locked";
+	EXPECT_TRUE(future.get());
+}
+
 } // namespace voxel
@@ -4,6 +4,7 @@
 
 #include "AbstractVoxFormatTest.h"
 #include "io/FileStream.h"
+#include "voxel/RawVolume.h"
 #include "voxelformat/QBTFormat.h"
 #include "voxelformat/VolumeFormat.h"
 
@@ -16,6 +17,33 @@ TEST_F(QBTFormatTest, testLoad) {
 	canLoad("qubicle.qbt", 17);
 }
 
+TEST_F(QBTFormatTest, testLoadFormatDecodesVolumes) {
+	SceneGraph sceneGraph;
+	io::FilePtr file = open("qubicle.qbt");
+	io::FileStream stream(file);
+	ASSERT_TRUE(voxelformat::loadFormat(file->name(), stream, sceneGraph));
+	ASSERT_EQ(17u, sceneGraph.size());
+	for (const SceneGraphNode &node : sceneGraph) {
+		EXPECT_FALSE(node.hasPendingVolume()) << "The volume of " << node.name().c_str() << " was not decoded on load";
+	}
+}
+
+TEST_F(QBTFormatTest, testLoadLazy) {
+	SceneGraph sceneGraph;
+	io::FilePtr file = open("qubicle.qbt");
+	io::FileStream stream(file);
+	ASSERT_TRUE(voxelformat::loadFormat(file->name(), stream, sceneGraph, true));
+	ASSERT_EQ(17u, sceneGraph.size());
+	for (const SceneGraphNode &node : sceneGraph) {
+		EXPECT_TRUE(node.hasPendingVolume()) << "The volume of " << node.name().c_str() << " was decoded on load";
+		const voxel::Region region = node.region();
+		EXPECT_TRUE(region.isValid());
+		ASSERT_NE(nullptr, node.volume());
+		EXPECT_FALSE(node.hasPendingVolume());
+		EXPECT_EQ(region, node.volume()->region());
+	}
+}
+
 TEST_F(QBTFormatTest, testSaveSingleVoxel) {
 	QBTFormat f;
 	testSaveSingleVoxel("qubicle-singlevoxelsavetest.qb", &f);
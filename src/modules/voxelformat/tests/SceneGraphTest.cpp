@@ -9,6 +9,7 @@
 #include "voxel/tests/TestHelper.h"
 #include "voxelformat/SceneGraph.h"
 #include "voxelformat/SceneGraphNode.h"
+#include "voxelformat/VolumeFormat.h"
 
 namespace voxelformat {
 
@@ -168,4 +169,50 @@ TEST_F(SceneGraphTest, testKeyframes) {
 	EXPECT_EQ(1u, node.keyFrames().size());
 }
 
+TEST_F(SceneGraphTest, testVolumeLoader) {
+	const voxel::Region region(0, 3);
+	int calls = 0;
+	SceneGraphNode node(SceneGraphNodeType::Model);
+	node.setVolumeLoader(region, [&calls, region]() {
+		++calls;
+		voxel::RawVolume *v = new voxel::RawVolume(region);
+		v->setVoxel(1, 2, 3, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		return v;
+	});
+	EXPECT_TRUE(node.hasPendingVolume());
+	EXPECT_EQ(region, node.region());
+	EXPECT_EQ(0, calls) << "The region should be available without decoding the volume";
+
+	SceneGraph sceneGraph;
+	const int nodeId = sceneGraph.emplace(core::move(node));
+	ASSERT_NE(-1, nodeId);
+	const SceneGraphNode &moved = sceneGraph.node(nodeId);
+	EXPECT_TRUE(moved.hasPendingVolume());
+	ASSERT_NE(nullptr, moved.volume());
+	EXPECT_FALSE(moved.hasPendingVolume());
+	EXPECT_EQ(1, calls);
+	EXPECT_TRUE(voxel::isBlocked(moved.volume()->voxel(1, 2, 3).getMaterial()));
+	EXPECT_EQ(1, calls) << "The volume should only get decoded once";
+}
+
+TEST_F(SceneGraphTest, testVolumeLoaderRelease) {
+	int calls = 0;
+	{
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		node.setVolumeLoader(voxel::Region(0, 1), [&calls]() {
+			++calls;
+			return new voxel::RawVolume(voxel::Region(0, 1));
+		});
+	}
+	EXPECT_EQ(0, calls) << "A volume that was never accessed should never get decoded";
+}
+
+TEST_F(SceneGraphTest, testLoadVolumesFailure) {
+	SceneGraph sceneGraph;
+	SceneGraphNode node(SceneGraphNodeType::Model);
+	node.setVolumeLoader(voxel::Region(0, 1), []() { return (voxel::RawVolume *)nullptr; });
+	ASSERT_NE(-1, sceneGraph.emplace(core::move(node)));
+	EXPECT_FALSE(loadVolumes(sceneGraph)) << "A volume that fails to decode must be reported";
+}
+
 }
@@ -7,6 +7,7 @@
 #include "voxel/RawVolume.h"
 #include "voxel/tests/TestHelper.h"
 #include "voxelformat/SceneGraphNode.h"
+#include "voxelformat/VolumeFormat.h"
 
 namespace voxelformat {
 
@@ -35,4 +36,55 @@ TEST_F(SceneGraphUtilTest, testAddSceneGraphNodes) {
 	ASSERT_EQ(1, target.node(2).parent());
 }
 
+TEST_F(SceneGraphUtilTest, testCopySceneGraph) {
+	SceneGraph source;
+	int groupNodeId = -1;
+	{
+		SceneGraphNode node(SceneGraphNodeType::Group);
+		node.setName("group");
+		groupNodeId = source.emplace(core::move(node));
+	}
+	{
+		SceneGraphNode node;
+		node.setName("model");
+		node.setVolume(new voxel::RawVolume(voxel::Region(0, 0)), true);
+		source.emplace(core::move(node), groupNodeId);
+	}
+	SceneGraph target;
+	EXPECT_EQ(1, copySceneGraph(target, source));
+	ASSERT_TRUE(target.hasNode(2));
+	const SceneGraphNode &model = target.node(2);
+	EXPECT_EQ("model", model.name());
+	EXPECT_EQ(1, model.parent());
+	ASSERT_NE(nullptr, model.volume());
+	EXPECT_NE(source.node(2).volume(), model.volume()) << "The volume should be copied";
+	ASSERT_NE(nullptr, source.node(2).volume()) << "The source should still own its volume";
+}
+
+TEST_F(SceneGraphUtilTest, testAddSceneGraphNodesPendingVolumes) {
+	int calls[2] = {0, 0};
+	SceneGraph source;
+	for (int i = 0; i < 2; ++i) {
+		SceneGraphNode node;
+		node.setVolumeLoader(voxel::Region(0, i), [&calls, i]() {
+			++calls[i];
+			return new voxel::RawVolume(voxel::Region(0, i));
+		});
+		source.emplace(core::move(node));
+	}
+	SceneGraph target;
+	EXPECT_EQ(2, addSceneGraphNodes(target, source, target.root().id()));
+	EXPECT_EQ(0, calls[0] + calls[1]) << "The volumes should be handed over without decoding them";
+	ASSERT_TRUE(target[0]->hasPendingVolume());
+	EXPECT_EQ(voxel::Region(0, 1), target[1]->region());
+
+	// filter out the first layer like voxconvert does
+	target[0]->release();
+	EXPECT_TRUE(loadVolumes(target));
+	EXPECT_EQ(0, calls[0]) << "The volume of a removed node should never get decoded";
+	EXPECT_EQ(1, calls[1]);
+	ASSERT_NE(nullptr, target[1]->volume());
+	EXPECT_EQ(1, calls[1]);
+}
+
 } // namespace voxelformat
@@ -64,4 +64,23 @@ TEST_F(TriTest, colorAt4x4) {
 	}
 }
 
+TEST_F(TriTest, uvAt) {
+	Tri tri;
+	tri.vertices[0] = glm::vec3(0.0f, 0.0f, 0.0f);
+	tri.vertices[1] = glm::vec3(4.0f, 0.0f, 0.0f);
+	tri.vertices[2] = glm::vec3(0.0f, 4.0f, 0.0f);
+	tri.uv[0] = glm::vec2(0.0f, 0.0f);
+	tri.uv[1] = glm::vec2(1.0f, 0.0f);
+	tri.uv[2] = glm::vec2(0.0f, 1.0f);
+	const glm::vec2 &uv = tri.uvAt(glm::vec3(1.0f, 2.0f, 0.0f));
+	EXPECT_FLOAT_EQ(0.25f, uv.x);
+	EXPECT_FLOAT_EQ(0.5f, uv.y);
+	const glm::vec2 &projected = tri.uvAt(glm::vec3(1.0f, 2.0f, 3.0f));
+	EXPECT_FLOAT_EQ(0.25f, projected.x);
+	EXPECT_FLOAT_EQ(0.5f, projected.y);
+	const glm::vec2 &outside = tri.uvAt(glm::vec3(-1.0f, -1.0f, 0.0f));
+	EXPECT_FLOAT_EQ(0.0f, outside.x);
+	EXPECT_FLOAT_EQ(0.0f, outside.y);
+}
+
 } // namespace voxelformat
@@ -19,6 +19,7 @@
 #include "voxel/Palette.h"
 #include "core/Color.h"
 #include "io/Filesystem.h"
+#include "noise/Noise.h"
 #include "noise/Simplex.h"
 #include "app/App.h"
 #include "voxelformat/SceneGraphUtil.h"
@@ -272,6 +273,244 @@ static int luaVoxel_volumewrapper_setvoxel(lua_State* s) {
 	return 1;
 }
 
+/**
+ * @brief The optional region parameter of the bulk functions - cropped to the region of the volume
+ */
+static voxel::Region luaVoxel_optregion(lua_State *s, int n, const LuaRawVolumeWrapper *volume) {
+	voxel::Region region = volume->region();
+	if (!lua_isnoneornil(s, n)) {
+		region.cropTo(*luaVoxel_toRegion(s, n));
+	}
+	return region;
+}
+
+/**
+ * @brief Visits the positions of the region in memory order of the volume (x, y and then z)
+ *
+ * The sampler of the wrapper only adds the voxels that are really set to the dirty region. The visiting stops once
+ * the function returns @c false.
+ */
+template<class FUNC>
+static void luaVoxel_visitregion(LuaRawVolumeWrapper *volume, const voxel::Region &region, FUNC &&func) {
+	if (!region.isValid()) {
+		return;
+	}
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	LuaRawVolumeWrapper::Sampler sampler(volume);
+	for (int32_t z = mins.z; z <= maxs.z; ++z) {
+		for (int32_t y = mins.y; y <= maxs.y; ++y) {
+			sampler.setPosition(mins.x, y, z);
+			for (int32_t x = mins.x; x <= maxs.x; ++x) {
+				if (!func(sampler, x, y, z)) {
+					return;
+				}
+				sampler.movePositiveX();
+			}
+		}
+	}
+}
+
+static inline int luaVoxel_color(const voxel::Voxel &voxel) {
+	if (voxel::isAir(voxel.getMaterial())) {
+		return -1;
+	}
+	return voxel.getColor();
+}
+
+static inline bool luaVoxel_setIfChanged(LuaRawVolumeWrapper::Sampler &sampler, const voxel::Voxel &voxel) {
+	if (sampler.voxel().isSame(voxel)) {
+		return false;
+	}
+	return sampler.setVoxel(voxel);
+}
+
+static int luaVoxel_volumewrapper_fill(lua_State *s) {
+	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
+	const voxel::Region &region = luaVoxel_optregion(s, 2, volume);
+	const voxel::Voxel voxel = luaVoxel_getVoxel(s, 3);
+	int changed = 0;
+	luaVoxel_visitregion(volume, region, [&](LuaRawVolumeWrapper::Sampler &sampler, int32_t, int32_t, int32_t) {
+		if (luaVoxel_setIfChanged(sampler, voxel)) {
+			++changed;
+		}
+		return true;
+	});
+	lua_pushinteger(s, changed);
+	return 1;
+}
+
+static int luaVoxel_volumewrapper_replace(lua_State *s) {
+	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
+	const voxel::Region &region = luaVoxel_optregion(s, 2, volume);
+	const int oldColor = (int)luaL_checkinteger(s, 3);
+	const voxel::Voxel voxel = luaVoxel_getVoxel(s, 4);
+	int changed = 0;
+	luaVoxel_visitregion(volume, region, [&](LuaRawVolumeWrapper::Sampler &sampler, int32_t, int32_t, int32_t) {
+		if (luaVoxel_color(sampler.voxel()) == oldColor && luaVoxel_setIfChanged(sampler, voxel)) {
+			++changed;
+		}
+		return true;
+	});
+	lua_pushinteger(s, changed);
+	return 1;
+}
+
+static int luaVoxel_volumewrapper_voxels(lua_State *s) {
+	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
+	const voxel::Region &region = luaVoxel_optregion(s, 2, volume);
+	lua_createtable(s, region.isValid() ? region.voxels() : 0, 0);
+	lua_Integer idx = 1;
+	luaVoxel_visitregion(volume, region, [&](LuaRawVolumeWrapper::Sampler &sampler, int32_t, int32_t, int32_t) {
+		lua_pushinteger(s, luaVoxel_color(sampler.voxel()));
+		lua_rawseti(s, -2, idx++);
+		return true;
+	});
+	return 1;
+}
+
+static int luaVoxel_volumewrapper_setvoxels(lua_State *s) {
+	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
+	const voxel::Region &region = luaVoxel_optregion(s, 2, volume);
+	luaL_checktype(s, 3, LUA_TTABLE);
+	const lua_Integer voxels = region.isValid() ? region.voxels() : 0;
+	const lua_Integer len = (lua_Integer)lua_rawlen(s, 3);
+	if (len != voxels) {
+		return clua_error(s, "Expected %i colors for the region, but got %i", (int)voxels, (int)len);
+	}
+	// validate the whole table before the first voxel is modified
+	for (lua_Integer i = 1; i <= len; ++i) {
+		const bool valid = lua_rawgeti(s, 3, i) == LUA_TNUMBER && lua_isinteger(s, -1);
+		lua_pop(s, 1);
+		if (!valid) {
+			return clua_error(s, "Entry %i is no color", (int)i);
+		}
+	}
+	int changed = 0;
+	lua_Integer idx = 1;
+	luaVoxel_visitregion(volume, region, [&](LuaRawVolumeWrapper::Sampler &sampler, int32_t, int32_t, int32_t) {
+		lua_rawgeti(s, 3, idx++);
+		if (luaVoxel_setIfChanged(sampler, luaVoxel_getVoxel(s, -1))) {
+			++changed;
+		}
+		lua_pop(s, 1);
+		return true;
+	});
+	lua_pushinteger(s, changed);
+	return 1;
+}
+
+static int luaVoxel_volumewrapper_fillnoise(lua_State *s) {
+	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
+	const voxel::Region &region = luaVoxel_optregion(s, 2, volume);
+	const voxel::Voxel voxel = luaVoxel_getVoxel(s, 3);
+	const float threshold = (float)luaL_optnumber(s, 4, 0.5f);
+	const float frequency = (float)luaL_optnumber(s, 5, 0.01f);
+	const uint8_t octaves = luaL_optinteger(s, 6, 4);
+	const float lacunarity = (float)luaL_optnumber(s, 7, 2.0f);
+	const float gain = (float)luaL_optnumber(s, 8, 0.5f);
+	int changed = 0;
+	luaVoxel_visitregion(volume, region, [&](LuaRawVolumeWrapper::Sampler &sampler, int32_t x, int32_t y, int32_t z) {
+		const glm::vec3 pos = glm::vec3(x, y, z) * frequency;
+		if (noise::norm(noise::fBm(pos, octaves, lacunarity, gain)) > threshold && luaVoxel_setIfChanged(sampler, voxel)) {
+			++changed;
+		}
+		return true;
+	});
+	lua_pushinteger(s, changed);
+	return 1;
+}
+
+static int luaVoxel_volumewrapper_map(lua_State *s) {
+	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
+	const voxel::Region &region = luaVoxel_optregion(s, 2, volume);
+	luaL_checktype(s, 3, LUA_TFUNCTION);
+	// the filter is evaluated natively - the lua function is only called for the matching voxels
+	enum class Filter { All, Solid, Air, Color };
+	Filter filter = Filter::All;
+	int filterColor = -1;
+	if (lua_isnumber(s, 4)) {
+		// a float like 2.0 is a valid color, too
+		int isInteger = 0;
+		const lua_Integer color = lua_tointegerx(s, 4, &isInteger);
+		if (!isInteger) {
+			return clua_error(s, "Unknown filter %f - expected all, solid, air or a color", lua_tonumber(s, 4));
+		}
+		filter = Filter::Color;
+		filterColor = (int)color;
+	} else {
+		const core::String filterName = luaL_optstring(s, 4, "all");
+		if (filterName == "solid") {
+			filter = Filter::Solid;
+		} else if (filterName == "air") {
+			filter = Filter::Air;
+		} else if (filterName != "all") {
+			return clua_error(s, "Unknown filter %s - expected all, solid, air or a color", filterName.c_str());
+		}
+	}
+	int changed = 0;
+	bool failed = false;
+	const voxel::RawVolume *mapped = volume->volume();
+	luaVoxel_visitregion(volume, region, [&](LuaRawVolumeWrapper::Sampler &sampler, int32_t x, int32_t y, int32_t z) {
+		const int color = luaVoxel_color(sampler.voxel());
+		switch (filter) {
+		case Filter::Solid:
+			if (color == -1) {
+				return true;
+			}
+			break;
+		case Filter::Air:
+			if (color != -1) {
+				return true;
+			}
+			break;
+		case Filter::Color:
+			if (color != filterColor) {
+				return true;
+			}
+			break;
+		case Filter::All:
+			break;
+		}
+		lua_pushvalue(s, 3);
+		lua_pushinteger(s, x);
+		lua_pushinteger(s, y);
+		lua_pushinteger(s, z);
+		lua_pushinteger(s, color);
+		// don't let the error jump over the sampler - it is raised once the loop is left
+		if (lua_pcall(s, 4, 1, 0) != LUA_OK) {
+			failed = true;
+			return false;
+		}
+		// crop, resize, mirrorAxis or rotateAxis would leave the sampler with the deleted volume
+		if (volume->volume() != mapped || volume->node()->volume() != mapped) {
+			lua_pop(s, 1);
+			lua_pushstring(s, "map function must not replace the volume");
+			failed = true;
+			return false;
+		}
+		// nil keeps the current voxel
+		if (!lua_isnil(s, -1)) {
+			if (!lua_isinteger(s, -1)) {
+				lua_pop(s, 1);
+				lua_pushstring(s, "map function must return a color or nil");
+				failed = true;
+				return false;
+			}
+			if (luaVoxel_setIfChanged(sampler, luaVoxel_getVoxel(s, -1))) {
+				++changed;
+			}
+		}
+		lua_pop(s, 1);
+		return true;
+	});
+	if (failed) {
+		return lua_error(s);
+	}
+	lua_pushinteger(s, changed);
+	return 1;
+}
+
 static int luaVoxel_volumewrapper_gc(lua_State *s) {
 	LuaRawVolumeWrapper* volume = luaVoxel_tovolumewrapper(s, 1);
 	if (volume->dirtyRegion().isValid()) {
@@ -677,6 +916,12 @@ static void prepareState(lua_State* s) {
 		{"mirrorAxis", luaVoxel_volumewrapper_mirroraxis},
 		{"rotateAxis", luaVoxel_volumewrapper_rotateaxis},
 		{"setVoxel", luaVoxel_volumewrapper_setvoxel},
+		{"fill", luaVoxel_volumewrapper_fill},
+		{"replace", luaVoxel_volumewrapper_replace},
+		{"voxels", luaVoxel_volumewrapper_voxels},
+		{"setVoxels", luaVoxel_volumewrapper_setvoxels},
+		{"fillNoise", luaVoxel_volumewrapper_fillnoise},
+		{"map", luaVoxel_volumewrapper_map},
 		{"__gc", luaVoxel_volumewrapper_gc},
 		{nullptr, nullptr}
 	};
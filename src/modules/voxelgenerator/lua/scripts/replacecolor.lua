@@ -2,8 +2,6 @@
 -- replace one palette color with another one
 --
 
-local vol = require "modules.volume"
-
 function arguments()
 	return {
 		{ name = 'newcolor', desc = 'the palette color index', type = 'colorindex' }
@@ -11,17 +9,5 @@ function arguments()
 end
 
 function main(node, region, color, newcolor)
-	local volume = node:volume()
-	local visitor = function (volume, x, y, z)
-		volume:setVoxel(x, y, z, newcolor)
-	end
-
-	local condition = function (volume, x, y, z)
-		local voxel = volume:voxel(x, y, z)
-		if voxel == color then
-			return true
-		end
-		return false
-	end
-	vol.conditionYXZ(volume, region, visitor, condition)
+	node:volume():replace(region, color, newcolor)
 end
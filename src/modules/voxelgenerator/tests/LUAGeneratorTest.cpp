@@ -29,8 +29,10 @@ protected:
 	}
 
 	void run(voxelformat::SceneGraph &sceneGraph, const core::String &script,
-			 const core::DynamicArray<core::String> &args = {}, bool validateDirtyRegion = false) {
-		const voxel::Region region(0, 0, 0, 7, 7, 7);
+			 const core::DynamicArray<core::String> &args = {}, bool validateDirtyRegion = false,
+			 voxel::Region *outDirtyRegion = nullptr) {
+		// not const - the scripts are allowed to modify the region
+		voxel::Region region(0, 0, 0, 7, 7, 7);
 		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 42);
 		int nodeId;
 		{
@@ -54,6 +56,9 @@ protected:
 		if (validateDirtyRegion) {
 			EXPECT_TRUE(dirtyRegion.isValid());
 		}
+		if (outDirtyRegion != nullptr) {
+			*outDirtyRegion = dirtyRegion;
+		}
 		g.shutdown();
 	}
 };
@@ -96,6 +101,101 @@ TEST_F(LUAGeneratorTest, testExecute) {
 	EXPECT_NE(0u, volume->voxel(1, 0, 0).getColor());
 }
 
+TEST_F(LUAGeneratorTest, testBulkFunctions) {
+	const core::String script = R"(
+		function main(node, region, color)
+			local volume = node:volume()
+			assert(volume:replace(nil, 42, 2) == 6)
+			region:setMins(ivec3.new(1, 4, 1))
+			region:setMaxs(ivec3.new(2, 5, 2))
+			assert(volume:fill(region, 1) == 8)
+			assert(volume:fill(region, 1) == 0)
+			local colors = volume:voxels(region)
+			assert(#colors == 8)
+			colors[1] = -1
+			colors[8] = 3
+			assert(not pcall(volume.setVoxels, volume, region, {1, 2}))
+			colors[2] = 'x'
+			assert(not pcall(volume.setVoxels, volume, region, colors))
+			assert(volume:voxel(1, 4, 1) == 1)
+			colors[2] = 1
+			assert(volume:setVoxels(region, colors) == 2)
+			assert(volume:voxel(1, 4, 1) == -1)
+			assert(volume:voxel(2, 5, 2) == 3)
+			local changed = volume:map(nil, function(x, y, z, c)
+				if y == 1 then
+					return 4
+				end
+			end, 2)
+			assert(changed == 2)
+		end
+	)";
+
+	voxelformat::SceneGraph sceneGraph;
+	voxel::Region dirtyRegion;
+	run(sceneGraph, script, {}, true, &dirtyRegion);
+	voxel::RawVolume *volume = sceneGraph.node(sceneGraph.activeNode()).volume();
+	EXPECT_EQ(2u, volume->voxel(0, 0, 0).getColor());
+	EXPECT_EQ(4u, volume->voxel(0, 1, 0).getColor());
+	EXPECT_EQ(4u, volume->voxel(2, 1, 0).getColor());
+	EXPECT_EQ(1u, volume->voxel(2, 4, 1).getColor());
+	EXPECT_TRUE(voxel::isAir(volume->voxel(1, 4, 1).getMaterial()));
+	EXPECT_EQ(glm::ivec3(0, 0, 0), dirtyRegion.getLowerCorner());
+	EXPECT_EQ(glm::ivec3(2, 5, 2), dirtyRegion.getUpperCorner());
+}
+
+TEST_F(LUAGeneratorTest, testMapReplaceVolume) {
+	const core::String script = R"(
+		function main(node, region, color)
+			local volume = node:volume()
+			local ok, err = pcall(volume.map, volume, nil, function(x, y, z, c)
+				volume:crop()
+			end)
+			assert(not ok)
+			assert(string.find(err, 'must not replace the volume'), err)
+			assert(volume:map(nil, function(x, y, z, c) return 3 end, 42.0) == 6)
+			assert(not pcall(volume.map, volume, nil, function(x, y, z, c) end, 2.5))
+		end
+	)";
+
+	voxelformat::SceneGraph sceneGraph;
+	run(sceneGraph, script);
+	voxel::RawVolume *volume = sceneGraph.node(sceneGraph.activeNode()).volume();
+	EXPECT_EQ(voxel::Region(0, 0, 0, 2, 2, 0), volume->region());
+	EXPECT_EQ(3u, volume->voxel(0, 0, 0).getColor());
+	EXPECT_EQ(3u, volume->voxel(2, 2, 0).getColor());
+}
+
+TEST_F(LUAGeneratorTest, testFillNoise) {
+	const core::String script = R"(
+		function main(node, region, color)
+			local volume = node:volume()
+			volume:fill(nil, -1)
+			local filled = volume:fillNoise(nil, 5, 0.5, 0.2)
+			assert(filled > 64 and filled < 448, 'filled ' .. filled)
+			assert(volume:fillNoise(nil, 5, 0.5, 0.2) == 0)
+		end
+	)";
+
+	voxelformat::SceneGraph sceneGraph;
+	run(sceneGraph, script);
+	voxel::RawVolume *volume = sceneGraph.node(sceneGraph.activeNode()).volume();
+	int filled = 0;
+	for (int z = 0; z < 8; ++z) {
+		for (int y = 0; y < 8; ++y) {
+			for (int x = 0; x < 8; ++x) {
+				const voxel::Voxel &voxel = volume->voxel(x, y, z);
+				if (!voxel::isAir(voxel.getMaterial())) {
+					EXPECT_EQ(5u, voxel.getColor());
+					++filled;
+				}
+			}
+		}
+	}
+	EXPECT_GT(filled, 64) << "A threshold at the median of the noise should fill a good part of the volume";
+	EXPECT_LT(filled, 448);
+}
+
 TEST_F(LUAGeneratorTest, testArgumentInfo) {
 	const core::String script = R"(
 		function arguments()
@@ -34,6 +34,7 @@
 #include "core/StandardLib.h"
 #include "VoxelShaderConstants.h"
 #include "voxel/IsQuadNeeded.h"
+#include "voxel/BinaryCubicSurfaceExtractor.h"
 #include <SDL.h>
 
 namespace voxelrender {
@@ -45,6 +46,7 @@ RawVolumeRenderer::RawVolumeRenderer() :
 
 void RawVolumeRenderer::construct() {
 	core::Var::get(cfg::VoxelMeshSize, "64", core::CV_READONLY);
+	core::Var::get(cfg::VoxelBinaryMesher, "true", "Use the bitmask based greedy mesher for the surface extraction", core::Var::boolValidator);
 }
 
 bool RawVolumeRenderer::resize(const glm::ivec2 &size) {
@@ -74,6 +76,7 @@ bool RawVolumeRenderer::init(const glm::ivec2 &size) {
 	_shadowMap = core::Var::getSafe(cfg::ClientShadowMap);
 	_bloom = core::Var::getSafe(cfg::ClientBloom);
 	_meshSize = core::Var::getSafe(cfg::VoxelMeshSize);
+	_binaryMesher = core::Var::getSafe(cfg::VoxelBinaryMesher);
 
 	_threadPool.init();
 	Log::debug("Threadpool size: %i", (int)_threadPool.size());
@@ -118,6 +121,9 @@ bool RawVolumeRenderer::init(const glm::ivec2 &size) {
 			Log::error("Could not create the vertex buffer object for the indices");
 			return false;
 		}
+		// the mesh cells are uploaded partially with every modification
+		state._vertexBuffer.setMode(state._vertexBufferIndex, video::BufferMode::Dynamic);
+		state._vertexBuffer.setMode(state._indexBufferIndex, video::BufferMode::Dynamic);
 	}
 
 	const int shaderMaterialColorsArraySize = lengthof(shader::VoxelData::MaterialblockData::materialcolor);
@@ -171,14 +177,30 @@ bool RawVolumeRenderer::scheduleExtractions(size_t maxExtraction) {
 			continue;
 		}
 		const voxel::Region& finalRegion = _extractRegions[i].region;
+		// the same cell was modified again - it's enough to extract it once
+		bool queuedAgain = false;
+		for (size_t j = i + 1; j < n; ++j) {
+			if (_extractRegions[j].idx == idx && _extractRegions[j].region == finalRegion) {
+				queuedAgain = true;
+				break;
+			}
+		}
+		if (queuedAgain) {
+			continue;
+		}
 		bool onlyAir = true;
 		voxel::RawVolume copy(v, voxel::Region(finalRegion.getLowerCorner() - 2, finalRegion.getUpperCorner() + 2), &onlyAir);
 		const glm::ivec3& mins = finalRegion.getLowerCorner();
 		if (!onlyAir) {
-			_threadPool.enqueue([movedCopy = core::move(copy), mins, idx, finalRegion, this] () {
+			const bool binaryMesher = _binaryMesher->boolVal();
+			_threadPool.enqueue([movedCopy = core::move(copy), mins, idx, finalRegion, binaryMesher, this] () {
 				++_runningExtractorTasks;
 				voxel::Mesh mesh(65536, 65536, true);
-				voxel::extractCubicMesh(&movedCopy, finalRegion, &mesh, voxel::IsQuadNeeded(), mins);
+				if (binaryMesher) {
+					voxel::extractBinaryCubicMesh(&movedCopy, finalRegion, &mesh, mins);
+				} else {
+					voxel::extractCubicMesh(&movedCopy, finalRegion, &mesh, voxel::IsQuadNeeded(), mins);
+				}
 				_pendingQueue.emplace(mins, idx, core::move(mesh));
 				Log::debug("Enqueue mesh for idx: %i (%i:%i:%i)", idx, mins.x, mins.y, mins.z);
 				--_runningExtractorTasks;
@@ -199,20 +221,69 @@ bool RawVolumeRenderer::scheduleExtractions(size_t maxExtraction) {
 void RawVolumeRenderer::update() {
 	scheduleExtractions();
 	ExtractionCtx result;
-	int cnt = 0;
+	// the mesh cell mins and the volume index of the meshes that were extracted since the last frame
+	core::DynamicArray<glm::ivec4> updates;
 	while (_pendingQueue.pop(result)) {
 		Meshes& meshes = _meshes[result.mins];
 		if (meshes[result.idx] != nullptr) {
 			delete meshes[result.idx];
 		}
 		meshes[result.idx] = new voxel::Mesh(core::move(result.mesh));
-		if (!updateBufferForVolume(result.idx)) {
-			Log::error("Failed to update the mesh at index %i", result.idx);
+		updates.emplace_back(result.mins, result.idx);
+	}
+	// a full update of a volume already includes all the other cell meshes of this volume
+	bool fullUpdate[MAX_VOLUMES];
+	core_memset(fullUpdate, 0, sizeof(fullUpdate));
+	for (const glm::ivec4& u : updates) {
+		const int idx = u.w;
+		if (fullUpdate[idx]) {
+			continue;
+		}
+		const State& state = _state[idx];
+		const glm::ivec3 mins(u);
+		bool success;
+		if (state._slots.find(mins) == state._slots.end()) {
+			fullUpdate[idx] = true;
+			success = updateBufferForVolume(idx);
+		} else {
+			success = updateBufferForRegion(idx, mins);
+		}
+		if (!success) {
+			Log::error("Failed to update the mesh at index %i", idx);
+		}
+	}
+	if (!updates.empty()) {
+		Log::debug("Perform %i mesh updates in this frame", (int)updates.size());
+	}
+}
+
+/**
+ * @brief The slack of a buffer slot - the amount of elements a re-extracted mesh cell may grow
+ * without the need to upload the whole volume again
+ */
+static inline uint32_t slotCapacity(size_t elements) {
+	return (uint32_t)(elements + elements / 4u + 96u);
+}
+
+/**
+ * @brief Copies the mesh into the buffer slot. The indices are moved by the vertex offset of the slot,
+ * the unused indices are filled with degenerated triangles.
+ */
+static void fillBufferSlot(const voxel::Mesh* mesh, uint32_t vertexOffset, uint32_t indexCapacity, voxel::VoxelVertex* vertices, voxel::IndexType* indices) {
+	uint32_t indexCount = 0u;
+	if (mesh != nullptr && mesh->getNoOfIndices() > 0) {
+		const voxel::VertexArray& vertexVector = mesh->getVertexVector();
+		const voxel::IndexArray& indexVector = mesh->getIndexVector();
+		if (vertices != nullptr) {
+			core_memcpy(vertices, &vertexVector[0], vertexVector.size() * sizeof(voxel::VoxelVertex));
+		}
+		indexCount = (uint32_t)indexVector.size();
+		for (uint32_t i = 0u; i < indexCount; ++i) {
+			indices[i] = indexVector[i] + vertexOffset;
 		}
-		++cnt;
 	}
-	if (cnt > 0) {
-		Log::debug("Perform %i mesh updates in this frame", cnt);
+	for (uint32_t i = indexCount; i < indexCapacity; ++i) {
+		indices[i] = (voxel::IndexType)vertexOffset;
 	}
 }
 
@@ -222,6 +293,8 @@ bool RawVolumeRenderer::updateBufferForVolume(int idx) {
 	}
 	core_trace_scoped(RawVolumeRendererUpdate);
 
+	State& state = _state[idx];
+	state._slots.clear();
 	size_t vertCount = 0u;
 	size_t indCount = 0u;
 	for (auto& i : _meshes) {
@@ -230,13 +303,17 @@ bool RawVolumeRenderer::updateBufferForVolume(int idx) {
 		if (mesh == nullptr || mesh->getNoOfIndices() <= 0) {
 			continue;
 		}
-		const voxel::VertexArray& vertexVector = mesh->getVertexVector();
-		const voxel::IndexArray& indexVector = mesh->getIndexVector();
-		vertCount += vertexVector.size();
-		indCount += indexVector.size();
+		BufferSlot slot;
+		slot.vertexOffset = (uint32_t)vertCount;
+		slot.vertexCapacity = slotCapacity(mesh->getNoOfVertices());
+		slot.indexOffset = (uint32_t)indCount;
+		// keep the triangle list intact
+		slot.indexCapacity = slotCapacity(mesh->getNoOfIndices()) / 3u * 3u;
+		vertCount += slot.vertexCapacity;
+		indCount += slot.indexCapacity;
+		state._slots.emplace(i.first, slot);
 	}
 
-	State& state = _state[idx];
 	if (indCount == 0u || vertCount == 0u) {
 		state._vertexBuffer.update(state._vertexBufferIndex, nullptr, 0);
 		state._vertexBuffer.update(state._indexBufferIndex, nullptr, 0);
@@ -247,34 +324,20 @@ bool RawVolumeRenderer::updateBufferForVolume(int idx) {
 	voxel::VoxelVertex* verticesBuf = (voxel::VoxelVertex*)core_malloc(verticesBufSize);
 	const size_t indicesBufSize = indCount * sizeof(voxel::IndexType);
 	voxel::IndexType* indicesBuf = (voxel::IndexType*)core_malloc(indicesBufSize);
+	// the unused vertices are never referenced - but don't upload random memory
+	core_memset(verticesBuf, 0, verticesBufSize);
 
-	voxel::VoxelVertex* verticesPos = verticesBuf;
-	voxel::IndexType* indicesPos = indicesBuf;
-
-	voxel::IndexType offset = (voxel::IndexType)0;
-	for (auto& i : _meshes) {
-		const Meshes& meshes = i.second;
-		const voxel::Mesh* mesh = meshes[idx];
-		if (mesh == nullptr || mesh->getNoOfIndices() <= 0) {
-			continue;
-		}
-		const voxel::VertexArray& vertexVector = mesh->getVertexVector();
-		const voxel::IndexArray& indexVector = mesh->getIndexVector();
-		core_memcpy(verticesPos, &vertexVector[0], vertexVector.size() * sizeof(voxel::VoxelVertex));
-		core_memcpy(indicesPos, &indexVector[0], indexVector.size() * sizeof(voxel::IndexType));
-
-		for (size_t i = 0; i < indexVector.size(); ++i) {
-			*indicesPos++ += offset;
-		}
-
-		verticesPos += vertexVector.size();
-		offset += vertexVector.size();
+	for (const auto& e : state._slots) {
+		const BufferSlot& slot = e.second;
+		const voxel::Mesh* mesh = _meshes[e.first][idx];
+		fillBufferSlot(mesh, slot.vertexOffset, slot.indexCapacity, verticesBuf + slot.vertexOffset, indicesBuf + slot.indexOffset);
 	}
 
 	if (!state._vertexBuffer.update(state._vertexBufferIndex, verticesBuf, verticesBufSize)) {
 		Log::error("Failed to update the vertex buffer");
 		core_free(indicesBuf);
 		core_free(verticesBuf);
+		state._slots.clear();
 		return false;
 	}
 	core_free(verticesBuf);
@@ -282,12 +345,54 @@ bool RawVolumeRenderer::updateBufferForVolume(int idx) {
 	if (!state._vertexBuffer.update(state._indexBufferIndex, indicesBuf, indicesBufSize)) {
 		Log::error("Failed to update the index buffer");
 		core_free(indicesBuf);
+		state._slots.clear();
 		return false;
 	}
 	core_free(indicesBuf);
 	return true;
 }
 
+bool RawVolumeRenderer::updateBufferForRegion(int idx, const glm::ivec3& mins) {
+	if (idx < 0 || idx >= MAX_VOLUMES) {
+		return false;
+	}
+	State& state = _state[idx];
+	auto slotIter = state._slots.find(mins);
+	if (slotIter == state._slots.end()) {
+		return updateBufferForVolume(idx);
+	}
+	const BufferSlot& slot = slotIter->second;
+	const voxel::Mesh* mesh = nullptr;
+	auto meshIter = _meshes.find(mins);
+	if (meshIter != _meshes.end()) {
+		mesh = meshIter->second[idx];
+	}
+	const size_t vertCount = mesh == nullptr ? 0u : mesh->getNoOfVertices();
+	const size_t indCount = mesh == nullptr ? 0u : mesh->getNoOfIndices();
+	if (vertCount > slot.vertexCapacity || indCount > slot.indexCapacity) {
+		return updateBufferForVolume(idx);
+	}
+	core_trace_scoped(RawVolumeRendererUpdateRegion);
+
+	if (indCount > 0u) {
+		const voxel::VertexArray& vertexVector = mesh->getVertexVector();
+		if (!state._vertexBuffer.updateRange(state._vertexBufferIndex, slot.vertexOffset * sizeof(voxel::VoxelVertex),
+				&vertexVector[0], vertCount * sizeof(voxel::VoxelVertex))) {
+			return updateBufferForVolume(idx);
+		}
+	}
+	const size_t indicesBufSize = slot.indexCapacity * sizeof(voxel::IndexType);
+	voxel::IndexType* indicesBuf = (voxel::IndexType*)core_malloc(indicesBufSize);
+	fillBufferSlot(mesh, slot.vertexOffset, slot.indexCapacity, nullptr, indicesBuf);
+	const bool success = state._vertexBuffer.updateRange(state._indexBufferIndex, slot.indexOffset * sizeof(voxel::IndexType),
+			indicesBuf, indicesBufSize);
+	core_free(indicesBuf);
+	if (!success) {
+		return updateBufferForVolume(idx);
+	}
+	return true;
+}
+
 bool RawVolumeRenderer::updateBufferForVolume(int idx, const voxel::VertexArray& vertices, const voxel::IndexArray& indices) {
 	if (idx < 0 || idx >= MAX_VOLUMES) {
 		return false;
@@ -295,6 +400,7 @@ bool RawVolumeRenderer::updateBufferForVolume(int idx, const voxel::VertexArray&
 	core_trace_scoped(RawVolumeRendererUpdate);
 
 	State& state = _state[idx];
+	state._slots.clear();
 	if (indices.empty() || vertices.empty()) {
 		state._vertexBuffer.update(state._vertexBufferIndex, nullptr, 0);
 		state._vertexBuffer.update(state._indexBufferIndex, nullptr, 0);
@@ -360,6 +466,7 @@ void RawVolumeRenderer::deleteMeshes(Meshes& meshes, int idx) {
 	delete meshes[idx];
 	meshes[idx] = nullptr;
 	State& state = _state[idx];
+	state._slots.clear();
 	state._vertexBuffer.update(state._vertexBufferIndex, nullptr, 0);
 	state._vertexBuffer.update(state._indexBufferIndex, nullptr, 0);
 }
@@ -430,7 +537,11 @@ void RawVolumeRenderer::clearPendingExtractions() {
 void RawVolumeRenderer::extractVolumeRegionToMesh(voxel::RawVolume* volume, const voxel::Region& region, voxel::Mesh* mesh) const {
 	voxel::Region reg = region;
 	reg.shiftUpperCorner(1, 1, 1);
-	voxel::extractCubicMesh(volume, reg, mesh, voxel::IsQuadNeeded(), reg.getLowerCorner());
+	if (_binaryMesher->boolVal()) {
+		voxel::extractBinaryCubicMesh(volume, reg, mesh, reg.getLowerCorner());
+	} else {
+		voxel::extractCubicMesh(volume, reg, mesh, voxel::IsQuadNeeded(), reg.getLowerCorner());
+	}
 }
 
 bool RawVolumeRenderer::hidden(int idx) const {
@@ -53,6 +53,16 @@ class RawVolumeRenderer : public core::NonCopyable {
 public:
 	static constexpr int MAX_VOLUMES = 2048;
 protected:
+	/**
+	 * @brief The range of a mesh cell in the vertex and index buffer of a volume. The ranges are allocated
+	 * with some slack to be able to upload a re-extracted cell without re-uploading the whole volume.
+	 */
+	struct BufferSlot {
+		uint32_t vertexOffset = 0u;
+		uint32_t vertexCapacity = 0u;
+		uint32_t indexOffset = 0u;
+		uint32_t indexCapacity = 0u;
+	};
 	struct State {
 		bool _hidden = false;
 		bool _gray = false;
@@ -64,6 +74,7 @@ protected:
 		video::Buffer _vertexBuffer;
 		voxel::RawVolume* _rawVolume = nullptr;
 		core::Optional<voxel::Palette> _palette;
+		std::unordered_map<glm::ivec3, BufferSlot> _slots;
 	};
 	core::Array<State, MAX_VOLUMES> _state {};
 	typedef core::Array<voxel::Mesh*, MAX_VOLUMES> Meshes;
@@ -80,6 +91,7 @@ protected:
 	render::BloomRenderer _bloomRenderer;
 
 	core::VarPtr _meshSize;
+	core::VarPtr _binaryMesher;
 	core::VarPtr _shadowMap;
 	core::VarPtr _bloom;
 
@@ -115,6 +127,11 @@ protected:
 	voxel::Region calculateExtractRegion(int x, int y, int z, const glm::ivec3& meshSize) const;
 	void updatePalette(int idx);
 	void deleteMeshes(Meshes& meshes, int idx);
+	/**
+	 * @brief Uploads only the buffer range of the mesh cell at the given position
+	 * @note Falls back to updateBufferForVolume() if the mesh doesn't fit into the range anymore
+	 */
+	bool updateBufferForRegion(int idx, const glm::ivec3& mins);
 public:
 	RawVolumeRenderer();
 
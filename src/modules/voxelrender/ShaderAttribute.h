@@ -43,6 +43,21 @@ inline video::Attribute getInfoVertexAttribute(uint32_t bufferIndex, uint32_t at
 	return attrib;
 }
 
+/**
+ * @brief The attribute for the voxel::PackedVoxelVertex - it's decoded in the shader
+ */
+inline video::Attribute getPackedVertexAttribute(uint32_t bufferIndex, uint32_t attributeLocation, int components = 1) {
+	video::Attribute attrib;
+	attrib.bufferIndex = (int32_t)bufferIndex;
+	attrib.location = (int32_t)attributeLocation;
+	attrib.stride = sizeof(voxel::PackedVoxelVertex);
+	attrib.size = components;
+	attrib.type = video::mapType<decltype(voxel::PackedVoxelVertex::data)>();
+	attrib.typeIsInt = true;
+	attrib.offset = offsetof(voxel::PackedVoxelVertex, data);
+	return attrib;
+}
+
 inline video::Attribute getOffsetVertexAttribute(uint32_t bufferIndex, uint32_t attributeLocation, int components) {
 	video::Attribute voxelAttributeOffsets;
 	voxelAttributeOffsets.bufferIndex = (int32_t)bufferIndex;
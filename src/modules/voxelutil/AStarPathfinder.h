@@ -5,6 +5,7 @@
 #pragma once
 
 #include "AStarPathfinderImpl.h"
+#include "core/ArrayLength.h"
 #include "core/Common.h"
 #include "core/Assert.h"
 #include "core/GLM.h"
@@ -13,6 +14,7 @@
 #include <glm/gtc/constants.hpp>
 #include <glm/geometric.hpp>
 
+#include <algorithm>
 #include <functional>
 
 namespace voxelutil {
@@ -114,10 +116,17 @@ class AStarPathfinder {
 public:
 	AStarPathfinder(const AStarPathfinderParams<VolumeType>& params);
 
+	/**
+	 * @brief Replace the parameters for the next execute() call - this allows to reuse the memory of the node
+	 * containers for several searches.
+	 */
+	void setParams(const AStarPathfinderParams<VolumeType>& params);
+
 	bool execute();
 
 private:
 	void processNeighbour(const glm::ivec3& neighbourPos, float neighbourGVal);
+	int addNode(const glm::ivec3& pos);
 
 	float SixConnectedCost(const glm::ivec3& a, const glm::ivec3& b);
 	float EighteenConnectedCost(const glm::ivec3& a, const glm::ivec3& b);
@@ -125,13 +134,13 @@ private:
 	float computeH(const glm::ivec3& a, const glm::ivec3& b);
 	uint32_t hash(uint32_t a);
 
-	// Node containers
+	// Node containers - they are only cleared between the searches to keep their memory
 	AllNodesContainer _allNodes;
+	NodeIndexMap _nodeIndices;
 	OpenNodesContainer _openNodes;
-	ClosedNodesContainer _closedNodes;
 
-	// The current node
-	AllNodesContainer::iterator _current;
+	// The index of the current node
+	int _current = -1;
 
 	float _progress = 0.0f;
 
@@ -146,35 +155,46 @@ AStarPathfinder<VolumeType>::AStarPathfinder(const AStarPathfinderParams<VolumeT
 		_params(params) {
 }
 
+template<typename VolumeType>
+void AStarPathfinder<VolumeType>::setParams(const AStarPathfinderParams<VolumeType>& params) {
+	_params = params;
+}
+
+template<typename VolumeType>
+int AStarPathfinder<VolumeType>::addNode(const glm::ivec3& pos) {
+	const int idx = (int)_allNodes.size();
+	if (_allNodes.size() == _allNodes.capacity()) {
+		// the array only grows by a fixed amount otherwise
+		_allNodes.reserve(core_max(_allNodes.capacity() * 2u, (size_t)1024u));
+	}
+	_allNodes.emplace_back(pos);
+	_nodeIndices.insert(pos, idx);
+	return idx;
+}
+
 template<typename VolumeType>
 bool AStarPathfinder<VolumeType>::execute() {
 	//Clear any existing nodes
 	_allNodes.clear();
-	_openNodes.clear();
-	_closedNodes.clear();
+	_nodeIndices.clear();
+	_openNodes.init(&_allNodes);
 
 	//Clear the result
 	_params.result->clear();
 
-	//Iterators to start and end node.
-	AllNodesContainer::iterator startNode = _allNodes.insert(Node(_params.start.x, _params.start.y, _params.start.z)).first;
-	AllNodesContainer::iterator endNode = _allNodes.insert(Node(_params.end.x, _params.end.y, _params.end.z)).first;
-
-	//Regarding the const_cast - normally you should not modify an object which is in an std::set.
-	//The reason is that objects in a set are stored sorted in a tree so they can be accessed quickly,
-	//and changing the object directly can break the sorting. However, in our case we have provided a
-	//custom sort operator for the set which we know only uses the position to sort. Hence we can safely
-	//modify other properties of the object while it is in the set.
-	Node* tempStart = const_cast<Node*>(&(*startNode));
-	tempStart->gVal = 0;
-	tempStart->hVal = computeH(startNode->position, endNode->position);
+	const int startNode = addNode(_params.start);
+	int endNode = _nodeIndices.find(_params.end);
+	if (endNode == -1) {
+		endNode = addNode(_params.end);
+	}
 
-	Node* tempEnd = const_cast<Node*>(&(*endNode));
-	tempEnd->hVal = 0.0f;
+	_allNodes[startNode].gVal = 0;
+	_allNodes[startNode].hVal = computeH(_params.start, _params.end);
+	_allNodes[endNode].hVal = 0.0f;
 
 	_openNodes.insert(startNode);
 
-	float fDistStartToEnd = glm::length(glm::vec3(endNode->position) - glm::vec3(startNode->position));
+	float fDistStartToEnd = glm::length(glm::vec3(_params.end) - glm::vec3(_params.start));
 	_progress = 0.0f;
 	if (_params.progressCallback) {
 		_params.progressCallback(_progress);
@@ -212,16 +232,23 @@ bool AStarPathfinder<VolumeType>::execute() {
 			glm::ivec3(+1, +1, -1),
 			glm::ivec3(+1, +1, +1) };
 
+	//The distance from one cell to another connected by face, edge, or corner.
+	const float fFaceCost = 1.0f;
+	const float fEdgeCost = glm::root_two<float>();
+	const float fCornerCost = glm::root_three<float>();
+
 	while (!_openNodes.empty() && _openNodes.getFirst() != endNode) {
 		//Move the first node from open to closed.
-		_current = _openNodes.getFirst();
-		_openNodes.removeFirst();
-		_closedNodes.insert(_current);
+		_current = _openNodes.removeFirst();
+
+		// copy the values - the node array might grow while the neighbours are processed
+		const glm::ivec3 currentPos = _allNodes[_current].position;
+		const float currentGVal = _allNodes[_current].gVal;
 
 		//Update the user on our progress
 		if (_params.progressCallback) {
 			const float fMinProgresIncreament = 0.001f;
-			float fDistCurrentToEnd = glm::length(glm::vec3(endNode->position) - glm::vec3(_current->position));
+			float fDistCurrentToEnd = glm::length(glm::vec3(_params.end) - glm::vec3(currentPos));
 			float fDistNormalised = fDistCurrentToEnd / fDistStartToEnd;
 			float fProgress = 1.0f - fDistNormalised;
 			if (fProgress >= _progress + fMinProgresIncreament) {
@@ -230,47 +257,25 @@ bool AStarPathfinder<VolumeType>::execute() {
 			}
 		}
 
-		//The distance from one cell to another connected by face, edge, or corner.
-		const float fFaceCost = 1.0f;
-		const float fEdgeCost = glm::root_two<float>();
-		const float fCornerCost = glm::root_three<float>();
-
 		//Process the neighbours. Note the deliberate lack of 'break'
 		//statements, larger connectivities include smaller ones.
 		switch (_params.connectivity) {
 		case TwentySixConnected:
-			processNeighbour(_current->position + arrayPathfinderCorners[0], _current->gVal + fCornerCost);
-			processNeighbour(_current->position + arrayPathfinderCorners[1], _current->gVal + fCornerCost);
-			processNeighbour(_current->position + arrayPathfinderCorners[2], _current->gVal + fCornerCost);
-			processNeighbour(_current->position + arrayPathfinderCorners[3], _current->gVal + fCornerCost);
-			processNeighbour(_current->position + arrayPathfinderCorners[4], _current->gVal + fCornerCost);
-			processNeighbour(_current->position + arrayPathfinderCorners[5], _current->gVal + fCornerCost);
-			processNeighbour(_current->position + arrayPathfinderCorners[6], _current->gVal + fCornerCost);
-			processNeighbour(_current->position + arrayPathfinderCorners[7], _current->gVal + fCornerCost);
+			for (int i = 0; i < lengthof(arrayPathfinderCorners); ++i) {
+				processNeighbour(currentPos + arrayPathfinderCorners[i], currentGVal + fCornerCost);
+			}
 			/* fallthrough */
 
 		case EighteenConnected:
-			processNeighbour(_current->position + arrayPathfinderEdges[0], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[1], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[2], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[3], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[4], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[5], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[6], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[7], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[8], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[9], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[10], _current->gVal + fEdgeCost);
-			processNeighbour(_current->position + arrayPathfinderEdges[11], _current->gVal + fEdgeCost);
+			for (int i = 0; i < lengthof(arrayPathfinderEdges); ++i) {
+				processNeighbour(currentPos + arrayPathfinderEdges[i], currentGVal + fEdgeCost);
+			}
 			/* fallthrough */
 
 		case SixConnected:
-			processNeighbour(_current->position + arrayPathfinderFaces[0], _current->gVal + fFaceCost);
-			processNeighbour(_current->position + arrayPathfinderFaces[1], _current->gVal + fFaceCost);
-			processNeighbour(_current->position + arrayPathfinderFaces[2], _current->gVal + fFaceCost);
-			processNeighbour(_current->position + arrayPathfinderFaces[3], _current->gVal + fFaceCost);
-			processNeighbour(_current->position + arrayPathfinderFaces[4], _current->gVal + fFaceCost);
-			processNeighbour(_current->position + arrayPathfinderFaces[5], _current->gVal + fFaceCost);
+			for (int i = 0; i < lengthof(arrayPathfinderFaces); ++i) {
+				processNeighbour(currentPos + arrayPathfinderFaces[i], currentGVal + fFaceCost);
+			}
 			break;
 		}
 
@@ -284,15 +289,8 @@ bool AStarPathfinder<VolumeType>::execute() {
 		Log::debug("We've failed to find a valid path.");
 		return false;
 	}
-	//Regarding the const_cast - normally you should not modify an object which is in an std::set.
-	//The reason is that objects in a set are stored sorted in a tree so they can be accessed quickly,
-	//and changing the object directly can break the sorting. However, in our case we have provided a
-	//custom sort operator for the set which we know only uses the position to sort. Hence we can safely
-	//modify other properties of the object while it is in the set.
-	Node* n = const_cast<Node*>(&(*endNode));
-	while (n != 0) {
-		_params.result->insert_front(n->position);
-		n = n->parent;
+	for (int n = endNode; n != -1; n = _allNodes[n].parent) {
+		_params.result->insert_front(_allNodes[n].position);
 	}
 
 	if (_params.progressCallback) {
@@ -304,50 +302,35 @@ bool AStarPathfinder<VolumeType>::execute() {
 
 template<typename VolumeType>
 void AStarPathfinder<VolumeType>::processNeighbour(const glm::ivec3& neighbourPos, float neighbourGVal) {
+	const float cost = neighbourGVal;
+
+	int neighbour = _nodeIndices.find(neighbourPos);
+	// nodes in the open or closed list are only touched again if we found a cheaper way to them
+	if (neighbour != -1 && _allNodes[neighbour].heapIndex != Node::NotOpen) {
+		if (!(cost < _allNodes[neighbour].gVal)) {
+			return;
+		}
+	}
+
 	bool bIsVoxelValidForPath = _params.isVoxelValidForPath(_params.volume, neighbourPos);
 	if (!bIsVoxelValidForPath) {
 		return;
 	}
 
-	float cost = neighbourGVal;
-
-	std::pair<AllNodesContainer::iterator, bool> insertResult = _allNodes.insert(Node(neighbourPos.x, neighbourPos.y, neighbourPos.z));
-	AllNodesContainer::iterator neighbour = insertResult.first;
-
-	if (insertResult.second) {
+	if (neighbour == -1) {
 		//New node, compute h.
-		Node* tempNeighbour = const_cast<Node*>(&(*neighbour));
-		tempNeighbour->hVal = computeH(neighbour->position, _params.end);
-	}
-
-	OpenNodesContainer::iterator openIter = _openNodes.find(neighbour);
-	if (openIter != _openNodes.end()) {
-		if (cost < neighbour->gVal) {
-			_openNodes.remove(openIter);
-			openIter = _openNodes.end();
-		}
-	}
-
-	//TODO - Nodes could keep track of if they are in open or closed? And a pointer to where they are?
-	ClosedNodesContainer::iterator closedIter = _closedNodes.find(neighbour);
-	if (closedIter != _closedNodes.end()) {
-		if (cost < neighbour->gVal) {
-			//Probably shouldn't happen?
-			_closedNodes.remove(closedIter);
-			closedIter = _closedNodes.end();
-		}
+		neighbour = addNode(neighbourPos);
+		_allNodes[neighbour].hVal = computeH(neighbourPos, _params.end);
 	}
 
-	if (openIter == _openNodes.end() && closedIter == _closedNodes.end()) {
-		//Regarding the const_cast - normally you should not modify an object which is in an std::set.
-		//The reason is that objects in a set are stored sorted in a tree so they can be accessed quickly,
-		//and changing the object directly can break the sorting. However, in our case we have provided a
-		//custom sort operator for the set which we know only uses the position to sort. Hence we can safely
-		//modify other properties of the object while it is in the set.
-		Node* temp = const_cast<Node*>(&(*neighbour));
-		temp->gVal = cost;
+	Node& node = _allNodes[neighbour];
+	node.gVal = cost;
+	node.parent = _current;
+	if (node.heapIndex >= 0) {
+		_openNodes.decreased(neighbour);
+	} else {
+		// new nodes and closed nodes that are reached on a cheaper way are (re-)opened
 		_openNodes.insert(neighbour);
-		temp->parent = const_cast<Node*>(&(*_current));
 	}
 }
 
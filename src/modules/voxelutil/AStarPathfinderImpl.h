@@ -4,18 +4,14 @@
 
 #pragma once
 
+#include "core/Assert.h"
 #include "core/Common.h"
+#include "core/collection/DynamicArray.h"
 #include <glm/vec3.hpp>
-#include <algorithm>
 #include <limits> //For numeric_limits
-#include <set>
-#include <vector>
 
 namespace voxelutil {
 
-class OpenNodesContainer;
-class ClosedNodesContainer;
-
 /// The Connectivity of a voxel determines how many neighbours it has.
 enum Connectivity {
 	/// Each voxel has six neighbours, which are those sharing a face.
@@ -26,137 +22,228 @@ enum Connectivity {
 	TwentySixConnected
 };
 
+/**
+ * @brief A node of the search - nodes are stored in a flat array and reference each other by index
+ */
 struct Node {
-	Node(int x, int y, int z) :
-			// Initialise with NaNs so that we will know if we forget to set these properly.
-			gVal(std::numeric_limits<float>::quiet_NaN()), hVal(std::numeric_limits<float>::quiet_NaN()), parent(nullptr) {
-		position = {x, y, z};
-	}
-
-	bool operator==(const Node& rhs) const {
-		return position == rhs.position;
-	}
+	/// The node isn't in the open list - and was never expanded
+	static constexpr int NotOpen = -1;
+	/// The node was already expanded
+	static constexpr int Closed = -2;
 
-	bool operator<(const Node& rhs) const {
-		if (position.x < rhs.position.x)
-			return true;
-		if (rhs.position.x < position.x)
-			return false;
-
-		if (position.y < rhs.position.y)
-			return true;
-		if (rhs.position.y < position.y)
-			return false;
-
-		if (position.z < rhs.position.z)
-			return true;
-		if (rhs.position.z < position.z)
-			return false;
-
-		return false;
+	Node(const glm::ivec3 &pos) :
+			// Initialise with NaNs so that we will know if we forget to set these properly.
+			position(pos), gVal(std::numeric_limits<float>::quiet_NaN()), hVal(std::numeric_limits<float>::quiet_NaN()) {
 	}
 
 	glm::ivec3 position;
 	float gVal;
 	float hVal;
-	Node* parent;
+	/// Index of the node we came from or @c -1 for the start node
+	int parent = -1;
+	/// Index in the open list heap or one of @c NotOpen and @c Closed
+	int heapIndex = NotOpen;
 
 	inline float f() const {
 		return gVal + hVal;
 	}
 };
 
-typedef std::set<Node> AllNodesContainer;
+typedef core::DynamicArray<Node> AllNodesContainer;
 
-class AllNodesContainerIteratorComparator {
-public:
-	bool operator()(const AllNodesContainer::iterator& lhs, const AllNodesContainer::iterator& rhs) const {
-		return (&(*lhs)) < (&(*rhs));
+/**
+ * @brief Maps the voxel positions to the index of their node
+ *
+ * Open addressing with linear probing over a flat slot array - the memory is kept between the searches.
+ */
+class NodeIndexMap {
+private:
+	struct Slot {
+		glm::ivec3 position;
+		int node;
+	};
+	core::DynamicArray<Slot> _slots;
+	size_t _mask = 0u;
+	size_t _size = 0u;
+
+	static inline size_t hash(const glm::ivec3 &pos) {
+		// the low bits are used as slot index - mix all bits of the coordinates into them to avoid long probe chains
+		uint64_t h = (uint64_t)(uint32_t)pos.x ^ ((uint64_t)(uint32_t)pos.y << 21) ^ ((uint64_t)(uint32_t)pos.z << 42);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ull;
+		h ^= h >> 33;
+		return (size_t)h;
+	}
+
+	void grow() {
+		core::DynamicArray<Slot> old;
+		old.resize(_slots.size());
+		for (size_t i = 0; i < _slots.size(); ++i) {
+			old[i] = _slots[i];
+		}
+		const size_t capacity = _slots.empty() ? 1024u : _slots.size() * 2u;
+		_slots.resize(capacity);
+		_mask = capacity - 1u;
+		clear();
+		for (size_t i = 0; i < old.size(); ++i) {
+			if (old[i].node != -1) {
+				insert(old[i].position, old[i].node);
+			}
+		}
 	}
-};
 
-class NodeSort {
 public:
-	bool operator()(const AllNodesContainer::iterator& lhs, const AllNodesContainer::iterator& rhs) const {
-		return lhs->f() > rhs->f();
+	void clear() {
+		for (size_t i = 0; i < _slots.size(); ++i) {
+			_slots[i].node = -1;
+		}
+		_size = 0u;
+	}
+
+	/**
+	 * @return The index of the node at the given position or @c -1
+	 */
+	int find(const glm::ivec3 &pos) const {
+		if (_slots.empty()) {
+			return -1;
+		}
+		for (size_t i = hash(pos) & _mask;; i = (i + 1u) & _mask) {
+			const Slot &slot = _slots[i];
+			if (slot.node == -1) {
+				return -1;
+			}
+			if (slot.position == pos) {
+				return slot.node;
+			}
+		}
+	}
+
+	/**
+	 * @note The position must not be in the map yet
+	 */
+	void insert(const glm::ivec3 &pos, int node) {
+		// keep the load factor below 50 percent
+		if ((_size + 1u) * 2u > _slots.size()) {
+			grow();
+		}
+		for (size_t i = hash(pos) & _mask;; i = (i + 1u) & _mask) {
+			Slot &slot = _slots[i];
+			if (slot.node == -1) {
+				slot.position = pos;
+				slot.node = node;
+				++_size;
+				return;
+			}
+			core_assert(slot.position != pos);
+		}
 	}
 };
 
+/**
+ * @brief Binary min heap over the f() values of the nodes
+ *
+ * The nodes remember their position in the heap - this allows to update the costs of a node that is already in the
+ * open list without searching for it.
+ */
 class OpenNodesContainer {
-public:
-	typedef std::vector<AllNodesContainer::iterator>::iterator iterator;
-
-public:
-	inline void clear() {
-		open.clear();
-	}
-
-	inline bool empty() const {
-		return open.empty();
-	}
-
-	void insert(AllNodesContainer::iterator node) {
-		open.push_back(node);
-		push_heap(open.begin(), open.end(), NodeSort());
-	}
-
-	inline AllNodesContainer::iterator getFirst() {
-		return open[0];
-	}
-
-	void removeFirst() {
-		pop_heap(open.begin(), open.end(), NodeSort());
-		open.pop_back();
-	}
-
-	void remove(iterator iterToRemove) {
-		open.erase(iterToRemove);
-		make_heap(open.begin(), open.end(), NodeSort());
-	}
-
-	inline iterator begin() {
-		return open.begin();
-	}
-
-	inline iterator end() {
-		return open.end();
-	}
-
-	iterator find(AllNodesContainer::iterator node) {
-		return std::find(open.begin(), open.end(), node);
-	}
-
 private:
-	std::vector<AllNodesContainer::iterator> open;
-};
-
-class ClosedNodesContainer {
-public:
-	typedef std::set<AllNodesContainer::iterator, AllNodesContainerIteratorComparator>::iterator iterator;
-
-public:
-	inline void clear() {
-		closed.clear();
-	}
-
-	inline void insert(AllNodesContainer::iterator node) {
-		closed.insert(node);
+	core::DynamicArray<int> _heap;
+	AllNodesContainer *_nodes = nullptr;
+
+	inline bool less(int a, int b) const {
+		return (*_nodes)[_heap[a]].f() < (*_nodes)[_heap[b]].f();
+	}
+
+	inline void swap(int a, int b) {
+		const int nodeA = _heap[a];
+		const int nodeB = _heap[b];
+		_heap[a] = nodeB;
+		_heap[b] = nodeA;
+		(*_nodes)[nodeB].heapIndex = a;
+		(*_nodes)[nodeA].heapIndex = b;
+	}
+
+	void siftUp(int i) {
+		while (i > 0) {
+			const int parent = (i - 1) / 2;
+			if (!less(i, parent)) {
+				break;
+			}
+			swap(i, parent);
+			i = parent;
+		}
+	}
+
+	void siftDown(int i) {
+		const int n = (int)_heap.size();
+		for (;;) {
+			const int left = 2 * i + 1;
+			if (left >= n) {
+				break;
+			}
+			int smallest = left;
+			const int right = left + 1;
+			if (right < n && less(right, left)) {
+				smallest = right;
+			}
+			if (!less(smallest, i)) {
+				break;
+			}
+			swap(i, smallest);
+			i = smallest;
+		}
 	}
 
-	inline void remove(iterator iterToRemove) {
-		closed.erase(iterToRemove);
-	}
-
-	inline iterator end() {
-		return closed.end();
+public:
+	inline void init(AllNodesContainer *nodes) {
+		_nodes = nodes;
+		_heap.clear();
 	}
 
-	inline iterator find(AllNodesContainer::iterator node) {
-		return closed.find(node);
+	inline bool empty() const {
+		return _heap.empty();
+	}
+
+	inline int getFirst() const {
+		return _heap[0];
+	}
+
+	void insert(int node) {
+		const int i = (int)_heap.size();
+		if (_heap.size() == _heap.capacity()) {
+			// the array only grows by a fixed amount otherwise
+			_heap.reserve(core_max(_heap.capacity() * 2u, (size_t)1024u));
+		}
+		_heap.push_back(node);
+		(*_nodes)[node].heapIndex = i;
+		siftUp(i);
+	}
+
+	/**
+	 * @brief Restores the heap order after the costs of the given node were lowered
+	 */
+	void decreased(int node) {
+		siftUp((*_nodes)[node].heapIndex);
+	}
+
+	/**
+	 * @brief Removes the first node and marks it as closed
+	 */
+	int removeFirst() {
+		const int first = _heap[0];
+		const int last = (int)_heap.size() - 1;
+		if (last > 0) {
+			swap(0, last);
+		}
+		_heap.pop();
+		(*_nodes)[first].heapIndex = Node::Closed;
+		if (!_heap.empty()) {
+			siftDown(0);
+		}
+		return first;
 	}
-
-private:
-	std::set<AllNodesContainer::iterator, AllNodesContainerIteratorComparator> closed;
 };
 
 }
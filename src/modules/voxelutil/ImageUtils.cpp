@@ -163,7 +163,7 @@ voxel::RawVolume* importAsPlane(const image::ImagePtr& image, uint8_t thickness)
 	}
 	Log::info("Import image as plane: w(%i), h(%i), d(%i)", imageWidth, imageHeight, thickness);
 	const voxel::Region region(0, 0, 0, imageWidth - 1, imageHeight - 1, thickness - 1);
-	const voxel::Palette &palette = voxel::getPalette();
+	voxel::PaletteLookup palLookup(voxel::getPalette());
 	voxel::RawVolume* volume = new voxel::RawVolume(region);
 	for (int x = 0; x < imageWidth; ++x) {
 		for (int y = 0; y < imageHeight; ++y) {
@@ -171,8 +171,7 @@ voxel::RawVolume* importAsPlane(const image::ImagePtr& image, uint8_t thickness)
 			if (data.a == 0) {
 				continue;
 			}
-			const glm::vec4& color = core::Color::fromRGBA(data);
-			const uint8_t index = palette.getClosestMatch(color);
+			const uint8_t index = palLookup.findClosestIndex(data);
 			const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, index);
 			for (int z = 0; z < thickness; ++z) {
 				volume->setVoxel(x, (imageHeight - 1) - y, z, voxel);
@@ -0,0 +1,132 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/Trace.h"
+#include "core/collection/BitSet.h"
+#include "core/collection/DynamicArray.h"
+#include <glm/vec3.hpp>
+
+namespace voxelutil {
+
+/**
+ * @brief Span based flood fill over the cells of a box
+ *
+ * The cells are addressed in local coordinates from @c 0 to @c dim-1. Instead of visiting the neighbours of each
+ * single cell, whole runs along the x axis are filled at once and only the rows next to such a run are scanned for
+ * new runs. The visited cells are tracked in a bitset - this keeps the memory usage low and doesn't need any
+ * recursion for large areas.
+ *
+ * The fill callback gets the local coordinates of a cell and is executed at most once per cell. Return @c true to
+ * add the cell to the filled area and continue the fill from there. Rejected cells are marked as visited, too.
+ */
+class ScanlineFill {
+private:
+	struct Span {
+		int x0;
+		int x1;
+		int y;
+		int z;
+	};
+	const glm::ivec3 _dim;
+	core::BitSet _visited;
+	core::DynamicArray<Span> _spans;
+
+	inline int index(int x, int y, int z) const {
+		return (z * _dim.y + y) * _dim.x + x;
+	}
+
+	template<class FUNC>
+	inline bool tryFill(int x, int y, int z, FUNC &&func) {
+		const int idx = index(x, y, z);
+		if (_visited[idx]) {
+			return false;
+		}
+		_visited.set(idx, true);
+		return func(x, y, z);
+	}
+
+	/**
+	 * @brief Extends the already filled cell to a run along the x axis and queues the run
+	 * @return The amount of filled cells of the run
+	 */
+	template<class FUNC>
+	int addSpan(int x, int y, int z, FUNC &&func) {
+		int x0 = x;
+		while (x0 > 0 && tryFill(x0 - 1, y, z, func)) {
+			--x0;
+		}
+		int x1 = x;
+		while (x1 < _dim.x - 1 && tryFill(x1 + 1, y, z, func)) {
+			++x1;
+		}
+		_spans.push_back(Span{x0, x1, y, z});
+		return x1 - x0 + 1;
+	}
+
+	template<class FUNC>
+	int scanRow(const Span &span, int y, int z, FUNC &&func) {
+		int n = 0;
+		for (int x = span.x0; x <= span.x1; ++x) {
+			if (!tryFill(x, y, z, func)) {
+				continue;
+			}
+			n += addSpan(x, y, z, func);
+			// the new run might reach beyond the current one - continue behind it
+			x = _spans.back().x1 + 1;
+		}
+		return n;
+	}
+
+public:
+	ScanlineFill(const glm::ivec3 &dim) : _dim(dim), _visited(dim.x * dim.y * dim.z) {
+	}
+
+	inline const glm::ivec3 &dimensions() const {
+		return _dim;
+	}
+
+	/**
+	 * @return @c true if the fill callback was already executed for the given cell
+	 */
+	inline bool visited(int x, int y, int z) const {
+		return _visited[index(x, y, z)];
+	}
+
+	/**
+	 * @brief Starts a fill at the given cell
+	 * @return The amount of cells that were filled - @c 0 if the start cell was rejected or already visited
+	 */
+	template<class FUNC>
+	int fill(int x, int y, int z, FUNC &&func) {
+		if (x < 0 || y < 0 || z < 0 || x >= _dim.x || y >= _dim.y || z >= _dim.z) {
+			return 0;
+		}
+		if (!tryFill(x, y, z, func)) {
+			return 0;
+		}
+		core_trace_scoped(ScanlineFill);
+		int n = addSpan(x, y, z, func);
+		while (!_spans.empty()) {
+			const Span span = _spans.back();
+			_spans.pop();
+			if (span.y > 0) {
+				n += scanRow(span, span.y - 1, span.z, func);
+			}
+			if (span.y < _dim.y - 1) {
+				n += scanRow(span, span.y + 1, span.z, func);
+			}
+			if (span.z > 0) {
+				n += scanRow(span, span.y, span.z - 1, func);
+			}
+			if (span.z < _dim.z - 1) {
+				n += scanRow(span, span.y, span.z + 1, func);
+			}
+		}
+		return n;
+	}
+};
+
+} // namespace voxelutil
@@ -0,0 +1,91 @@
+/**
+ * @file
+ */
+
+#include "VolumeRescaler.h"
+#include "app/Parallel.h"
+#include "core/StandardLib.h"
+
+namespace voxelutil {
+
+/**
+ * @brief Computes one level of the mip chain - the z slices are processed in parallel
+ *
+ * The material-air boundary pass reads the result of the first pass and writes into a second buffer - this way
+ * the slices don't depend on the progress of their neighbours.
+ */
+static voxel::RawVolume *rescaleLevel(const voxel::RawVolume &sourceVolume, const voxel::Region &destRegion,
+									  const voxel::Palette &palette,
+									  const core::DynamicArray<glm::vec4> &materialColors) {
+	core_trace_scoped(RescaleLevel);
+	const glm::ivec3 &srcMins = sourceVolume.region().getLowerCorner();
+	const glm::ivec3 &dim = destRegion.getDimensionsInVoxels();
+	const int strideZ = dim.x * dim.y;
+	const size_t size = (size_t)strideZ * dim.z * sizeof(voxel::Voxel);
+	voxel::Voxel *rescaled = (voxel::Voxel *)core_malloc(size);
+	voxel::Voxel *colored = (voxel::Voxel *)core_malloc(size);
+
+	app::for_parallel(dim.z, [&](int z) {
+		voxel::RawVolume::Sampler srcSampler(sourceVolume);
+		voxel::Voxel *slice = rescaled + z * strideZ;
+		for (int32_t y = 0; y < dim.y; ++y) {
+			for (int32_t x = 0; x < dim.x; ++x) {
+				const glm::ivec3 srcPos = srcMins + glm::ivec3(x, y, z) * 2;
+				slice[x + y * dim.x] = rescaleVoxel(srcSampler, srcPos, palette, materialColors);
+			}
+		}
+	});
+
+	// everything outside of the level is air
+	auto isAir = [&](int32_t x, int32_t y, int32_t z) {
+		if (x < 0 || y < 0 || z < 0 || x >= dim.x || y >= dim.y || z >= dim.z) {
+			return true;
+		}
+		return rescaled[x + y * dim.x + z * strideZ].getMaterial() == voxel::VoxelType::Air;
+	};
+	app::for_parallel(dim.z, [&](int z) {
+		voxel::RawVolume::Sampler srcSampler(sourceVolume);
+		for (int32_t y = 0; y < dim.y; ++y) {
+			for (int32_t x = 0; x < dim.x; ++x) {
+				const int idx = x + y * dim.x + z * strideZ;
+				const voxel::Voxel &voxel = rescaled[idx];
+				// only the voxels on a material-air boundary get a new color - see rescaleVolume()
+				if (voxel.getMaterial() == voxel::VoxelType::Air ||
+					(!isAir(x, y, z - 1) && !isAir(x, y, z + 1) && !isAir(x, y - 1, z) && !isAir(x, y + 1, z) &&
+					 !isAir(x - 1, y, z) && !isAir(x + 1, y, z))) {
+					colored[idx] = voxel;
+					continue;
+				}
+				const glm::ivec3 srcPos = srcMins + glm::ivec3(x, y, z) * 2;
+				colored[idx] = rescaleBoundaryVoxel(srcSampler, srcPos, palette, materialColors);
+			}
+		}
+	});
+	core_free(rescaled);
+	return voxel::RawVolume::createRaw(colored, destRegion);
+}
+
+core::DynamicArray<voxel::RawVolume *> rescaleVolumeMipChain(const voxel::RawVolume &sourceVolume, int maxLevels) {
+	core_trace_scoped(RescaleVolumeMipChain);
+	const voxel::Palette &palette = voxel::getPalette();
+	core::DynamicArray<glm::vec4> materialColors;
+	palette.toVec4f(materialColors);
+
+	core::DynamicArray<voxel::RawVolume *> levels;
+	levels.reserve(core_max(0, maxLevels));
+	const voxel::RawVolume *source = &sourceVolume;
+	for (int level = 0; level < maxLevels; ++level) {
+		const voxel::Region &srcRegion = source->region();
+		const glm::ivec3 &dimensionsHalf = srcRegion.getDimensionsInVoxels() / 2;
+		if (dimensionsHalf.x <= 0 || dimensionsHalf.y <= 0 || dimensionsHalf.z <= 0) {
+			break;
+		}
+		const voxel::Region destRegion(srcRegion.getLowerCorner(), srcRegion.getLowerCorner() + dimensionsHalf - 1);
+		voxel::RawVolume *rescaled = rescaleLevel(*source, destRegion, palette, materialColors);
+		levels.push_back(rescaled);
+		source = rescaled;
+	}
+	return levels;
+}
+
+} // namespace voxelutil
@@ -3,11 +3,14 @@
  */
 #pragma once
 
+#include "core/Assert.h"
 #include "core/Common.h"
 #include "core/Trace.h"
 #include "core/Color.h"
+#include "core/collection/DynamicArray.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/Palette.h"
+#include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
 #include "voxel/Region.h"
 
@@ -35,6 +38,129 @@ static bool isHidden(Sampler &srcSampler) {
 	return true;
 }
 
+/**
+ * @brief Computes the voxel of a rescaled volume from the eight corresponding voxels of the source volume
+ * @param[in] srcPos The position of the first of the eight source voxels
+ * @sa rescaleVolume()
+ */
+template<typename Sampler>
+voxel::Voxel rescaleVoxel(Sampler &srcSampler, const glm::ivec3 &srcPos, const voxel::Palette &palette,
+						  const core::DynamicArray<glm::vec4> &materialColors) {
+	float colorContributors = 0.0f;
+	float solidVoxels = 0.0f;
+	float avgColorRed = 0.0f;
+	float avgColorGreen = 0.0f;
+	float avgColorBlue = 0.0f;
+	voxel::Voxel colorGuardVoxel;
+	for (int32_t childZ = 0; childZ < 2; ++childZ) {
+		for (int32_t childY = 0; childY < 2; ++childY) {
+			for (int32_t childX = 0; childX < 2; ++childX) {
+				srcSampler.setPosition(srcPos + glm::ivec3(childX, childY, childZ));
+				if (!srcSampler.currentPositionValid()) {
+					continue;
+				}
+				const voxel::Voxel& child = srcSampler.voxel();
+
+				if (isBlocked(child.getMaterial())) {
+					++solidVoxels;
+					if (isHidden(srcSampler)) {
+						colorGuardVoxel = child;
+						continue;
+					}
+					const glm::vec4& color = core::Color::fromRGBA(palette.colors[child.getColor()]);
+					avgColorRed += color.r;
+					avgColorGreen += color.g;
+					avgColorBlue += color.b;
+					++colorContributors;
+				}
+			}
+		}
+	}
+
+	// We only make a voxel solid if the eight corresponding voxels are also all solid. This
+	// means that higher LOD meshes actually shrink away which ensures cracks aren't visible.
+	if (solidVoxels >= 7.0f) {
+		if (colorContributors <= 0.0f) {
+			const glm::vec4 &color = core::Color::fromRGBA(palette.colors[colorGuardVoxel.getColor()]);
+			avgColorRed += color.r;
+			avgColorGreen += color.g;
+			avgColorBlue += color.b;
+			++colorContributors;
+		}
+		const glm::vec4 avgColor(avgColorRed / colorContributors, avgColorGreen / colorContributors, avgColorBlue / colorContributors, 1.0f);
+		const int index = core::Color::getClosestMatch(avgColor, materialColors);
+		return createVoxel(voxel::VoxelType::Generic, index);
+	}
+	return voxel::Voxel();
+}
+
+/**
+ * @brief Recomputes the color of a rescaled voxel on a material-air boundary from the 64 (4x4x4) source voxels
+ * around it - weighted by the exposed faces of the source voxels
+ * @param[in] srcPos The position of the first of the eight source voxels that were merged into the rescaled voxel
+ * @sa rescaleVolume()
+ */
+template<typename Sampler>
+voxel::Voxel rescaleBoundaryVoxel(Sampler &srcSampler, const glm::ivec3 &srcPos, const voxel::Palette &palette,
+								  const core::DynamicArray<glm::vec4> &materialColors) {
+	float totalRed = 0.0f;
+	float totalGreen = 0.0f;
+	float totalBlue = 0.0f;
+	float totalExposedFaces = 0.0f;
+
+	// Look at the 64 (4x4x4) children
+	for (int32_t childZ = -1; childZ < 3; childZ++) {
+		for (int32_t childY = -1; childY < 3; childY++) {
+			for (int32_t childX = -1; childX < 3; childX++) {
+				srcSampler.setPosition(srcPos + glm::ivec3(childX, childY, childZ));
+
+				const voxel::Voxel& child = srcSampler.voxel();
+				if (child.getMaterial() == voxel::VoxelType::Air) {
+					continue;
+				}
+
+				// For each small voxel, count the exposed faces and use this
+				// to determine the importance of the color contribution.
+				float exposedFaces = 0.0f;
+				if (srcSampler.peekVoxel0px0py1nz().getMaterial() == voxel::VoxelType::Air) {
+					++exposedFaces;
+				}
+				if (srcSampler.peekVoxel0px0py1pz().getMaterial() == voxel::VoxelType::Air) {
+					++exposedFaces;
+				}
+				if (srcSampler.peekVoxel0px1ny0pz().getMaterial() == voxel::VoxelType::Air) {
+					++exposedFaces;
+				}
+				if (srcSampler.peekVoxel0px1py0pz().getMaterial() == voxel::VoxelType::Air) {
+					++exposedFaces;
+				}
+				if (srcSampler.peekVoxel1nx0py0pz().getMaterial() == voxel::VoxelType::Air) {
+					++exposedFaces;
+				}
+				if (srcSampler.peekVoxel1px0py0pz().getMaterial() == voxel::VoxelType::Air) {
+					++exposedFaces;
+				}
+
+				const glm::vec4& color = core::Color::fromRGBA(palette.colors[child.getColor()]);
+				totalRed += color.r * exposedFaces;
+				totalGreen += color.g * exposedFaces;
+				totalBlue += color.b * exposedFaces;
+
+				totalExposedFaces += exposedFaces;
+			}
+		}
+	}
+
+	// Avoid divide by zero if there were no exposed faces.
+	if (totalExposedFaces <= 0.01f) {
+		++totalExposedFaces;
+	}
+
+	const glm::vec4 avgColor(totalRed / totalExposedFaces, totalGreen / totalExposedFaces, totalBlue / totalExposedFaces, 1.0f);
+	const int index = core::Color::getClosestMatch(avgColor, materialColors);
+	return createVoxel(voxel::VoxelType::Generic, index);
+}
+
 /**
  * @brief Rescales a volume by sampling two voxels to produce one output voxel.
  * @param[in] sourceVolume The source volume to resample
@@ -42,6 +168,7 @@ static bool isHidden(Sampler &srcSampler) {
  * @param[in] sourceRegion The region of the source volume to resample
  * @param[in] destRegion The region of the destination volume to resample into. Usually this should
  * be exactly half of the size of the sourceRegion.
+ * @sa rescaleVolumeMipChain()
  */
 template<typename SourceVolume, typename DestVolume>
 void rescaleVolume(const SourceVolume& sourceVolume, const voxel::Region& sourceRegion, DestVolume& destVolume, const voxel::Region& destRegion) {
@@ -63,56 +190,7 @@ void rescaleVolume(const SourceVolume& sourceVolume, const voxel::Region& source
 				const glm::ivec3 curPos(x, y, z);
 				const glm::ivec3 srcPos = sourceRegion.getLowerCorner() + curPos * 2;
 				const glm::ivec3 dstPos = destRegion.getLowerCorner() + curPos;
-
-				float colorContributors = 0.0f;
-				float solidVoxels = 0.0f;
-				float avgColorRed = 0.0f;
-				float avgColorGreen = 0.0f;
-				float avgColorBlue = 0.0f;
-				voxel::Voxel colorGuardVoxel;
-				for (int32_t childZ = 0; childZ < 2; ++childZ) {
-					for (int32_t childY = 0; childY < 2; ++childY) {
-						for (int32_t childX = 0; childX < 2; ++childX) {
-							srcSampler.setPosition(srcPos + glm::ivec3(childX, childY, childZ));
-							if (!srcSampler.currentPositionValid()) {
-								continue;
-							}
-							const voxel::Voxel& child = srcSampler.voxel();
-
-							if (isBlocked(child.getMaterial())) {
-								++solidVoxels;
-								if (isHidden(srcSampler)) {
-									colorGuardVoxel = child;
-									continue;
-								}
-								const glm::vec4& color = core::Color::fromRGBA(palette.colors[child.getColor()]);
-								avgColorRed += color.r;
-								avgColorGreen += color.g;
-								avgColorBlue += color.b;
-								++colorContributors;
-							}
-						}
-					}
-				}
-
-				// We only make a voxel solid if the eight corresponding voxels are also all solid. This
-				// means that higher LOD meshes actually shrink away which ensures cracks aren't visible.
-				if (solidVoxels >= 7.0f) {
-					if (colorContributors <= 0.0f) {
-						const glm::vec4 &color = core::Color::fromRGBA(palette.colors[colorGuardVoxel.getColor()]);
-						avgColorRed += color.r;
-						avgColorGreen += color.g;
-						avgColorBlue += color.b;
-						++colorContributors;
-					}
-					const glm::vec4 avgColor(avgColorRed / colorContributors, avgColorGreen / colorContributors, avgColorBlue / colorContributors, 1.0f);
-					const int index = core::Color::getClosestMatch(avgColor, materialColors);
-					voxel::Voxel voxel = createVoxel(voxel::VoxelType::Generic, index);
-					destVolume.setVoxel(dstPos, voxel);
-				} else {
-					const voxel::Voxel voxelAir;
-					destVolume.setVoxel(dstPos, voxelAir);
-				}
+				destVolume.setVoxel(dstPos, rescaleVoxel(srcSampler, srcPos, palette, materialColors));
 			}
 		}
 	}
@@ -143,64 +221,7 @@ void rescaleVolume(const SourceVolume& sourceVolume, const voxel::Region& source
 					continue;
 				}
 				const glm::ivec3 srcPos = sourceRegion.getLowerCorner() + curPos * 2;
-
-				float totalRed = 0.0f;
-				float totalGreen = 0.0f;
-				float totalBlue = 0.0f;
-				float totalExposedFaces = 0.0f;
-
-				// Look at the 64 (4x4x4) children
-				for (int32_t childZ = -1; childZ < 3; childZ++) {
-					for (int32_t childY = -1; childY < 3; childY++) {
-						for (int32_t childX = -1; childX < 3; childX++) {
-							srcSampler.setPosition(srcPos + glm::ivec3(childX, childY, childZ));
-
-							const voxel::Voxel& child = srcSampler.voxel();
-							if (child.getMaterial() == voxel::VoxelType::Air) {
-								continue;
-							}
-
-							// For each small voxel, count the exposed faces and use this
-							// to determine the importance of the color contribution.
-							float exposedFaces = 0.0f;
-							if (srcSampler.peekVoxel0px0py1nz().getMaterial() == voxel::VoxelType::Air) {
-								++exposedFaces;
-							}
-							if (srcSampler.peekVoxel0px0py1pz().getMaterial() == voxel::VoxelType::Air) {
-								++exposedFaces;
-							}
-							if (srcSampler.peekVoxel0px1ny0pz().getMaterial() == voxel::VoxelType::Air) {
-								++exposedFaces;
-							}
-							if (srcSampler.peekVoxel0px1py0pz().getMaterial() == voxel::VoxelType::Air) {
-								++exposedFaces;
-							}
-							if (srcSampler.peekVoxel1nx0py0pz().getMaterial() == voxel::VoxelType::Air) {
-								++exposedFaces;
-							}
-							if (srcSampler.peekVoxel1px0py0pz().getMaterial() == voxel::VoxelType::Air) {
-								++exposedFaces;
-							}
-
-							const glm::vec4& color = core::Color::fromRGBA(palette.colors[child.getColor()]);
-							totalRed += color.r * exposedFaces;
-							totalGreen += color.g * exposedFaces;
-							totalBlue += color.b * exposedFaces;
-
-							totalExposedFaces += exposedFaces;
-						}
-					}
-				}
-
-				// Avoid divide by zero if there were no exposed faces.
-				if (totalExposedFaces <= 0.01f) {
-					++totalExposedFaces;
-				}
-
-				const glm::vec4 avgColor(totalRed / totalExposedFaces, totalGreen / totalExposedFaces, totalBlue / totalExposedFaces, 1.0f);
-				const int index = core::Color::getClosestMatch(avgColor, materialColors);
-				const voxel::Voxel voxel = createVoxel(voxel::VoxelType::Generic, index);
-				destVolume.setVoxel(dstPos, voxel);
+				destVolume.setVoxel(dstPos, rescaleBoundaryVoxel(srcSampler, srcPos, palette, materialColors));
 			}
 		}
 	}
@@ -211,4 +232,67 @@ void rescaleVolume(const SourceVolume& sourceVolume, DestVolume& destVolume) {
 	rescaleVolume(sourceVolume, sourceVolume.region(), destVolume, destVolume.region());
 }
 
+/**
+ * @brief Builds the levels of detail of the given volume with the same sampling as rescaleVolume() - each level
+ * has half the size of the previous one.
+ *
+ * Only the first level is computed from the source volume, all other levels are computed from their previous
+ * level. The z slices of a level are processed in parallel on the app thread pool.
+ *
+ * @param[in] maxLevels The maximum amount of levels. The chain ends earlier if a level would be smaller than one
+ * voxel on any axis.
+ * @return The levels - starting with the half sized volume. The lower corner of all levels is the lower corner
+ * of the source region. It's the caller's responsibility to free the volumes.
+ */
+core::DynamicArray<voxel::RawVolume *> rescaleVolumeMipChain(const voxel::RawVolume &sourceVolume, int maxLevels);
+
+/**
+ * @brief Downsamples a volume by the given factor for level of detail meshes.
+ *
+ * A destination voxel is solid if any of the corresponding source voxels is solid - the topmost of them
+ * is taken over. Contrary to rescaleVolume() the surface never moves below the surface of the source
+ * volume - which means that the chunk borders of the downsampled mesh hide the cracks to the neighbours.
+ * This is also a lot faster, because there are no color computations involved.
+ *
+ * @param[in] sourceRegion The region of the source volume to downsample
+ * @param[in] destRegion The region of the destination volume. This should be the size of the @c sourceRegion
+ * divided by @c factor (rounded up).
+ * @note Only the solid voxels are written - the destination region is expected to be empty.
+ */
+template<typename SourceVolume, typename DestVolume>
+void downsampleVolume(const SourceVolume& sourceVolume, const voxel::Region& sourceRegion, DestVolume& destVolume, const voxel::Region& destRegion, int factor) {
+	core_trace_scoped(DownsampleVolume);
+	core_assert(factor >= 1);
+	typename SourceVolume::Sampler srcSampler(sourceVolume);
+	const glm::ivec3& srcMins = sourceRegion.getLowerCorner();
+	const glm::ivec3& srcMaxs = sourceRegion.getUpperCorner();
+	const glm::ivec3& dstMins = destRegion.getLowerCorner();
+	const glm::ivec3& dstMaxs = destRegion.getUpperCorner();
+	// the source voxels are visited from bottom to top - the upper voxels overwrite the lower ones
+	for (int32_t y = srcMins.y; y <= srcMaxs.y; ++y) {
+		const int32_t dstY = dstMins.y + (y - srcMins.y) / factor;
+		if (dstY > dstMaxs.y) {
+			break;
+		}
+		for (int32_t z = srcMins.z; z <= srcMaxs.z; ++z) {
+			const int32_t dstZ = dstMins.z + (z - srcMins.z) / factor;
+			if (dstZ > dstMaxs.z) {
+				break;
+			}
+			srcSampler.setPosition(srcMins.x, y, z);
+			for (int32_t x = srcMins.x; x <= srcMaxs.x; ++x, srcSampler.movePositiveX()) {
+				const voxel::Voxel& voxel = srcSampler.voxel();
+				if (voxel::isAir(voxel.getMaterial())) {
+					continue;
+				}
+				const int32_t dstX = dstMins.x + (x - srcMins.x) / factor;
+				if (dstX > dstMaxs.x) {
+					break;
+				}
+				destVolume.setVoxel(dstX, dstY, dstZ, voxel);
+			}
+		}
+	}
+}
+
 }
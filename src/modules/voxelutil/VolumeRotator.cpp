@@ -3,11 +3,14 @@
  */
 
 #include "VolumeRotator.h"
+#include "app/Parallel.h"
 #include "math/Axis.h"
 #include "voxel/RawVolume.h"
 #include "math/AABB.h"
 #include "core/GLM.h"
 #include "core/Assert.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
 #define GLM_ENABLE_EXPERIMENTAL
@@ -15,10 +18,117 @@
 
 namespace voxelutil {
 
+namespace {
+// edge length of the cubes that are copied at once - the source and target cache lines of such a cube stay in the cache
+constexpr int BlockSize = 16;
+// volumes with less voxels are permuted on the calling thread only
+constexpr int ParallelVoxels = 128 * 128 * 128;
+}
+
 static inline glm::vec4 transform(const glm::mat4x4 &mat, const glm::ivec3 &pos, const glm::vec4 &pivot) {
 	return glm::floor(mat * (glm::vec4((float)pos.x + 0.5f, (float)pos.y + 0.5f, (float)pos.z + 0.5f, 1.0f) - pivot));
 }
 
+/**
+ * @brief Copies the voxels into a new volume with exchanged and/or flipped axes - this covers all rotations by
+ * multiples of 90 degree and the mirroring without any floating point math.
+ *
+ * The voxels are copied in cubes of @c BlockSize voxels. Slabs of these cubes along the z axis are distributed over
+ * the workers of the thread pool for larger volumes.
+ *
+ * @param[in] axes The source axis for each axis of the new volume
+ * @param[in] flip Whether the axis of the new volume runs in the opposite direction of its source axis
+ * @param[in] destRegion The region of the new volume - the dimensions must match the exchanged source dimensions
+ */
+static voxel::RawVolume *permuteVolume(const voxel::RawVolume *source, const glm::ivec3 &axes, const glm::bvec3 &flip,
+									   const voxel::Region &destRegion) {
+	core_trace_scoped(PermuteVolume);
+	const glm::ivec3 &srcDim = source->region().getDimensionsInVoxels();
+	const glm::ivec3 &destDim = destRegion.getDimensionsInVoxels();
+	const glm::ivec3 srcStride(1, srcDim.x, srcDim.x * srcDim.y);
+	const glm::ivec3 destStride(1, destDim.x, destDim.x * destDim.y);
+	// the target index offset for a step along each of the source axes
+	glm::ivec3 step;
+	int base = 0;
+	for (int i = 0; i < 3; ++i) {
+		const int axis = axes[i];
+		core_assert_msg(srcDim[axis] == destDim[i], "Dimension mismatch for axis %i", i);
+		if (flip[i]) {
+			step[axis] = -destStride[i];
+			base += (srcDim[axis] - 1) * destStride[i];
+		} else {
+			step[axis] = destStride[i];
+		}
+	}
+
+	const voxel::Voxel *src = (const voxel::Voxel *)source->data();
+	voxel::Voxel *dest = (voxel::Voxel *)core_malloc((size_t)destDim.x * destDim.y * destDim.z * sizeof(voxel::Voxel));
+	auto copySlab = [=](int slab) {
+		const int z0 = slab * BlockSize;
+		const int z1 = core_min(z0 + BlockSize, srcDim.z);
+		for (int y0 = 0; y0 < srcDim.y; y0 += BlockSize) {
+			const int y1 = core_min(y0 + BlockSize, srcDim.y);
+			for (int x0 = 0; x0 < srcDim.x; x0 += BlockSize) {
+				const int x1 = core_min(x0 + BlockSize, srcDim.x);
+				for (int z = z0; z < z1; ++z) {
+					for (int y = y0; y < y1; ++y) {
+						int srcIdx = x0 + y * srcStride.y + z * srcStride.z;
+						int destIdx = base + x0 * step.x + y * step.y + z * step.z;
+						for (int x = x0; x < x1; ++x) {
+							dest[destIdx] = src[srcIdx];
+							++srcIdx;
+							destIdx += step.x;
+						}
+					}
+				}
+			}
+		}
+	};
+
+	const int slabs = (srcDim.z + BlockSize - 1) / BlockSize;
+	if (srcDim.x * srcDim.y * srcDim.z < ParallelVoxels) {
+		for (int slab = 0; slab < slabs; ++slab) {
+			copySlab(slab);
+		}
+	} else {
+		app::for_parallel(slabs, copySlab);
+	}
+	return voxel::RawVolume::createRaw(dest, destRegion);
+}
+
+/**
+ * @brief Rotates by exchanging the axes - the rotated volume keeps the center of the source volume
+ */
+static voxel::RawVolume *rotateVolumeAxes(const voxel::RawVolume *source, const glm::ivec3 &axes,
+										  const glm::bvec3 &flip) {
+	const voxel::Region &srcRegion = source->region();
+	const glm::ivec3 &srcDim = srcRegion.getDimensionsInVoxels();
+	const glm::ivec3 destDim(srcDim[axes.x], srcDim[axes.y], srcDim[axes.z]);
+	const glm::ivec3 mins = srcRegion.getCenter() - (destDim - 1) / 2;
+	return permuteVolume(source, axes, flip, voxel::Region(mins, mins + destDim - 1));
+}
+
+/**
+ * @brief Converts the rotation matrix into exchanged axes if it only rotates by multiples of 90 degree
+ */
+static bool toAxes(const glm::mat4 &mat, glm::ivec3 &axes, glm::bvec3 &flip) {
+	for (int i = 0; i < 3; ++i) {
+		axes[i] = -1;
+		for (int j = 0; j < 3; ++j) {
+			// row i of the matrix
+			const float v = mat[j][i];
+			if (glm::abs(v) > 0.5f) {
+				axes[i] = j;
+				flip[i] = v < 0.0f;
+			}
+		}
+		if (axes[i] == -1) {
+			return false;
+		}
+	}
+	return true;
+}
+
 /**
  * @param[in] source The RawVolume to rotate
  * @param[in] angles The angles for the x, y and z axis given in degrees
@@ -30,6 +140,13 @@ voxel::RawVolume* rotateVolume(const voxel::RawVolume* source, const glm::vec3&
 	const float yaw = glm::radians(angles.y);
 	const float roll = glm::radians(angles.z);
 	const glm::mat4& mat = glm::eulerAngleXYZ(pitch, yaw, roll);
+	if (glm::all(glm::equal(glm::mod(angles, 90.0f), glm::vec3(0.0f)))) {
+		glm::ivec3 axes;
+		glm::bvec3 flip;
+		if (toAxes(mat, axes, flip)) {
+			return rotateVolumeAxes(source, axes, flip);
+		}
+	}
 	const voxel::Region& srcRegion = source->region();
 	const glm::ivec3 maxs = srcRegion.getDimensionsInCells();
 
@@ -62,59 +179,29 @@ voxel::RawVolume* rotateVolume(const voxel::RawVolume* source, const glm::vec3&
 }
 
 voxel::RawVolume* rotateAxis(const voxel::RawVolume* source, math::Axis axis) {
-	const voxel::Region& region = source->region();
-	glm::vec3 rotVec{0.0f};
-	rotVec[math::getIndexForAxis(axis)] = 90.0f;
-	return rotateVolume(source, rotVec, region.getPivot());
+	switch (axis) {
+	case math::Axis::X:
+		return rotateVolumeAxes(source, glm::ivec3(0, 2, 1), glm::bvec3(false, true, false));
+	case math::Axis::Y:
+		return rotateVolumeAxes(source, glm::ivec3(2, 1, 0), glm::bvec3(false, false, true));
+	case math::Axis::Z:
+	default:
+		return rotateVolumeAxes(source, glm::ivec3(1, 0, 2), glm::bvec3(true, false, false));
+	}
 }
 
 voxel::RawVolume* mirrorAxis(const voxel::RawVolume* source, math::Axis axis) {
-	const voxel::Region& srcRegion = source->region();
-	voxel::RawVolume* destination = new voxel::RawVolume(source);
-	voxel::RawVolume::Sampler destSampler(destination);
-	voxel::RawVolume::Sampler srcSampler(source);
-
-	const glm::ivec3& mins = srcRegion.getLowerCorner();
-	const glm::ivec3& maxs = srcRegion.getUpperCorner();
-
-	if (axis == math::Axis::X) {
-		for (int32_t z = mins.z; z <= maxs.z; ++z) {
-			for (int32_t y = mins.y; y <= maxs.y; ++y) {
-				srcSampler.setPosition(mins.x, y, z);
-				destSampler.setPosition(maxs.x, y, z);
-				for (int32_t x = mins.x; x <= maxs.x; ++x) {
-					destSampler.setVoxel(srcSampler.voxel());
-					srcSampler.movePositiveX();
-					destSampler.moveNegativeX();
-				}
-			}
-		}
-	} else if (axis == math::Axis::Y) {
-		for (int32_t z = mins.z; z <= maxs.z; ++z) {
-			for (int32_t x = mins.x; x <= maxs.x; ++x) {
-				srcSampler.setPosition(x, mins.y, z);
-				destSampler.setPosition(x, maxs.y, z);
-				for (int32_t y = mins.y; y <= maxs.y; ++y) {
-					destSampler.setVoxel(srcSampler.voxel());
-					srcSampler.movePositiveY();
-					destSampler.moveNegativeY();
-				}
-			}
-		}
-	} else if (axis == math::Axis::Z) {
-		for (int32_t y = mins.y; y <= maxs.y; ++y) {
-			for (int32_t x = mins.x; x <= maxs.x; ++x) {
-				srcSampler.setPosition(x, y, mins.z);
-				destSampler.setPosition(x, y, maxs.z);
-				for (int32_t z = mins.z; z <= maxs.z; ++z) {
-					destSampler.setVoxel(srcSampler.voxel());
-					srcSampler.movePositiveZ();
-					destSampler.moveNegativeZ();
-				}
-			}
-		}
+	glm::bvec3 flip(false);
+	switch (axis) {
+	case math::Axis::X:
+	case math::Axis::Y:
+	case math::Axis::Z:
+		flip[math::getIndexForAxis(axis)] = true;
+		break;
+	default:
+		return new voxel::RawVolume(source);
 	}
-	return destination;
+	return permuteVolume(source, glm::ivec3(0, 1, 2), flip, source->region());
 }
 
 }
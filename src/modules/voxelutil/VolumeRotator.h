@@ -16,6 +16,7 @@ class Voxel;
 namespace voxelutil {
 /**
  * @brief Rotate the given volume by the given angles in degree
+ * @note Rotations by multiples of 90 degree only exchange the axes - they are exact and don't lose any voxels
  */
 extern voxel::RawVolume *rotateVolume(const voxel::RawVolume *source, const glm::vec3 &angles, const glm::vec3 &pivot);
 /**
@@ -5,15 +5,12 @@
 #include "VoxelUtil.h"
 #include "core/ArrayLength.h"
 #include "core/GLM.h"
-#include "core/collection/Array3DView.h"
-#include "core/collection/Buffer.h"
-#include "core/collection/DynamicArray.h"
-#include "core/collection/Set.h"
 #include "voxel/Face.h"
 #include "voxel/RawVolumeWrapper.h"
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
 #include "voxel/PaletteLookup.h"
+#include "voxelutil/ScanlineFill.h"
 #include "voxelutil/VolumeVisitor.h"
 
 namespace voxelutil {
@@ -102,102 +99,32 @@ bool copyIntoRegion(const voxel::RawVolume &in, voxel::RawVolume &out, const vox
 
 static void fillRegion(voxel::RawVolumeWrapper &in, const voxel::Voxel &voxel) {
 	const voxel::Region &region = in.region();
-	const int width = region.getWidthInVoxels();
-	const int height = region.getHeightInVoxels();
-	const int depth = region.getDepthInVoxels();
-	const int size = width * height * depth;
-	const glm::ivec3 mins = in.region().getLowerCorner();
-	core::DynamicArray<glm::ivec3> positions;
-	positions.reserve(size);
-	core::Buffer<bool> visitedData(size);
-	core::Array3DView<bool> visited(visitedData.data(), width, height, depth);
+	const glm::ivec3 &dim = region.getDimensionsInVoxels();
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const voxel::RawVolume *volume = in.volume();
 
-	visitVolume(
-		in, region, 1, 1, 1,
-		[&](int x, int y, int z, const voxel::Voxel &) { visited.set(x - mins.x, y - mins.y, z - mins.z, true); },
-		SkipEmpty());
-
-	for (int x = 0; x < width; ++x) {
-		for (int z = 1; z < depth - 1; ++z) {
-			const glm::ivec3 v1(x, 0, z);
-			if (voxel::isAir(in.voxel(v1 + mins).getMaterial())) {
-				positions.push_back(v1);
-				visited.set(v1, true);
-			}
-			const glm::ivec3 v2(x, height - 1, z);
-			if (voxel::isAir(in.voxel(v2 + mins).getMaterial())) {
-				positions.push_back(v2);
-				visited.set(v2, true);
-			}
-		}
-		for (int y = 0; y < height; ++y) {
-			const glm::ivec3 v1(x, y, 0);
-			if (voxel::isAir(in.voxel(v1 + mins).getMaterial())) {
-				positions.push_back(v1);
-				visited.set(v1, true);
-			}
-			const glm::ivec3 v2(x, y, depth - 1);
-			if (voxel::isAir(in.voxel(v2 + mins).getMaterial())) {
-				positions.push_back(v2);
-				visited.set(v2, true);
-			}
-		}
-	}
-	for (int y = 1; y < height - 1; ++y) {
-		for (int z = 1; z < depth - 1; ++z) {
-			const glm::ivec3 v1(0, y, z);
-			if (voxel::isAir(in.voxel(v1 + mins).getMaterial())) {
-				positions.push_back(v1);
-				visited.set(v1, true);
-			}
-			const glm::ivec3 v2(width - 1, y, z);
-			if (voxel::isAir(in.voxel(v2 + mins).getMaterial())) {
-				positions.push_back(v2);
-				visited.set(v2, true);
+	// flood the air that is connected to the border of the region - everything else is hollow
+	ScanlineFill outside(dim);
+	auto isOutside = [&](int x, int y, int z) {
+		return voxel::isAir(volume->voxel(mins.x + x, mins.y + y, mins.z + z).getMaterial());
+	};
+	for (int z = 0; z < dim.z; ++z) {
+		for (int y = 0; y < dim.y; ++y) {
+			if (z == 0 || z == dim.z - 1 || y == 0 || y == dim.y - 1) {
+				for (int x = 0; x < dim.x; ++x) {
+					outside.fill(x, y, z, isOutside);
+				}
+			} else {
+				outside.fill(0, y, z, isOutside);
+				outside.fill(dim.x - 1, y, z, isOutside);
 			}
 		}
 	}
 
-	while (!positions.empty()) {
-		const glm::ivec3 v = positions.back();
-		positions.erase(positions.size() - 1);
-
-		if (v.z > 0 && !visited.get(v.x, v.y, v.z - 1)) {
-			const glm::ivec3 v1(v.x, v.y, v.z - 1);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-		if (v.y > 0 && !visited.get(v.x, v.y - 1, v.z)) {
-			const glm::ivec3 v1(v.x, v.y - 1, v.z);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-		if (v.x > 0 && !visited.get(v.x - 1, v.y, v.z)) {
-			const glm::ivec3 v1(v.x - 1, v.y, v.z);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-		if (v.z < depth - 1 && !visited.get(v.x, v.y, v.z + 1)) {
-			const glm::ivec3 v1(v.x, v.y, v.z + 1);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-		if (v.y < height - 1 && !visited.get(v.x, v.y + 1, v.z)) {
-			const glm::ivec3 v1(v.x, v.y + 1, v.z);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-		if (v.x < width - 1 && !visited.get(v.x + 1, v.y, v.z)) {
-			const glm::ivec3 v1(v.x + 1, v.y, v.z);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-	}
-
 	visitVolume(
 		in, region, 1, 1, 1,
-		[&](int x, int y, int z, const voxel::Voxel &) {
-			if (!visited.get(x - mins.x, y - mins.y, z - mins.z)) {
+		[&](int x, int y, int z, const voxel::Voxel &v) {
+			if (voxel::isAir(v.getMaterial()) && !outside.visited(x - mins.x, y - mins.y, z - mins.z)) {
 				in.setVoxel(x, y, z, voxel);
 			}
 		},
@@ -208,59 +135,14 @@ void fillHollow(voxel::RawVolumeWrapper &in, const voxel::Voxel &voxel) {
 	fillRegion(in, voxel);
 }
 
-using IVec3Set = core::Set<glm::ivec3, 11, glm::hash<glm::ivec3>>;
-
-static int walkPlane_r(IVec3Set &visited, voxel::RawVolumeWrapper &in, const voxel::Region &region,
-					   const WalkCheckCallback &check, const WalkExecCallback &exec, const glm::ivec3 &position,
-					   const glm::ivec3 &checkOffset, voxel::FaceNames face) {
-	const glm::ivec3 checkPosition = position + checkOffset;
-	if (visited.has(checkPosition)) {
-		return 0;
-	}
-	visited.insert(checkPosition);
-	if (!region.containsPoint(position)) {
-		return 0;
-	}
-	if (!check(in, checkPosition)) {
-		return 0;
-	}
-	if (!exec(in, position)) {
-		return 0;
-	}
-	int n = 1;
-	if (region.containsPoint(position.x + 1, position.y, position.z)) {
-		n += walkPlane_r(visited, in, region, check, exec, glm::ivec3(position.x + 1, position.y, position.z), checkOffset,
-						 face);
-	}
-	if (region.containsPoint(position.x - 1, position.y, position.z)) {
-		n += walkPlane_r(visited, in, region, check, exec, glm::ivec3(position.x - 1, position.y, position.z), checkOffset,
-						 face);
-	}
-	if (region.containsPoint(position.x, position.y + 1, position.z)) {
-		n += walkPlane_r(visited, in, region, check, exec, glm::ivec3(position.x, position.y + 1, position.z), checkOffset,
-						 face);
-	}
-	if (region.containsPoint(position.x, position.y - 1, position.z)) {
-		n += walkPlane_r(visited, in, region, check, exec, glm::ivec3(position.x, position.y - 1, position.z), checkOffset,
-						 face);
-	}
-	if (region.containsPoint(position.x, position.y, position.z + 1)) {
-		n += walkPlane_r(visited, in, region, check, exec, glm::ivec3(position.x, position.y, position.z + 1), checkOffset,
-						 face);
-	}
-	if (region.containsPoint(position.x, position.y, position.z - 1)) {
-		n += walkPlane_r(visited, in, region, check, exec, glm::ivec3(position.x, position.y, position.z - 1), checkOffset,
-						 face);
-	}
-	return n;
-}
-
 static int walkPlane(voxel::RawVolumeWrapper &in, const glm::ivec3 &position, voxel::FaceNames face, int checkOffset,
 					 const WalkCheckCallback &check, const WalkExecCallback &exec) {
 	const voxel::Region &region = in.region();
 	glm::ivec3 mins = region.getLowerCorner();
 	glm::ivec3 maxs = region.getUpperCorner();
 	glm::ivec3 checkOffsetV(0);
+	// the axis of the face normal - the plane is spanned by the other two axes
+	int axis = 0;
 	switch (face) {
 	case voxel::FaceNames::PositiveX:
 		mins.x = position.x;
@@ -282,6 +164,7 @@ static int walkPlane(voxel::RawVolumeWrapper &in, const glm::ivec3 &position, vo
 		if (!region.isOnBorderY(position.y)) {
 			checkOffsetV.y = checkOffset;
 		}
+		axis = 1;
 		break;
 	case voxel::FaceNames::NegativeY:
 		mins.y = position.y;
@@ -289,6 +172,7 @@ static int walkPlane(voxel::RawVolumeWrapper &in, const glm::ivec3 &position, vo
 		if (!region.isOnBorderY(position.y)) {
 			checkOffsetV.y = -checkOffset;
 		}
+		axis = 1;
 		break;
 	case voxel::FaceNames::PositiveZ:
 		mins.z = position.z;
@@ -296,6 +180,7 @@ static int walkPlane(voxel::RawVolumeWrapper &in, const glm::ivec3 &position, vo
 		if (!region.isOnBorderZ(position.z)) {
 			checkOffsetV.z = checkOffset;
 		}
+		axis = 2;
 		break;
 	case voxel::FaceNames::NegativeZ:
 		mins.z = position.z;
@@ -303,15 +188,32 @@ static int walkPlane(voxel::RawVolumeWrapper &in, const glm::ivec3 &position, vo
 		if (!region.isOnBorderZ(position.z)) {
 			checkOffsetV.z = -checkOffset;
 		}
+		axis = 2;
 		break;
 	case voxel::FaceNames::Max:
 		return -1;
 	}
 	const voxel::Region walkRegion(mins, maxs);
-	const glm::ivec3 &dim = walkRegion.getDimensionsInVoxels();
-	const int maxSize = dim.x * dim.y * dim.z;
-	IVec3Set visited(maxSize);
-	return walkPlane_r(visited, in, walkRegion, check, exec, position, checkOffsetV, face);
+	if (!walkRegion.containsPoint(position)) {
+		return 0;
+	}
+
+	// map the plane axes to the x and y axes of the fill to get long spans
+	const int axis0 = axis == 0 ? 1 : 0;
+	const int axis1 = axis == 2 ? 1 : 2;
+	const glm::ivec3 &walkDim = walkRegion.getDimensionsInVoxels();
+	ScanlineFill plane(glm::ivec3(walkDim[axis0], walkDim[axis1], 1));
+	auto walk = [&](int x, int y, int) {
+		glm::ivec3 pos = mins;
+		pos[axis0] += x;
+		pos[axis1] += y;
+		if (!check(in, pos + checkOffsetV)) {
+			return false;
+		}
+		return exec(in, pos);
+	};
+	const glm::ivec3 start = position - mins;
+	return plane.fill(start[axis0], start[axis1], 0, walk);
 }
 
 static glm::vec2 calcUV(const glm::ivec3 &pos, const voxel::Region &region, voxel::FaceNames face) {
@@ -0,0 +1,92 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "voxel/PagedVolume.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/AStarPathfinder.h"
+
+static constexpr int MAX_BENCHMARK_VOLUME_SIZE = 256;
+
+class AStarPathfinderBenchmark : public app::AbstractBenchmark {
+public:
+	/**
+	 * @brief A floor with walls that have a gap at alternating ends - the path has to zig-zag through them
+	 */
+	template<class Volume>
+	void fill(int size, Volume *v) const {
+		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+		for (int x = 0; x < size; ++x) {
+			for (int z = 0; z < size; ++z) {
+				v->setVoxel(x, 0, z, voxel);
+			}
+		}
+		for (int x = 8; x < size; x += 8) {
+			const int gap = (x / 8) % 2 == 0 ? 0 : size - 1;
+			for (int z = 0; z < size; ++z) {
+				if (z == gap) {
+					continue;
+				}
+				v->setVoxel(x, 1, z, voxel);
+				v->setVoxel(x, 2, z, voxel);
+			}
+		}
+	}
+
+	template<class Volume>
+	static bool isWalkable(const Volume *v, const glm::ivec3 &pos) {
+		if (voxel::isBlocked(v->voxel(pos).getMaterial())) {
+			return false;
+		}
+		const glm::ivec3 below(pos.x, pos.y - 1, pos.z);
+		return voxel::isBlocked(v->voxel(below).getMaterial());
+	}
+
+	template<class Volume>
+	void execute(benchmark::State &state, const Volume *volume) const {
+		const int size = (int)state.range(0);
+		const glm::ivec3 start(0, 1, 0);
+		const glm::ivec3 end(size - 1, 1, size - 1);
+		core::List<glm::ivec3> listResult;
+		voxelutil::AStarPathfinderParams<Volume> params(volume, start, end, &listResult, isWalkable<Volume>, 1.0f,
+														size * size, voxelutil::TwentySixConnected);
+		voxelutil::AStarPathfinder<Volume> pathfinder(params);
+		for (auto _ : state) {
+			if (!pathfinder.execute()) {
+				state.SkipWithError("No path found");
+				break;
+			}
+		}
+	}
+
+	class BenchmarkPager : public voxel::PagedVolume::Pager {
+	public:
+		bool pageIn(voxel::PagedVolume::PagerContext &) override {
+			return false;
+		}
+
+		void pageOut(voxel::PagedVolume::Chunk *chunk) override {
+		}
+	};
+};
+
+BENCHMARK_DEFINE_F(AStarPathfinderBenchmark, RawVolume)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	voxel::RawVolume volume(voxel::Region(glm::ivec3(0), glm::ivec3(size - 1, 3, size - 1)));
+	fill(size, &volume);
+	execute(state, &volume);
+}
+
+BENCHMARK_DEFINE_F(AStarPathfinderBenchmark, PagedVolume)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	BenchmarkPager pager;
+	voxel::PagedVolume volume(&pager, 1024 * 1024 * 1024, 256);
+	fill(size, &volume);
+	execute(state, &volume);
+}
+
+BENCHMARK_REGISTER_F(AStarPathfinderBenchmark, RawVolume)->RangeMultiplier(2)->Range(32, MAX_BENCHMARK_VOLUME_SIZE);
+BENCHMARK_REGISTER_F(AStarPathfinderBenchmark, PagedVolume)->RangeMultiplier(2)->Range(32, MAX_BENCHMARK_VOLUME_SIZE);
+
+BENCHMARK_MAIN();
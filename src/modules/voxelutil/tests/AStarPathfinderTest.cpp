@@ -31,4 +31,44 @@ TEST_F(AStarPathfinderTest, test) {
 	EXPECT_EQ(20u, listResult.size());
 }
 
+TEST_F(AStarPathfinderTest, testWall) {
+	voxel::RawVolume volume(voxel::Region(0, 20));
+	for (int x = 0; x < 20; ++x) {
+		for (int z = 0; z < 20; ++z) {
+			volume.setVoxel(x, 0, z, createVoxel(voxel::VoxelType::Generic, 1));
+		}
+	}
+	// a wall at z == 10 with a gap at x == 19
+	for (int x = 0; x < 19; ++x) {
+		volume.setVoxel(x, 1, 10, createVoxel(voxel::VoxelType::Generic, 1));
+	}
+	auto isWalkable = [](const voxel::RawVolume *v, const glm::ivec3 &pos) {
+		if (!v->region().containsPoint(pos) || voxel::isBlocked(v->voxel(pos).getMaterial())) {
+			return false;
+		}
+		const glm::ivec3 below(pos.x, pos.y - 1, pos.z);
+		return voxel::isBlocked(v->voxel(below).getMaterial());
+	};
+	core::List<glm::ivec3> listResult;
+	AStarPathfinderParams<voxel::RawVolume> params(&volume, glm::ivec3(0, 1, 0), glm::ivec3(0, 1, 19), &listResult,
+												   isWalkable, 1.0f, 10000, SixConnected);
+	AStarPathfinder pathfinder(params);
+	ASSERT_TRUE(pathfinder.execute());
+	// 19 steps to the gap and back again and 19 steps along z
+	EXPECT_EQ(19u + 19u + 19u + 1u, listResult.size());
+	for (const glm::ivec3 &pos : listResult) {
+		EXPECT_TRUE(isWalkable(&volume, pos));
+	}
+
+	// the same pathfinder instance can be reused - the goal is unreachable now
+	volume.setVoxel(19, 1, 10, createVoxel(voxel::VoxelType::Generic, 1));
+	EXPECT_FALSE(pathfinder.execute());
+	EXPECT_TRUE(listResult.empty());
+
+	params.end = glm::ivec3(19, 1, 0);
+	pathfinder.setParams(params);
+	ASSERT_TRUE(pathfinder.execute());
+	EXPECT_EQ(20u, listResult.size());
+}
+
 } // namespace voxelutil
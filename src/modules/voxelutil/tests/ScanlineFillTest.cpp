@@ -0,0 +1,60 @@
+/**
+ * @file
+ */
+
+#include "voxelutil/ScanlineFill.h"
+#include "app/tests/AbstractTest.h"
+
+namespace voxelutil {
+
+class ScanlineFillTest : public app::AbstractTest {};
+
+TEST_F(ScanlineFillTest, testFillBox) {
+	const glm::ivec3 dim(7, 5, 3);
+	ScanlineFill fill(dim);
+	int calls = 0;
+	auto func = [&](int, int, int) {
+		++calls;
+		return true;
+	};
+	EXPECT_EQ(dim.x * dim.y * dim.z, fill.fill(3, 2, 1, func));
+	EXPECT_EQ(dim.x * dim.y * dim.z, calls) << "Each cell should only be visited once";
+	EXPECT_EQ(0, fill.fill(0, 0, 0, func));
+	EXPECT_EQ(dim.x * dim.y * dim.z, calls);
+}
+
+TEST_F(ScanlineFillTest, testFillOutside) {
+	ScanlineFill fill(glm::ivec3(4, 4, 1));
+	auto func = [](int, int, int) { return true; };
+	EXPECT_EQ(0, fill.fill(-1, 0, 0, func));
+	EXPECT_EQ(0, fill.fill(0, 4, 0, func));
+	EXPECT_FALSE(fill.visited(0, 0, 0));
+}
+
+TEST_F(ScanlineFillTest, testFillWalls) {
+	// a wall at x == 4 with a single gap at y == 8 - and a wall at y == 5 on the right side of it
+	const glm::ivec3 dim(9, 9, 1);
+	ScanlineFill fill(dim);
+	auto func = [](int x, int y, int) {
+		if (x == 4) {
+			return y == 8;
+		}
+		return x < 4 || y != 5;
+	};
+	// left side: 4 * 9 cells, the gap and the right side above the wall: 4 * 3
+	EXPECT_EQ(4 * 9 + 1 + 4 * 3, fill.fill(0, 0, 0, func));
+	EXPECT_TRUE(fill.visited(4, 0, 0)) << "Rejected cells should be marked as visited";
+	EXPECT_TRUE(fill.visited(5, 5, 0));
+	EXPECT_FALSE(fill.visited(5, 4, 0));
+	EXPECT_EQ(4 * 5, fill.fill(8, 0, 0, func));
+}
+
+TEST_F(ScanlineFillTest, testFillUShape) {
+	// the runs of the fill have to turn around the bottom of the U
+	const glm::ivec3 dim(5, 5, 5);
+	ScanlineFill fill(dim);
+	auto func = [](int x, int y, int) { return x == 0 || x == 4 || y == 0; };
+	EXPECT_EQ((5 + 4 + 4) * 5, fill.fill(4, 4, 4, func));
+}
+
+} // namespace voxelutil
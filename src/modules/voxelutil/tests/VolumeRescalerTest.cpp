@@ -0,0 +1,92 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxel/tests/TestHelper.h"
+#include "voxelutil/VolumeRescaler.h"
+
+namespace voxelutil {
+
+class VolumeRescalerTest: public app::AbstractTest {
+};
+
+TEST_F(VolumeRescalerTest, testDownsample) {
+	voxel::RawVolume volume(voxel::Region(-4, 3));
+	const voxel::Voxel rock = createVoxel(voxel::VoxelType::Rock, 1);
+	const voxel::Voxel grass = createVoxel(voxel::VoxelType::Grass, 2);
+	// a single column - the top voxel is grass
+	for (int y = -4; y <= 0; ++y) {
+		volume.setVoxel(-3, y, -4, y == 0 ? grass : rock);
+	}
+	voxel::RawVolume downsampled(voxel::Region(0, 3));
+	downsampleVolume(volume, volume.region(), downsampled, downsampled.region(), 2);
+	EXPECT_EQ(rock, downsampled.voxel(0, 0, 0));
+	EXPECT_EQ(rock, downsampled.voxel(0, 1, 0));
+	EXPECT_EQ(grass, downsampled.voxel(0, 2, 0)) << "The topmost voxel should be taken over";
+	EXPECT_TRUE(voxel::isAir(downsampled.voxel(0, 3, 0).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(downsampled.voxel(1, 0, 0).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(downsampled.voxel(0, 0, 1).getMaterial()));
+}
+
+TEST_F(VolumeRescalerTest, testDownsampleUnevenSize) {
+	voxel::RawVolume volume(voxel::Region(0, 4));
+	volume.setVoxel(4, 4, 4, createVoxel(voxel::VoxelType::Rock, 1));
+	voxel::RawVolume downsampled(voxel::Region(0, 1));
+	downsampleVolume(volume, volume.region(), downsampled, downsampled.region(), 4);
+	EXPECT_EQ(createVoxel(voxel::VoxelType::Rock, 1), downsampled.voxel(1, 1, 1));
+	EXPECT_TRUE(voxel::isAir(downsampled.voxel(0, 0, 0).getMaterial()));
+}
+
+TEST_F(VolumeRescalerTest, testMipChain) {
+	const voxel::Region region(glm::ivec3(-5, 2, 3), glm::ivec3(26, 33, 34));
+	voxel::RawVolume volume(region);
+	// a sphere with a colored cap
+	const glm::ivec3 &center = region.getCenter();
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				const glm::ivec3 delta = glm::ivec3(x, y, z) - center;
+				if (delta.x * delta.x + delta.y * delta.y + delta.z * delta.z <= 15 * 15) {
+					volume.setVoxel(x, y, z, createVoxel(voxel::VoxelType::Generic, y > center.y + 10 ? 2 : 1));
+				}
+			}
+		}
+	}
+
+	core::DynamicArray<voxel::RawVolume *> levels = rescaleVolumeMipChain(volume, 10);
+	ASSERT_EQ(5u, levels.size()) << "32 voxels should result in 16, 8, 4, 2 and 1 voxels";
+	int expectedSize = 16;
+	for (voxel::RawVolume *level : levels) {
+		EXPECT_EQ(region.getLowerCorner(), level->region().getLowerCorner());
+		EXPECT_EQ(glm::ivec3(expectedSize), level->region().getDimensionsInVoxels());
+		expectedSize /= 2;
+	}
+
+	// every level must match the single threaded rescaling of the previous level
+	const voxel::RawVolume *source = &volume;
+	for (voxel::RawVolume *level : levels) {
+		voxel::RawVolume expected(level->region());
+		rescaleVolume(*source, expected);
+		const voxel::Region &levelRegion = level->region();
+		for (int z = levelRegion.getLowerZ(); z <= levelRegion.getUpperZ(); ++z) {
+			for (int y = levelRegion.getLowerY(); y <= levelRegion.getUpperY(); ++y) {
+				for (int x = levelRegion.getLowerX(); x <= levelRegion.getUpperX(); ++x) {
+					ASSERT_TRUE(expected.voxel(x, y, z).isSame(level->voxel(x, y, z))) << x << ":" << y << ":" << z;
+				}
+			}
+		}
+		source = level;
+	}
+	for (voxel::RawVolume *level : levels) {
+		delete level;
+	}
+}
+
+TEST_F(VolumeRescalerTest, testMipChainTooSmall) {
+	voxel::RawVolume volume(voxel::Region(glm::ivec3(0), glm::ivec3(7, 0, 7)));
+	const core::DynamicArray<voxel::RawVolume *> &levels = rescaleVolumeMipChain(volume, 2);
+	EXPECT_TRUE(levels.empty());
+}
+
+}
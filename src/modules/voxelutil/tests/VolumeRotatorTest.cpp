@@ -6,6 +6,9 @@
 #include "voxel/MaterialColor.h"
 #include "voxel/tests/TestHelper.h"
 #include "voxelutil/VolumeRotator.h"
+#include "voxelutil/VolumeVisitor.h"
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/euler_angles.hpp>
 
 namespace voxelutil {
 
@@ -14,6 +17,61 @@ protected:
 	inline core::String str(const voxel::Region& region) const {
 		return region.toString();
 	}
+
+	void fill(voxel::RawVolume &volume) const {
+		const voxel::Region &region = volume.region();
+		int i = 0;
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					if (++i % 3 != 0) {
+						volume.setVoxel(x, y, z, createVoxel(voxel::VoxelType::Generic, i % 255));
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief The rotation by transforming each voxel with a float matrix - this is the reference for the axis
+	 * permutation that is used for multiples of 90 degree
+	 */
+	voxel::RawVolume *floatRotation(const voxel::RawVolume *source, const glm::vec3 &angles, const glm::vec3 &pivot) const {
+		const glm::mat4 &mat = glm::eulerAngleXYZ(glm::radians(angles.x), glm::radians(angles.y), glm::radians(angles.z));
+		auto transform = [&](const glm::ivec3 &pos) {
+			const glm::vec4 p((float)pos.x + 0.5f, (float)pos.y + 0.5f, (float)pos.z + 0.5f, 1.0f);
+			return glm::ivec3(glm::floor(mat * (p - glm::vec4(pivot, 0.0f))));
+		};
+		const voxel::Region &srcRegion = source->region();
+		const glm::ivec3 &transformedMins = transform(glm::ivec3(0));
+		const glm::ivec3 &transformedMaxs = transform(srcRegion.getDimensionsInCells());
+		voxel::RawVolume *destination =
+			new voxel::RawVolume(voxel::Region(glm::min(transformedMins, transformedMaxs), glm::max(transformedMins, transformedMaxs)));
+		for (int z = srcRegion.getLowerZ(); z <= srcRegion.getUpperZ(); ++z) {
+			for (int y = srcRegion.getLowerY(); y <= srcRegion.getUpperY(); ++y) {
+				for (int x = srcRegion.getLowerX(); x <= srcRegion.getUpperX(); ++x) {
+					const voxel::Voxel &voxel = source->voxel(x, y, z);
+					if (!voxel::isAir(voxel.getMaterial())) {
+						destination->setVoxel(transform(glm::ivec3(x, y, z) - srcRegion.getLowerCorner()), voxel);
+					}
+				}
+			}
+		}
+		destination->translate(srcRegion.getCenter() - destination->region().getCenter());
+		return destination;
+	}
+
+	void expectSame(const voxel::RawVolume &expected, const voxel::RawVolume &volume) const {
+		const voxel::Region &region = expected.region();
+		ASSERT_EQ(region, volume.region()) << str(region) << " vs " << str(volume.region());
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					ASSERT_TRUE(expected.voxel(x, y, z).isSame(volume.voxel(x, y, z))) << x << ":" << y << ":" << z;
+				}
+			}
+		}
+	}
 };
 
 TEST_F(VolumeRotatorTest, testRotateAxisZ) {
@@ -74,4 +132,83 @@ TEST_F(VolumeRotatorTest, testRotate45Y) {
 	delete rotated;
 }
 
+TEST_F(VolumeRotatorTest, testRotateAxisNonCubic) {
+	const voxel::Region region(glm::ivec3(-3, 2, 5), glm::ivec3(2, 4, 21));
+	voxel::RawVolume volume(region);
+	EXPECT_TRUE(volume.setVoxel(2, 2, 5, createVoxel(voxel::VoxelType::Rock, 1)));
+	voxel::RawVolume* rotated = voxelutil::rotateAxis(&volume, math::Axis::Y);
+	ASSERT_NE(nullptr, rotated);
+	const glm::ivec3 &dim = region.getDimensionsInVoxels();
+	EXPECT_EQ(glm::ivec3(dim.z, dim.y, dim.x), rotated->region().getDimensionsInVoxels());
+	EXPECT_EQ(region.getCenter(), rotated->region().getCenter());
+	EXPECT_EQ(1, voxelutil::visitVolume(*rotated, [](int, int, int, const voxel::Voxel &) {}));
+	delete rotated;
+}
+
+TEST_F(VolumeRotatorTest, testRotateAxisFullCircle) {
+	// large enough to copy several blocks of voxels on the workers of the thread pool
+	const voxel::Region region(glm::ivec3(-10, 3, 7), glm::ivec3(150, 66, 226));
+	voxel::RawVolume volume(region);
+	fill(volume);
+	const math::Axis axes[] = {math::Axis::X, math::Axis::Y, math::Axis::Z};
+	for (math::Axis axis : axes) {
+		voxel::RawVolume *rotated = new voxel::RawVolume(volume);
+		for (int i = 0; i < 4; ++i) {
+			voxel::RawVolume *v = voxelutil::rotateAxis(rotated, axis);
+			delete rotated;
+			rotated = v;
+		}
+		expectSame(volume, *rotated);
+		delete rotated;
+	}
+}
+
+TEST_F(VolumeRotatorTest, testRotate90MatchesFloatRotation) {
+	const voxel::Region regions[] = {voxel::Region(glm::ivec3(0, 0, 0), glm::ivec3(6, 3, 8)),
+									 voxel::Region(glm::ivec3(-3, 2, 5), glm::ivec3(4, 5, 16))};
+	const math::Axis axes[] = {math::Axis::X, math::Axis::Y, math::Axis::Z};
+	for (const voxel::Region &region : regions) {
+		voxel::RawVolume volume(region);
+		fill(volume);
+		for (math::Axis axis : axes) {
+			glm::vec3 angles(0.0f);
+			angles[math::getIndexForAxis(axis)] = 90.0f;
+			voxel::RawVolume *expected = floatRotation(&volume, angles, region.getPivot());
+			voxel::RawVolume *rotated = voxelutil::rotateAxis(&volume, axis);
+			expectSame(*expected, *rotated);
+			delete expected;
+			delete rotated;
+		}
+		const glm::vec3 angles[] = {glm::vec3(180.0f, 0.0f, 0.0f), glm::vec3(0.0f, 270.0f, 0.0f),
+									glm::vec3(90.0f, 180.0f, 0.0f), glm::vec3(90.0f, 90.0f, 270.0f)};
+		for (const glm::vec3 &a : angles) {
+			voxel::RawVolume *expected = floatRotation(&volume, a, region.getPivot());
+			voxel::RawVolume *rotated = voxelutil::rotateVolume(&volume, a, region.getPivot());
+			expectSame(*expected, *rotated);
+			delete expected;
+			delete rotated;
+		}
+	}
+}
+
+TEST_F(VolumeRotatorTest, testMirrorAxis) {
+	const voxel::Region region(glm::ivec3(-2, 0, 1), glm::ivec3(20, 5, 3));
+	voxel::RawVolume volume(region);
+	fill(volume);
+	const math::Axis axes[] = {math::Axis::X, math::Axis::Y, math::Axis::Z};
+	for (math::Axis axis : axes) {
+		voxel::RawVolume *mirrored = voxelutil::mirrorAxis(&volume, axis);
+		ASSERT_EQ(region, mirrored->region());
+		const int idx = math::getIndexForAxis(axis);
+		glm::ivec3 pos = region.getLowerCorner();
+		glm::ivec3 mirroredPos = pos;
+		mirroredPos[idx] = region.getUpperCorner()[idx];
+		EXPECT_TRUE(volume.voxel(pos).isSame(mirrored->voxel(mirroredPos)));
+		voxel::RawVolume *twice = voxelutil::mirrorAxis(mirrored, axis);
+		expectSame(volume, *twice);
+		delete twice;
+		delete mirrored;
+	}
+}
+
 }
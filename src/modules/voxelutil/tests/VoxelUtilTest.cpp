@@ -138,6 +138,47 @@ TEST_F(VoxelUtilTest, testFillEmptyPlanePositiveZ) {
 	EXPECT_EQ(9, voxelutil::visitVolume(v, [&](int, int, int, const voxel::Voxel &) {}));
 }
 
+TEST_F(VoxelUtilTest, testExtrudeLargePlane) {
+	voxel::Region region(0, 0, 0, 511, 2, 511);
+	voxel::RawVolume v(region);
+	const voxel::Voxel groundVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 2);
+	const voxel::Voxel newPlaneVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 3);
+	voxel::RawVolumeWrapper wrapper(&v);
+	for (int z = 0; z < 512; ++z) {
+		for (int x = 0; x < 512; ++x) {
+			// leave a hole in the ground
+			if (x != 100 || z != 100) {
+				v.setVoxel(x, 0, z, groundVoxel);
+			}
+		}
+	}
+	EXPECT_EQ(512 * 512 - 1, voxelutil::extrudePlane(wrapper, glm::ivec3(0, 1, 0), voxel::FaceNames::PositiveY, groundVoxel, newPlaneVoxel));
+	EXPECT_TRUE(voxel::isAir(v.voxel(100, 1, 100).getMaterial()));
+	EXPECT_EQ(512 * 512 - 1, voxelutil::paintPlane(wrapper, glm::ivec3(0, 1, 0), voxel::FaceNames::PositiveY, newPlaneVoxel, groundVoxel));
+}
+
+TEST_F(VoxelUtilTest, testFillHollowUnreachedSolid) {
+	voxel::Region region(0, 4);
+	voxel::RawVolume v(region);
+	const voxel::Voxel borderVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	const voxel::Voxel innerVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 3);
+	voxelutil::visitVolume(
+		v, [&](int x, int y, int z, const voxel::Voxel &) {
+			if (region.isOnBorder(glm::ivec3(x, y, z))) {
+				v.setVoxel(x, y, z, borderVoxel);
+			}
+		},
+		VisitAll());
+	EXPECT_TRUE(v.setVoxel(region.getCenter(), innerVoxel));
+
+	const voxel::Voxel fillVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 2);
+	voxel::RawVolumeWrapper wrapper(&v);
+	voxelutil::fillHollow(wrapper, fillVoxel);
+	EXPECT_EQ(3, v.voxel(region.getCenter()).getColor()) << "Solid voxels should not get replaced";
+	EXPECT_EQ(2, v.voxel(1, 1, 1).getColor());
+	EXPECT_EQ(1, v.voxel(0, 0, 0).getColor());
+}
+
 TEST_F(VoxelUtilTest, testFillPlaneWithImage) {
 	voxel::PaletteLookup palLookup;
 
@@ -16,15 +16,19 @@ namespace voxelworld {
 
 bool ChunkPersister::saveCompressed(const voxel::PagedVolume::ChunkPtr& chunk, io::BufferedReadWriteStream& outStream) const {
 	// save the stuff
-	const voxel::Voxel* voxelBuf = chunk->data();
 	const int voxelSize = chunk->dataSizeInBytes();
+	std::unique_ptr<voxel::Voxel[]> voxelBuf(new voxel::Voxel[chunk->voxels()]);
+	if (!chunk->data(voxelBuf.get(), voxelSize)) {
+		Log::error("Failed to get the voxel data");
+		return false;
+	}
 	uint32_t neededVoxelBufLen = core::zip::compressBound(voxelSize);
 	uint8_t* compressedVoxelBuf = new uint8_t[neededVoxelBufLen];
 	std::unique_ptr<uint8_t[]> smartBuf(compressedVoxelBuf);
 	size_t finalBufferSize;
 	{
 		core_trace_scoped(ChunkPersisterCompress);
-		const bool success = core::zip::compress((const uint8_t*)voxelBuf, voxelSize, compressedVoxelBuf, neededVoxelBufLen, &finalBufferSize);
+		const bool success = core::zip::compress((const uint8_t*)voxelBuf.get(), voxelSize, compressedVoxelBuf, neededVoxelBufLen, &finalBufferSize);
 		if (!success) {
 			Log::error("Failed to compress the voxel data");
 			return false;
@@ -67,12 +71,12 @@ bool ChunkPersister::loadCompressed(const voxel::PagedVolume::ChunkPtr& chunk, c
 	const size_t remaining = fileLen - headerSize;
 
 	// TODO: doesn't work on big endian
-	uint8_t *targetBuf = (uint8_t*)chunk->data();
-	if (!core::zip::uncompress(buf, remaining, targetBuf, sizeLimit)) {
+	std::unique_ptr<voxel::Voxel[]> voxelBuf(new voxel::Voxel[chunk->voxels()]);
+	if (!core::zip::uncompress(buf, remaining, (uint8_t*)voxelBuf.get(), sizeLimit)) {
 		Log::error("Failed to uncompress the world data with len %i", len);
 		return false;
 	}
-	return true;
+	return chunk->setData(voxelBuf.get(), sizeLimit);
 }
 
 }
@@ -0,0 +1,476 @@
+/**
+ * @file
+ */
+
+#include "HierarchicalPathfinder.h"
+#include "core/Log.h"
+#include "voxel/Constants.h"
+#include "voxel/Voxel.h"
+#include <glm/geometric.hpp>
+#include <algorithm>
+
+namespace voxelworld {
+
+/**
+ * The max amount of positions of a path inside of a cluster and its neighbour
+ */
+static constexpr int LocalPathSize = HierarchicalPathfinder::ClusterSize * HierarchicalPathfinder::ClusterSize * 2;
+
+static inline int clusterCoord(int v) {
+	if (v >= 0) {
+		return v / HierarchicalPathfinder::ClusterSize;
+	}
+	return (v - HierarchicalPathfinder::ClusterSize + 1) / HierarchicalPathfinder::ClusterSize;
+}
+
+static float pathCost(const core::List<glm::ivec3> &path) {
+	float cost = 0.0f;
+	const glm::ivec3 *prev = nullptr;
+	for (const glm::ivec3 &pos : path) {
+		if (prev != nullptr) {
+			cost += glm::length(glm::vec3(pos - *prev));
+		}
+		prev = &pos;
+	}
+	return cost;
+}
+
+const HierarchicalPathfinder::Portal *HierarchicalPathfinder::Cluster::portal(const glm::ivec3 &pos) const {
+	for (const Portal &portal : portals) {
+		if (portal.pos == pos) {
+			return &portal;
+		}
+	}
+	return nullptr;
+}
+
+HierarchicalPathfinder::Portal &HierarchicalPathfinder::Cluster::addPortal(const glm::ivec3 &pos) {
+	for (Portal &portal : portals) {
+		if (portal.pos == pos) {
+			return portal;
+		}
+	}
+	Portal portal;
+	portal.pos = pos;
+	portals.push_back(portal);
+	return portals.back();
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(const voxel::PagedVolume *volume, int maxClusters) :
+		_volume(volume), _maxClusters(maxClusters), _clusters(maxClusters) {
+}
+
+bool HierarchicalPathfinder::isWalkable(const voxel::PagedVolume *volume, const glm::ivec3 &pos) {
+	if (pos.y < 1 || pos.y >= voxel::MAX_HEIGHT) {
+		return false;
+	}
+	if (voxel::isBlocked(volume->voxel(pos).getMaterial())) {
+		return false;
+	}
+	return voxel::isBlocked(volume->voxel(pos.x, pos.y - 1, pos.z).getMaterial());
+}
+
+glm::ivec2 HierarchicalPathfinder::clusterPos(const glm::ivec3 &pos) {
+	return glm::ivec2(clusterCoord(pos.x), clusterCoord(pos.z));
+}
+
+/**
+ * @brief Fills the walkable state for all heights of the given column
+ */
+static void walkableColumn(voxel::PagedVolume::Sampler &sampler, int x, int z, bool *walkable) {
+	sampler.setPosition(x, 0, z);
+	bool belowBlocked = voxel::isBlocked(sampler.voxel().getMaterial());
+	walkable[0] = false;
+	for (int y = 1; y < voxel::MAX_HEIGHT; ++y) {
+		sampler.movePositiveY();
+		const bool blocked = voxel::isBlocked(sampler.voxel().getMaterial());
+		walkable[y] = !blocked && belowBlocked;
+		belowBlocked = blocked;
+	}
+}
+
+void HierarchicalPathfinder::addEntrances(Cluster &cluster, const glm::ivec2 &lowerCluster, int axis,
+										  bool lowerSide) const {
+	// the x and z coordinates of the clusters are stored as x and y components
+	const int lowerBorder = (axis == 0 ? lowerCluster.x : lowerCluster.y) * ClusterSize + ClusterSize - 1;
+	const int tStart = (axis == 0 ? lowerCluster.y : lowerCluster.x) * ClusterSize;
+	auto toPos = [axis](int border, int y, int t) {
+		return axis == 0 ? glm::ivec3(border, y, t) : glm::ivec3(t, y, border);
+	};
+
+	struct Crossing {
+		glm::ivec3 lower;
+		glm::ivec3 upper;
+	};
+	core::DynamicArray<Crossing> crossings;
+	voxel::PagedVolume::Sampler sampler(_volume);
+	bool lowerColumn[voxel::MAX_HEIGHT];
+	bool upperColumn[voxel::MAX_HEIGHT];
+	for (int t = tStart; t < tStart + ClusterSize; ++t) {
+		const glm::ivec3 &lowerColumnPos = toPos(lowerBorder, 0, t);
+		const glm::ivec3 &upperColumnPos = toPos(lowerBorder + 1, 0, t);
+		walkableColumn(sampler, lowerColumnPos.x, lowerColumnPos.z, lowerColumn);
+		walkableColumn(sampler, upperColumnPos.x, upperColumnPos.z, upperColumn);
+		for (int y = 1; y < voxel::MAX_HEIGHT; ++y) {
+			if (!lowerColumn[y]) {
+				continue;
+			}
+			// steps of one voxel up or down are possible
+			for (int dy = -1; dy <= 1; ++dy) {
+				const int upperY = y + dy;
+				if (upperY < 1 || upperY >= voxel::MAX_HEIGHT || !upperColumn[upperY]) {
+					continue;
+				}
+				crossings.push_back(Crossing{toPos(lowerBorder, y, t), toPos(lowerBorder + 1, upperY, t)});
+			}
+		}
+	}
+
+	// group the crossings of neighbouring border columns to entrances - each entrance gets one portal in its middle
+	struct Entrance {
+		core::DynamicArray<int> crossings;
+		int lastT;
+		int lastY;
+	};
+	core::DynamicArray<Entrance> entrances;
+	for (int i = 0; i < (int)crossings.size(); ++i) {
+		const Crossing &crossing = crossings[i];
+		const int t = axis == 0 ? crossing.lower.z : crossing.lower.x;
+		const int y = crossing.lower.y;
+		Entrance *entrance = nullptr;
+		for (Entrance &e : entrances) {
+			if (e.lastT == t - 1 && glm::abs(e.lastY - y) <= 1) {
+				entrance = &e;
+				break;
+			}
+			if (e.lastT == t && e.lastY == y) {
+				// another crossing of the same voxel
+				entrance = &e;
+				break;
+			}
+		}
+		if (entrance == nullptr) {
+			entrances.emplace_back();
+			entrance = &entrances.back();
+		}
+		entrance->crossings.push_back(i);
+		entrance->lastT = t;
+		entrance->lastY = y;
+	}
+
+	for (const Entrance &entrance : entrances) {
+		const Crossing &crossing = crossings[entrance.crossings[entrance.crossings.size() / 2]];
+		const float cost = glm::length(glm::vec3(crossing.upper - crossing.lower));
+		if (lowerSide) {
+			cluster.addPortal(crossing.lower).edges.push_back(Edge{crossing.upper, cost});
+		} else {
+			cluster.addPortal(crossing.upper).edges.push_back(Edge{crossing.lower, cost});
+		}
+	}
+}
+
+HierarchicalPathfinder::ClusterPtr HierarchicalPathfinder::buildCluster(const glm::ivec2 &clusterPos) const {
+	core_trace_scoped(BuildPathCluster);
+	ClusterPtr graph = core::make_shared<Cluster>();
+	Cluster &cluster = *graph.get();
+	addEntrances(cluster, clusterPos, 0, true);
+	addEntrances(cluster, clusterPos - glm::ivec2(1, 0), 0, false);
+	addEntrances(cluster, clusterPos, 2, true);
+	addEntrances(cluster, clusterPos - glm::ivec2(0, 1), 2, false);
+
+	core::List<glm::ivec3> path(LocalPathSize);
+	LocalPathfinder pathfinder(localParams(glm::ivec3(0), glm::ivec3(0), clusterPos, clusterPos, &path));
+	const int portals = (int)cluster.portals.size();
+	for (int i = 0; i < portals; ++i) {
+		for (int j = i + 1; j < portals; ++j) {
+			Portal &a = cluster.portals[i];
+			Portal &b = cluster.portals[j];
+			float cost;
+			if (findLocalPath(pathfinder, a.pos, b.pos, clusterPos, clusterPos, path, &cost)) {
+				a.edges.push_back(Edge{b.pos, cost});
+				b.edges.push_back(Edge{a.pos, cost});
+			}
+		}
+	}
+	Log::debug("Computed %i portals for cluster %i:%i", portals, clusterPos.x, clusterPos.y);
+	return graph;
+}
+
+HierarchicalPathfinder::ClusterPtr HierarchicalPathfinder::cluster(const glm::ivec2 &clusterPos) {
+	int generation;
+	{
+		core::ScopedLock lock(_lock);
+		auto iter = _clusters.find(clusterPos);
+		if (iter != _clusters.end()) {
+			iter->value.lastUse = ++_useCounter;
+			return iter->value.graph;
+		}
+		generation = _generation;
+	}
+	// the lock is not held while building - the voxel lookups might page in chunks
+	const ClusterPtr &graph = buildCluster(clusterPos);
+	core::ScopedLock lock(_lock);
+	if (generation == _generation) {
+		if ((int)_clusters.size() >= _maxClusters) {
+			evict();
+		}
+		_clusters.put(clusterPos, CachedCluster{graph, ++_useCounter});
+	}
+	return graph;
+}
+
+void HierarchicalPathfinder::evict() {
+	core_trace_scoped(EvictPathClusters);
+	struct Use {
+		uint64_t lastUse;
+		glm::ivec2 pos;
+	};
+	core::DynamicArray<Use> uses;
+	uses.reserve(_clusters.size());
+	for (auto iter = _clusters.begin(); iter != _clusters.end(); ++iter) {
+		uses.push_back(Use{iter->value.lastUse, iter->key});
+	}
+	// evict a batch to not pay for the scan on each new cluster
+	const size_t n = core_max(uses.size() / 4u, (size_t)1u);
+	Use *begin = uses.data();
+	std::nth_element(begin, begin + (n - 1u), begin + uses.size(),
+					 [](const Use &a, const Use &b) { return a.lastUse < b.lastUse; });
+	for (size_t i = 0u; i < n; ++i) {
+		_clusters.remove(uses[i].pos);
+	}
+}
+
+HierarchicalPathfinder::LocalPathfinderParams
+HierarchicalPathfinder::localParams(const glm::ivec3 &start, const glm::ivec3 &end, const glm::ivec2 &minsCluster,
+									const glm::ivec2 &maxsCluster, core::List<glm::ivec3> *path) const {
+	const int minX = minsCluster.x * ClusterSize;
+	const int minZ = minsCluster.y * ClusterSize;
+	const int maxX = maxsCluster.x * ClusterSize + ClusterSize - 1;
+	const int maxZ = maxsCluster.y * ClusterSize + ClusterSize - 1;
+	auto isValid = [=](const voxel::PagedVolume *volume, const glm::ivec3 &pos) {
+		if (pos.x < minX || pos.x > maxX || pos.z < minZ || pos.z > maxZ) {
+			return false;
+		}
+		return isWalkable(volume, pos);
+	};
+	const uint32_t maxNodes = (uint32_t)LocalPathSize * 4u;
+	return LocalPathfinderParams(_volume, start, end, path, isValid, 1.0f, maxNodes, voxelutil::TwentySixConnected);
+}
+
+bool HierarchicalPathfinder::findLocalPath(LocalPathfinder &pathfinder, const glm::ivec3 &start,
+										   const glm::ivec3 &end, const glm::ivec2 &minsCluster,
+										   const glm::ivec2 &maxsCluster, core::List<glm::ivec3> &path,
+										   float *cost) const {
+	pathfinder.setParams(localParams(start, end, minsCluster, maxsCluster, &path));
+	if (!pathfinder.execute()) {
+		return false;
+	}
+	if (cost != nullptr) {
+		*cost = pathCost(path);
+	}
+	return true;
+}
+
+bool HierarchicalPathfinder::findRoute(const glm::ivec3 &start, const glm::ivec3 &end,
+									   core::List<glm::ivec3> &waypoints, int maxNodes) {
+	core_trace_scoped(HierarchicalFindRoute);
+	waypoints.clear();
+	if (!isWalkable(_volume, start) || !isWalkable(_volume, end)) {
+		return false;
+	}
+	const glm::ivec2 &startCluster = clusterPos(start);
+	const glm::ivec2 &endCluster = clusterPos(end);
+	core::List<glm::ivec3> path(LocalPathSize);
+	LocalPathfinder pathfinder(localParams(start, end, startCluster, startCluster, &path));
+	if (startCluster == endCluster && findLocalPath(pathfinder, start, end, startCluster, startCluster, path, nullptr)) {
+		waypoints.insert(start);
+		waypoints.insert(end);
+		return true;
+	}
+
+	// connect the start and the end position to the portals of their clusters
+	const ClusterPtr &startGraph = cluster(startCluster);
+	core::DynamicArray<Edge> startEdges;
+	for (const Portal &portal : startGraph->portals) {
+		float cost;
+		if (findLocalPath(pathfinder, start, portal.pos, startCluster, startCluster, path, &cost)) {
+			startEdges.push_back(Edge{portal.pos, cost});
+		}
+	}
+	const ClusterPtr &endGraph = cluster(endCluster);
+	// the target of these edges is the portal - the costs are the costs from the portal to the end
+	core::DynamicArray<Edge> endEdges;
+	for (const Portal &portal : endGraph->portals) {
+		float cost;
+		if (findLocalPath(pathfinder, portal.pos, end, endCluster, endCluster, path, &cost)) {
+			endEdges.push_back(Edge{portal.pos, cost});
+		}
+	}
+	if (startEdges.empty() || endEdges.empty()) {
+		Log::debug("The start or the end position is not connected to a portal");
+		return false;
+	}
+
+	voxelutil::AllNodesContainer nodes;
+	voxelutil::NodeIndexMap nodeIndices;
+	voxelutil::OpenNodesContainer openNodes;
+	openNodes.init(&nodes);
+	auto visit = [&](const glm::ivec3 &pos, int parent, float gVal) {
+		int idx = nodeIndices.find(pos);
+		if (idx == -1) {
+			idx = (int)nodes.size();
+			if (nodes.size() == nodes.capacity()) {
+				nodes.reserve(core_max(nodes.capacity() * 2u, (size_t)64u));
+			}
+			nodes.emplace_back(pos);
+			nodes[idx].hVal = glm::distance(glm::vec3(pos), glm::vec3(end));
+			nodeIndices.insert(pos, idx);
+		} else if (!(gVal < nodes[idx].gVal)) {
+			return;
+		}
+		voxelutil::Node &node = nodes[idx];
+		node.gVal = gVal;
+		node.parent = parent;
+		if (node.heapIndex >= 0) {
+			openNodes.decreased(idx);
+		} else {
+			openNodes.insert(idx);
+		}
+	};
+
+	visit(start, -1, 0.0f);
+	const int startNode = 0;
+	int endNode = -1;
+	while (!openNodes.empty()) {
+		const int current = openNodes.removeFirst();
+		const glm::ivec3 pos = nodes[current].position;
+		const float gVal = nodes[current].gVal;
+		if (pos == end) {
+			endNode = current;
+			break;
+		}
+		if (current == startNode) {
+			for (const Edge &edge : startEdges) {
+				visit(edge.target, current, gVal + edge.cost);
+			}
+		}
+		const glm::ivec2 &currentCluster = clusterPos(pos);
+		if (currentCluster == endCluster) {
+			for (const Edge &edge : endEdges) {
+				if (edge.target == pos) {
+					visit(end, current, gVal + edge.cost);
+					break;
+				}
+			}
+		}
+		// keep a reference - the cluster might get invalidated while we are iterating the edges
+		const ClusterPtr &graph = cluster(currentCluster);
+		if (const Portal *portal = graph->portal(pos)) {
+			for (const Edge &edge : portal->edges) {
+				visit(edge.target, current, gVal + edge.cost);
+			}
+		}
+		if ((int)nodes.size() > maxNodes) {
+			Log::debug("Reached the max amount of nodes for the route search");
+			break;
+		}
+	}
+	if (endNode == -1) {
+		Log::debug("Failed to find a route");
+		return false;
+	}
+	for (int n = endNode; n != -1; n = nodes[n].parent) {
+		if (!waypoints.insert_front(nodes[n].position)) {
+			Log::warn("The waypoint list is too small for the route");
+			waypoints.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool HierarchicalPathfinder::refine(const glm::ivec3 &from, const glm::ivec3 &to, core::List<glm::ivec3> &path) const {
+	const glm::ivec2 &mins = glm::min(clusterPos(from), clusterPos(to));
+	const glm::ivec2 &maxs = glm::max(clusterPos(from), clusterPos(to));
+	LocalPathfinder pathfinder(localParams(from, to, mins, maxs, &path));
+	return findLocalPath(pathfinder, from, to, mins, maxs, path, nullptr);
+}
+
+bool HierarchicalPathfinder::findPath(const glm::ivec3 &start, const glm::ivec3 &end, core::List<glm::ivec3> &path,
+									  int maxNodes) {
+	core_trace_scoped(HierarchicalFindPath);
+	path.clear();
+	core::List<glm::ivec3> waypoints(maxNodes);
+	if (!findRoute(start, end, waypoints, maxNodes)) {
+		return false;
+	}
+	core::List<glm::ivec3> leg(LocalPathSize);
+	const glm::ivec3 *prev = nullptr;
+	for (const glm::ivec3 &waypoint : waypoints) {
+		if (prev == nullptr) {
+			path.insert(waypoint);
+			prev = &waypoint;
+			continue;
+		}
+		if (!refine(*prev, waypoint, leg)) {
+			Log::debug("Failed to refine the route - the world was modified");
+			path.clear();
+			return false;
+		}
+		bool first = true;
+		for (const glm::ivec3 &pos : leg) {
+			// the first position of the leg is the last position of the previous one
+			if (first) {
+				first = false;
+				continue;
+			}
+			if (!path.insert(pos)) {
+				Log::warn("The path list is too small for the path");
+				path.clear();
+				return false;
+			}
+		}
+		prev = &waypoint;
+	}
+	return true;
+}
+
+void HierarchicalPathfinder::invalidate(const voxel::Region &region) {
+	// the entrances of the neighbouring clusters depend on the border voxels of the region, too
+	const glm::ivec2 &mins = clusterPos(region.getLowerCorner()) - 1;
+	const glm::ivec2 &maxs = clusterPos(region.getUpperCorner()) + 1;
+	core::ScopedLock lock(_lock);
+	++_generation;
+	const int64_t columns = (int64_t)(maxs.x - mins.x + 1) * (int64_t)(maxs.y - mins.y + 1);
+	if (columns <= (int64_t)_clusters.size()) {
+		for (int x = mins.x; x <= maxs.x; ++x) {
+			for (int z = mins.y; z <= maxs.y; ++z) {
+				_clusters.remove(glm::ivec2(x, z));
+			}
+		}
+		return;
+	}
+	core::DynamicArray<glm::ivec2> remove;
+	for (auto iter = _clusters.begin(); iter != _clusters.end(); ++iter) {
+		const glm::ivec2 &pos = iter->key;
+		if (pos.x >= mins.x && pos.x <= maxs.x && pos.y >= mins.y && pos.y <= maxs.y) {
+			remove.push_back(pos);
+		}
+	}
+	for (const glm::ivec2 &pos : remove) {
+		_clusters.remove(pos);
+	}
+}
+
+void HierarchicalPathfinder::clear() {
+	core::ScopedLock lock(_lock);
+	++_generation;
+	_clusters.clear();
+}
+
+int HierarchicalPathfinder::cachedClusters() const {
+	core::ScopedLock lock(_lock);
+	return (int)_clusters.size();
+}
+
+}
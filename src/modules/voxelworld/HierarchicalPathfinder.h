@@ -0,0 +1,144 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "voxel/PagedVolume.h"
+#include "voxel/Region.h"
+#include "voxelutil/AStarPathfinder.h"
+#include "core/GLM.h"
+#include "core/SharedPtr.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/List.h"
+#include "core/collection/Map.h"
+#include "core/concurrent/Concurrency.h"
+#include "core/concurrent/Lock.h"
+#include <glm/vec2.hpp>
+
+namespace voxelworld {
+
+/**
+ * @brief Hierarchical (HPA*) pathfinding over the paged world
+ *
+ * The world is split into columns of @c ClusterSize x @c ClusterSize voxels - a chunk consists of several of these
+ * clusters. The entrances between two neighbouring clusters are represented by a portal position on each side. The
+ * costs between the portals of a cluster are computed once with the voxel A* restricted to the cluster. Routes are
+ * searched on this portal graph and only the legs between two waypoints are refined with the voxel A*.
+ *
+ * The portal graph of a cluster is computed lazily by the first query that touches it and is dropped when one of
+ * the chunks it depends on is paged out or modified - see invalidate().
+ *
+ * @note All public methods are thread safe
+ * @ingroup VoxelWorld
+ */
+class HierarchicalPathfinder {
+public:
+	static constexpr int ClusterSize = 32;
+
+private:
+	struct Edge {
+		glm::ivec3 target;
+		float cost;
+	};
+
+	struct Portal {
+		glm::ivec3 pos;
+		/// The other portals of the cluster and the portal on the other side of the entrance
+		core::DynamicArray<Edge> edges;
+	};
+
+	struct Cluster {
+		core::DynamicArray<Portal> portals;
+
+		const Portal *portal(const glm::ivec3 &pos) const;
+		Portal &addPortal(const glm::ivec3 &pos);
+	};
+	typedef core::SharedPtr<Cluster> ClusterPtr;
+	struct CachedCluster {
+		ClusterPtr graph;
+		/// The value of the use counter at the last access - the least recently used clusters are evicted first
+		uint64_t lastUse;
+	};
+	typedef core::Map<glm::ivec2, CachedCluster, 64, glm::hash<glm::ivec2>> Clusters;
+	typedef voxelutil::AStarPathfinder<voxel::PagedVolume> LocalPathfinder;
+	typedef voxelutil::AStarPathfinderParams<voxel::PagedVolume> LocalPathfinderParams;
+
+	const voxel::PagedVolume *_volume;
+	const int _maxClusters;
+	mutable core_trace_mutex(core::Lock, _lock, "HierarchicalPathfinder");
+	Clusters _clusters core_thread_guarded_by(_lock);
+	/// Increased by each invalidation - graphs that were computed while the world changed are not cached
+	int _generation core_thread_guarded_by(_lock) = 0;
+	uint64_t _useCounter core_thread_guarded_by(_lock) = 0u;
+
+	ClusterPtr cluster(const glm::ivec2 &clusterPos);
+	ClusterPtr buildCluster(const glm::ivec2 &clusterPos) const;
+	/**
+	 * @brief Removes the least recently used quarter of the cached clusters
+	 */
+	void evict() core_thread_requires(_lock);
+	/**
+	 * @brief Adds the portals of the entrances between the given cluster and its neighbour in positive x or z direction
+	 * @param[in] lowerCluster The cluster with the lower coordinates
+	 * @param[in] axis @c 0 for the x and @c 2 for the z axis
+	 * @param[in] lowerSide Add the portals on the side of the lower cluster - or on the side of its neighbour
+	 */
+	void addEntrances(Cluster &cluster, const glm::ivec2 &lowerCluster, int axis, bool lowerSide) const;
+	LocalPathfinderParams localParams(const glm::ivec3 &start, const glm::ivec3 &end, const glm::ivec2 &minsCluster,
+									  const glm::ivec2 &maxsCluster, core::List<glm::ivec3> *path) const;
+	/**
+	 * @brief Runs the voxel A* between the given positions - the path may only use the columns of the given clusters
+	 * @param[in] pathfinder The instance is reused for several searches to keep the memory of its node containers
+	 * @param[out] cost The costs of the path if one was found - might be @c nullptr
+	 */
+	bool findLocalPath(LocalPathfinder &pathfinder, const glm::ivec3 &start, const glm::ivec3 &end,
+					   const glm::ivec2 &minsCluster, const glm::ivec2 &maxsCluster, core::List<glm::ivec3> &path,
+					   float *cost) const;
+
+public:
+	/**
+	 * @param maxClusters The amount of cluster graphs that are kept - the least recently used ones are evicted if
+	 * this is exceeded
+	 */
+	HierarchicalPathfinder(const voxel::PagedVolume *volume, int maxClusters = 4096);
+
+	/**
+	 * @return @c true if the given position is free and the voxel below is solid
+	 */
+	static bool isWalkable(const voxel::PagedVolume *volume, const glm::ivec3 &pos);
+	static glm::ivec2 clusterPos(const glm::ivec3 &pos);
+
+	/**
+	 * @brief Searches a route on the portal graph
+	 * @param[out] waypoints The start, the portals that must be passed and the end position. The voxel path between
+	 * two of these waypoints can be computed with refine()
+	 * @param maxNodes The amount of portals that are visited before giving up
+	 * @return @c false if no route was found
+	 */
+	bool findRoute(const glm::ivec3 &start, const glm::ivec3 &end, core::List<glm::ivec3> &waypoints,
+				   int maxNodes = 4096);
+	/**
+	 * @brief Computes the voxel path between two consecutive waypoints of findRoute()
+	 * @param[out] path The positions from @c from to @c to
+	 */
+	bool refine(const glm::ivec3 &from, const glm::ivec3 &to, core::List<glm::ivec3> &path) const;
+	/**
+	 * @brief Searches a route and refines all legs of it
+	 * @param[out] path The positions from @c start to @c end
+	 */
+	bool findPath(const glm::ivec3 &start, const glm::ivec3 &end, core::List<glm::ivec3> &path, int maxNodes = 4096);
+
+	/**
+	 * @brief Drops the graphs of all clusters that depend on voxels of the given region
+	 */
+	void invalidate(const voxel::Region &region);
+	void clear();
+	/**
+	 * @return The amount of clusters with a computed portal graph
+	 */
+	int cachedClusters() const;
+};
+
+}
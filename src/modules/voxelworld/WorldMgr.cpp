@@ -3,6 +3,7 @@
  */
 
 #include "WorldMgr.h"
+#include "app/App.h"
 #include "core/Var.h"
 #include "core/Log.h"
 #include "core/GLM.h"
@@ -53,12 +54,16 @@ voxel::PagedVolume::Sampler WorldMgr::sampler() {
 
 bool WorldMgr::init(uint32_t volumeMemoryMegaBytes, uint16_t chunkSideLength) {
 	_volumeData = new voxel::PagedVolume(_pager.get(), volumeMemoryMegaBytes * 1024 * 1024, chunkSideLength);
+	_volumeData->setThreadPool(&app::App::getInstance()->threadPool());
+	_pathfinder = new HierarchicalPathfinder(_volumeData);
 	return true;
 }
 
 void WorldMgr::shutdown() {
 	delete _volumeData;
 	_volumeData = nullptr;
+	delete _pathfinder;
+	_pathfinder = nullptr;
 }
 
 voxelutil::FloorTraceResult WorldMgr::findWalkableFloor(const glm::ivec3& position, int maxDistanceUpwards) const {
@@ -67,4 +72,14 @@ voxelutil::FloorTraceResult WorldMgr::findWalkableFloor(const glm::ivec3& positi
 	return voxelutil::findWalkableFloor(&sampler, position, maxDistanceUpwards);
 }
 
+bool WorldMgr::findRoute(const glm::ivec3& start, const glm::ivec3& end, core::List<glm::ivec3>& waypoints) {
+	core_assert_msg(_pathfinder != nullptr, "WorldMgr is not initialized");
+	return _pathfinder->findRoute(start, end, waypoints);
+}
+
+bool WorldMgr::findPath(const glm::ivec3& start, const glm::ivec3& end, core::List<glm::ivec3>& path) {
+	core_assert_msg(_pathfinder != nullptr, "WorldMgr is not initialized");
+	return _pathfinder->findPath(start, end, path);
+}
+
 }
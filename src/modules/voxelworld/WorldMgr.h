@@ -10,6 +10,7 @@
 #include "voxel/PagedVolume.h"
 #include "voxelutil/Raycast.h"
 #include "voxelutil/FloorTraceResult.h"
+#include "voxelworld/HierarchicalPathfinder.h"
 #include "voxelformat/VolumeCache.h"
 #include "voxel/Constants.h"
 #include "core/GLM.h"
@@ -47,6 +48,16 @@ public:
 	 */
 	voxelutil::FloorTraceResult findWalkableFloor(const glm::ivec3& position, int maxDistanceUpwards = voxel::MAX_HEIGHT) const;
 
+	/**
+	 * @brief Computes the route over the portals of the world clusters
+	 * @sa HierarchicalPathfinder::findRoute()
+	 */
+	bool findRoute(const glm::ivec3& start, const glm::ivec3& end, core::List<glm::ivec3>& waypoints);
+	/**
+	 * @sa HierarchicalPathfinder::findPath()
+	 */
+	bool findPath(const glm::ivec3& start, const glm::ivec3& end, core::List<glm::ivec3>& path);
+
 	bool init(uint32_t volumeMemoryMegaBytes = 1024, uint16_t chunkSideLength = 256);
 	void shutdown();
 	void reset();
@@ -64,6 +75,7 @@ public:
 
 	voxel::PagedVolume::Sampler sampler();
 	voxel::PagedVolume *volumeData();
+	HierarchicalPathfinder *pathfinder();
 
 private:
 	friend class WorldMgrTest;
@@ -75,6 +87,7 @@ private:
 
 	voxel::PagedVolume::PagerPtr _pager;
 	voxel::PagedVolume *_volumeData = nullptr;
+	HierarchicalPathfinder *_pathfinder = nullptr;
 	mutable std::mt19937 _engine;
 	long _seed = 0l;
 
@@ -85,6 +98,10 @@ inline voxel::PagedVolume *WorldMgr::volumeData() {
 	return _volumeData;
 }
 
+inline HierarchicalPathfinder *WorldMgr::pathfinder() {
+	return _pathfinder;
+}
+
 inline glm::ivec3 WorldMgr::chunkPos(const glm::ivec3& pos) const {
 	const float size = _volumeData->chunkSideLength();
 	const int x = glm::floor((float)pos.x / size);
@@ -7,9 +7,11 @@
 #include "voxel/PagedVolumeWrapper.h"
 #include "voxelutil/Raycast.h"
 #include "noise/Simplex.h"
+#include "noise/SimplexBatch.h"
 #include "core/Common.h"
 #include "core/StringUtil.h"
 #include "core/collection/Array.h"
+#include "core/collection/DynamicArray.h"
 
 namespace voxelworld {
 
@@ -19,6 +21,9 @@ WorldPager::WorldPager(const voxelformat::VolumeCachePtr& volumeCache, const Chu
 
 void WorldPager::erase(const voxel::Region& region) {
 	_chunkPersister->erase(region, _seed);
+	if (_chunkListener) {
+		_chunkListener(region);
+	}
 }
 
 bool WorldPager::pageIn(voxel::PagedVolume::PagerContext& pctx) {
@@ -42,6 +47,10 @@ bool WorldPager::pageIn(voxel::PagedVolume::PagerContext& pctx) {
 
 void WorldPager::pageOut(voxel::PagedVolume::Chunk* chunk) {
 	// currently chunks are not modifiable and are saved directly after creating the chunk
+	if (_chunkListener) {
+		const glm::ivec3 mins = chunk->chunkPos() * (int)chunk->sideLength();
+		_chunkListener(voxel::Region(mins, mins + (int)chunk->sideLength() - 1));
+	}
 }
 
 void WorldPager::setSeed(unsigned int seed) {
@@ -52,6 +61,10 @@ void WorldPager::setNoiseOffset(const glm::vec2& noiseOffset) {
 	_noiseSeedOffset = noiseOffset;
 }
 
+void WorldPager::setChunkListener(const ChunkListener& listener) {
+	_chunkListener = listener;
+}
+
 bool WorldPager::init(voxel::PagedVolume *volumeData, const core::String& worldParamsLua, const core::String& biomesLua) {
 	if (!_biomeManager.init(biomesLua)) {
 		Log::error("Failed to init biome mgr");
@@ -97,13 +110,27 @@ void WorldPager::createWorld(voxel::PagedVolumeWrapper& volume) const {
 	const int size = 2;
 	core_assert(depth % size == 0);
 	core_assert(width % size == 0);
+	const int columnsX = width / size;
+	const int columnsZ = depth / size;
+	const int columns = columnsX * columnsZ;
+	core::DynamicArray<glm::vec2> positions;
+	positions.reserve(columns);
 	for (int z = lowerZ; z < lowerZ + depth; z += size) {
 		for (int x = lowerX; x < lowerX + width; x += size) {
-			voxel::Voxel voxels[voxel::MAX_TERRAIN_HEIGHT];
-			const int ni = fillVoxels(x, minsY, z, voxels);
-			volume.setVoxels(x, minsY, z, size, size, voxels, ni);
+			positions.push_back(glm::vec2(x, z));
 		}
 	}
+	core::DynamicArray<float> noiseValues;
+	noiseValues.resize(columns);
+	getNoiseValues(positions.data(), noiseValues.data(), columns);
+
+	for (int i = 0; i < columns; ++i) {
+		const int x = (int)positions[i].x;
+		const int z = (int)positions[i].y;
+		voxel::Voxel voxels[voxel::MAX_TERRAIN_HEIGHT];
+		const int ni = fillVoxels(x, minsY, z, noiseValues[i], voxels);
+		volume.setVoxels(x, minsY, z, size, size, voxels, ni);
+	}
 }
 
 float WorldPager::getNoiseValue(float x, float z) const {
@@ -121,6 +148,31 @@ float WorldPager::getNoiseValue(float x, float z) const {
 	return n;
 }
 
+void WorldPager::getNoiseValues(const glm::vec2 *positions, float *out, int amount) const {
+	core_trace_scoped(NoiseValues);
+	core::DynamicArray<glm::vec2> landscapePositions;
+	core::DynamicArray<glm::vec2> mountainPositions;
+	landscapePositions.reserve(amount);
+	mountainPositions.reserve(amount);
+	for (int i = 0; i < amount; ++i) {
+		const glm::vec2 noisePos2d(_noiseSeedOffset.x + positions[i].x, _noiseSeedOffset.y + positions[i].y);
+		landscapePositions.push_back(noisePos2d * _worldCtx.landscapeNoiseFrequency);
+		mountainPositions.push_back(noisePos2d * _worldCtx.mountainNoiseFrequency);
+	}
+	core::DynamicArray<float> mountainNoise;
+	mountainNoise.resize(amount);
+	noise::fBmBatch(landscapePositions.data(), out, amount, _worldCtx.landscapeNoiseOctaves,
+			_worldCtx.landscapeNoiseLacunarity, _worldCtx.landscapeNoiseGain);
+	noise::fBmBatch(mountainPositions.data(), mountainNoise.data(), amount, _worldCtx.mountainNoiseOctaves,
+			_worldCtx.mountainNoiseLacunarity, _worldCtx.mountainNoiseGain);
+	for (int i = 0; i < amount; ++i) {
+		const float noiseNormalized = noise::norm(out[i]);
+		const float mountainNoiseNormalized = noise::norm(mountainNoise[i]);
+		const float mountainMultiplier = mountainNoiseNormalized * (mountainNoiseNormalized + 0.5f);
+		out[i] = glm::clamp(noiseNormalized * mountainMultiplier, 0.0f, 1.0f);
+	}
+}
+
 float WorldPager::getDensity(float x, float y, float z, float n) const {
 	core_trace_scoped(DensityValue);
 	const glm::vec3 noisePos3d(_noiseSeedOffset.x + x, y, _noiseSeedOffset.y + z);
@@ -131,6 +183,26 @@ float WorldPager::getDensity(float x, float y, float z, float n) const {
 	return finalDensity;
 }
 
+void WorldPager::getDensities(int x, int z, int minsY, int maxsY, float n, float *densities) const {
+	core_trace_scoped(DensityValues);
+	const int amount = maxsY - minsY;
+	if (amount <= 0) {
+		return;
+	}
+	core_assert(maxsY <= voxel::MAX_TERRAIN_HEIGHT);
+	glm::vec3 positions[voxel::MAX_TERRAIN_HEIGHT];
+	for (int i = 0; i < amount; ++i) {
+		const glm::vec3 noisePos3d(_noiseSeedOffset.x + (float)x, (float)(minsY + i), _noiseSeedOffset.y + (float)z);
+		positions[i] = noisePos3d * _worldCtx.caveNoiseFrequency;
+	}
+	float noiseValues[voxel::MAX_TERRAIN_HEIGHT];
+	noise::fBmBatch(positions, noiseValues, amount, _worldCtx.caveNoiseOctaves, _worldCtx.caveNoiseLacunarity,
+			_worldCtx.caveNoiseGain);
+	for (int i = 0; i < amount; ++i) {
+		densities[minsY + i] = n + noise::norm(noiseValues[i]);
+	}
+}
+
 int WorldPager::terrainHeight(int x, int y, int z) const {
 	const float n = getNoiseValue(x, z);
 	return terrainHeight(x, y, z, n);
@@ -138,6 +210,18 @@ int WorldPager::terrainHeight(int x, int y, int z) const {
 
 int WorldPager::terrainHeight(int x, int minsY, int z, float n) const {
 	core_trace_scoped(TerrainHeight);
+	int ni = surfaceHeight(x, z, n);
+	for (int y = ni - 1; y >= minsY + 1; --y) {
+		const float density = getDensity(x, y, z, n);
+		if (density > _worldCtx.caveDensityThreshold) {
+			break;
+		}
+		--ni;
+	}
+	return ni;
+}
+
+int WorldPager::surfaceHeight(int x, int z, float n) const {
 	const int maxHeight = voxel::MAX_TERRAIN_HEIGHT - 1;
 	int centerHeight;
 	// the center of a city should make the terrain more even
@@ -149,20 +233,21 @@ int WorldPager::terrainHeight(int x, int minsY, int z, float n) const {
 	} else {
 		ni = n * maxHeight;
 	}
+	return ni;
+}
+
+int WorldPager::fillVoxels(int x, int minsY, int z, float n, voxel::Voxel* voxels) const {
+	core_trace_scoped(FillVoxels);
+	// the densities below the surface are needed for the terrain height and for the voxels
+	int ni = surfaceHeight(x, z, n);
+	float densities[voxel::MAX_TERRAIN_HEIGHT];
+	getDensities(x, z, minsY + 1, ni, n, densities);
 	for (int y = ni - 1; y >= minsY + 1; --y) {
-		const float density = getDensity(x, y, z, n);
-		if (density > _worldCtx.caveDensityThreshold) {
+		if (densities[y] > _worldCtx.caveDensityThreshold) {
 			break;
 		}
 		--ni;
 	}
-	return ni;
-}
-
-int WorldPager::fillVoxels(int x, int minsY, int z, voxel::Voxel* voxels) const {
-	core_trace_scoped(FillVoxels);
-	const float n = getNoiseValue(x, z);
-	const int ni = terrainHeight(x, minsY, z, n);
 	if (ni < minsY) {
 		return 0;
 	}
@@ -174,8 +259,7 @@ int WorldPager::fillVoxels(int x, int minsY, int z, voxel::Voxel* voxels) const
 	voxels[0] = dirt;
 	glm::ivec3 pos(x, 0, z);
 	for (int y = ni - 1; y >= minsY + 1; --y) {
-		const float density = getDensity(x, y, z, n);
-		if (density > _worldCtx.caveDensityThreshold) {
+		if (densities[y] > _worldCtx.caveDensityThreshold) {
 			const bool cave = y < ni - 1;
 			pos.y = y;
 			const voxel::Voxel& voxel = _biomeManager.getVoxel(pos, cave);
@@ -15,6 +15,7 @@
 #include "ChunkPersister.h"
 #include "TreeVolumeCache.h"
 #include "voxelutil/RawVolumeRotateWrapper.h"
+#include <functional>
 
 namespace voxel {
 class PagedVolumeWrapper;
@@ -30,6 +31,11 @@ namespace voxelworld {
  * The pager is the streaming interface for the voxel::PagedVolume.
  */
 class WorldPager: public voxel::PagedVolume::Pager {
+public:
+	/**
+	 * @brief Called with the region of chunks that are paged out or modified
+	 */
+	typedef std::function<void(const voxel::Region&)> ChunkListener;
 private:
 	unsigned int _seed = 0l;
 	glm::vec2 _noiseSeedOffset;
@@ -40,6 +46,7 @@ private:
 	noise::Noise _noise;
 	TreeVolumeCache _volumeCache;
 	ChunkPersisterPtr _chunkPersister;
+	ChunkListener _chunkListener;
 
 	void createWorld(voxel::PagedVolumeWrapper& volume) const;
 	void placeTrees(voxel::PagedVolume::PagerContext& pagerCtx);
@@ -47,13 +54,27 @@ private:
 
 	int terrainHeight(int x, int minsY, int z) const;
 	int terrainHeight(int x, int minsY, int z, float n) const;
-	int fillVoxels(int x, int minsY, int z, voxel::Voxel* voxels) const;
+	/**
+	 * @return The terrain height without the caves
+	 */
+	int surfaceHeight(int x, int z, float n) const;
+	int fillVoxels(int x, int minsY, int z, float n, voxel::Voxel* voxels) const;
 
 	/**
 	 * @return A float value between [0.0-1.0]
 	 */
 	float getNoiseValue(float x, float z) const;
+	/**
+	 * @brief Batched version of getNoiseValue() that gives the same results
+	 * @param[in] positions The x and z coordinates of the columns
+	 */
+	void getNoiseValues(const glm::vec2 *positions, float *out, int amount) const;
 	float getDensity(float x, float y, float z, float n) const;
+	/**
+	 * @brief Batched version of getDensity() for the heights [minsY,maxsY) of a column
+	 * @param[out] densities Indexed by the height
+	 */
+	void getDensities(int x, int z, int minsY, int maxsY, float n, float *densities) const;
 
 public:
 	WorldPager(const voxelformat::VolumeCachePtr& volumeCache, const ChunkPersisterPtr& chunkPersister);
@@ -80,6 +101,11 @@ public:
 
 	void setNoiseOffset(const glm::vec2& noiseOffset);
 
+	/**
+	 * @brief Allows to drop data that was computed from the voxels of a chunk - like the pathfinding graph
+	 */
+	void setChunkListener(const ChunkListener& listener);
+
 	void erase(const voxel::Region& region);
 	/**
 	 * @return @c true if the chunk was modified (created), @c false if it was just loaded
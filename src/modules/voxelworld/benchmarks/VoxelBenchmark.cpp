@@ -45,4 +45,30 @@ BENCHMARK_DEFINE_F(PagedVolumeBenchmark, pageIn) (benchmark::State& state) {
 
 BENCHMARK_REGISTER_F(PagedVolumeBenchmark, pageIn);
 
+BENCHMARK_DEFINE_F(PagedVolumeBenchmark, createChunk) (benchmark::State& state) {
+	voxelworld::WorldPager pager(_volumeCache, std::make_shared<voxelworld::ChunkPersister>());
+	pager.setSeed(0l);
+	// the world generation expects chunks that cover the whole height
+	const int chunkSize = voxel::MAX_HEIGHT + 1;
+	voxel::PagedVolume volumeData(&pager, 1024 * 1024 * 1024, chunkSize);
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	const core::String& luaParameters = filesystem->load("worldparams.lua");
+	const core::String& luaBiomes = filesystem->load("biomes.lua");
+	pager.init(&volumeData, luaParameters, luaBiomes);
+	int i = 0;
+	for (auto _ : state) {
+		// don't go through the volume - this only measures the generation of a single chunk
+		const glm::ivec3 pos(chunkSize * i, 0, 0);
+		voxel::PagedVolume::PagerContext ctx;
+		ctx.region = voxel::Region(pos, pos + (chunkSize - 1));
+		ctx.chunk = core::make_shared<voxel::PagedVolume::Chunk>(pos, chunkSize, &pager);
+		pager.pageIn(ctx);
+		++i;
+	}
+	state.SetItemsProcessed(state.iterations() * chunkSize * chunkSize);
+	pager.shutdown();
+}
+
+BENCHMARK_REGISTER_F(PagedVolumeBenchmark, createChunk)->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
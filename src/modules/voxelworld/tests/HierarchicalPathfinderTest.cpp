@@ -0,0 +1,122 @@
+/**
+ * @file
+ */
+
+#include "voxelworld/HierarchicalPathfinder.h"
+#include "AbstractVoxelWorldTest.h"
+
+namespace voxelworld {
+
+/**
+ * A floor of 128x128 voxels with a wall at x == 64 - the wall has a gap at z == 100..102
+ */
+class HierarchicalPathfinderTest : public AbstractVoxelWorldTest {
+protected:
+	static constexpr int WorldSize = 128;
+	static constexpr int WallX = 64;
+	static constexpr int GapZ = 100;
+
+	bool pageIn(const voxel::Region &region, const voxel::PagedVolume::ChunkPtr &chunk) override {
+		const glm::ivec3 &mins = region.getLowerCorner();
+		if (mins.y != 0) {
+			return true;
+		}
+		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Grass, 0);
+		for (int z = 0; z < region.getDepthInVoxels(); ++z) {
+			const int worldZ = mins.z + z;
+			if (worldZ < 0 || worldZ >= WorldSize) {
+				continue;
+			}
+			for (int x = 0; x < region.getWidthInVoxels(); ++x) {
+				const int worldX = mins.x + x;
+				if (worldX < 0 || worldX >= WorldSize) {
+					continue;
+				}
+				chunk->setVoxel(x, 0, z, voxel);
+				if (worldX == WallX && (worldZ < GapZ || worldZ > GapZ + 2)) {
+					chunk->setVoxel(x, 1, z, voxel);
+					chunk->setVoxel(x, 2, z, voxel);
+				}
+			}
+		}
+		return true;
+	}
+};
+
+TEST_F(HierarchicalPathfinderTest, testSameCluster) {
+	HierarchicalPathfinder pathfinder(&_volData);
+	core::List<glm::ivec3> waypoints;
+	ASSERT_TRUE(pathfinder.findRoute(glm::ivec3(2, 1, 2), glm::ivec3(20, 1, 20), waypoints));
+	EXPECT_EQ(2u, waypoints.size()) << "No portal is needed inside of a cluster";
+	EXPECT_EQ(0, pathfinder.cachedClusters());
+}
+
+TEST_F(HierarchicalPathfinderTest, testPathThroughGap) {
+	HierarchicalPathfinder pathfinder(&_volData);
+	const glm::ivec3 start(10, 1, 10);
+	const glm::ivec3 end(120, 1, 10);
+	core::List<glm::ivec3> waypoints;
+	ASSERT_TRUE(pathfinder.findRoute(start, end, waypoints));
+	EXPECT_EQ(start, *waypoints.begin());
+	EXPECT_GT(waypoints.size(), 2u);
+	EXPECT_GT(pathfinder.cachedClusters(), 0);
+
+	core::List<glm::ivec3> path(4096);
+	ASSERT_TRUE(pathfinder.findPath(start, end, path));
+	const glm::ivec3 *prev = nullptr;
+	bool passedGap = false;
+	for (const glm::ivec3 &pos : path) {
+		ASSERT_TRUE(HierarchicalPathfinder::isWalkable(&_volData, pos)) << pos.x << ":" << pos.y << ":" << pos.z;
+		if (prev == nullptr) {
+			EXPECT_EQ(start, pos);
+		} else {
+			const glm::ivec3 &delta = glm::abs(pos - *prev);
+			ASSERT_LE(glm::max(delta.x, glm::max(delta.y, delta.z)), 1) << "The path must consist of neighbours";
+		}
+		if (pos.x == WallX) {
+			EXPECT_GE(pos.z, GapZ);
+			EXPECT_LE(pos.z, GapZ + 2);
+			passedGap = true;
+		}
+		prev = &pos;
+	}
+	ASSERT_NE(nullptr, prev);
+	EXPECT_EQ(end, *prev);
+	EXPECT_TRUE(passedGap);
+}
+
+TEST_F(HierarchicalPathfinderTest, testEvictLeastRecentlyUsed) {
+	HierarchicalPathfinder pathfinder(&_volData, 4);
+	const glm::ivec3 start(10, 1, 10);
+	const glm::ivec3 end(120, 1, 10);
+	core::List<glm::ivec3> waypoints;
+	ASSERT_TRUE(pathfinder.findRoute(start, end, waypoints));
+	EXPECT_LE(pathfinder.cachedClusters(), 4);
+	EXPECT_GT(pathfinder.cachedClusters(), 0);
+	// the same route again must still succeed with the evicted clusters being rebuilt
+	ASSERT_TRUE(pathfinder.findRoute(start, end, waypoints));
+	EXPECT_LE(pathfinder.cachedClusters(), 4);
+}
+
+TEST_F(HierarchicalPathfinderTest, testInvalidate) {
+	HierarchicalPathfinder pathfinder(&_volData);
+	const glm::ivec3 start(10, 1, 10);
+	const glm::ivec3 end(120, 1, 10);
+	core::List<glm::ivec3> waypoints;
+	ASSERT_TRUE(pathfinder.findRoute(start, end, waypoints));
+	const int cached = pathfinder.cachedClusters();
+
+	// close the gap
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Grass, 0);
+	const voxel::Region gap(glm::ivec3(WallX, 1, GapZ), glm::ivec3(WallX, 2, GapZ + 2));
+	for (int z = GapZ; z <= GapZ + 2; ++z) {
+		_volData.setVoxel(WallX, 1, z, voxel);
+		_volData.setVoxel(WallX, 2, z, voxel);
+	}
+	pathfinder.invalidate(gap);
+	EXPECT_LT(pathfinder.cachedClusters(), cached);
+	EXPECT_FALSE(pathfinder.findRoute(start, end, waypoints));
+	EXPECT_TRUE(waypoints.empty());
+}
+
+}
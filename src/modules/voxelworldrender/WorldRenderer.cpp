@@ -45,8 +45,7 @@ alignas(16) static constexpr glm::vec2 waterPlaneVecs[] = {
 };
 
 WorldRenderer::WorldRenderer(const AssetVolumeCachePtr& assetVolumeCache) :
-		_threadPool(1, "WorldRenderer"), _worldChunkMgr(_threadPool), _assetVolumeCache(assetVolumeCache),
-		_shadowMapShader(shader::ShadowmapShader::getInstance()) {
+		_threadPool(1, "WorldRenderer"), _worldChunkMgr(_threadPool), _assetVolumeCache(assetVolumeCache) {
 	setViewDistance(800.0f);
 }
 
@@ -152,14 +151,15 @@ int WorldRenderer::renderClippingPlanes(const video::Camera& camera) {
 	// render above water
 	_reflectionBuffer.bind(true);
 	const glm::mat4& vpmatRefl = reflectionMatrix(camera);
-	drawCallsWorld += renderTerrain(vpmatRefl, waterAbovePlane);
+	// the occlusion culling is only valid for the camera - not for the mirrored one
+	drawCallsWorld += renderTerrain(vpmatRefl, waterAbovePlane, false);
 	drawCallsWorld += renderEntities(vpmatRefl, waterAbovePlane);
 	_reflectionBuffer.unbind();
 
 	// render below water
 	const glm::mat4& vpmat = camera.viewProjectionMatrix();
 	_refractionBuffer.bind(true);
-	drawCallsWorld += renderTerrain(vpmat, waterBelowPlane);
+	drawCallsWorld += renderTerrain(vpmat, waterBelowPlane, true);
 	drawCallsWorld += renderEntities(vpmat, waterBelowPlane);
 	_refractionBuffer.unbind();
 
@@ -227,7 +227,7 @@ int WorldRenderer::renderToFrameBuffer(const video::Camera& camera) {
 	return drawCallsWorld;
 }
 
-int WorldRenderer::renderTerrain(const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane) {
+int WorldRenderer::renderTerrain(const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane, bool occlusionCulling) {
 	int drawCallsWorld = 0;
 	video_trace_scoped(WorldRendererRenderOpaque);
 	video::ScopedShader scoped(_worldShader);
@@ -255,7 +255,7 @@ int WorldRenderer::renderTerrain(const glm::mat4& viewProjectionMatrix, const gl
 		_worldShader.setCascades(_shadow.cascades());
 		_worldShader.setDistances(_shadow.distances());
 	}
-	drawCallsWorld += _worldChunkMgr.renderTerrain();
+	drawCallsWorld += _worldChunkMgr.renderTerrain(occlusionCulling);
 	return drawCallsWorld;
 }
 
@@ -318,7 +318,7 @@ int WorldRenderer::renderAll(const video::Camera& camera) {
 	// due to driver bugs the clip plane might still be taken into account
 	constexpr glm::vec4 ignoreClipPlane(glm::up, 0.0f);
 	const glm::mat4& vpmat = camera.viewProjectionMatrix();
-	drawCallsWorld += renderTerrain(vpmat, ignoreClipPlane);
+	drawCallsWorld += renderTerrain(vpmat, ignoreClipPlane, true);
 	drawCallsWorld += renderEntities(vpmat, ignoreClipPlane);
 	drawCallsWorld += renderPlants(vpmat, ignoreClipPlane);
 	drawCallsWorld += renderEntityDetails(camera);
@@ -349,6 +349,12 @@ void WorldRenderer::construct() {
 	_shadowMap = core::Var::getSafe(cfg::ClientShadowMap);
 	_bloom = core::Var::getSafe(cfg::ClientBloom);
 	_water = core::Var::getSafe(cfg::ClientWater);
+	core::Var::get(cfg::VoxelBinaryMesher, "true", "Use the bitmask based greedy mesher for the surface extraction", core::Var::boolValidator);
+	core::Var::get(cfg::VoxelLodDistance, "256", "The distance at which the world chunks are extracted with a lower level of detail - each level doubles the distance. 0 disables it");
+	core::Var::get(cfg::VoxelPackedVertices, "true", "Upload the world chunks in the packed 32 bit vertex format", core::Var::boolValidator);
+	core::Var::get(cfg::VoxelOcclusionCulling, "true", "Skip the world chunks that are hidden behind the solid parts of the closest chunks", core::Var::boolValidator);
+	core::Var::get(cfg::VoxelMeshCache, "true", "Store the extracted world chunk meshes on disk and reuse them for chunks that weren't modified", core::Var::boolValidator);
+	core::Var::get(cfg::VoxelMeshCacheSize, "256", "The size limit of the mesh cache in megabytes - the least recently used meshes are removed if it's exceeded");
 	_entityRenderer.construct();
 }
 
@@ -436,7 +442,7 @@ bool WorldRenderer::init(voxel::PagedVolume* volume, const glm::ivec2& position,
 		return false;
 	}
 
-	_worldChunkMgr.init(&_worldShader, volume);
+	_worldChunkMgr.init(&_worldShader, &_shadowMapShader, volume);
 	_worldChunkMgr.updateViewDistance(_viewDistance);
 	_threadPool.enqueue([this] () {while (!_cancelThreads) { _worldChunkMgr.extractScheduledMesh(); } });
 
@@ -71,7 +71,7 @@ protected:
 	shader::WorldShader _worldShader;
 	shader::WaterShader _waterShader;
 	// shared shaders
-	shader::ShadowmapShader& _shadowMapShader;
+	shader::WorldShadowmapShader _shadowMapShader;
 
 	bool initFrameBuffers(const glm::ivec2 &dimensions);
 	void shutdownFrameBuffers();
@@ -92,7 +92,10 @@ protected:
 	int renderEntitiesToDepthMap(const video::Camera& camera);
 
 	int renderAll(const video::Camera& camera);
-	int renderTerrain(const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane);
+	/**
+	 * @param occlusionCulling Only for passes that are rendered with the camera that was given to @c update()
+	 */
+	int renderTerrain(const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane, bool occlusionCulling);
 	int renderEntities(const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane);
 	int renderPlants(const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane);
 	int renderEntityDetails(const video::Camera& camera);
@@ -134,6 +137,15 @@ public:
 	float getViewDistance() const;
 	void setViewDistance(float viewDistance);
 
+	/**
+	 * @return The amount of world chunks that passed the frustum culling
+	 */
+	int visibleChunks() const;
+	/**
+	 * @return The amount of visible world chunks that were skipped by the occlusion culling
+	 */
+	int occludedChunks() const;
+
 	int renderWorld(const video::Camera &camera);
 };
 
@@ -159,6 +171,14 @@ inline void WorldRenderer::setViewDistance(float viewDistance) {
 	_entityRenderer.setViewDistance(_viewDistance, _fogRange);
 }
 
+inline int WorldRenderer::visibleChunks() const {
+	return _worldChunkMgr.visibleChunks();
+}
+
+inline int WorldRenderer::occludedChunks() const {
+	return _worldChunkMgr.occludedChunks();
+}
+
 inline render::Shadow &WorldRenderer::shadow() {
 	return _shadow;
 }
@@ -0,0 +1,19 @@
+/**
+ * @brief Decoding of the voxel::PackedVoxelVertex
+ * x (7 bits), y (8 bits), z (7 bits), ambient occlusion (2 bits) and the color index (8 bits)
+ */
+
+/**
+ * @return The position relative to the chunk
+ */
+vec3 packedPosition(uint data) {
+	return vec3(float(data & 127u), float((data >> 7u) & 255u), float((data >> 15u) & 127u));
+}
+
+uint packedAmbientOcclusion(uint data) {
+	return (data >> 22u) & 3u;
+}
+
+uint packedColorIndex(uint data) {
+	return data >> 24u;
+}
@@ -1,7 +1,10 @@
-// attributes from the VAOs
-$in vec3 a_pos;
-$in uvec2 a_info;
+// attributes from the VAOs - the locations must match the world_shadowmap shader
+layout(location = 0) $in vec3 a_pos;
+layout(location = 1) $in uvec2 a_info;
+// see voxel::PackedVoxelVertex - only bound if u_packed is not 0
+layout(location = 2) $in uint a_packed;
 
+uniform int u_packed;
 uniform mat4 u_model;
 uniform vec4 u_clipplane;
 uniform mat4 u_viewprojection;
@@ -16,11 +19,22 @@ $out float v_ambientocclusion;
 #include "_fog.vert"
 #include "_shadowmap.vert"
 #include "_ambientocclusion.vert"
+#include "_packedvertex.vert"
 
 void main(void) {
-	uint a_ao = a_info[0];
-	uint a_colorindex = a_info[1];
-	vec4 pos = u_model * vec4(a_pos, 1.0);
+	uint a_ao;
+	uint a_colorindex;
+	vec3 vertexpos;
+	if (u_packed != 0) {
+		vertexpos = packedPosition(a_packed);
+		a_ao = packedAmbientOcclusion(a_packed);
+		a_colorindex = packedColorIndex(a_packed);
+	} else {
+		vertexpos = a_pos;
+		a_ao = a_info[0];
+		a_colorindex = a_info[1];
+	}
+	vec4 pos = u_model * vec4(vertexpos, 1.0);
 	v_pos = pos.xyz;
 	v_clipspace = u_viewprojection * pos;
 
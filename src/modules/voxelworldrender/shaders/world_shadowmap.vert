@@ -0,0 +1,24 @@
+/**
+ * @brief Fills the bound shadowmap with the depth values of the world chunks
+ * @note The attribute locations must match the world shader
+ */
+
+layout(location = 0) $in vec3 a_pos;
+layout(location = 2) $in uint a_packed;
+
+uniform int u_packed;
+uniform mat4 u_lightviewprojection;
+uniform mat4 u_model;
+
+#include "_packedvertex.vert"
+
+void main()
+{
+	vec3 vertexpos;
+	if (u_packed != 0) {
+		vertexpos = packedPosition(a_packed);
+	} else {
+		vertexpos = a_pos;
+	}
+	gl_Position = u_lightviewprojection * u_model * vec4(vertexpos, 1.0);
+}
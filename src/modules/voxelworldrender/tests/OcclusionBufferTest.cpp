@@ -0,0 +1,78 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxelworldrender/worldrenderer/OcclusionBuffer.h"
+#include "core/GLM.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace voxelworldrender {
+
+class OcclusionBufferTest : public app::AbstractTest {
+protected:
+	OcclusionBuffer _buffer;
+
+	void SetUp() override {
+		app::AbstractTest::SetUp();
+		// looking from the origin along the negative z axis
+		const glm::mat4 &view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::up);
+		const glm::mat4 &projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 500.0f);
+		_buffer.clear(projection * view);
+	}
+};
+
+TEST_F(OcclusionBufferTest, testEmpty) {
+	_buffer.buildHierarchy();
+	EXPECT_EQ(0, _buffer.occluders());
+	EXPECT_TRUE(_buffer.isVisible(glm::vec3(-1.0f, -1.0f, -20.0f), glm::vec3(1.0f, 1.0f, -18.0f)));
+	EXPECT_TRUE(_buffer.isVisible(glm::vec3(-1.0f, -1.0f, -400.0f), glm::vec3(1.0f, 1.0f, -398.0f)));
+}
+
+TEST_F(OcclusionBufferTest, testOccluded) {
+	// a wall in front of the camera
+	_buffer.rasterizeBox(glm::vec3(-20.0f, -20.0f, -12.0f), glm::vec3(20.0f, 20.0f, -10.0f));
+	_buffer.buildHierarchy();
+	EXPECT_EQ(1, _buffer.occluders());
+	EXPECT_LT(_buffer.depth(OcclusionBuffer::Width / 2, OcclusionBuffer::Height / 2), 1.0f);
+	EXPECT_FALSE(_buffer.isVisible(glm::vec3(-1.0f, -1.0f, -30.0f), glm::vec3(1.0f, 1.0f, -28.0f)))
+		<< "Box behind the wall should be occluded";
+	EXPECT_FALSE(_buffer.isVisible(glm::vec3(-10.0f, -5.0f, -100.0f), glm::vec3(10.0f, 5.0f, -50.0f)))
+		<< "Box behind the wall should be occluded";
+	EXPECT_TRUE(_buffer.isVisible(glm::vec3(-1.0f, -1.0f, -8.0f), glm::vec3(1.0f, 1.0f, -6.0f)))
+		<< "Box in front of the wall should be visible";
+	EXPECT_TRUE(_buffer.isVisible(glm::vec3(-1.0f, -1.0f, -30.0f), glm::vec3(1.0f, 1.0f, -5.0f)))
+		<< "Box that intersects the wall should be visible";
+	EXPECT_TRUE(_buffer.isVisible(glm::vec3(-20.0f, -20.0f, -12.0f), glm::vec3(20.0f, 20.0f, -10.0f)))
+		<< "The occluder itself should be visible";
+}
+
+TEST_F(OcclusionBufferTest, testPartiallyOccluded) {
+	// a wall that only covers the left half of the screen
+	_buffer.rasterizeBox(glm::vec3(-50.0f, -20.0f, -12.0f), glm::vec3(0.0f, 20.0f, -10.0f));
+	_buffer.buildHierarchy();
+	EXPECT_FALSE(_buffer.isVisible(glm::vec3(-20.0f, -1.0f, -40.0f), glm::vec3(-15.0f, 1.0f, -38.0f)));
+	EXPECT_TRUE(_buffer.isVisible(glm::vec3(15.0f, -1.0f, -40.0f), glm::vec3(20.0f, 1.0f, -38.0f)));
+	EXPECT_TRUE(_buffer.isVisible(glm::vec3(-5.0f, -1.0f, -40.0f), glm::vec3(5.0f, 1.0f, -38.0f)))
+		<< "Box that is only partially hidden should be visible";
+}
+
+TEST_F(OcclusionBufferTest, testNearPlane) {
+	// only the far face of this occluder doesn't intersect the near plane
+	_buffer.rasterizeBox(glm::vec3(0.5f, -20.0f, -30.0f), glm::vec3(20.0f, 20.0f, 10.0f));
+	_buffer.buildHierarchy();
+	EXPECT_TRUE(_buffer.isVisible(glm::vec3(2.0f, -1.0f, -25.0f), glm::vec3(4.0f, 1.0f, -23.0f)))
+		<< "The faces that intersect the near plane must not be rasterized";
+	EXPECT_FALSE(_buffer.isVisible(glm::vec3(2.0f, -1.0f, -50.0f), glm::vec3(4.0f, 1.0f, -48.0f)))
+		<< "Box behind the far face should be occluded";
+	// an occludee that intersects the near plane is always visible
+	EXPECT_TRUE(_buffer.isVisible(glm::vec3(2.0f, -1.0f, -50.0f), glm::vec3(4.0f, 1.0f, 1.0f)));
+}
+
+TEST_F(OcclusionBufferTest, testOutsideOfScreen) {
+	_buffer.buildHierarchy();
+	EXPECT_FALSE(_buffer.isVisible(glm::vec3(200.0f, -1.0f, -30.0f), glm::vec3(202.0f, 1.0f, -28.0f)));
+	EXPECT_FALSE(_buffer.isVisible(glm::vec3(-1.0f, 100.0f, -30.0f), glm::vec3(1.0f, 102.0f, -28.0f)));
+}
+
+}
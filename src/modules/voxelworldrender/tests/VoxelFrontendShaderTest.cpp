@@ -19,6 +19,15 @@ TEST_P(VoxelFrontendShaderTest, testWorldShader) {
 	shader.shutdown();
 }
 
+TEST_P(VoxelFrontendShaderTest, testWorldShadowmapShader) {
+	if (!_supported) {
+		return;
+	}
+	shader::WorldShadowmapShader shader;
+	EXPECT_TRUE(shader.setup());
+	shader.shutdown();
+}
+
 TEST_P(VoxelFrontendShaderTest, testWaterShader) {
 	if (!_supported) {
 		return;
@@ -0,0 +1,67 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxelworldrender/worldrenderer/WorldChunkMgr.h"
+#include "core/GameConfig.h"
+#include "voxel/Constants.h"
+
+namespace voxelworldrender {
+
+class WorldChunkMgrTest : public app::AbstractTest {
+protected:
+	class TestWorldChunkMgr : public WorldChunkMgr {
+	public:
+		TestWorldChunkMgr(core::ThreadPool &threadPool) : WorldChunkMgr(threadPool) {
+			_occlusionCulling = core::Var::get(cfg::VoxelOcclusionCulling, "true");
+		}
+
+		ChunkBuffer *addChunk(const glm::ivec3 &mins, int occluderHeight, int maxHeight) {
+			ChunkBuffer *chunkBuffer = &_chunkBuffers[_visibleBuffers.size];
+			chunkBuffer->inuse = true;
+			chunkBuffer->occluderHeight = occluderHeight;
+			chunkBuffer->maxHeight = maxHeight;
+			chunkBuffer->_aabb = {mins, mins + glm::ivec3(16, voxel::MAX_MESH_CHUNK_HEIGHT, 16)};
+			_visibleBuffers.visible[_visibleBuffers.size++] = chunkBuffer;
+			return chunkBuffer;
+		}
+
+		bool occluded(const ChunkBuffer *chunkBuffer) const {
+			return chunkBuffer->occluded;
+		}
+
+		void occlusionCull(const video::Camera &camera) {
+			WorldChunkMgr::occlusionCull(camera);
+		}
+	};
+
+	video::Camera camera() const {
+		video::Camera camera;
+		camera.setNearPlane(0.1f);
+		camera.setFarPlane(500.0f);
+		camera.setSize(glm::ivec2(1024, 768));
+		camera.setWorldPosition(glm::vec3(8.0f, 20.0f, 60.0f));
+		camera.lookAt(glm::vec3(8.0f, 20.0f, 0.0f));
+		camera.update(0.0);
+		return camera;
+	}
+};
+
+TEST_F(WorldChunkMgrTest, testOcclusionCull) {
+	TestWorldChunkMgr *mgr = new TestWorldChunkMgr(_testApp->threadPool());
+	// a chunk that is solid up to a height of 24 voxels right in front of the camera
+	auto *wall = mgr->addChunk(glm::ivec3(0, 0, 16), 24, 24);
+	// a low chunk behind the wall - the aabb covers the full chunk height and would reach above the wall
+	auto *hidden = mgr->addChunk(glm::ivec3(0, 0, -16), 0, 12);
+	// a chunk behind the wall whose mesh reaches above the wall
+	auto *tall = mgr->addChunk(glm::ivec3(0, 0, -32), 0, 100);
+	mgr->occlusionCull(camera());
+	EXPECT_FALSE(mgr->occluded(wall));
+	EXPECT_TRUE(mgr->occluded(hidden)) << "The chunk behind the wall should be culled";
+	EXPECT_FALSE(mgr->occluded(tall)) << "The chunk reaches above the wall and should be visible";
+	EXPECT_EQ(1, mgr->occludedChunks());
+	delete mgr;
+}
+
+}
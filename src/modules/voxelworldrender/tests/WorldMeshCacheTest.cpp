@@ -0,0 +1,144 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxelworldrender/worldrenderer/WorldMeshCache.h"
+#include "voxelworldrender/worldrenderer/WorldMeshExtractor.h"
+#include "voxel/CubicSurfaceExtractor.h"
+#include "voxel/IsQuadNeeded.h"
+#include "voxel/RawVolume.h"
+
+namespace voxelworldrender {
+
+class WorldMeshCacheTest : public app::AbstractTest {
+protected:
+	WorldMeshCache _cache;
+
+	void SetUp() override {
+		app::AbstractTest::SetUp();
+		ASSERT_TRUE(_cache.init("meshcachetest"));
+	}
+
+	void TearDown() override {
+		_cache.clear();
+		_cache.shutdown();
+		app::AbstractTest::TearDown();
+	}
+
+	void fill(voxel::RawVolume &volume) const {
+		const voxel::Region &region = volume.region();
+		for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				const int height = 1 + (x * 3 + z * 7) % 5;
+				for (int32_t y = 0; y < height; ++y) {
+					volume.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (uint8_t)(x + z)));
+				}
+			}
+		}
+	}
+};
+
+TEST_F(WorldMeshCacheTest, testKey) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	fill(volume);
+	const voxel::Region region(1, 14);
+	const uint64_t key = WorldMeshCache::key(volume, region, 0, 0u);
+	EXPECT_EQ(key, WorldMeshCache::key(volume, region, 0, 0u));
+	EXPECT_NE(key, WorldMeshCache::key(volume, region, 1, 0u));
+	EXPECT_NE(key, WorldMeshCache::key(volume, region, 0, 1u));
+	EXPECT_NE(key, WorldMeshCache::key(volume, voxel::Region(2, 14), 0, 0u));
+
+	volume.setVoxel(8, 10, 8, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	EXPECT_NE(key, WorldMeshCache::key(volume, region, 0, 0u));
+	volume.setVoxel(8, 10, 8, voxel::Voxel());
+	EXPECT_EQ(key, WorldMeshCache::key(volume, region, 0, 0u));
+
+	// the neighbours of the region are taken into account by the extractors
+	volume.setVoxel(0, 10, 0, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	EXPECT_NE(key, WorldMeshCache::key(volume, region, 0, 0u));
+}
+
+TEST_F(WorldMeshCacheTest, testSaveAndLoad) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	fill(volume);
+	const voxel::Region region(1, 14);
+	ExtractedMesh extracted;
+	voxel::extractCubicMesh(&volume, region, &extracted.mesh, voxel::IsQuadNeeded(), region.getLowerCorner());
+	ASSERT_FALSE(extracted.mesh.isEmpty());
+	ASSERT_TRUE(voxel::packVertices(extracted.mesh, extracted.packedVertices));
+	extracted.lod = 1;
+	extracted.occluderHeight = 2;
+	extracted.maxHeight = 5;
+
+	const uint64_t key = WorldMeshCache::key(volume, region, extracted.lod, 0u);
+	ExtractedMesh loaded;
+	EXPECT_FALSE(_cache.load(key, loaded));
+	ASSERT_TRUE(_cache.save(key, extracted));
+	ASSERT_TRUE(_cache.load(key, loaded));
+	EXPECT_FALSE(_cache.load(key + 1, loaded));
+
+	EXPECT_EQ(extracted.lod, loaded.lod);
+	EXPECT_EQ(extracted.occluderHeight, loaded.occluderHeight);
+	EXPECT_EQ(extracted.maxHeight, loaded.maxHeight);
+	EXPECT_EQ(extracted.mesh.getOffset(), loaded.mesh.getOffset());
+	ASSERT_EQ(extracted.mesh.getNoOfVertices(), loaded.mesh.getNoOfVertices());
+	for (size_t i = 0; i < extracted.mesh.getNoOfVertices(); ++i) {
+		const voxel::VoxelVertex &expected = extracted.mesh.getVertex((voxel::IndexType)i);
+		const voxel::VoxelVertex &vertex = loaded.mesh.getVertex((voxel::IndexType)i);
+		EXPECT_EQ(expected.position, vertex.position);
+		EXPECT_EQ(expected.colorIndex, vertex.colorIndex);
+	}
+	ASSERT_EQ(extracted.packedVertices.size(), loaded.packedVertices.size());
+	for (size_t i = 0; i < extracted.packedVertices.size(); ++i) {
+		EXPECT_EQ(extracted.packedVertices[i].data, loaded.packedVertices[i].data);
+	}
+	ASSERT_EQ(extracted.mesh.getNoOfIndices(), loaded.mesh.getNoOfIndices());
+	ASSERT_EQ(extracted.mesh.compressedIndexSize(), loaded.mesh.compressedIndexSize());
+	for (size_t i = 0; i < extracted.mesh.getNoOfIndices(); ++i) {
+		EXPECT_EQ(extracted.mesh.getIndex((voxel::IndexType)i), loaded.mesh.getIndex((voxel::IndexType)i));
+	}
+
+	EXPECT_TRUE(_cache.clear());
+	EXPECT_FALSE(_cache.load(key, loaded));
+}
+
+TEST_F(WorldMeshCacheTest, testEvictLeastRecentlyUsed) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	fill(volume);
+	const voxel::Region region(1, 14);
+	ExtractedMesh extracted;
+	voxel::extractCubicMesh(&volume, region, &extracted.mesh, voxel::IsQuadNeeded(), region.getLowerCorner());
+	ASSERT_FALSE(extracted.mesh.isEmpty());
+	const uint64_t entrySize = sizeof(WorldMeshCache::Header) +
+							   extracted.mesh.getNoOfVertices() * sizeof(voxel::VoxelVertex) +
+							   extracted.mesh.getNoOfIndices() * sizeof(voxel::IndexType);
+
+	// a budget for two entries
+	WorldMeshCache cache;
+	ASSERT_TRUE(cache.init("meshcacheevicttest", entrySize * 3u - 1u));
+	ASSERT_TRUE(cache.clear());
+	ASSERT_TRUE(cache.save(1u, extracted));
+	ASSERT_TRUE(cache.save(2u, extracted));
+	EXPECT_EQ(2u, cache.entries());
+	EXPECT_EQ(entrySize * 2u, cache.size());
+	ExtractedMesh loaded;
+	ASSERT_TRUE(cache.load(1u, loaded));
+	ASSERT_TRUE(cache.save(3u, extracted));
+	EXPECT_EQ(2u, cache.entries());
+	EXPECT_EQ(entrySize * 2u, cache.size());
+	EXPECT_TRUE(cache.load(1u, loaded));
+	EXPECT_FALSE(cache.load(2u, loaded)) << "The least recently used entry should have been removed";
+	EXPECT_TRUE(cache.load(3u, loaded));
+
+	// the existing files are taken into account after a restart
+	cache.shutdown();
+	ASSERT_TRUE(cache.init("meshcacheevicttest", entrySize * 3u - 1u));
+	EXPECT_EQ(2u, cache.entries());
+	EXPECT_EQ(entrySize * 2u, cache.size());
+	EXPECT_TRUE(cache.clear());
+	EXPECT_EQ(0u, cache.entries());
+	cache.shutdown();
+}
+
+}
@@ -0,0 +1,107 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxelworldrender/worldrenderer/WorldMeshExtractor.h"
+#include "core/GameConfig.h"
+#include "voxel/Constants.h"
+
+namespace voxelworldrender {
+
+class WorldMeshExtractorTest : public app::AbstractTest {
+protected:
+	class Pager : public voxel::PagedVolume::Pager {
+	public:
+		bool pageIn(voxel::PagedVolume::PagerContext &ctx) override {
+			const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+			const int size = ctx.chunk->sideLength();
+			for (int z = 0; z < size; ++z) {
+				for (int y = 0; y < size; ++y) {
+					for (int x = 0; x < size; ++x) {
+						ctx.chunk->setVoxel(x, y, z, voxel);
+					}
+				}
+			}
+			return true;
+		}
+
+		void pageOut(voxel::PagedVolume::Chunk *chunk) override {
+		}
+	};
+
+	Pager _pager;
+	voxel::PagedVolume _volume{&_pager, 64 * 1024 * 1024, 32};
+	WorldMeshExtractor _extractor;
+
+	void SetUp() override {
+		app::AbstractTest::SetUp();
+		core::Var::get(cfg::VoxelMeshSize, "16", core::CV_READONLY);
+		core::Var::get(cfg::VoxelBinaryMesher, "false");
+		core::Var::get(cfg::VoxelPackedVertices, "false");
+		core::Var::get(cfg::VoxelMeshCache, "false");
+		core::Var::get(cfg::VoxelMeshCacheSize, "1");
+		ASSERT_TRUE(_extractor.init(&_volume));
+	}
+
+	void TearDown() override {
+		_extractor.shutdown();
+		app::AbstractTest::TearDown();
+	}
+
+	/**
+	 * @return @c true if there is a triangle that lies in the plane where the given component is @c value
+	 */
+	bool hasFace(const voxel::Mesh &mesh, int component, int value) const {
+		const voxel::IndexArray &indices = mesh.getIndexVector();
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			bool inPlane = true;
+			for (size_t j = i; j < i + 3; ++j) {
+				if (mesh.getVertex(indices[j]).position[component] != value) {
+					inPlane = false;
+					break;
+				}
+			}
+			if (inPlane) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void extract(int lod, ExtractedMesh &extracted) {
+		ASSERT_TRUE(_extractor.scheduleMeshExtraction(glm::ivec3(0), lod));
+		_extractor.extractScheduledMesh();
+		ASSERT_TRUE(_extractor.pop(extracted));
+		ASSERT_EQ(lod, extracted.lod);
+	}
+};
+
+TEST_F(WorldMeshExtractorTest, testLodBorderFaces) {
+	ExtractedMesh extracted;
+	extract(1, extracted);
+	const voxel::Mesh &mesh = extracted.mesh;
+	ASSERT_FALSE(mesh.isEmpty());
+	const glm::ivec3 &size = _extractor.meshSize();
+	EXPECT_TRUE(hasFace(mesh, 0, 0)) << "Missing -x face";
+	EXPECT_TRUE(hasFace(mesh, 0, size.x)) << "Missing +x face";
+	EXPECT_TRUE(hasFace(mesh, 2, 0)) << "Missing -z face";
+	EXPECT_TRUE(hasFace(mesh, 2, size.z)) << "Missing +z face";
+	EXPECT_TRUE(hasFace(mesh, 1, voxel::MAX_MESH_CHUNK_HEIGHT)) << "Missing top face";
+	EXPECT_EQ(voxel::MAX_MESH_CHUNK_HEIGHT - 1, extracted.occluderHeight);
+	EXPECT_EQ(voxel::MAX_MESH_CHUNK_HEIGHT, extracted.maxHeight);
+}
+
+TEST_F(WorldMeshExtractorTest, testLodBorderFacesBinaryMesher) {
+	core::Var::getSafe(cfg::VoxelBinaryMesher)->setVal(true);
+	ExtractedMesh extracted;
+	extract(2, extracted);
+	const voxel::Mesh &mesh = extracted.mesh;
+	ASSERT_FALSE(mesh.isEmpty());
+	const glm::ivec3 &size = _extractor.meshSize();
+	EXPECT_TRUE(hasFace(mesh, 0, size.x)) << "Missing +x face";
+	EXPECT_TRUE(hasFace(mesh, 2, size.z)) << "Missing +z face";
+	EXPECT_TRUE(hasFace(mesh, 1, voxel::MAX_MESH_CHUNK_HEIGHT)) << "Missing top face";
+}
+
+}
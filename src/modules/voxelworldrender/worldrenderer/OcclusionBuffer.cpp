@@ -0,0 +1,202 @@
+/**
+ * @file
+ */
+
+#include "OcclusionBuffer.h"
+#include "core/Common.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include <glm/common.hpp>
+
+namespace voxelworldrender {
+
+namespace {
+// vertices that are closer to the camera plane can't be projected in a stable way
+constexpr float MinClipW = 0.001f;
+}
+
+OcclusionBuffer::OcclusionBuffer() {
+	for (int level = 0; level < Levels; ++level) {
+		_levels[level] = (float *)core_malloc(levelWidth(level) * levelHeight(level) * sizeof(float));
+	}
+	clear(glm::mat4(1.0f));
+}
+
+OcclusionBuffer::~OcclusionBuffer() {
+	for (int level = 0; level < Levels; ++level) {
+		core_free(_levels[level]);
+	}
+}
+
+void OcclusionBuffer::clear(const glm::mat4 &viewProjection) {
+	_viewProjection = viewProjection;
+	_occluders = 0;
+	float *buf = _levels[0];
+	for (int i = 0; i < Width * Height; ++i) {
+		buf[i] = 1.0f;
+	}
+}
+
+bool OcclusionBuffer::project(const glm::vec3 &pos, glm::vec3 &screen) const {
+	const glm::vec4 &clip = _viewProjection * glm::vec4(pos, 1.0f);
+	if (clip.w < MinClipW) {
+		return false;
+	}
+	const float z = clip.z / clip.w;
+	// in front of the near plane - this part would get clipped away
+	if (z < -1.0f) {
+		return false;
+	}
+	screen.x = (clip.x / clip.w * 0.5f + 0.5f) * (float)Width;
+	screen.y = (clip.y / clip.w * 0.5f + 0.5f) * (float)Height;
+	screen.z = z;
+	return true;
+}
+
+void OcclusionBuffer::rasterizeTriangle(const glm::vec3 &v0, const glm::vec3 &a, const glm::vec3 &b) {
+	float area = (a.x - v0.x) * (b.y - v0.y) - (a.y - v0.y) * (b.x - v0.x);
+	if (glm::abs(area) < 0.0001f) {
+		return;
+	}
+	// both windings are rasterized - make the edge functions positive inside of the triangle
+	const bool ccw = area > 0.0f;
+	const glm::vec3 &v1 = ccw ? a : b;
+	const glm::vec3 &v2 = ccw ? b : a;
+	area = glm::abs(area);
+
+	// clamp in float space - the projected coordinates of vertices close to the camera plane might not fit into an int
+	const int minX = (int)glm::floor(glm::clamp(core_min(v0.x, core_min(v1.x, v2.x)), 0.0f, (float)Width));
+	const int maxX = (int)glm::ceil(glm::clamp(core_max(v0.x, core_max(v1.x, v2.x)), -1.0f, (float)(Width - 1)));
+	const int minY = (int)glm::floor(glm::clamp(core_min(v0.y, core_min(v1.y, v2.y)), 0.0f, (float)Height));
+	const int maxY = (int)glm::ceil(glm::clamp(core_max(v0.y, core_max(v1.y, v2.y)), -1.0f, (float)(Height - 1)));
+	if (minX > maxX || minY > maxY) {
+		return;
+	}
+
+	// edge functions e(p) = (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x) for the edges opposite to
+	// the vertices - evaluated incrementally for the pixel centers
+	const float stepX0 = -(v2.y - v1.y), stepY0 = v2.x - v1.x;
+	const float stepX1 = -(v0.y - v2.y), stepY1 = v0.x - v2.x;
+	const float stepX2 = -(v1.y - v0.y), stepY2 = v1.x - v0.x;
+	const float px = (float)minX + 0.5f;
+	const float py = (float)minY + 0.5f;
+	float row0 = stepY0 * (py - v1.y) + stepX0 * (px - v1.x);
+	float row1 = stepY1 * (py - v2.y) + stepX1 * (px - v2.x);
+	float row2 = stepY2 * (py - v0.y) + stepX2 * (px - v0.x);
+	// the normalized device depth is linear in screen space
+	const float z0 = v0.z / area;
+	const float z1 = v1.z / area;
+	const float z2 = v2.z / area;
+
+	float *buf = _levels[0];
+	for (int y = minY; y <= maxY; ++y) {
+		float w0 = row0;
+		float w1 = row1;
+		float w2 = row2;
+		float *line = &buf[y * Width];
+		for (int x = minX; x <= maxX; ++x) {
+			if (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f) {
+				const float z = w0 * z0 + w1 * z1 + w2 * z2;
+				if (z < line[x]) {
+					line[x] = z;
+				}
+			}
+			w0 += stepX0;
+			w1 += stepX1;
+			w2 += stepX2;
+		}
+		row0 += stepY0;
+		row1 += stepY1;
+		row2 += stepY2;
+	}
+}
+
+void OcclusionBuffer::rasterizeBox(const glm::vec3 &mins, const glm::vec3 &maxs) {
+	core_trace_scoped(OcclusionBufferRasterizeBox);
+	glm::vec3 screen[8];
+	bool valid[8];
+	for (int i = 0; i < 8; ++i) {
+		const glm::vec3 corner((i & 1) ? maxs.x : mins.x, (i & 2) ? maxs.y : mins.y, (i & 4) ? maxs.z : mins.z);
+		valid[i] = project(corner, screen[i]);
+	}
+	// the corner indices of the six faces
+	static const int faces[6][4] = {
+		{0, 2, 6, 4}, {1, 3, 7, 5}, // -x, +x
+		{0, 1, 5, 4}, {2, 3, 7, 6}, // -y, +y
+		{0, 1, 3, 2}, {4, 5, 7, 6}  // -z, +z
+	};
+	for (int f = 0; f < 6; ++f) {
+		const int *face = faces[f];
+		if (!valid[face[0]] || !valid[face[1]] || !valid[face[2]] || !valid[face[3]]) {
+			continue;
+		}
+		rasterizeTriangle(screen[face[0]], screen[face[1]], screen[face[2]]);
+		rasterizeTriangle(screen[face[0]], screen[face[2]], screen[face[3]]);
+	}
+	++_occluders;
+}
+
+void OcclusionBuffer::buildHierarchy() {
+	core_trace_scoped(OcclusionBufferBuildHierarchy);
+	for (int level = 1; level < Levels; ++level) {
+		const float *src = _levels[level - 1];
+		float *dst = _levels[level];
+		const int srcWidth = levelWidth(level - 1);
+		const int w = levelWidth(level);
+		const int h = levelHeight(level);
+		for (int y = 0; y < h; ++y) {
+			const float *line0 = &src[(y * 2) * srcWidth];
+			const float *line1 = line0 + srcWidth;
+			for (int x = 0; x < w; ++x) {
+				const float d0 = core_max(line0[x * 2], line0[x * 2 + 1]);
+				const float d1 = core_max(line1[x * 2], line1[x * 2 + 1]);
+				dst[y * w + x] = core_max(d0, d1);
+			}
+		}
+	}
+}
+
+bool OcclusionBuffer::isVisible(const glm::vec3 &mins, const glm::vec3 &maxs) const {
+	glm::vec3 screenMins(0.0f);
+	glm::vec3 screenMaxs(0.0f);
+	for (int i = 0; i < 8; ++i) {
+		const glm::vec3 corner((i & 1) ? maxs.x : mins.x, (i & 2) ? maxs.y : mins.y, (i & 4) ? maxs.z : mins.z);
+		glm::vec3 screen;
+		if (!project(corner, screen)) {
+			return true;
+		}
+		if (i == 0) {
+			screenMins = screenMaxs = screen;
+		} else {
+			screenMins = glm::min(screenMins, screen);
+			screenMaxs = glm::max(screenMaxs, screen);
+		}
+	}
+	if (screenMaxs.x < 0.0f || screenMaxs.y < 0.0f || screenMins.x >= (float)Width || screenMins.y >= (float)Height) {
+		return false;
+	}
+	int x0 = (int)core_max(0.0f, screenMins.x);
+	int y0 = (int)core_max(0.0f, screenMins.y);
+	int x1 = (int)core_min((float)(Width - 1), screenMaxs.x);
+	int y1 = (int)core_min((float)(Height - 1), screenMaxs.y);
+	// pick the mip level where the box covers only a few texels
+	int level = 0;
+	while (level < Levels - 1 && ((x1 >> level) - (x0 >> level) > 3 || (y1 >> level) - (y0 >> level) > 3)) {
+		++level;
+	}
+	x0 >>= level;
+	y0 >>= level;
+	x1 >>= level;
+	y1 >>= level;
+	const float nearestDepth = screenMins.z;
+	for (int y = y0; y <= y1; ++y) {
+		for (int x = x0; x <= x1; ++x) {
+			if (depth(x, y, level) >= nearestDepth) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+}
@@ -0,0 +1,101 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/NonCopyable.h"
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+namespace voxelworldrender {
+
+/**
+ * @brief Low resolution software rasterized depth buffer that is used to reject the world chunks that are
+ * hidden behind other chunks before they are drawn.
+ *
+ * The occluders are rasterized with their interpolated depth - the occludees are tested conservatively
+ * with the nearest depth of their bounding box against the farthest depth of the covered texels of a
+ * hierarchical (max) depth mip chain.
+ *
+ * @code
+ * buffer.clear(camera.viewProjectionMatrix());
+ * buffer.rasterizeBox(occluderMins, occluderMaxs);
+ * buffer.buildHierarchy();
+ * if (buffer.isVisible(mins, maxs)) { ... }
+ * @endcode
+ */
+class OcclusionBuffer : public core::NonCopyable {
+public:
+	static constexpr int Width = 256;
+	static constexpr int Height = 128;
+	/**
+	 * @brief The amount of mip levels including the full resolution level @c 0 - the last level is 2x1 texels
+	 */
+	static constexpr int Levels = 8;
+
+private:
+	glm::mat4 _viewProjection{1.0f};
+	/** the normalized device depth values - level 0 is the rasterized buffer, the others are the max depth mips */
+	float *_levels[Levels];
+	int _occluders = 0;
+
+	/**
+	 * @brief Transforms the given world position into pixel coordinates and normalized device depth
+	 * @return @c false if the position is too close to the camera or behind it
+	 */
+	bool project(const glm::vec3 &pos, glm::vec3 &screen) const;
+	void rasterizeTriangle(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2);
+
+	static inline int levelWidth(int level) {
+		return Width >> level;
+	}
+	static inline int levelHeight(int level) {
+		return Height >> level;
+	}
+
+public:
+	OcclusionBuffer();
+	~OcclusionBuffer();
+
+	/**
+	 * @brief Resets the depth values to the far plane and sets the matrix for the following occluders and tests
+	 */
+	void clear(const glm::mat4 &viewProjection);
+	/**
+	 * @brief Rasterizes the faces of the given box - the box must be completely solid from all sides
+	 * @note Faces that are crossing the near plane are skipped. This makes the buffer less effective for
+	 * occluders that are very close to the camera, but it's still conservative.
+	 */
+	void rasterizeBox(const glm::vec3 &mins, const glm::vec3 &maxs);
+	/**
+	 * @brief Updates the max depth mip chain. Must be called after the occluders were rasterized and
+	 * before @c isVisible() is called.
+	 */
+	void buildHierarchy();
+	/**
+	 * @return @c false if the given box is hidden behind the rasterized occluders or outside of the screen.
+	 * A box that intersects the near plane is always treated as visible.
+	 */
+	bool isVisible(const glm::vec3 &mins, const glm::vec3 &maxs) const;
+
+	/**
+	 * @return The normalized device depth of the given pixel of the given mip level
+	 */
+	float depth(int x, int y, int level = 0) const;
+
+	/**
+	 * @return The amount of boxes that were rasterized since the last @c clear()
+	 */
+	int occluders() const;
+};
+
+inline float OcclusionBuffer::depth(int x, int y, int level) const {
+	return _levels[level][y * levelWidth(level) + x];
+}
+
+inline int OcclusionBuffer::occluders() const {
+	return _occluders;
+}
+
+}
@@ -6,11 +6,14 @@
 #include "core/Trace.h"
 #include "video/Trace.h"
 #include "voxel/Constants.h"
+#include "core/GameConfig.h"
 #include "voxelrender/ShaderAttribute.h"
 #include "WorldShader.h"
+#include "WorldShadowmapShader.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/transform.hpp>
+#include <algorithm>
 
 namespace voxelworldrender {
 
@@ -28,8 +31,11 @@ void WorldChunkMgr::updateViewDistance(float viewDistance) {
 	_maxAllowedDistance = glm::pow(viewDistance + (float)maxCullingThreshold, 2);
 }
 
-bool WorldChunkMgr::init(shader::WorldShader* worldShader, voxel::PagedVolume* volume) {
+bool WorldChunkMgr::init(shader::WorldShader* worldShader, shader::WorldShadowmapShader* shadowMapShader, voxel::PagedVolume* volume) {
 	_worldShader = worldShader;
+	_shadowMapShader = shadowMapShader;
+	_lodDistance = core::Var::getSafe(cfg::VoxelLodDistance);
+	_occlusionCulling = core::Var::getSafe(cfg::VoxelOcclusionCulling);
 	if (!_meshExtractor.init(volume)) {
 		Log::error("Failed to initialize the mesh extractor");
 		return false;
@@ -46,19 +52,37 @@ void WorldChunkMgr::reset() {
 		chunkBuffer.inuse = false;
 	}
 	_visibleBuffers.size = 0;
+	_occludedChunks = 0;
 	_meshExtractor.reset();
 	_octree.clear();
 }
 
 void WorldChunkMgr::handleMeshQueue() {
-	voxel::Mesh mesh;
-	if (!_meshExtractor.pop(mesh)) {
+	ExtractedMesh extracted;
+	if (!_meshExtractor.pop(extracted)) {
+		return;
+	}
+	const voxel::Mesh& mesh = extracted.mesh;
+	if (!_meshExtractor.isExtracted(mesh.getOffset())) {
+		// the chunk was already removed again while the (re-)extraction was running
 		return;
 	}
 
 	// Now add the mesh to the list of meshes to render.
 	core_trace_scoped(WorldRendererHandleMeshQueue);
 
+	if (mesh.isEmpty()) {
+		// nothing to render - but a mesh of a previous level of detail must not stay around with a pending lod
+		for (ChunkBuffer& chunkBuffer : _chunkBuffers) {
+			if (chunkBuffer.inuse && chunkBuffer.aabb().mins() == mesh.getOffset()) {
+				_octree.remove(&chunkBuffer);
+				chunkBuffer.reset();
+				break;
+			}
+		}
+		return;
+	}
+
 	ChunkBuffer* freeChunkBuffer = nullptr;
 	for (ChunkBuffer& chunkBuffer : _chunkBuffers) {
 		if (freeChunkBuffer == nullptr && !chunkBuffer.inuse) {
@@ -76,23 +100,40 @@ void WorldChunkMgr::handleMeshQueue() {
 		return;
 	}
 
+	// a new level of detail replaces the existing mesh without the scale animation
+	const bool replace = freeChunkBuffer->inuse;
+	if (replace) {
+		_octree.remove(freeChunkBuffer);
+		freeChunkBuffer->reset();
+	}
+
 	video::Buffer& buffer = freeChunkBuffer->_buffer;
 	freeChunkBuffer->_vbo = buffer.create();
 	if (freeChunkBuffer->_vbo == -1) {
 		Log::error("Failed to create vertex buffer");
 		return;
 	}
-	const int locationPos = _worldShader->getLocationPos();
-	const video::Attribute& posAttrib = voxelrender::getPositionVertexAttribute(freeChunkBuffer->_vbo, locationPos, _worldShader->getAttributeComponents(locationPos));
-	if (!buffer.addAttribute(posAttrib)) {
-		Log::error("Failed to add position attribute");
-		return;
-	}
-	const int locationInfo = _worldShader->getLocationInfo();
-	const video::Attribute& infoAttrib = voxelrender::getInfoVertexAttribute(freeChunkBuffer->_vbo, locationInfo, _worldShader->getAttributeComponents(locationInfo));
-	if (!buffer.addAttribute(infoAttrib)) {
-		Log::error("Failed to add info attribute");
-		return;
+	const bool packed = !extracted.packedVertices.empty();
+	if (packed) {
+		const int locationPacked = _worldShader->getLocationPacked();
+		const video::Attribute& packedAttrib = voxelrender::getPackedVertexAttribute(freeChunkBuffer->_vbo, locationPacked, _worldShader->getAttributeComponents(locationPacked));
+		if (!buffer.addAttribute(packedAttrib)) {
+			Log::error("Failed to add packed vertex attribute");
+			return;
+		}
+	} else {
+		const int locationPos = _worldShader->getLocationPos();
+		const video::Attribute& posAttrib = voxelrender::getPositionVertexAttribute(freeChunkBuffer->_vbo, locationPos, _worldShader->getAttributeComponents(locationPos));
+		if (!buffer.addAttribute(posAttrib)) {
+			Log::error("Failed to add position attribute");
+			return;
+		}
+		const int locationInfo = _worldShader->getLocationInfo();
+		const video::Attribute& infoAttrib = voxelrender::getInfoVertexAttribute(freeChunkBuffer->_vbo, locationInfo, _worldShader->getAttributeComponents(locationInfo));
+		if (!buffer.addAttribute(infoAttrib)) {
+			Log::error("Failed to add info attribute");
+			return;
+		}
 	}
 	freeChunkBuffer->_ibo = buffer.create(nullptr, 0, video::BufferType::IndexBuffer);
 	if (freeChunkBuffer->_ibo == -1) {
@@ -101,9 +142,14 @@ void WorldChunkMgr::handleMeshQueue() {
 	}
 	freeChunkBuffer->_compressedIndexSize = mesh.compressedIndexSize();
 
-	const voxel::VertexArray& vertices = mesh.getVertexVector();
 	const uint8_t* indices = mesh.compressedIndices();
-	buffer.update(freeChunkBuffer->_vbo, &vertices.front(), vertices.size() * sizeof(voxel::VertexArray::value_type));
+	if (packed) {
+		const voxel::PackedVertexArray& vertices = extracted.packedVertices;
+		buffer.update(freeChunkBuffer->_vbo, &vertices.front(), vertices.size() * sizeof(voxel::PackedVertexArray::value_type));
+	} else {
+		const voxel::VertexArray& vertices = mesh.getVertexVector();
+		buffer.update(freeChunkBuffer->_vbo, &vertices.front(), vertices.size() * sizeof(voxel::VertexArray::value_type));
+	}
 	buffer.update(freeChunkBuffer->_ibo, indices, mesh.getNoOfIndices() * freeChunkBuffer->_compressedIndexSize);
 
 	const glm::ivec3& size = _meshExtractor.meshSize();
@@ -114,12 +160,19 @@ void WorldChunkMgr::handleMeshQueue() {
 		Log::warn("Failed to insert into octree");
 	}
 	freeChunkBuffer->inuse = true;
-	freeChunkBuffer->scaleSeconds = ScaleDuration;
+	freeChunkBuffer->lod = extracted.lod;
+	freeChunkBuffer->packed = packed;
+	freeChunkBuffer->occluderHeight = extracted.occluderHeight;
+	freeChunkBuffer->maxHeight = extracted.maxHeight;
+	if (!replace) {
+		freeChunkBuffer->scaleSeconds = ScaleDuration;
+	}
 }
 
 void WorldChunkMgr::update(double deltaFrameSeconds, const video::Camera &camera, const glm::vec3& focusPos) {
 	handleMeshQueue();
 
+	_focusPos = focusPos;
 	_meshExtractor.updateExtractionOrder(focusPos);
 	for (ChunkBuffer& chunkBuffer : _chunkBuffers) {
 		if (!chunkBuffer.inuse) {
@@ -129,6 +182,7 @@ void WorldChunkMgr::update(double deltaFrameSeconds, const video::Camera &camera
 		const glm::ivec3& pos = chunkBuffer.aabb().mins();
 		const int distance = distance2(pos, focusPos);
 		if (distance < _maxAllowedDistance) {
+			updateLod(chunkBuffer);
 			continue;
 		}
 		core_assert_always(_meshExtractor.allowReExtraction(pos));
@@ -161,6 +215,63 @@ void WorldChunkMgr::cull(const video::Camera& camera) {
 		_visibleBuffers.visible[index++] = chunkBuffer;
 	}
 	_visibleBuffers.size = index;
+
+	occlusionCull(camera);
+}
+
+void WorldChunkMgr::occlusionCull(const video::Camera& camera) {
+	_occludedChunks = 0;
+	for (int i = 0; i < _visibleBuffers.size; ++i) {
+		_visibleBuffers.visible[i]->occluded = false;
+	}
+	if (!_occlusionCulling->boolVal()) {
+		return;
+	}
+	core_trace_scoped(WorldRendererOcclusionCull);
+
+	// the closest chunks are the best occluders
+	const glm::vec3& cameraPos = camera.worldPosition();
+	ChunkBuffer* occluders[MAX_CHUNKBUFFERS];
+	int occluderCount = 0;
+	for (int i = 0; i < _visibleBuffers.size; ++i) {
+		ChunkBuffer* chunkBuffer = _visibleBuffers.visible[i];
+		// still animated chunks are scaled down and don't cover their full solid slab yet
+		if (chunkBuffer->occluderHeight <= 0 || chunkBuffer->scaleSeconds > 0.0) {
+			continue;
+		}
+		const math::AABB<int>& aabb = chunkBuffer->aabb();
+		const glm::vec3 mins(aabb.mins());
+		const glm::vec3 maxs((float)aabb.maxs().x, (float)(aabb.mins().y + chunkBuffer->occluderHeight), (float)aabb.maxs().z);
+		// the back faces of the chunk would get culled if the camera is inside of the solid slab
+		if (glm::all(glm::greaterThanEqual(cameraPos, mins)) && glm::all(glm::lessThanEqual(cameraPos, maxs))) {
+			continue;
+		}
+		occluders[occluderCount++] = chunkBuffer;
+	}
+	const int n = core_min(occluderCount, MAX_OCCLUDERS);
+	const glm::ivec3 cameraGridPos(cameraPos);
+	std::partial_sort(occluders, occluders + n, occluders + occluderCount, [&] (const ChunkBuffer* lhs, const ChunkBuffer* rhs) {
+		return distance2(lhs->aabb().getCenter(), cameraGridPos) < distance2(rhs->aabb().getCenter(), cameraGridPos);
+	});
+
+	_occlusionBuffer.clear(camera.viewProjectionMatrix());
+	for (int i = 0; i < n; ++i) {
+		const math::AABB<int>& aabb = occluders[i]->aabb();
+		const glm::vec3 maxs((float)aabb.maxs().x, (float)(aabb.mins().y + occluders[i]->occluderHeight), (float)aabb.maxs().z);
+		_occlusionBuffer.rasterizeBox(glm::vec3(aabb.mins()), maxs);
+	}
+	_occlusionBuffer.buildHierarchy();
+
+	for (int i = 0; i < _visibleBuffers.size; ++i) {
+		ChunkBuffer* chunkBuffer = _visibleBuffers.visible[i];
+		const math::AABB<int>& aabb = chunkBuffer->aabb();
+		// the aabb covers the full chunk height - only test the part that contains the mesh
+		const glm::vec3 maxs((float)aabb.maxs().x, (float)(aabb.mins().y + chunkBuffer->maxHeight), (float)aabb.maxs().z);
+		if (!_occlusionBuffer.isVisible(glm::vec3(aabb.mins()), maxs)) {
+			chunkBuffer->occluded = true;
+			++_occludedChunks;
+		}
+	}
 }
 
 int WorldChunkMgr::distance2(const glm::ivec3& pos, const glm::ivec3& pos2) const {
@@ -170,6 +281,41 @@ int WorldChunkMgr::distance2(const glm::ivec3& pos, const glm::ivec3& pos2) cons
 	return distance;
 }
 
+int WorldChunkMgr::chunkDistance(const glm::ivec3& pos) const {
+	const glm::ivec3 center = pos + _meshExtractor.meshSize() / 2;
+	return (int)glm::sqrt((float)distance2(center, _focusPos));
+}
+
+int WorldChunkMgr::lod(int distance) const {
+	const int lodDistance = _lodDistance->intVal();
+	if (lodDistance <= 0) {
+		return 0;
+	}
+	// each level of detail covers twice the distance of the previous one
+	int level = 0;
+	for (int d = lodDistance; distance >= d && level < WorldMeshExtractor::MaxLod; d *= 2) {
+		++level;
+	}
+	return level;
+}
+
+void WorldChunkMgr::updateLod(ChunkBuffer& chunkBuffer) {
+	if (chunkBuffer.pendingLod != -1) {
+		return;
+	}
+	const glm::ivec3& pos = chunkBuffer.aabb().mins();
+	const int distance = chunkDistance(pos);
+	// don't switch back and forth if the focus is moving around the lod threshold
+	const int margin = _meshExtractor.meshSize().x / 2;
+	if (chunkBuffer.lod >= lod(distance - margin) && chunkBuffer.lod <= lod(distance + margin)) {
+		return;
+	}
+	// the current mesh is rendered until the new one is extracted
+	chunkBuffer.pendingLod = lod(distance);
+	_meshExtractor.allowReExtraction(pos);
+	_meshExtractor.scheduleMeshExtraction(pos, chunkBuffer.pendingLod);
+}
+
 void WorldChunkMgr::extractMeshes(const video::Camera& camera) {
 	core_trace_scoped(WorldRendererExtractMeshes);
 
@@ -186,31 +332,40 @@ void WorldChunkMgr::extractMeshes(const video::Camera& camera) {
 	maxs.z += farplane;
 
 	_octree.visit(mins, maxs, [&] (const glm::ivec3& mins, const glm::ivec3& maxs) {
-		return !_meshExtractor.scheduleMeshExtraction(mins);
+		return !_meshExtractor.scheduleMeshExtraction(mins, lod(chunkDistance(mins)));
 	}, glm::vec3(_meshExtractor.meshSize()));
 }
 
 void WorldChunkMgr::extractMesh(const glm::ivec3& pos) {
-	_meshExtractor.scheduleMeshExtraction(pos);
+	_meshExtractor.scheduleMeshExtraction(pos, lod(chunkDistance(_meshExtractor.meshPos(pos))));
 }
 
-int WorldChunkMgr::renderTerrain() {
+int WorldChunkMgr::renderTerrain(bool occlusionCulling) {
 	video_trace_scoped(WorldChunkMgrRenderTerrain);
 	int drawCalls = 0;
 
 	for (int i = 0; i < _visibleBuffers.size; ++i) {
 		ChunkBuffer& chunkBuffer = *_visibleBuffers.visible[i];
 		core_assert(chunkBuffer.inuse);
+		if (occlusionCulling && chunkBuffer.occluded) {
+			continue;
+		}
 		const video::Buffer& buffer = chunkBuffer._buffer;
 		const int ibo = chunkBuffer._ibo;
 		const uint32_t numIndices = buffer.elements(ibo, 1, chunkBuffer._compressedIndexSize);
 		core_assert_msg(numIndices > 0u, "Empty meshes should not be part of the array");
 		video::ScopedBuffer scopedBuf(buffer);
+		// the packed vertices are relative to the chunk position
+		const glm::mat4& translation = chunkBuffer.packed ? glm::translate(glm::vec3(chunkBuffer.aabb().mins())) : glm::mat4(1.0f);
 		if (_worldShader->isActive()) {
 			const double delta = glm::clamp(core_max(0.0, chunkBuffer.scaleSeconds) / ScaleDuration, 0.0, 1.0);
 			const glm::vec3& size = glm::mix(glm::vec3(1.0f), glm::vec3(1.0f, 0.4f, 1.0f), (float)delta);
-			const glm::mat4& model = glm::scale(size);
+			const glm::mat4& model = glm::scale(size) * translation;
 			_worldShader->setModel(model);
+			_worldShader->setPacked(chunkBuffer.packed ? 1 : 0);
+		} else if (_shadowMapShader->isActive()) {
+			_shadowMapShader->setModel(translation);
+			_shadowMapShader->setPacked(chunkBuffer.packed ? 1 : 0);
 		}
 		video::drawElements(video::Primitive::Triangles, numIndices, chunkBuffer._compressedIndexSize);
 		++drawCalls;
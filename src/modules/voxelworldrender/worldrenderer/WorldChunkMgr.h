@@ -6,6 +6,7 @@
 
 #include "math/Octree.h"
 #include "WorldMeshExtractor.h"
+#include "OcclusionBuffer.h"
 #include "video/Camera.h"
 #include "voxel/VoxelVertex.h"
 #include "voxel/Mesh.h"
@@ -13,6 +14,7 @@
 
 namespace shader {
 class WorldShader;
+class WorldShadowmapShader;
 }
 
 namespace voxelworldrender {
@@ -22,6 +24,18 @@ protected:
 	struct ChunkBuffer {
 		bool inuse = false;
 		double scaleSeconds = 0.0;
+		// the level of detail of the current mesh
+		int lod = 0;
+		// the level of detail of a scheduled re-extraction or -1 if there is none
+		int pendingLod = -1;
+		// the vertices are uploaded in the packed format relative to the chunk position
+		bool packed = false;
+		// the height of the solid slab at the bottom of the chunk that is used as occluder
+		int occluderHeight = 0;
+		// the height of the highest vertex - the upper bound of the chunk when it's tested against the occluders
+		int maxHeight = 0;
+		// hidden behind other chunks for the current camera - only valid for the visible buffers
+		bool occluded = false;
 		math::AABB<int> _aabb = {glm::ivec3(0), glm::ivec3(0)};
 		size_t _compressedIndexSize = 0;
 
@@ -38,6 +52,12 @@ protected:
 			_vbo = -1;
 			_ibo = -1;
 			inuse = false;
+			lod = 0;
+			pendingLod = -1;
+			packed = false;
+			occluderHeight = 0;
+			maxHeight = 0;
+			occluded = false;
 		}
 
 		/**
@@ -55,6 +75,8 @@ protected:
 	static constexpr int MAX_CHUNKBUFFERS = 2048;
 	ChunkBuffer _chunkBuffers[MAX_CHUNKBUFFERS];
 	int _maxAllowedDistance = -1;
+	glm::ivec3 _focusPos { 0 };
+	core::VarPtr _lodDistance;
 
 	struct VisibleBuffers {
 		int size = 0;
@@ -62,19 +84,57 @@ protected:
 	};
 	VisibleBuffers _visibleBuffers;
 
+	/**
+	 * @brief The amount of the closest visible chunks that are rasterized into the occlusion buffer
+	 */
+	static constexpr int MAX_OCCLUDERS = 32;
+	OcclusionBuffer _occlusionBuffer;
+	core::VarPtr _occlusionCulling;
+	int _occludedChunks = 0;
+
 	shader::WorldShader* _worldShader;
+	shader::WorldShadowmapShader* _shadowMapShader;
 
 	WorldMeshExtractor _meshExtractor;
 	core::ThreadPool &_threadPool;
 
 	int distance2(const glm::ivec3 &pos, const glm::ivec3 &pos2) const;
+	/**
+	 * @return The distance of the center of the given mesh chunk to the focus position
+	 */
+	int chunkDistance(const glm::ivec3 &pos) const;
+	/**
+	 * @brief The level of detail for a mesh chunk in the given distance
+	 * @sa cfg::VoxelLodDistance
+	 */
+	int lod(int distance) const;
+	void updateLod(ChunkBuffer &chunkBuffer);
 
 	void cull(const video::Camera &camera);
+	/**
+	 * @brief Marks the visible chunks that are hidden behind the solid parts of the closest chunks
+	 * @sa cfg::VoxelOcclusionCulling
+	 */
+	void occlusionCull(const video::Camera &camera);
 	void handleMeshQueue();
 public:
 	WorldChunkMgr(core::ThreadPool& threadPool);
 
-	int renderTerrain();
+	/**
+	 * @param occlusionCulling Skip the chunks that are hidden for the camera that was given to @c update().
+	 * This is only valid for passes that are rendered from the same camera - not for e.g. the shadow map or
+	 * reflections.
+	 */
+	int renderTerrain(bool occlusionCulling = false);
+
+	/**
+	 * @return The amount of chunks that passed the frustum culling
+	 */
+	int visibleChunks() const;
+	/**
+	 * @return The amount of visible chunks that are hidden behind other chunks
+	 */
+	int occludedChunks() const;
 
 	void extractMesh(const glm::ivec3 &pos);
 	void extractMeshes(const video::Camera &camera);
@@ -83,9 +143,17 @@ public:
 	void update(double deltaFrameSeconds, const video::Camera &camera, const glm::vec3& focusPos);
 
 	void updateViewDistance(float viewDistance);
-	bool init(shader::WorldShader* worldShader, voxel::PagedVolume* volume);
+	bool init(shader::WorldShader* worldShader, shader::WorldShadowmapShader* shadowMapShader, voxel::PagedVolume* volume);
 	void shutdown();
 	void reset();
 };
 
+inline int WorldChunkMgr::visibleChunks() const {
+	return _visibleBuffers.size;
+}
+
+inline int WorldChunkMgr::occludedChunks() const {
+	return _occludedChunks;
+}
+
 }
@@ -0,0 +1,236 @@
+/**
+ * @file
+ */
+
+#include "WorldMeshCache.h"
+#include "WorldMeshExtractor.h"
+#include "app/App.h"
+#include "core/FourCC.h"
+#include "core/Log.h"
+#include "core/StandardLib.h"
+#include "core/StringUtil.h"
+#include "core/Trace.h"
+#include "io/File.h"
+#include "io/Filesystem.h"
+#include <SDL_stdinc.h>
+#include <algorithm>
+#include <vector>
+
+namespace voxelworldrender {
+
+namespace {
+constexpr uint32_t CacheMagic = FourCC('V', 'W', 'M', 'C');
+constexpr uint32_t CacheVersion = 3u;
+}
+
+bool WorldMeshCache::init(const core::String &directory, uint64_t maxSize) {
+	const io::FilesystemPtr &fs = io::filesystem();
+	_directory = fs->writePath(directory.c_str());
+	if (!fs->createDir(_directory)) {
+		Log::warn("Failed to create the mesh cache directory %s", _directory.c_str());
+		_directory = "";
+		return false;
+	}
+	core::DynamicArray<io::FilesystemEntry> files;
+	fs->list(_directory, files, "*.vmc");
+	// the least recently written files are evicted first
+	std::sort(files.data(), files.data() + files.size(), [] (const io::FilesystemEntry &lhs, const io::FilesystemEntry &rhs) {
+		return lhs.mtime < rhs.mtime;
+	});
+	core::ScopedLock lock(_lock);
+	_maxSize = maxSize;
+	_entries.clear();
+	_size = 0u;
+	_useCounter = 0u;
+	for (const io::FilesystemEntry &entry : files) {
+		if (entry.type != io::FilesystemEntry::Type::file) {
+			continue;
+		}
+		const uint64_t key = SDL_strtoull(entry.name.c_str(), nullptr, 16);
+		_entries[key] = Entry{entry.size, ++_useCounter};
+		_size += entry.size;
+	}
+	evict();
+	Log::debug("Use mesh cache directory %s with %i entries (%i kb)", _directory.c_str(), (int)_entries.size(), (int)(_size / 1024u));
+	return true;
+}
+
+void WorldMeshCache::shutdown() {
+	core::ScopedLock lock(_lock);
+	_directory = "";
+	_entries.clear();
+	_size = 0u;
+}
+
+void WorldMeshCache::evict() {
+	if (_maxSize == 0u || _size <= _maxSize) {
+		return;
+	}
+	core_trace_scoped(WorldMeshCacheEvict);
+	std::vector<std::pair<uint64_t, uint64_t>> uses;
+	uses.reserve(_entries.size());
+	for (const auto &e : _entries) {
+		uses.emplace_back(e.second.lastUse, e.first);
+	}
+	std::sort(uses.begin(), uses.end());
+	const uint64_t targetSize = _maxSize / 4u * 3u;
+	const io::FilesystemPtr &fs = io::filesystem();
+	for (const auto &use : uses) {
+		if (_size <= targetSize) {
+			break;
+		}
+		auto i = _entries.find(use.second);
+		if (!fs->removeFile(path(use.second))) {
+			Log::debug("Failed to remove mesh cache entry %s", path(use.second).c_str());
+		}
+		_size -= i->second.size;
+		_entries.erase(i);
+	}
+}
+
+core::String WorldMeshCache::path(uint64_t key) const {
+	return core::string::path(_directory, core::string::format("%08x%08x.vmc", (uint32_t)(key >> 32), (uint32_t)key));
+}
+
+bool WorldMeshCache::load(uint64_t key, ExtractedMesh &extracted) {
+	if (_directory.empty()) {
+		return false;
+	}
+	core_trace_scoped(WorldMeshCacheLoad);
+	const io::FilePtr &file = io::filesystem()->open(path(key), io::FileMode::SysRead);
+	if (!file->exists()) {
+		return false;
+	}
+	const long length = file->length();
+	if (length < (long)sizeof(Header)) {
+		return false;
+	}
+	uint8_t *buf = (uint8_t *)core_malloc(length);
+	if (file->read(buf, (int)length) != (int)length) {
+		core_free(buf);
+		return false;
+	}
+	Header header;
+	core_memcpy(&header, buf, sizeof(header));
+	const size_t vertexBytes = (size_t)header.vertices * sizeof(voxel::VoxelVertex);
+	const size_t packedBytes = (size_t)header.packedVertices * sizeof(voxel::PackedVoxelVertex);
+	const size_t indexBytes = (size_t)header.indices * sizeof(voxel::IndexType);
+	if (header.magic != CacheMagic || header.version != CacheVersion || header.key != key ||
+		sizeof(Header) + vertexBytes + packedBytes + indexBytes != (size_t)length) {
+		Log::debug("Invalid mesh cache entry %s", file->name().c_str());
+		core_free(buf);
+		return false;
+	}
+
+	const uint8_t *data = buf + sizeof(Header);
+	voxel::Mesh &mesh = extracted.mesh;
+	mesh.clear();
+	mesh.setOffset(glm::ivec3(header.offset[0], header.offset[1], header.offset[2]));
+	voxel::VertexArray &vertices = mesh.getVertexVector();
+	vertices.resize(header.vertices);
+	if (vertexBytes > 0u) {
+		core_memcpy(vertices.data(), data, vertexBytes);
+	}
+	data += vertexBytes;
+	extracted.packedVertices.resize(header.packedVertices);
+	if (packedBytes > 0u) {
+		core_memcpy(extracted.packedVertices.data(), data, packedBytes);
+	}
+	data += packedBytes;
+	voxel::IndexArray &indices = mesh.getIndexVector();
+	indices.resize(header.indices);
+	if (indexBytes > 0u) {
+		core_memcpy(indices.data(), data, indexBytes);
+	}
+	mesh.compressIndices();
+	extracted.lod = header.lod;
+	extracted.occluderHeight = header.occluderHeight;
+	extracted.maxHeight = header.maxHeight;
+	core_free(buf);
+	core::ScopedLock lock(_lock);
+	auto i = _entries.find(key);
+	if (i != _entries.end()) {
+		i->second.lastUse = ++_useCounter;
+	}
+	return true;
+}
+
+bool WorldMeshCache::save(uint64_t key, const ExtractedMesh &extracted) {
+	if (_directory.empty()) {
+		return false;
+	}
+	core_trace_scoped(WorldMeshCacheSave);
+	const voxel::Mesh &mesh = extracted.mesh;
+	const glm::ivec3 &offset = mesh.getOffset();
+	Header header;
+	header.magic = CacheMagic;
+	header.version = CacheVersion;
+	header.key = key;
+	header.offset[0] = offset.x;
+	header.offset[1] = offset.y;
+	header.offset[2] = offset.z;
+	header.lod = extracted.lod;
+	header.occluderHeight = extracted.occluderHeight;
+	header.maxHeight = extracted.maxHeight;
+	header.padding = 0u;
+	header.vertices = (uint32_t)mesh.getNoOfVertices();
+	header.packedVertices = (uint32_t)extracted.packedVertices.size();
+	header.indices = (uint32_t)mesh.getNoOfIndices();
+
+	const size_t vertexBytes = (size_t)header.vertices * sizeof(voxel::VoxelVertex);
+	const size_t packedBytes = (size_t)header.packedVertices * sizeof(voxel::PackedVoxelVertex);
+	const size_t indexBytes = (size_t)header.indices * sizeof(voxel::IndexType);
+	const size_t length = sizeof(Header) + vertexBytes + packedBytes + indexBytes;
+	uint8_t *buf = (uint8_t *)core_malloc(length);
+	uint8_t *data = buf;
+	core_memcpy(data, &header, sizeof(header));
+	data += sizeof(header);
+	if (vertexBytes > 0u) {
+		core_memcpy(data, mesh.getRawVertexData(), vertexBytes);
+	}
+	data += vertexBytes;
+	if (packedBytes > 0u) {
+		core_memcpy(data, extracted.packedVertices.data(), packedBytes);
+	}
+	data += packedBytes;
+	if (indexBytes > 0u) {
+		core_memcpy(data, mesh.getRawIndexData(), indexBytes);
+	}
+	const bool success = io::filesystem()->syswrite(path(key), buf, length);
+	core_free(buf);
+	if (!success) {
+		Log::debug("Failed to write mesh cache entry for key %08x%08x", (uint32_t)(key >> 32), (uint32_t)key);
+		return false;
+	}
+	core::ScopedLock lock(_lock);
+	Entry &entry = _entries[key];
+	_size = _size - entry.size + length;
+	entry.size = length;
+	entry.lastUse = ++_useCounter;
+	evict();
+	return true;
+}
+
+bool WorldMeshCache::clear() {
+	if (_directory.empty()) {
+		return false;
+	}
+	core::ScopedLock lock(_lock);
+	_entries.clear();
+	_size = 0u;
+	const io::FilesystemPtr &fs = io::filesystem();
+	core::DynamicArray<io::FilesystemEntry> entities;
+	fs->list(_directory, entities, "*.vmc");
+	bool success = true;
+	for (const io::FilesystemEntry &entry : entities) {
+		if (entry.type != io::FilesystemEntry::Type::file) {
+			continue;
+		}
+		if (!fs->removeFile(core::string::path(_directory, entry.name))) {
+			success = false;
+		}
+	}
+	return success;
+}
+
+}
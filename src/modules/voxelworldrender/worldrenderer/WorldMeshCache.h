@@ -0,0 +1,150 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "core/Trace.h"
+#include "core/concurrent/Lock.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include <stdint.h>
+#include <unordered_map>
+
+namespace voxelworldrender {
+
+struct ExtractedMesh;
+
+/**
+ * @brief Persistent cache for the extracted world chunk meshes
+ *
+ * The meshes are stored in one file per chunk in the home path of the application. The file name is a hash of
+ * the voxels of the chunk and the extraction settings - a chunk that wasn't modified since the last extraction
+ * is loaded from the cache instead of being extracted again.
+ *
+ * Each file is a fixed size header followed by the raw vertex, packed vertex and index arrays in native byte
+ * order - so the arrays can be used directly from a memory mapped file.
+ *
+ * The size of all files is limited by a budget - if a new entry exceeds it, the least recently used entries are
+ * removed. The files that are already in the cache directory are ordered by their modification time on
+ * initialization.
+ *
+ * @note The cache is threadsafe as long as the same key isn't written by several threads at the same time
+ * @sa WorldMeshExtractor
+ */
+class WorldMeshCache {
+public:
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint64_t key;
+		int32_t offset[3];
+		int32_t lod;
+		int32_t occluderHeight;
+		int32_t maxHeight;
+		uint32_t padding;
+		uint32_t vertices;
+		uint32_t packedVertices;
+		uint32_t indices;
+	};
+	static_assert(sizeof(Header) % 8 == 0, "The arrays after the header should be aligned");
+
+private:
+	struct Entry {
+		uint64_t size;
+		uint64_t lastUse;
+	};
+	core::String _directory;
+	core_trace_mutex(core::Lock, _lock, "WorldMeshCache");
+	std::unordered_map<uint64_t, Entry> _entries;
+	uint64_t _maxSize = 0u;
+	uint64_t _size = 0u;
+	uint64_t _useCounter = 0u;
+
+	core::String path(uint64_t key) const;
+	/**
+	 * @brief Removes the least recently used entries until the cache is at three quarters of its budget - so not
+	 * every new entry triggers an eviction.
+	 * @note The lock must be held
+	 */
+	void evict();
+
+public:
+	/**
+	 * @param[in] directory The cache directory relative to the home path of the application
+	 * @param[in] maxSize The budget for all cache files in bytes - @c 0 disables the limit
+	 */
+	bool init(const core::String &directory = "meshcache", uint64_t maxSize = 0u);
+	void shutdown();
+
+	/**
+	 * @brief Hashes the voxels of the given region and the neighbours that are taken into account by the
+	 * surface extractors.
+	 * @param[in] settings The extraction settings that have an influence on the mesh
+	 */
+	template<class Volume>
+	static uint64_t key(const Volume &volume, const voxel::Region &region, int lod, uint32_t settings);
+
+	/**
+	 * @return @c false if there is no valid cache entry for the given key
+	 */
+	bool load(uint64_t key, ExtractedMesh &extracted);
+	bool save(uint64_t key, const ExtractedMesh &extracted);
+	/**
+	 * @brief Removes all cached meshes
+	 */
+	bool clear();
+
+	/**
+	 * @return The size of all cache files in bytes
+	 */
+	uint64_t size() const;
+	/**
+	 * @return The amount of cached meshes
+	 */
+	size_t entries() const;
+};
+
+inline uint64_t WorldMeshCache::size() const {
+	return _size;
+}
+
+inline size_t WorldMeshCache::entries() const {
+	return _entries.size();
+}
+
+template<class Volume>
+uint64_t WorldMeshCache::key(const Volume &volume, const voxel::Region &region, int lod, uint32_t settings) {
+	// FNV-1a - applied to the 16 bit voxel values
+	constexpr uint64_t prime = 1099511628211ull;
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash] (uint32_t value) {
+		hash = (hash ^ value) * prime;
+	};
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	mix((uint32_t)mins.x);
+	mix((uint32_t)mins.y);
+	mix((uint32_t)mins.z);
+	mix((uint32_t)maxs.x);
+	mix((uint32_t)maxs.y);
+	mix((uint32_t)maxs.z);
+	mix((uint32_t)lod);
+	mix(settings);
+
+	typename Volume::Sampler sampler(volume);
+	for (int32_t z = mins.z - 1; z <= maxs.z + 1; ++z) {
+		for (int32_t x = mins.x - 1; x <= maxs.x + 1; ++x) {
+			sampler.setPosition(x, mins.y - 1, z);
+			for (int32_t y = mins.y - 1; y <= maxs.y + 1; ++y) {
+				const voxel::Voxel &voxel = sampler.voxel();
+				mix((uint32_t)voxel.getMaterial() | ((uint32_t)voxel.getColor() << 8) | ((uint32_t)voxel.getFlags() << 16));
+				sampler.movePositiveY();
+			}
+		}
+	}
+	return hash;
+}
+
+}
@@ -6,7 +6,10 @@
 #include "core/concurrent/Concurrency.h"
 #include "voxel/CubicSurfaceExtractor.h"
 #include "voxel/IsQuadNeeded.h"
+#include "voxel/BinaryCubicSurfaceExtractor.h"
 #include "voxel/Constants.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/VolumeRescaler.h"
 
 namespace voxelworldrender {
 
@@ -16,6 +19,14 @@ WorldMeshExtractor::WorldMeshExtractor() {
 bool WorldMeshExtractor::init(voxel::PagedVolume *volume) {
 	_volume = volume;
 	_meshSize = core::Var::getSafe(cfg::VoxelMeshSize);
+	_binaryMesher = core::Var::getSafe(cfg::VoxelBinaryMesher);
+	_packedVertices = core::Var::getSafe(cfg::VoxelPackedVertices);
+	_meshCache = core::Var::getSafe(cfg::VoxelMeshCache);
+	_meshCacheSize = core::Var::getSafe(cfg::VoxelMeshCacheSize);
+	const uint64_t maxCacheSize = (uint64_t)core_max(1, _meshCacheSize->intVal()) * 1024u * 1024u;
+	if (_meshCache->boolVal() && !_cache.init("meshcache", maxCacheSize)) {
+		Log::warn("Failed to initialize the mesh cache");
+	}
 	return true;
 }
 
@@ -26,6 +37,7 @@ void WorldMeshExtractor::shutdown() {
 	_extracted.abortWait();
 	_positionsExtracted.clear();
 	_extracted.clear();
+	_cache.shutdown();
 	_volume = nullptr;
 }
 
@@ -38,7 +50,7 @@ void WorldMeshExtractor::reset() {
 	_pendingExtraction.clear();
 }
 
-bool WorldMeshExtractor::pop(voxel::Mesh& item) {
+bool WorldMeshExtractor::pop(ExtractedMesh& item) {
 	core_trace_value_scoped(QueryNewMesh, _positionsExtracted.size());
 	return _extracted.pop(item);
 }
@@ -72,27 +84,74 @@ bool WorldMeshExtractor::allowReExtraction(const glm::ivec3& pos) {
 	return _positionsExtracted.erase(gridPos) != 0;
 }
 
+bool WorldMeshExtractor::isExtracted(const glm::ivec3& pos) const {
+	const glm::ivec3& gridPos = meshPos(pos);
+	return _positionsExtracted.find(gridPos) != _positionsExtracted.end();
+}
+
 // Extract the surface for the specified region of the volume.
 // The surface extractor outputs the mesh in an efficient compressed format which
 // is not directly suitable for rendering.
-bool WorldMeshExtractor::scheduleMeshExtraction(const glm::ivec3& p) {
+bool WorldMeshExtractor::scheduleMeshExtraction(const glm::ivec3& p, int lod) {
 	const glm::ivec3& pos = meshPos(p);
 	auto i = _positionsExtracted.insert(pos);
 	if (!i.second) {
 		return false;
 	}
-	Log::trace("mesh extraction for %i:%i:%i (%i:%i:%i)",
-			p.x, p.y, p.z, pos.x, pos.y, pos.z);
-	_pendingExtraction.push(pos);
+	Log::trace("mesh extraction for %i:%i:%i (%i:%i:%i) with lod %i",
+			p.x, p.y, p.z, pos.x, pos.y, pos.z, lod);
+	// page in the chunks in the background - the extraction only has to wait if they are not yet ready
+	const glm::ivec3& size = meshSize();
+	const voxel::Region region(pos, pos + size - 1);
+	const int priority = -CloseToPoint(_pendingExtractionSortPosition).distanceToSortPos(pos);
+	_volume->prefetchRegion(region, priority);
+	_pendingExtraction.push(glm::ivec4(pos, glm::clamp(lod, 0, MaxLod)));
 	return true;
 }
 
+template<class Volume>
+void WorldMeshExtractor::extractMesh(Volume* volume, const voxel::Region& region, voxel::Mesh* mesh, const glm::ivec3& translate) const {
+	if (_binaryMesher->boolVal()) {
+		voxel::extractBinaryCubicMesh(volume, region, mesh, translate);
+	} else {
+		voxel::extractCubicMesh(volume, region, mesh, voxel::IsQuadNeeded(), translate);
+	}
+}
+
+template<class Volume>
+int WorldMeshExtractor::occluderHeight(const Volume& volume, const voxel::Region& region) const {
+	int height = region.getHeightInVoxels();
+	typename Volume::Sampler sampler(volume);
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+			sampler.setPosition(x, region.getLowerY(), z);
+			// only the smallest column height is needed - so stop at the current minimum
+			int columnHeight = 0;
+			while (columnHeight < height) {
+				const voxel::VoxelType material = sampler.voxel().getMaterial();
+				if (!voxel::isBlocked(material) || voxel::isTransparent(material)) {
+					break;
+				}
+				++columnHeight;
+				sampler.movePositiveY();
+			}
+			height = columnHeight;
+			if (height == 0) {
+				return 0;
+			}
+		}
+	}
+	return height;
+}
+
 void WorldMeshExtractor::extractScheduledMesh() {
-	decltype(_pendingExtraction)::Key pos;
-	if (!_pendingExtraction.waitAndPop(pos)) {
+	decltype(_pendingExtraction)::Key key;
+	if (!_pendingExtraction.waitAndPop(key)) {
 		return;
 	}
 	core_trace_scoped(MeshExtraction);
+	const glm::ivec3 pos(key);
+	const int lod = key.w;
 	const glm::ivec3& size = meshSize();
 	const glm::ivec3 mins(pos);
 	const glm::ivec3 maxs(pos.x + size.x - 1, pos.y + size.y - 2, pos.z + size.z - 1);
@@ -100,12 +159,62 @@ void WorldMeshExtractor::extractScheduledMesh() {
 	// these numbers are made up mostly by try-and-error - we need to revisit them from time to time to prevent extra mem allocs
 	// they also heavily depend on the size of the mesh region we extract
 	const int factor = 64;
-	const int vertices = region.getWidthInVoxels() * region.getDepthInVoxels() * factor;
-	voxel::Mesh mesh(vertices, vertices);
-	voxel::extractCubicMesh(_volume, region, &mesh, voxel::IsQuadNeeded(), region.getLowerCorner());
-	if (!mesh.isEmpty()) {
-		_extracted.push(std::move(mesh));
+	const int lodFactor = 1 << lod;
+	const int vertices = region.getWidthInVoxels() * region.getDepthInVoxels() * factor / (lodFactor * lodFactor);
+	ExtractedMesh extracted;
+	// the settings that have an influence on the extracted mesh
+	const uint32_t settings = (_binaryMesher->boolVal() ? 1u : 0u) | (_packedVertices->boolVal() ? 2u : 0u);
+	const bool useCache = _meshCache->boolVal();
+	uint64_t cacheKey = 0u;
+	if (useCache) {
+		cacheKey = WorldMeshCache::key(*_volume, region, lod, settings);
+		if (_cache.load(cacheKey, extracted)) {
+			_extracted.push(std::move(extracted));
+			return;
+		}
+	}
+	extracted.mesh = voxel::Mesh(vertices, vertices);
+	extracted.lod = lod;
+	voxel::Mesh& mesh = extracted.mesh;
+	if (lod == 0) {
+		extractMesh(_volume, region, &mesh, region.getLowerCorner());
+		extracted.occluderHeight = occluderHeight(*_volume, region);
+	} else {
+		const glm::ivec3 lodSize = (region.getDimensionsInVoxels() + lodFactor - 1) / lodFactor;
+		const voxel::Region lodRegion(glm::ivec3(0), lodSize - 1);
+		// the volume is one voxel larger at the upper corner - the extractors only generate the faces
+		// between a voxel and its lower neighbour, so the empty layer is needed for the +x, +y and +z faces
+		voxel::RawVolume lodVolume(voxel::Region(glm::ivec3(0), lodSize));
+		voxelutil::downsampleVolume(*_volume, region, lodVolume, lodRegion, lodFactor);
+		// the faces at all borders of the downsampled volume are generated - they hide the cracks to the
+		// neighbours with a different level of detail
+		extractMesh(&lodVolume, lodVolume.region(), &mesh, glm::ivec3(0));
+		// the occluder must match the rendered (downsampled) surface
+		extracted.occluderHeight = core_min(occluderHeight(lodVolume, lodRegion) * lodFactor, region.getHeightInVoxels());
+		for (voxel::VoxelVertex& vertex : mesh.getVertexVector()) {
+			vertex.position.x = (int16_t)(vertex.position.x * lodFactor + mins.x);
+			vertex.position.y = (int16_t)(vertex.position.y * lodFactor + mins.y);
+			vertex.position.z = (int16_t)(vertex.position.z * lodFactor + mins.z);
+		}
+		mesh.setOffset(mins);
 	}
+	for (const voxel::VoxelVertex& vertex : mesh.getVertexVector()) {
+		extracted.maxHeight = core_max(extracted.maxHeight, (int)vertex.position.y - mins.y);
+	}
+	// empty meshes are handed over, too - they replace the mesh of a previous level of detail
+	if (!mesh.isEmpty() && _packedVertices->boolVal()) {
+		if (voxel::packVertices(mesh, extracted.packedVertices)) {
+			// only the packed vertices are uploaded
+			mesh.getVertexVector().release();
+		} else {
+			Log::debug("Mesh at %i:%i:%i exceeds the packed vertex limits", mins.x, mins.y, mins.z);
+			extracted.packedVertices.release();
+		}
+	}
+	if (useCache) {
+		_cache.save(cacheKey, extracted);
+	}
+	_extracted.push(std::move(extracted));
 }
 
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "voxel/Mesh.h"
+#include "WorldMeshCache.h"
 #include "core/concurrent/ThreadPool.h"
 #include "core/Var.h"
 #include "core/collection/ConcurrentPriorityQueue.h"
@@ -20,9 +21,44 @@ namespace voxelworldrender {
 
 typedef std::unordered_set<glm::ivec3, std::hash<glm::ivec3> > PositionSet;
 
+struct ExtractedMesh {
+	voxel::Mesh mesh;
+	/**
+	 * @brief The level of detail the mesh was extracted with. @c 0 is the full resolution, each
+	 * level halves the resolution.
+	 */
+	int lod = 0;
+	/**
+	 * @brief The vertices in the packed format relative to the mesh offset - empty if the mesh should be
+	 * uploaded with the vertices of the mesh
+	 * @sa cfg::VoxelPackedVertices
+	 */
+	voxel::PackedVertexArray packedVertices;
+	/**
+	 * @brief The height of the solid slab at the bottom of the chunk - every column of the chunk is opaque up
+	 * to this height. This is used as occluder for the occlusion culling.
+	 */
+	int occluderHeight = 0;
+	/**
+	 * @brief The height of the highest vertex relative to the chunk position. The mesh chunks cover the full
+	 * chunk height - but most of them only reach a fraction of it. This is used as the bounds of the occludee for
+	 * the occlusion culling.
+	 */
+	int maxHeight = 0;
+
+	inline bool operator<(const ExtractedMesh& rhs) const {
+		return mesh < rhs.mesh;
+	}
+};
+
 class WorldMeshExtractor {
+public:
+	/**
+	 * @brief The lowest level of detail - this is an eighth of the resolution
+	 */
+	static constexpr int MaxLod = 3;
 private:
-	core::ConcurrentPriorityQueue<voxel::Mesh> _extracted;
+	core::ConcurrentPriorityQueue<ExtractedMesh> _extracted;
 	glm::ivec3 _pendingExtractionSortPosition { 0, 0, 0 };
 	struct CloseToPoint {
 		glm::ivec2 _refPoint;
@@ -32,17 +68,31 @@ private:
 			const glm::ivec2 d(_refPoint.x - pos.x, _refPoint.y - pos.z);
 			return d.x * d.x + d.y * d.y;
 		}
-		inline bool operator()(const glm::ivec3& lhs, const glm::ivec3& rhs) const {
+		// the w component is the level of detail
+		inline bool operator()(const glm::ivec4& lhs, const glm::ivec4& rhs) const {
 			return distanceToSortPos(lhs) > distanceToSortPos(rhs);
 		}
 	};
 
-	core::ConcurrentPriorityQueue<glm::ivec3, CloseToPoint> _pendingExtraction { CloseToPoint(_pendingExtractionSortPosition) };
+	core::ConcurrentPriorityQueue<glm::ivec4, CloseToPoint> _pendingExtraction { CloseToPoint(_pendingExtractionSortPosition) };
 	// fast lookup for positions that are already extracted
 	PositionSet _positionsExtracted;
 	core::VarPtr _meshSize;
+	core::VarPtr _binaryMesher;
+	core::VarPtr _packedVertices;
+	core::VarPtr _meshCache;
+	core::VarPtr _meshCacheSize;
+	WorldMeshCache _cache;
 	voxel::PagedVolume *_volume = nullptr;
 
+	template<class Volume>
+	void extractMesh(Volume* volume, const voxel::Region& region, voxel::Mesh* mesh, const glm::ivec3& translate) const;
+	/**
+	 * @return The amount of voxels from the bottom of the region that are opaque in every column
+	 */
+	template<class Volume>
+	int occluderHeight(const Volume& volume, const voxel::Region& region) const;
+
 public:
 	WorldMeshExtractor();
 
@@ -52,7 +102,7 @@ public:
 	 * @brief We need to pop the mesh extractor queue to find out if there are new and ready to use meshes for us
 	 * @return @c false if this isn't the case, @c true if the given reference was filled with valid data.
 	 */
-	bool pop(voxel::Mesh& item);
+	bool pop(ExtractedMesh& item);
 
 	/**
 	 * @brief If you don't need an extracted mesh anymore, make sure to allow the reextraction at a later time.
@@ -61,6 +111,12 @@ public:
 	 */
 	bool allowReExtraction(const glm::ivec3& pos);
 
+	/**
+	 * @return @c true if the given position was scheduled for extraction and wasn't released by
+	 * @c allowReExtraction() yet.
+	 */
+	bool isExtracted(const glm::ivec3& pos) const;
+
 	/**
 	 * @brief Reorder the scheduled extraction commands that the closest chunks to the given position are handled first
 	 */
@@ -70,9 +126,11 @@ public:
 	 * @brief Performs async mesh extraction. You need to call @c pop in order to see if some extraction is ready.
 	 *
 	 * @param[in] pos A world vector that is automatically converted into a mesh tile vector
+	 * @param[in] lod The level of detail in the range [0,MaxLod]. The volume is downsampled by the
+	 * factor @c 2^lod before the extraction.
 	 * @note This will not allow to reschedule an extraction for the same area until @c allowReExtraction was called.
 	 */
-	bool scheduleMeshExtraction(const glm::ivec3& pos);
+	bool scheduleMeshExtraction(const glm::ivec3& pos, int lod = 0);
 
 	void reset();
 
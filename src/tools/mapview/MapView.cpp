@@ -279,6 +279,9 @@ void MapView::onRenderUI() {
 		const float yaw = camera.horizontalYaw();
 		ImGui::Text("Fps: %f", fps());
 		ImGui::Text("Drawcalls: %i", _drawCallsWorld);
+		const int visibleChunks = _worldRenderer.visibleChunks();
+		const int occludedChunks = _worldRenderer.occludedChunks();
+		ImGui::Text("Chunks: %i drawn, %i occluded", visibleChunks - occludedChunks, occludedChunks);
 		ImGui::Text("Target Pos: %.2f:%.2f:%.2f ", targetpos.x, targetpos.y, targetpos.z);
 		ImGui::Text("Pos: %.2f:%.2f:%.2f, Distance:%.2f", pos.x, pos.y, pos.z, distance);
 		ImGui::Text("Yaw: %.2f Pitch: %.2f Roll: %.2f", yaw, pitch, camera.roll());
@@ -293,6 +296,7 @@ void MapView::onRenderUI() {
 	_worldRenderer.setSeconds(_worldTime);
 
 	ImGui::InputVarFloat("Rotation Speed", _rotationSpeed);
+	ImGui::CheckboxVar("Occlusion culling", cfg::VoxelOcclusionCulling);
 
 	if (ImGui::BeginCombo("Entity", network::EnumNameEntityType(_entityType), ImGuiComboFlags_None)) {
 		for (int i = ((int)network::EntityType::BEGIN_ANIMAL) + 1; i < (int)network::EntityType::MAX_CHARACTERS; ++i) {
@@ -0,0 +1,126 @@
+/**
+ * @file
+ */
+
+#include "BatchConvert.h"
+#include "core/Common.h"
+#include "core/Log.h"
+#include "io/MemoryMappedReadStream.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include "voxelformat/SceneGraph.h"
+#include "voxelformat/SceneGraphNode.h"
+#include "voxelformat/VolumeFormat.h"
+
+namespace voxconvert {
+
+// the formats store at least a byte for each voxel that is set - the volumes also hold the air voxels
+static constexpr uint64_t EstimatedVoxelsPerByte = 4u;
+
+BatchMemoryBudget::BatchMemoryBudget(uint64_t max) : _max(max) {
+}
+
+void BatchMemoryBudget::acquire(uint64_t bytes) {
+	if (_max == 0u) {
+		return;
+	}
+	core::ScopedLock lock(_lock);
+	_condition.wait(_lock, [&]() {
+		// predicate must return false if the waiting should continue
+		return _used == 0u || _used + bytes <= _max;
+	});
+	_used += bytes;
+	_peak = core_max(_peak, _used);
+}
+
+void BatchMemoryBudget::release(uint64_t bytes) {
+	if (_max == 0u) {
+		return;
+	}
+	{
+		core::ScopedLock lock(_lock);
+		_used -= bytes;
+	}
+	_condition.notify_all();
+}
+
+void BatchMemoryBudget::resize(uint64_t from, uint64_t to, bool allocated) {
+	if (_max == 0u) {
+		return;
+	}
+	{
+		core::ScopedLock lock(_lock);
+		if (allocated || to <= from) {
+			_used = _used - from + to;
+		} else {
+			// two growing jobs would wait for each other if they kept their reservations
+			_used -= from;
+			_condition.notify_all();
+			_condition.wait(_lock, [&]() { return _used == 0u || _used + to <= _max; });
+			_used += to;
+		}
+		_peak = core_max(_peak, _used);
+	}
+	_condition.notify_all();
+}
+
+uint64_t BatchMemoryBudget::peak() const {
+	core::ScopedLock lock(_lock);
+	return _peak;
+}
+
+uint64_t estimateVoxelBytes(uint64_t fileSize) {
+	return fileSize * EstimatedVoxelsPerByte * sizeof(voxel::Voxel);
+}
+
+BatchResult convertBatchFile(const io::FilesystemPtr &filesystem, const core::String &input,
+							 const core::String &output, BatchMemoryBudget &budget) {
+	BatchResult result;
+	const io::FilePtr &inputFile = filesystem->open(input, io::FileMode::SysRead);
+	if (!inputFile->exists()) {
+		Log::error("Given input file '%s' does not exist", input.c_str());
+		return result;
+	}
+	// some formats decode the volumes while they are loaded - reserve the memory before anything is decoded
+	uint64_t reserved = estimateVoxelBytes((uint64_t)core_max(0l, inputFile->length()));
+	budget.acquire(reserved);
+	voxelformat::SceneGraph sceneGraph;
+	{
+		io::MemoryMappedReadStream stream(inputFile);
+		if (!voxelformat::loadFormat(inputFile->name(), stream, sceneGraph, true)) {
+			Log::error("Failed to load %s", input.c_str());
+			budget.release(reserved);
+			return result;
+		}
+	}
+	// formats with lazy loaded volumes know the regions before the voxels are decoded
+	bool pending = false;
+	for (const voxelformat::SceneGraphNode &node : sceneGraph) {
+		const voxel::Region &region = node.region();
+		if (region.isValid()) {
+			const glm::ivec3 &dim = region.getDimensionsInVoxels();
+			result.voxels += (uint64_t)dim.x * (uint64_t)dim.y * (uint64_t)dim.z;
+		}
+		pending |= node.hasPendingVolume();
+	}
+	const uint64_t bytes = result.voxels * sizeof(voxel::Voxel);
+	budget.resize(reserved, bytes, !pending);
+	reserved = bytes;
+	if (!voxelformat::loadVolumes(sceneGraph)) {
+		Log::error("Failed to load %s", input.c_str());
+		sceneGraph.clear();
+		budget.release(reserved);
+		return result;
+	}
+	result.success = voxelformat::saveFormat(filesystem->open(output, io::FileMode::SysWrite), sceneGraph);
+	sceneGraph.clear();
+	budget.release(reserved);
+	if (result.success) {
+		Log::info(" .. %s", output.c_str());
+	} else {
+		Log::error("Failed to write to output file '%s'", output.c_str());
+	}
+	return result;
+}
+
+} // namespace voxconvert
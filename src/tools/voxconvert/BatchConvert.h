@@ -0,0 +1,64 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "core/Trace.h"
+#include "core/concurrent/ConditionVariable.h"
+#include "core/concurrent/Lock.h"
+#include "io/Filesystem.h"
+#include <stdint.h>
+
+namespace voxconvert {
+
+/**
+ * @brief Limits the amount of voxel data of the batch jobs that are processed at the same time
+ */
+class BatchMemoryBudget {
+private:
+	mutable core_trace_mutex(core::Lock, _lock, "BatchMemoryBudget");
+	core::ConditionVariable _condition;
+	const uint64_t _max;
+	uint64_t _used = 0u;
+	uint64_t _peak = 0u;
+
+public:
+	BatchMemoryBudget(uint64_t max);
+
+	/**
+	 * @note A job that exceeds the budget on its own is still processed - but only if no other job is running
+	 */
+	void acquire(uint64_t bytes);
+	void release(uint64_t bytes);
+	/**
+	 * @brief Corrects the reservation of a job once the real amount of voxel data is known
+	 * @param allocated @c true if the job already holds the memory - the reservation grows without waiting then.
+	 * Otherwise the job gives up its reservation while it waits for the other jobs.
+	 */
+	void resize(uint64_t from, uint64_t to, bool allocated);
+	/**
+	 * @return The highest amount of bytes that were reserved at the same time
+	 */
+	uint64_t peak() const;
+};
+
+struct BatchResult {
+	bool success = false;
+	uint64_t voxels = 0u;
+};
+
+/**
+ * @brief The amount of voxel data that is reserved for a file before its volumes are known
+ * @note The formats that decode their volumes while loading allocate the voxels before the regions are known
+ */
+uint64_t estimateVoxelBytes(uint64_t fileSize);
+
+/**
+ * @brief Converts a single file of a batch. The voxel data is reserved in the budget before it is decoded.
+ */
+BatchResult convertBatchFile(const io::FilesystemPtr &filesystem, const core::String &input,
+							 const core::String &output, BatchMemoryBudget &budget);
+
+} // namespace voxconvert
@@ -3,6 +3,7 @@
  */
 
 #include "VoxConvert.h"
+#include "BatchConvert.h"
 #include "core/Color.h"
 #include "core/Enum.h"
 #include "core/GameConfig.h"
@@ -11,9 +12,11 @@
 #include "command/Command.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/Set.h"
+#include "core/collection/StringSet.h"
 #include "core/concurrent/Concurrency.h"
+#include "core/concurrent/ThreadPool.h"
 #include "image/Image.h"
-#include "io/FileStream.h"
+#include "io/MemoryMappedReadStream.h"
 #include "io/Filesystem.h"
 #include "metric/Metric.h"
 #include "core/EventBus.h"
@@ -37,6 +40,10 @@
 
 #include <glm/gtc/quaternion.hpp>
 #include <glm/trigonometric.hpp>
+#include <SDL_platform.h>
+#if defined(__LINUX__) || defined(__MACOSX__)
+#include <sys/resource.h>
+#endif
 
 #define MaxHeightmapWidth 4096
 #define MaxHeightmapHeight 4096
@@ -48,6 +55,10 @@ VoxConvert::VoxConvert(const metric::MetricPtr& metric, const io::FilesystemPtr&
 
 app::AppState VoxConvert::onConstruct() {
 	const app::AppState state = Super::onConstruct();
+	registerArg("--batch").setDescription("Convert all model files of the given directory or manifest file (one input file per line) into the --output directory");
+	registerArg("--batch-format").setDefaultValue("vox").setDescription("The file extension of the target format for --batch");
+	registerArg("--batch-jobs").setDefaultValue(core::string::toString(core::cpus())).setDescription("The amount of files that are converted in parallel for --batch");
+	registerArg("--batch-memory").setDefaultValue("0").setDescription("The max amount of voxel data in MB that is processed at the same time for --batch (0 is unlimited)");
 	registerArg("--crop").setDescription("Reduce the volumes to their real voxel sizes");
 	registerArg("--dump").setDescription("Dump the scene graph of the input file");
 	registerArg("--export-layers").setDescription("Export all the layers of a scene into single files");
@@ -74,6 +85,7 @@ app::AppState VoxConvert::onConstruct() {
 
 	_mergeQuads = core::Var::get(cfg::VoxformatMergequads, "true", core::CV_NOPERSIST, "Merge similar quads to optimize the mesh");
 	_reuseVertices = core::Var::get(cfg::VoxformatReusevertices, "true", core::CV_NOPERSIST, "Reuse vertices or always create new ones");
+	core::Var::get(cfg::VoxelBinaryMesher, "true", core::CV_NOPERSIST, "Use the bitmask based greedy mesher for the surface extraction", core::Var::boolValidator);
 	_ambientOcclusion = core::Var::get(cfg::VoxformatAmbientocclusion, "false", core::CV_NOPERSIST, "Extra vertices for ambient occlusion");
 	_scale = core::Var::get(cfg::VoxformatScale, "1.0", core::CV_NOPERSIST, "Scale the vertices on all axis by the given factor");
 	_scaleX = core::Var::get(cfg::VoxformatScaleX, "1.0", core::CV_NOPERSIST, "Scale the vertices on X axis by the given factor");
@@ -127,6 +139,10 @@ app::AppState VoxConvert::onInit() {
 		return app::AppState::InitFailure;
 	}
 
+	if (hasArg("--batch")) {
+		return batch(getArgVal("--batch"), state);
+	}
+
 	const bool hasScript = hasArg("--script");
 
 	core::String infilesstr;
@@ -297,6 +313,12 @@ app::AppState VoxConvert::onInit() {
 		}
 	}
 
+	// only decode the volumes of the layers that survived the filter
+	if (!voxelformat::loadVolumes(sceneGraph)) {
+		Log::error("Failed to load the volumes of the input files");
+		return app::AppState::InitFailure;
+	}
+
 	if (_exportLayers) {
 		if (infiles.size() > 1) {
 			Log::warn("The format and path of the first input file is used for exporting all layers");
@@ -363,6 +385,152 @@ app::AppState VoxConvert::onInit() {
 	return state;
 }
 
+namespace {
+
+/**
+ * @return The peak resident set size of the process in bytes or @c 0 if not supported on this platform
+ */
+uint64_t peakResidentSetSize() {
+#if defined(__LINUX__) || defined(__MACOSX__)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0u;
+	}
+#if defined(__MACOSX__)
+	return (uint64_t)usage.ru_maxrss;
+#else
+	return (uint64_t)usage.ru_maxrss * 1024u;
+#endif
+#else
+	return 0u;
+#endif
+}
+
+}
+
+bool VoxConvert::collectBatchJobs(const core::String &source, const core::String &outdir, const core::String &format,
+								  core::DynamicArray<BatchJob> &jobs) {
+	core::DynamicArray<core::String> inputs;
+	if (filesystem()->isReadableDir(source)) {
+		core::DynamicArray<io::FilesystemEntry> entities;
+		filesystem()->list(source, entities);
+		for (const io::FilesystemEntry &entry : entities) {
+			if (entry.type != io::FilesystemEntry::Type::file || !voxelformat::isModelFormat(entry.name)) {
+				continue;
+			}
+			inputs.push_back(core::string::path(source, entry.name));
+		}
+	} else {
+		const io::FilePtr &manifest = filesystem()->open(source, io::FileMode::SysRead);
+		if (!manifest->exists()) {
+			Log::error("Given batch manifest '%s' does not exist", source.c_str());
+			return false;
+		}
+		core::DynamicArray<core::String> lines;
+		core::string::splitString(manifest->load(), lines, "\r\n");
+		for (const core::String &line : lines) {
+			const core::String &input = core::string::trim(line);
+			if (input.empty() || input[0] == '#') {
+				continue;
+			}
+			inputs.push_back(input);
+		}
+	}
+
+	// the target files are named after the input files - the first input wins
+	core::StringSet outputs;
+	for (const core::String &input : inputs) {
+		const core::String &output = core::string::path(outdir, core::string::extractFilename(input) + "." + format);
+		if (!outputs.insert(output)) {
+			Log::warn("Skip %s - the output file %s is already written by another input file", input.c_str(),
+					  output.c_str());
+			continue;
+		}
+		jobs.push_back(BatchJob{input, output});
+	}
+	if (jobs.empty()) {
+		Log::error("Could not find any input file for the batch conversion in %s", source.c_str());
+		return false;
+	}
+	return true;
+}
+
+app::AppState VoxConvert::batch(const core::String &source, app::AppState state) {
+	const core::String &outdir = getArgVal("--output");
+	if (outdir.empty()) {
+		Log::error("No output directory specified for the batch conversion");
+		return app::AppState::InitFailure;
+	}
+	if (!filesystem()->createDir(outdir)) {
+		Log::error("Could not create the output directory %s", outdir.c_str());
+		return app::AppState::InitFailure;
+	}
+	const core::String &format = getArgVal("--batch-format");
+	core::DynamicArray<BatchJob> jobs;
+	if (!collectBatchJobs(source, outdir, format, jobs)) {
+		return app::AppState::InitFailure;
+	}
+
+	// skip the files that were not modified since the last conversion
+	const bool force = hasArg("--force");
+	core::DynamicArray<BatchJob> pending;
+	pending.reserve(jobs.size());
+	for (const BatchJob &job : jobs) {
+		io::FilesystemEntry input;
+		io::FilesystemEntry output;
+		if (!force && io::Filesystem::stat(job.output, output) && io::Filesystem::stat(job.input, input) &&
+			output.mtime >= input.mtime) {
+			Log::debug("Skip %s - %s is up to date", job.input.c_str(), job.output.c_str());
+			continue;
+		}
+		pending.push_back(job);
+	}
+	const int skipped = (int)(jobs.size() - pending.size());
+
+	const int workers = core_max(1, core::string::toInt(getArgVal("--batch-jobs")));
+	const uint64_t maxMemory = (uint64_t)core_max(0, core::string::toInt(getArgVal("--batch-memory"))) * 1024u * 1024u;
+	Log::info("Convert %i files with %i jobs into %s (%i files are up to date)", (int)pending.size(), workers,
+			  outdir.c_str(), skipped);
+
+	voxconvert::BatchMemoryBudget budget(maxMemory);
+	// the jobs don't run on the app thread pool - the formats use that one for their own tasks
+	core::ThreadPool threadPool(workers, "batch");
+	threadPool.init();
+	const uint64_t startMillis = core::TimeProvider::systemMillis();
+	core::DynamicArray<std::future<voxconvert::BatchResult>> futures;
+	futures.reserve(pending.size());
+	for (const BatchJob &job : pending) {
+		futures.emplace_back(threadPool.enqueue([this, &budget, job]() {
+			return voxconvert::convertBatchFile(filesystem(), job.input, job.output, budget);
+		}));
+	}
+
+	int converted = 0;
+	int failed = 0;
+	uint64_t voxels = 0u;
+	for (std::future<voxconvert::BatchResult> &future : futures) {
+		const voxconvert::BatchResult &result = future.get();
+		if (result.success) {
+			++converted;
+			voxels += result.voxels;
+		} else {
+			++failed;
+		}
+	}
+	const double seconds = (double)core_max((uint64_t)1u, core::TimeProvider::systemMillis() - startMillis) / 1000.0;
+	Log::info("Converted %i files in %.2fs (%i failed, %i up to date)", converted, seconds, failed, skipped);
+	Log::info("* files/s:           - %.2f", (double)converted / seconds);
+	Log::info("* voxels/s:          - %.0f", (double)voxels / seconds);
+	const uint64_t peakRSS = peakResidentSetSize();
+	if (peakRSS > 0u) {
+		Log::info("* peak memory:       - %.2f MB", (double)peakRSS / (1024.0 * 1024.0));
+	}
+	if (failed > 0) {
+		_exitCode = 1;
+	}
+	return state;
+}
+
 core::String VoxConvert::getFilenameForLayerName(const core::String &inputfile, const core::String &layerName, int id) {
 	const core::String &ext = core::string::extractExtension(inputfile);
 	core::String name;
@@ -439,9 +607,10 @@ bool VoxConvert::handleInputFile(const core::String &infile, voxelformat::SceneG
 			sceneGraph.emplace(core::move(node));
 		}
 	} else {
-		io::FileStream inputFileStream(inputFile);
+		io::MemoryMappedReadStream inputFileStream(inputFile);
 		voxelformat::SceneGraph newSceneGraph;
-		if (!voxelformat::loadFormat(inputFile->name(), inputFileStream, newSceneGraph)) {
+		// the volumes are decoded after the layer filter was applied
+		if (!voxelformat::loadFormat(inputFile->name(), inputFileStream, newSceneGraph, true)) {
 			return false;
 		}
 
@@ -609,13 +778,9 @@ void VoxConvert::script(const core::String &scriptParameters, voxelformat::Scene
 void VoxConvert::scale(voxelformat::SceneGraph& sceneGraph) {
 	Log::info("Scale layers");
 	for (voxelformat::SceneGraphNode& node : sceneGraph) {
-		const voxel::Region srcRegion = node.region();
-		const glm::ivec3& targetDimensionsHalf = (srcRegion.getDimensionsInVoxels() / 2) - 1;
-		const voxel::Region destRegion(srcRegion.getLowerCorner(), srcRegion.getLowerCorner() + targetDimensionsHalf);
-		if (destRegion.isValid()) {
-			voxel::RawVolume* destVolume = new voxel::RawVolume(destRegion);
-			voxelutil::rescaleVolume(*node.volume(), *destVolume);
-			node.setVolume(destVolume, true);
+		const core::DynamicArray<voxel::RawVolume *> &levels = voxelutil::rescaleVolumeMipChain(*node.volume(), 1);
+		if (!levels.empty()) {
+			node.setVolume(levels[0], true);
 		}
 	}
 }
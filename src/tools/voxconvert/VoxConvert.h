@@ -5,6 +5,7 @@
 #pragma once
 
 #include "app/CommandlineApp.h"
+#include "core/collection/DynamicArray.h"
 #include "voxelformat/SceneGraph.h"
 
 /**
@@ -39,7 +40,19 @@ private:
 	bool _dumpSceneGraph = false;
 	bool _resizeVolumes = false;
 
+	struct BatchJob {
+		core::String input;
+		core::String output;
+	};
+
 protected:
+	bool collectBatchJobs(const core::String &source, const core::String &outdir, const core::String &format,
+						  core::DynamicArray<BatchJob> &jobs);
+	/**
+	 * @brief Converts each file of a directory or manifest independently on a bounded worker pool
+	 */
+	app::AppState batch(const core::String &source, app::AppState state);
+
 	glm::ivec3 getArgIvec3(const core::String &name);
 	core::String getFilenameForLayerName(const core::String& inputfile, const core::String &layerName, int id);
 	bool handleInputFile(const core::String &infile, voxelformat::SceneGraph &sceneGraph, bool multipleInputs);
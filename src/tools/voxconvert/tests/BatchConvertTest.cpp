@@ -0,0 +1,57 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "../BatchConvert.h"
+#include "voxel/RawVolume.h"
+#include "voxelformat/SceneGraph.h"
+#include "voxelformat/SceneGraphNode.h"
+#include "voxelformat/VolumeFormat.h"
+
+namespace voxconvert {
+
+class BatchConvertTest : public app::AbstractTest {};
+
+TEST_F(BatchConvertTest, testReserveBeforeDecodingEagerFormat) {
+	const io::FilesystemPtr &filesystem = _testApp->filesystem();
+	const voxel::Region region(0, 7);
+	{
+		voxelformat::SceneGraph sceneGraph;
+		voxelformat::SceneGraphNode node;
+		voxel::RawVolume *volume = new voxel::RawVolume(region);
+		for (int i = 0; i < 8; ++i) {
+			volume->setVoxel(i, i, i, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		}
+		node.setVolume(volume, true);
+		sceneGraph.emplace(core::move(node));
+		ASSERT_TRUE(voxelformat::saveFormat(filesystem->open("batchconverttest.vox", io::FileMode::SysWrite), sceneGraph));
+	}
+	const long fileSize = filesystem->open("batchconverttest.vox", io::FileMode::SysRead)->length();
+	ASSERT_GT(fileSize, 0l);
+
+	// the vox format decodes the volumes while it is loaded - the regions are known too late for the reservation
+	BatchMemoryBudget budget(1024u * 1024u * 1024u);
+	const BatchResult &result = convertBatchFile(filesystem, "batchconverttest.vox", "batchconverttest.qb", budget);
+	ASSERT_TRUE(result.success);
+	const glm::ivec3 &dim = region.getDimensionsInVoxels();
+	EXPECT_EQ((uint64_t)dim.x * dim.y * dim.z, result.voxels);
+	EXPECT_GE(budget.peak(), estimateVoxelBytes((uint64_t)fileSize))
+		<< "The file size estimation should be reserved before the volumes are decoded";
+	EXPECT_GE(budget.peak(), result.voxels * sizeof(voxel::Voxel));
+}
+
+TEST_F(BatchConvertTest, testResizeReservation) {
+	BatchMemoryBudget budget(100u);
+	budget.acquire(80u);
+	budget.resize(80u, 20u, true);
+	// fits next to the corrected reservation of the first job without waiting
+	budget.acquire(70u);
+	EXPECT_EQ(90u, budget.peak());
+	budget.resize(70u, 120u, true);
+	EXPECT_EQ(140u, budget.peak()) << "Memory that is already allocated has to be accounted for";
+	budget.release(120u);
+	budget.release(20u);
+}
+
+} // namespace voxconvert
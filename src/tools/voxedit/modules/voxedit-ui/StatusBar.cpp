@@ -77,6 +77,13 @@ void StatusBar::update(const char *title, float height, const core::String &last
 				ImGui::Text("Command: %s (%s)", lastExecutedCommand.c_str(), keybindingStr.c_str());
 			}
 		}
+		if (sceneMgr.isAutoSaving()) {
+			ImGui::SameLine();
+			ImGui::TextUnformatted("Autosaving...");
+		} else if (sceneMgr.autoSaveFailed()) {
+			ImGui::SameLine();
+			ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Autosave failed");
+		}
 	}
 	ImGui::End();
 }
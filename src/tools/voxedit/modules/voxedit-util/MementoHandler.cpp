@@ -13,28 +13,61 @@
 #include "core/StandardLib.h"
 #include "core/Log.h"
 #include "core/Zip.h"
+#include "core/collection/BitSet.h"
 #include "voxelformat/SceneGraphNode.h"
+#include <glm/vector_relational.hpp>
 
 namespace voxedit {
 
 static const MementoState InvalidMementoState{MementoType::Max, MementoData(), -1, -1, "", voxel::Region::InvalidRegion, glm::mat4(1.0f), 0};
 
-MementoData::MementoData(const uint8_t* buf, size_t bufSize,
-		const voxel::Region& _region) :
-		_compressedSize(bufSize), _region(_region) {
-	if (buf != nullptr) {
-		core_assert(_compressedSize > 0);
-		_buffer = (uint8_t*)core_malloc(_compressedSize);
-		core_memcpy(_buffer, buf, _compressedSize);
-	} else {
-		core_assert(_compressedSize == 0);
+/**
+ * @return The amount of bricks along each axis of the given volume region
+ */
+static inline glm::ivec3 brickCount(const voxel::Region &region) {
+	return (region.getDimensionsInVoxels() + MementoData::BrickSize - 1) / MementoData::BrickSize;
+}
+
+/**
+ * @return The region of the brick with the given index in local volume coordinates - clipped to the volume
+ */
+static voxel::Region brickRegion(const voxel::Region &region, uint32_t index) {
+	const glm::ivec3 &count = brickCount(region);
+	const glm::ivec3 &dim = region.getDimensionsInVoxels();
+	const int idx = (int)index;
+	const glm::ivec3 brick(idx % count.x, (idx / count.x) % count.y, idx / (count.x * count.y));
+	const glm::ivec3 mins = brick * MementoData::BrickSize;
+	const glm::ivec3 maxs = glm::min(mins + MementoData::BrickSize, dim) - 1;
+	return voxel::Region(mins, maxs);
+}
+
+/**
+ * @brief Computes the range of bricks that intersect the given region
+ * @return @c false if the region doesn't intersect the volume region
+ */
+static bool brickRange(const voxel::Region &volumeRegion, const voxel::Region &region, glm::ivec3 &mins,
+					   glm::ivec3 &maxs) {
+	voxel::Region cropped = region;
+	cropped.cropTo(volumeRegion);
+	if (!cropped.isValid()) {
+		return false;
 	}
+	const glm::ivec3 &lower = volumeRegion.getLowerCorner();
+	mins = (cropped.getLowerCorner() - lower) / MementoData::BrickSize;
+	maxs = (cropped.getUpperCorner() - lower) / MementoData::BrickSize;
+	return true;
+}
+
+MementoData::MementoData(const voxel::Region& region, bool delta) :
+		_region(region), _delta(delta) {
 }
 
 MementoData::MementoData(MementoData&& o) noexcept :
 		_compressedSize(o._compressedSize),
 		_buffer(o._buffer),
-		_region(o._region) {
+		_region(o._region),
+		_bricks(core::move(o._bricks)),
+		_delta(o._delta) {
 	o._compressedSize = 0;
 	o._buffer = nullptr;
 }
@@ -48,7 +81,9 @@ MementoData::~MementoData() {
 
 MementoData::MementoData(const MementoData& o) :
 		_compressedSize(o._compressedSize),
-		_region(o._region) {
+		_region(o._region),
+		_bricks(o._bricks),
+		_delta(o._delta) {
 	if (o._buffer != nullptr) {
 		core_assert(_compressedSize > 0);
 		_buffer = (uint8_t*)core_malloc(_compressedSize);
@@ -68,40 +103,187 @@ MementoData& MementoData::operator=(MementoData &&o) noexcept {
 		_buffer = o._buffer;
 		o._buffer = nullptr;
 		_region = o._region;
+		_bricks = core::move(o._bricks);
+		_delta = o._delta;
 	}
 	return *this;
 }
 
+void MementoData::addBrick(uint32_t index, const uint8_t* buf, size_t bufSize) {
+	if (buf == nullptr || bufSize == 0) {
+		_bricks.push_back(MementoBrick{index, _compressedSize, 0});
+		return;
+	}
+	_buffer = (uint8_t*)core_realloc(_buffer, _compressedSize + bufSize);
+	core_memcpy(_buffer + _compressedSize, buf, bufSize);
+	_bricks.push_back(MementoBrick{index, _compressedSize, bufSize});
+	_compressedSize += bufSize;
+}
+
+MementoData MementoData::merge(const MementoData& base, const MementoData& delta) {
+	core_assert(base._region == delta._region);
+	const glm::ivec3& count = brickCount(delta._region);
+	core::BitSet contained(count.x * count.y * count.z);
+	MementoData data(delta._region, base._delta);
+	for (const MementoBrick& b : delta._bricks) {
+		contained.set(b.index, true);
+		data.addBrick(b.index, delta._buffer + b.offset, b.size);
+	}
+	for (const MementoBrick& b : base._bricks) {
+		if (!contained[b.index]) {
+			data.addBrick(b.index, base._buffer + b.offset, b.size);
+		}
+	}
+	return data;
+}
+
 MementoData MementoData::fromVolume(const voxel::RawVolume* volume) {
+	return fromVolume(volume, voxel::Region::InvalidRegion);
+}
+
+MementoData MementoData::fromVolume(const voxel::RawVolume* volume, const voxel::Region& modifiedRegion) {
 	if (volume == nullptr) {
 		return MementoData();
 	}
-	const size_t uncompressedBufferSize = volume->region().voxels() * sizeof(voxel::Voxel);
-	const uint32_t compressedBufferSize = core::zip::compressBound(uncompressedBufferSize);
+	const voxel::Region& region = volume->region();
+	const glm::ivec3& count = brickCount(region);
+	glm::ivec3 mins(0);
+	glm::ivec3 maxs = count - 1;
+	const bool delta = modifiedRegion.isValid();
+	if (delta && !brickRange(region, modifiedRegion, mins, maxs)) {
+		return MementoData(region, true);
+	}
+	MementoData data(region, delta);
+
+	const glm::ivec3& dim = region.getDimensionsInVoxels();
+	const voxel::Voxel* voxels = (const voxel::Voxel*)volume->data();
+	const size_t brickBufferSize = BrickSize * BrickSize * BrickSize * sizeof(voxel::Voxel);
+	const uint32_t compressedBufferSize = core::zip::compressBound(brickBufferSize);
+	voxel::Voxel* brickBuf = (voxel::Voxel*)core_malloc(brickBufferSize);
 	uint8_t* compressedBuf = (uint8_t*)core_malloc(compressedBufferSize);
-	size_t finalBufSize = 0u;
-	if (!core::zip::compress(volume->data(), uncompressedBufferSize, compressedBuf, compressedBufferSize, &finalBufSize)) {
-		core_free(compressedBuf);
-		return MementoData();
+	for (int bz = mins.z; bz <= maxs.z; ++bz) {
+		for (int by = mins.y; by <= maxs.y; ++by) {
+			for (int bx = mins.x; bx <= maxs.x; ++bx) {
+				const uint32_t index = bx + by * count.x + bz * count.x * count.y;
+				const voxel::Region& brick = brickRegion(region, index);
+				const glm::ivec3& brickMins = brick.getLowerCorner();
+				const glm::ivec3& brickDim = brick.getDimensionsInVoxels();
+				bool air = true;
+				voxel::Voxel* row = brickBuf;
+				for (int z = 0; z < brickDim.z; ++z) {
+					for (int y = 0; y < brickDim.y; ++y) {
+						const int offset = brickMins.x + (brickMins.y + y) * dim.x + (brickMins.z + z) * dim.x * dim.y;
+						core_memcpy(row, voxels + offset, brickDim.x * sizeof(voxel::Voxel));
+						for (int x = 0; air && x < brickDim.x; ++x) {
+							air = row[x].isSame(voxel::Voxel()) && row[x].getFlags() == 0;
+						}
+						row += brickDim.x;
+					}
+				}
+				if (air) {
+					// a full state doesn't need to store bricks that only contain air
+					if (delta) {
+						data.addBrick(index, nullptr, 0);
+					}
+					continue;
+				}
+				const size_t uncompressedSize = brickDim.x * brickDim.y * brickDim.z * sizeof(voxel::Voxel);
+				size_t finalBufSize = 0u;
+				if (!core::zip::compress((const uint8_t*)brickBuf, uncompressedSize, compressedBuf, compressedBufferSize, &finalBufSize)) {
+					core_free(brickBuf);
+					core_free(compressedBuf);
+					return MementoData();
+				}
+				data.addBrick(index, compressedBuf, finalBufSize);
+			}
+		}
 	}
-	MementoData data(compressedBuf, finalBufSize, volume->region());
+	core_free(brickBuf);
 	core_free(compressedBuf);
 
-	Log::debug("Memento state. Volume: %i, compressed: %i",
-			(int)uncompressedBufferSize, (int)data._compressedSize);
+	Log::debug("Memento state. Volume: %i, compressed: %i, bricks: %i (%s)",
+			(int)(region.voxels() * sizeof(voxel::Voxel)), (int)data._compressedSize, (int)data._bricks.size(),
+			delta ? "delta" : "full");
 	return data;
 }
 
+/**
+ * @brief Calls the given function with the uncompressed voxels of each of the given bricks
+ */
+template<class FUNC>
+static bool visitBricks(const core::DynamicArray<MementoBrick>& bricks, const uint8_t* buffer, const voxel::Region& region, FUNC&& func) {
+	const size_t brickBufferSize = MementoData::BrickSize * MementoData::BrickSize * MementoData::BrickSize * sizeof(voxel::Voxel);
+	voxel::Voxel* brickBuf = (voxel::Voxel*)core_malloc(brickBufferSize);
+	for (const MementoBrick& b : bricks) {
+		const voxel::Region& brick = brickRegion(region, b.index);
+		const size_t uncompressedSize = brick.voxels() * sizeof(voxel::Voxel);
+		if (b.size == 0) {
+			for (int i = 0; i < brick.voxels(); ++i) {
+				brickBuf[i] = voxel::Voxel();
+			}
+		} else if (!core::zip::uncompress(buffer + b.offset, b.size, (uint8_t*)brickBuf, uncompressedSize)) {
+			core_free(brickBuf);
+			return false;
+		}
+		func(brick, brickBuf);
+	}
+	core_free(brickBuf);
+	return true;
+}
+
 voxel::RawVolume* MementoData::toVolume(const MementoData& mementoData) {
-	if (mementoData._buffer == nullptr) {
+	if (!mementoData._region.isValid() || mementoData._delta) {
 		return nullptr;
 	}
-	const size_t uncompressedBufferSize = mementoData._region.voxels() * sizeof(voxel::Voxel);
-	uint8_t *uncompressedBuf = (uint8_t*)core_malloc(uncompressedBufferSize);
-	if (!core::zip::uncompress(mementoData._buffer, mementoData._compressedSize, uncompressedBuf, uncompressedBufferSize)) {
+	const voxel::Region& region = mementoData._region;
+	const glm::ivec3& dim = region.getDimensionsInVoxels();
+	voxel::Voxel* voxels = (voxel::Voxel*)core_malloc(region.voxels() * sizeof(voxel::Voxel));
+	for (int i = 0; i < region.voxels(); ++i) {
+		voxels[i] = voxel::Voxel();
+	}
+	const bool success = visitBricks(mementoData._bricks, mementoData._buffer, region,
+			[&](const voxel::Region& brick, const voxel::Voxel* brickVoxels) {
+		const glm::ivec3& brickMins = brick.getLowerCorner();
+		const glm::ivec3& brickDim = brick.getDimensionsInVoxels();
+		for (int z = 0; z < brickDim.z; ++z) {
+			for (int y = 0; y < brickDim.y; ++y) {
+				const int offset = brickMins.x + (brickMins.y + y) * dim.x + (brickMins.z + z) * dim.x * dim.y;
+				core_memcpy(voxels + offset, brickVoxels, brickDim.x * sizeof(voxel::Voxel));
+				brickVoxels += brickDim.x;
+			}
+		}
+	});
+	if (!success) {
+		core_free(voxels);
 		return nullptr;
 	}
-	return voxel::RawVolume::createRaw((voxel::Voxel*)uncompressedBuf, mementoData._region);
+	return voxel::RawVolume::createRaw(voxels, region);
+}
+
+bool MementoData::applyToVolume(const MementoData& mementoData, voxel::RawVolume* volume) {
+	if (volume == nullptr || !mementoData._region.isValid()) {
+		return false;
+	}
+	const voxel::Region& region = volume->region();
+	if (region != mementoData._region) {
+		Log::error("The memento state doesn't match the volume region");
+		return false;
+	}
+	voxel::RawVolume::Sampler sampler(volume);
+	return visitBricks(mementoData._bricks, mementoData._buffer, region,
+			[&](const voxel::Region& brick, const voxel::Voxel* brickVoxels) {
+		const glm::ivec3 &brickMins = region.getLowerCorner() + brick.getLowerCorner();
+		const glm::ivec3& brickDim = brick.getDimensionsInVoxels();
+		for (int z = 0; z < brickDim.z; ++z) {
+			for (int y = 0; y < brickDim.y; ++y) {
+				sampler.setPosition(brickMins.x, brickMins.y + y, brickMins.z + z);
+				for (int x = 0; x < brickDim.x; ++x) {
+					sampler.setVoxel(*brickVoxels++);
+					sampler.movePositiveX();
+				}
+			}
+		}
+	});
 }
 
 MementoHandler::MementoHandler() {
@@ -144,7 +326,7 @@ void MementoHandler::print() const {
 		const glm::ivec3& mins = state.region.getLowerCorner();
 		const glm::ivec3& maxs = state.region.getUpperCorner();
 		Log::info("%4i: (%s) node id: %i (parent: %i) (frame %i) - %s (%s) [mins(%i:%i:%i)/maxs(%i:%i:%i)] (size: %ib)",
-				i++, states[(int)state.type], state.nodeId, state.parentId, state.keyFrame, state.name.c_str(), state.data._buffer == nullptr ? "empty" : "volume",
+				i++, states[(int)state.type], state.nodeId, state.parentId, state.keyFrame, state.name.c_str(), !state.hasVolumeData() ? "empty" : (state.data.isDelta() ? "delta" : "volume"),
 						mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z, (int)state.data.size());
 	}
 }
@@ -168,13 +350,15 @@ MementoState MementoHandler::undo() {
 	const MementoState& s = state();
 	--_statePosition;
 	if (s.type == MementoType::Modification) {
-		for (int i = _statePosition; i >= 0; --i) {
-			MementoState& prevS = _states[i];
-			if ((prevS.type == MementoType::Modification || prevS.type == MementoType::SceneNodeAdded) && prevS.nodeId == s.nodeId) {
-				core_assert(prevS.hasVolumeData());
-				// use the region from the current state - but the volume from the previous state of this node
-				return MementoState{s.type, prevS.data, s.parentId, s.nodeId, s.name, s.region, s.localMatrix, s.keyFrame};
-			}
+		const int prevIdx = volumeState(s.nodeId, _statePosition);
+		if (prevIdx != -1) {
+			const MementoState& prevS = _states[prevIdx];
+			core_assert(prevS.hasVolumeData());
+			// use the region from the current state - but the volume from the previous state of this node. If the volume
+			// region didn't change, only the bricks of the modified region are restored.
+			const bool delta = s.region.isValid() && s.dataRegion() == prevS.dataRegion();
+			return MementoState{s.type, volumeData(prevIdx, delta ? s.region : voxel::Region::InvalidRegion), s.parentId,
+								s.nodeId, s.name, s.region, s.localMatrix, s.keyFrame};
 		}
 		core_assert(_states[0].type == MementoType::Modification);
 		return _states[0];
@@ -274,6 +458,108 @@ void MementoHandler::markNodeTransform(const voxelformat::SceneGraphNode &node,
 	markUndo(parentId, nodeId, name, nullptr, MementoType::SceneNodeTransform, voxel::Region::InvalidRegion, localMatrix, keyFrameIdx);
 }
 
+static inline bool isVolumeState(const MementoState &state, int nodeId) {
+	return (state.type == MementoType::Modification || state.type == MementoType::SceneNodeAdded) &&
+		   state.nodeId == nodeId && state.hasVolumeData();
+}
+
+int MementoHandler::volumeState(int nodeId, int from) const {
+	for (int i = from; i >= 0; --i) {
+		if (isVolumeState(_states[i], nodeId)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+bool MementoHandler::useDelta(int nodeId, const voxel::Region &volumeRegion) const {
+	if (_states.empty()) {
+		return false;
+	}
+	int prevIdx = volumeState(nodeId, (int)_states.size() - 1);
+	if (prevIdx == -1 || _states[prevIdx].dataRegion() != volumeRegion) {
+		return false;
+	}
+	// limit the amount of deltas that have to be collected to restore a volume
+	int deltas = 0;
+	for (; prevIdx != -1; prevIdx = volumeState(nodeId, prevIdx - 1)) {
+		if (!_states[prevIdx].data.isDelta()) {
+			return deltas < FullStateInterval;
+		}
+		++deltas;
+	}
+	// there is no full state left that the deltas are based on
+	return false;
+}
+
+MementoData MementoHandler::volumeData(int stateIdx, const voxel::Region &region) const {
+	const MementoState &state = _states[stateIdx];
+	const voxel::Region &volumeRegion = state.dataRegion();
+	const glm::ivec3 &count = brickCount(volumeRegion);
+	glm::ivec3 mins(0);
+	glm::ivec3 maxs = count - 1;
+	const bool delta = region.isValid();
+	if (delta && !brickRange(volumeRegion, region, mins, maxs)) {
+		return MementoData(volumeRegion, true);
+	}
+	auto wanted = [&](uint32_t index) {
+		const int idx = (int)index;
+		const glm::ivec3 brick(idx % count.x, (idx / count.x) % count.y, idx / (count.x * count.y));
+		return glm::all(glm::greaterThanEqual(brick, mins)) && glm::all(glm::lessThanEqual(brick, maxs));
+	};
+
+	MementoData data(volumeRegion, delta);
+	core::BitSet collected(count.x * count.y * count.z);
+	for (int i = stateIdx; i != -1; i = volumeState(state.nodeId, i - 1)) {
+		const MementoData &prevData = _states[i].data;
+		if (prevData._region != volumeRegion) {
+			break;
+		}
+		for (const MementoBrick &b : prevData._bricks) {
+			if (collected[b.index] || !wanted(b.index)) {
+				continue;
+			}
+			collected.set(b.index, true);
+			data.addBrick(b.index, prevData._buffer + b.offset, b.size);
+		}
+		if (!prevData.isDelta()) {
+			break;
+		}
+	}
+	if (delta) {
+		// the bricks that are not part of the full state only contain air
+		for (int z = mins.z; z <= maxs.z; ++z) {
+			for (int y = mins.y; y <= maxs.y; ++y) {
+				for (int x = mins.x; x <= maxs.x; ++x) {
+					const uint32_t index = x + y * count.x + z * count.x * count.y;
+					if (!collected[index]) {
+						data.addBrick(index, nullptr, 0);
+					}
+				}
+			}
+		}
+	}
+	return data;
+}
+
+void MementoHandler::removeFirstState() {
+	const MementoState &first = _states[0];
+	if (first.hasVolumeData()) {
+		for (size_t i = 1; i < _states.size(); ++i) {
+			MementoState &next = _states[i];
+			if (!isVolumeState(next, first.nodeId)) {
+				continue;
+			}
+			// the next delta of this node would lose the bricks it is based on
+			if (next.data.isDelta()) {
+				next.data = MementoData::merge(first.data, next.data);
+			}
+			break;
+		}
+	}
+	_states.erase_front(1);
+}
+
 bool MementoHandler::markUndoPreamble(int nodeId) {
 	if (_locked > 0) {
 		Log::debug("Don't add undo state - we are currently in locked mode");
@@ -298,7 +584,13 @@ void MementoHandler::markUndo(int parentId, int nodeId, const core::String &name
 	}
 	Log::debug("New undo state for node %i with name %s (memento state index: %i)", nodeId, name.c_str(), (int)_states.size());
 	voxel::logRegion("MarkUndo", region);
-	const MementoData& data = MementoData::fromVolume(volume);
+	if (_states.size() == _states.capacity()) {
+		removeFirstState();
+	}
+	// decide after the eviction - the dropped state might have been the base of the new delta
+	const bool delta = type == MementoType::Modification && volume != nullptr && region.isValid() &&
+					   useDelta(nodeId, volume->region());
+	const MementoData& data = delta ? MementoData::fromVolume(volume, region) : MementoData::fromVolume(volume);
 	_states.emplace_back(type, data, parentId, nodeId, name, region, localMatrix, keyFrameIdx);
 	_statePosition = stateSize() - 1;
 }
@@ -8,6 +8,7 @@
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
 #include "voxelformat/SceneGraphNode.h"
+#include "core/collection/DynamicArray.h"
 #include "core/collection/RingBuffer.h"
 #include "core/String.h"
 #include <stdint.h>
@@ -34,10 +35,33 @@ enum class MementoType {
 	Max
 };
 
+/**
+ * @brief A brick of the volume in a memento state
+ *
+ * The volume is split into cubes of @c MementoData::BrickSize voxels that are compressed on their own. This allows
+ * to only store the bricks that were touched by a modification.
+ */
+struct MementoBrick {
+	/**
+	 * @brief The linear index of the brick in the volume
+	 */
+	uint32_t index;
+	/**
+	 * @brief The offset of the compressed brick in the buffer of the memento data
+	 */
+	size_t offset;
+	/**
+	 * @brief The compressed size of the brick - @c 0 if the brick only contains air
+	 */
+	size_t size;
+};
+
 /**
  * @brief Holds the data of a memento state
  *
- * The given buffer is owned by this class and represents a compressed volume
+ * The given buffer is owned by this class and contains the compressed bricks of a volume. A full state contains
+ * every brick of the volume (bricks that aren't listed only contain air). A delta state only contains the bricks
+ * that were touched by a modification and is applied on top of the volume of the previous state.
  */
 class MementoData {
 	friend struct MementoState;
@@ -52,33 +76,65 @@ private:
 	 */
 	uint8_t* _buffer = nullptr;
 	/**
-	 * The region the given volume data is for
+	 * The region of the whole volume the given data is for - invalid if there is no volume
+	 */
+	voxel::Region _region {0, -1};
+	core::DynamicArray<MementoBrick> _bricks;
+	/**
+	 * @brief @c true if only the modified bricks are stored
 	 */
-	voxel::Region _region {};
+	bool _delta = false;
 
-	MementoData(const uint8_t* buf, size_t bufSize, const voxel::Region& _region);
+	MementoData(const voxel::Region& region, bool delta);
+	/**
+	 * @param[in] buf The compressed brick data - @c null for a brick that only contains air
+	 */
+	void addBrick(uint32_t index, const uint8_t* buf, size_t bufSize);
+	/**
+	 * @brief Adds the bricks of the given @c base state that the @c delta state doesn't contain
+	 * @return The combined state that replaces @c delta after @c base was dropped from the history
+	 */
+	static MementoData merge(const MementoData& base, const MementoData& delta);
 public:
-	constexpr MementoData() {}
+	/**
+	 * @brief The edge length of the bricks the volume is split into
+	 */
+	static constexpr int BrickSize = 32;
+
+	MementoData() {}
 	MementoData(MementoData&& o) noexcept;
 	MementoData(const MementoData& o);
 	~MementoData();
 
 	inline size_t size() const { return _compressedSize; }
 
+	inline bool isDelta() const { return _delta; }
+
 	MementoData& operator=(MementoData &&o) noexcept;
 
 	/**
 	 * @brief Converts the given @c mementoData into a volume
 	 * @note Keep in mind that you own the returned memory
 	 * @return The volume from the given memento data or @c null if the memento data
-	 * did not contain a valid volume buffer
+	 * did not contain a valid volume buffer or only contains a delta
 	 */
 	static voxel::RawVolume* toVolume(const MementoData& mementoData);
+	/**
+	 * @brief Writes the bricks of the given @c mementoData into the volume
+	 * @note The volume must have the same region as the memento data
+	 */
+	static bool applyToVolume(const MementoData& mementoData, voxel::RawVolume* volume);
 	/**
 	 * @brief Converts the given volume into a @c MementoData structure (and perform the compression)
 	 * @param[in] volume The volume to create the memento state for. This might be @c null.
 	 */
 	static MementoData fromVolume(const voxel::RawVolume* volume);
+	/**
+	 * @brief Creates a delta state that only contains the bricks of the volume that intersect the given region
+	 * @param[in] volume The volume to create the memento state for. This might be @c null.
+	 * @param[in] modifiedRegion The region of the volume that was modified
+	 */
+	static MementoData fromVolume(const voxel::RawVolume* volume, const voxel::Region& modifiedRegion);
 };
 
 struct MementoState {
@@ -118,7 +174,7 @@ struct MementoState {
 	 * Some types (@c MementoType) don't have a volume attached.
 	 */
 	inline bool hasVolumeData() const {
-		return data._buffer != nullptr;
+		return data._region.isValid();
 	}
 
 	inline const voxel::Region& dataRegion() const {
@@ -136,7 +192,31 @@ private:
 	int _locked = 0;
 
 	bool markUndoPreamble(int nodeId);
+	/**
+	 * @return The index of the last state up to @c from that holds the volume of the given node or @c -1
+	 */
+	int volumeState(int nodeId, int from) const;
+	/**
+	 * @brief Decides whether a modification of the given node can be stored as delta to the previous state
+	 */
+	bool useDelta(int nodeId, const voxel::Region &volumeRegion) const;
+	/**
+	 * @brief Collects the bricks of the volume of the node at the given state from the deltas and the last full state
+	 * @param[in] region Only collect the bricks that intersect this region - this results in a delta. If the region is
+	 * invalid, the full volume is collected.
+	 */
+	MementoData volumeData(int stateIdx, const voxel::Region &region) const;
+	/**
+	 * @brief Drops the oldest state to make room for a new one - its bricks are handed over to the next state of the
+	 * same node if needed
+	 */
+	void removeFirstState();
 public:
+	/**
+	 * @brief After this amount of delta states for a node a full state is stored again
+	 */
+	static constexpr int FullStateInterval = 16;
+
 	MementoHandler();
 	~MementoHandler();
 
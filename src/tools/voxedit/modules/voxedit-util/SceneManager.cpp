@@ -14,7 +14,7 @@
 #include "core/StringUtil.h"
 #include "core/TimeProvider.h"
 #include "core/collection/DynamicArray.h"
-#include "io/FileStream.h"
+#include "io/MemoryMappedReadStream.h"
 #include "io/Filesystem.h"
 #include "math/AABB.h"
 #include "math/Axis.h"
@@ -164,7 +164,33 @@ bool SceneManager::importColoredHeightmap(const core::String& file) {
 	return true;
 }
 
+void SceneManager::finishAutoSave(bool wait) {
+	if (!_autoSaveFuture.valid()) {
+		return;
+	}
+	if (!wait) {
+		using namespace std::chrono_literals;
+		if (_autoSaveFuture.wait_for(0ms) != std::future_status::ready) {
+			return;
+		}
+	}
+	if (_autoSaveFuture.get()) {
+		Log::info("Autosave file %s", _autoSaveFilename.c_str());
+		core::Var::get(cfg::VoxEditLastFile)->setVal(_autoSaveFilename);
+		_autoSaveFailed = false;
+	} else {
+		Log::warn("Failed to autosave");
+		_autoSaveFailed = true;
+		_needAutoSave = true;
+	}
+	_autoSaveFuture = std::future<bool>();
+}
+
 void SceneManager::autosave() {
+	finishAutoSave(false);
+	if (_autoSaveFuture.valid()) {
+		return;
+	}
 	if (!_needAutoSave) {
 		return;
 	}
@@ -173,6 +199,9 @@ void SceneManager::autosave() {
 	if (_lastAutoSave + delay > timeProvider->tickSeconds()) {
 		return;
 	}
+	if (_sceneGraph.empty()) {
+		return;
+	}
 	core::String autoSaveFilename;
 	if (_lastFilename.empty()) {
 		autoSaveFilename = "autosave-noname.vox";
@@ -188,11 +217,39 @@ void SceneManager::autosave() {
 					p.c_str(), f.c_str(), e.c_str());
 		}
 	}
-	if (save(autoSaveFilename, true)) {
-		Log::info("Autosave file %s", autoSaveFilename.c_str());
-	} else {
-		Log::warn("Failed to autosave");
-	}
+	// the format is detected by the extension - so keep it for the temp file
+	const core::String tmpFilename = core::string::format("%s.tmp.%s",
+			core::string::stripExtension(autoSaveFilename).c_str(), core::string::extractExtension(autoSaveFilename).c_str());
+
+	// the volumes are copied - the format writers run in the background while the scene is still modified
+	core::SharedPtr<voxelformat::SceneGraph> snapshot = core::make_shared<voxelformat::SceneGraph>();
+	voxelformat::copySceneGraph(*snapshot.get(), _sceneGraph);
+
+	core::ThreadPool& threadPool = app::App::getInstance()->threadPool();
+	_autoSaveFuture = threadPool.enqueue([snapshot, tmpFilename, autoSaveFilename] () {
+		core_trace_scoped(AutoSave);
+		const io::FilesystemPtr& filesystem = io::filesystem();
+		const io::FilePtr& filePtr = filesystem->open(tmpFilename, io::FileMode::SysWrite);
+		if (!filePtr->validHandle()) {
+			Log::warn("Failed to open the given file '%s' for writing", tmpFilename.c_str());
+			return false;
+		}
+		const bool saved = voxelformat::saveFormat(filePtr, *snapshot.get());
+		filePtr->close();
+		if (!saved) {
+			filesystem->removeFile(tmpFilename);
+			return false;
+		}
+		// only replace the previous autosave once the new file is complete
+		if (!filesystem->rename(tmpFilename, autoSaveFilename)) {
+			Log::warn("Failed to move '%s' to '%s'", tmpFilename.c_str(), autoSaveFilename.c_str());
+			filesystem->removeFile(tmpFilename);
+			return false;
+		}
+		return true;
+	});
+	_autoSaveFilename = autoSaveFilename;
+	_needAutoSave = false;
 	_lastAutoSave = timeProvider->tickSeconds();
 }
 
@@ -251,6 +308,8 @@ bool SceneManager::saveModels(const core::String& dir) {
 }
 
 bool SceneManager::save(const core::String& file, bool autosave) {
+	// a running autosave might write to the same file
+	finishAutoSave(true);
 	if (_sceneGraph.empty()) {
 		Log::warn("No volumes for saving found");
 		return false;
@@ -301,7 +360,7 @@ bool SceneManager::prefab(const core::String& file) {
 		return false;
 	}
 	voxelformat::SceneGraph newSceneGraph;
-	io::FileStream stream(filePtr);
+	io::MemoryMappedReadStream stream(filePtr);
 	if (!voxelformat::loadFormat(filePtr->name(), stream, newSceneGraph)) {
 		Log::error("Failed to load %s", file.c_str());
 		return false;
@@ -331,7 +390,7 @@ bool SceneManager::load(const core::String& file) {
 	core::ThreadPool& threadPool = app::App::getInstance()->threadPool();
 	_loadingFuture = threadPool.enqueue([filePtr] () {
 		voxelformat::SceneGraph newSceneGraph;
-		io::FileStream stream(filePtr);
+		io::MemoryMappedReadStream stream(filePtr);
 		voxelformat::loadFormat(filePtr->name(), stream, newSceneGraph);
 		mergeIfNeeded(newSceneGraph);
 		// TODO: stuff that happens in RawVolumeRenderer::extractRegion and
@@ -422,14 +481,12 @@ void SceneManager::scale(int nodeId) {
 		return;
 	}
 	const voxel::Region srcRegion = srcVolume->region();
-	const glm::ivec3& targetDimensionsHalf = (srcRegion.getDimensionsInVoxels() / 2) - 1;
-	if (targetDimensionsHalf.x < 0 || targetDimensionsHalf.y < 0 || targetDimensionsHalf.z < 0) {
+	const core::DynamicArray<voxel::RawVolume *> &levels = voxelutil::rescaleVolumeMipChain(*srcVolume, 1);
+	if (levels.empty()) {
 		Log::debug("Can't scale anymore");
 		return;
 	}
-	const voxel::Region destRegion(srcRegion.getLowerCorner(), srcRegion.getLowerCorner() + targetDimensionsHalf);
-	voxel::RawVolume* destVolume = new voxel::RawVolume(destRegion);
-	voxelutil::rescaleVolume(*srcVolume, *destVolume);
+	voxel::RawVolume* destVolume = levels[0];
 	if (!setNewVolume(nodeId, destVolume, true)) {
 		delete destVolume;
 		return;
@@ -593,18 +650,24 @@ bool SceneManager::undo() {
 		return nodeRemove(s.nodeId, true);
 	} else if (s.type == MementoType::Modification) {
 		Log::debug("Memento: Undo modification in volume of node %i (%s)", s.nodeId, s.name.c_str());
-		voxel::RawVolume* v = MementoData::toVolume(s.data);
-		if (voxelformat::SceneGraphNode *node = sceneGraphNode(s.nodeId)) {
-			node->setVolume(v, true);
-			node->setName(s.name);
-			modified(node->id(), s.region, false);
-			_volumeRenderer.prepare(_sceneGraph);
-			return true;
-		} else {
+		voxelformat::SceneGraphNode *node = sceneGraphNode(s.nodeId);
+		if (node == nullptr) {
 			Log::warn("Failed to undo - node id %i not found (%s)", s.nodeId, s.name.c_str());
-			delete v;
 			return false;
 		}
+		if (s.data.isDelta()) {
+			// only the modified bricks are stored - write them back into the existing volume
+			if (!MementoData::applyToVolume(s.data, node->volume())) {
+				Log::warn("Failed to undo - could not apply the modification to node %i (%s)", s.nodeId, s.name.c_str());
+				return false;
+			}
+		} else {
+			node->setVolume(MementoData::toVolume(s.data), true);
+		}
+		node->setName(s.name);
+		modified(node->id(), s.region, false);
+		_volumeRenderer.prepare(_sceneGraph);
+		return true;
 	}
 	return true;
 }
@@ -648,18 +711,24 @@ bool SceneManager::redo() {
 		return newNodeId != -1;
 	} else if (s.type == MementoType::Modification) {
 		Log::debug("Memento: Redo modification in volume of node %i (%s)", s.nodeId, s.name.c_str());
-		voxel::RawVolume* v = MementoData::toVolume(s.data);
-		if (voxelformat::SceneGraphNode *node = sceneGraphNode(s.nodeId)) {
-			node->setVolume(v, true);
-			node->setName(s.name);
-			modified(node->id(), s.region, false);
-			_volumeRenderer.prepare(_sceneGraph);
-			return true;
-		} else {
+		voxelformat::SceneGraphNode *node = sceneGraphNode(s.nodeId);
+		if (node == nullptr) {
 			Log::warn("Failed to redo - node id %i not found (%s)", s.nodeId, s.name.c_str());
-			delete v;
 			return false;
 		}
+		if (s.data.isDelta()) {
+			// only the modified bricks are stored - write them back into the existing volume
+			if (!MementoData::applyToVolume(s.data, node->volume())) {
+				Log::warn("Failed to redo - could not apply the modification to node %i (%s)", s.nodeId, s.name.c_str());
+				return false;
+			}
+		} else {
+			node->setVolume(MementoData::toVolume(s.data), true);
+		}
+		node->setName(s.name);
+		modified(node->id(), s.region, false);
+		_volumeRenderer.prepare(_sceneGraph);
+		return true;
 	}
 	return true;
 }
@@ -1914,6 +1983,14 @@ bool SceneManager::isLoading() const {
 	return _loadingFuture.valid();
 }
 
+bool SceneManager::isAutoSaving() const {
+	return _autoSaveFuture.valid();
+}
+
+bool SceneManager::autoSaveFailed() const {
+	return _autoSaveFailed;
+}
+
 bool SceneManager::update(double nowSeconds) {
 	bool loadedNewScene = false;
 	if (_loadingFuture.valid()) {
@@ -1968,6 +2045,8 @@ void SceneManager::shutdown() {
 		return;
 	}
 
+	finishAutoSave(true);
+
 	if (_copy) {
 		delete _copy;
 		_copy = nullptr;
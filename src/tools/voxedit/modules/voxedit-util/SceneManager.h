@@ -90,6 +90,9 @@ private:
 	voxel::RawVolume* _copy = nullptr;
 	EditMode _editMode = EditMode::Scene;
 	std::future<voxelformat::SceneGraph> _loadingFuture;
+	std::future<bool> _autoSaveFuture;
+	core::String _autoSaveFilename;
+	bool _autoSaveFailed = false;
 
 #ifdef VOXEDIT_ANIMATION
 	animation::AnimationSettings::Type _entityType = animation::AnimationSettings::Type::Max;
@@ -190,7 +193,6 @@ private:
 	void handleAnimationViewUpdate(int nodeId);
 #endif
 	bool setNewVolume(int nodeId, voxel::RawVolume* volume, bool deleteMesh = true);
-	void autosave();
 	void setReferencePosition(const glm::ivec3& pos);
 	void updateGridRenderer(const voxel::Region& region);
 	void zoom(video::Camera& camera, float level) const;
@@ -244,6 +246,16 @@ protected:
 	bool saveNode(int nodeId, const core::String& file);
 
 	void flip(math::Axis axis);
+	/**
+	 * @brief Writes a snapshot of the scene in a task of the thread pool
+	 * @note The format writers must not wait for other tasks of the thread pool - the pool might only have one worker
+	 */
+	void autosave();
+	/**
+	 * @brief Processes the result of a running autosave
+	 * @param[in] wait @c true to block until the autosave is done
+	 */
+	void finishAutoSave(bool wait);
 public:
 	~SceneManager();
 
@@ -342,6 +354,14 @@ public:
 	 */
 	bool load(const core::String& file);
 	bool isLoading() const;
+	/**
+	 * @return @c true if an autosave is written in the background
+	 */
+	bool isAutoSaving() const;
+	/**
+	 * @return @c true if the last autosave failed
+	 */
+	bool autoSaveFailed() const;
 
 #ifdef VOXEDIT_ANIMATION
 	bool loadAnimationEntity(const core::String& luaFile);
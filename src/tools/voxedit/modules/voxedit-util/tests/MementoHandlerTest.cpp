@@ -23,6 +23,21 @@ protected:
 	void TearDown() override {
 		mementoHandler.shutdown();
 	}
+
+	/**
+	 * @brief Applies the volume of an undo or redo state like the scene manager does
+	 */
+	void apply(const MementoState &state, core::SharedPtr<voxel::RawVolume> &volume) const {
+		ASSERT_TRUE(state.hasVolumeData());
+		if (state.data.isDelta()) {
+			ASSERT_TRUE(MementoData::applyToVolume(state.data, volume.get()));
+		} else {
+			voxel::RawVolume *v = MementoData::toVolume(state.data);
+			ASSERT_NE(nullptr, v);
+			volume = core::make_shared<voxel::RawVolume>(core::move(*v));
+			delete v;
+		}
+	}
 };
 
 TEST_F(MementoHandlerTest, testMarkUndo) {
@@ -544,6 +559,148 @@ TEST_F(MementoHandlerTest, testAddNewNodeEdit) {
 	}
 }
 
+TEST_F(MementoHandlerTest, testDeltaUndoRedo) {
+	core::SharedPtr<voxel::RawVolume> volume = create(64);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	mementoHandler.markUndo(0, 0, "", volume.get(), MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	EXPECT_FALSE(mementoHandler.state().data.isDelta());
+
+	const glm::ivec3 first(1, 2, 3);
+	volume->setVoxel(first, voxel);
+	mementoHandler.markUndo(0, 0, "", volume.get(), MementoType::Modification, voxel::Region(first, first), glm::mat4(1.0f), 0);
+	EXPECT_TRUE(mementoHandler.state().data.isDelta());
+
+	const glm::ivec3 second(40, 50, 60);
+	volume->setVoxel(second, voxel);
+	mementoHandler.markUndo(0, 0, "", volume.get(), MementoType::Modification, voxel::Region(second, second), glm::mat4(1.0f), 0);
+	ASSERT_TRUE(mementoHandler.state().data.isDelta());
+	EXPECT_EQ(64, mementoHandler.state().dataRegion().getWidthInVoxels());
+
+	MementoState state = mementoHandler.undo();
+	ASSERT_TRUE(state.data.isDelta()) << "Only the modified brick should get restored";
+	apply(state, volume);
+	EXPECT_TRUE(volume->voxel(first).isSame(voxel));
+	EXPECT_TRUE(voxel::isAir(volume->voxel(second).getMaterial()));
+
+	state = mementoHandler.undo();
+	apply(state, volume);
+	EXPECT_TRUE(voxel::isAir(volume->voxel(first).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(volume->voxel(second).getMaterial()));
+
+	state = mementoHandler.redo();
+	apply(state, volume);
+	EXPECT_TRUE(volume->voxel(first).isSame(voxel));
+	EXPECT_TRUE(voxel::isAir(volume->voxel(second).getMaterial()));
+
+	state = mementoHandler.redo();
+	apply(state, volume);
+	EXPECT_TRUE(volume->voxel(first).isSame(voxel));
+	EXPECT_TRUE(volume->voxel(second).isSame(voxel));
+}
+
+TEST_F(MementoHandlerTest, testDeltaRegionChange) {
+	core::SharedPtr<voxel::RawVolume> first = create(2);
+	core::SharedPtr<voxel::RawVolume> second = create(3);
+	mementoHandler.markUndo(0, 0, "", first.get(), MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	mementoHandler.markUndo(0, 0, "", second.get(), MementoType::Modification, second->region(), glm::mat4(1.0f), 0);
+	EXPECT_FALSE(mementoHandler.state().data.isDelta()) << "A new volume size needs a full state";
+	const MementoState &state = mementoHandler.undo();
+	EXPECT_FALSE(state.data.isDelta());
+	EXPECT_EQ(2, state.dataRegion().getWidthInVoxels());
+}
+
+TEST_F(MementoHandlerTest, testFullStateInterval) {
+	core::SharedPtr<voxel::RawVolume> volume = create(8);
+	const voxel::Region region(0, 0);
+	mementoHandler.markUndo(0, 0, "", volume.get(), MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	for (int i = 1; i <= MementoHandler::FullStateInterval; ++i) {
+		mementoHandler.markUndo(0, 0, "", volume.get(), MementoType::Modification, region, glm::mat4(1.0f), 0);
+		EXPECT_TRUE(mementoHandler.state().data.isDelta()) << "state " << i;
+	}
+	mementoHandler.markUndo(0, 0, "", volume.get(), MementoType::Modification, region, glm::mat4(1.0f), 0);
+	EXPECT_FALSE(mementoHandler.state().data.isDelta());
+}
+
+TEST_F(MementoHandlerTest, testDeltaDropOldStates) {
+	// more modifications than the handler can hold - the dropped states must not break the deltas that follow them
+	core::SharedPtr<voxel::RawVolume> volume = create(64);
+	auto pos = [](int i) { return glm::ivec3(i % 4 * 16 + 1, i / 4 % 4 * 16 + 2, i / 16 * 8 + 3); };
+	auto check = [&](int modifications) {
+		for (int i = 0; i < 80; ++i) {
+			const voxel::Voxel &v = volume->voxel(pos(i));
+			if (i < modifications) {
+				EXPECT_EQ(i + 1, (int)v.getColor()) << "modification " << i << " of " << modifications;
+			} else {
+				EXPECT_TRUE(voxel::isAir(v.getMaterial())) << "modification " << i << " of " << modifications;
+			}
+		}
+	};
+	mementoHandler.markUndo(0, 0, "", volume.get(), MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	for (int i = 0; i < 80; ++i) {
+		const glm::ivec3 &p = pos(i);
+		volume->setVoxel(p, voxel::createVoxel(voxel::VoxelType::Generic, i + 1));
+		mementoHandler.markUndo(0, 0, "", volume.get(), MementoType::Modification, voxel::Region(p, p), glm::mat4(1.0f), 0);
+	}
+	const int size = (int)mementoHandler.stateSize();
+	ASSERT_EQ(64, size);
+	for (int i = 1; i < size; ++i) {
+		apply(mementoHandler.undo(), volume);
+		check(80 - i);
+	}
+	EXPECT_FALSE(mementoHandler.canUndo());
+	for (int i = 1; i < size; ++i) {
+		apply(mementoHandler.redo(), volume);
+		check(80 - size + 1 + i);
+	}
+	EXPECT_FALSE(mementoHandler.canRedo());
+}
+
+TEST_F(MementoHandlerTest, testDeltaDropBaseState) {
+	// the only full state of the node is dropped while the new modification is added - it must not become a delta
+	core::SharedPtr<voxel::RawVolume> volume = create(64);
+	auto pos = [](int i) { return glm::ivec3(i % 4 * 16 + 1, i / 4 % 4 * 16 + 2, i / 16 * 16 + 3); };
+	const int modifications = MementoHandler::FullStateInterval + 4;
+	for (int i = 0; i < modifications; ++i) {
+		// voxels next to the modifications that are only part of the first full state
+		volume->setVoxel(pos(i) + glm::ivec3(1, 0, 0), voxel::createVoxel(voxel::VoxelType::Generic, 200));
+	}
+	mementoHandler.markUndo(0, 0, "", volume.get(), MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	for (int i = 1; i < 64; ++i) {
+		mementoHandler.markUndo(0, 0, "", nullptr, MementoType::SceneNodeTransform, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	}
+	ASSERT_EQ(64, (int)mementoHandler.stateSize());
+
+	core::DynamicArray<core::SharedPtr<voxel::RawVolume>> snapshots;
+	for (int i = 0; i < modifications; ++i) {
+		const glm::ivec3 &p = pos(i);
+		volume->setVoxel(p, voxel::createVoxel(voxel::VoxelType::Generic, i + 1));
+		mementoHandler.markUndo(0, 0, "", volume.get(), MementoType::Modification, voxel::Region(p, p), glm::mat4(1.0f), 0);
+		snapshots.push_back(core::make_shared<voxel::RawVolume>(*volume.get()));
+	}
+	ASSERT_EQ(64, (int)mementoHandler.stateSize());
+
+	// undo to the oldest modification that is left
+	for (int i = modifications - 1; i > 0; --i) {
+		const MementoState &state = mementoHandler.undo();
+		ASSERT_EQ(MementoType::Modification, state.type);
+		apply(state, volume);
+		const voxel::RawVolume &expected = *snapshots[i - 1].get();
+		const voxel::Region &region = expected.region();
+		ASSERT_EQ(region, volume->region());
+		int differences = 0;
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					if (!volume->voxel(x, y, z).isSame(expected.voxel(x, y, z))) {
+						++differences;
+					}
+				}
+			}
+		}
+		EXPECT_EQ(0, differences) << "undo of modification " << i;
+	}
+}
+
 #if 0
 // TODO
 TEST_F(MementoHandlerTest, testSceneNodeRenamed) {
@@ -7,6 +7,9 @@
 #include "video/tests/AbstractGLTest.h"
 #include "voxel/RawVolume.h"
 #include "voxel/tests/TestHelper.h"
+#include "core/concurrent/ThreadPool.h"
+#include <chrono>
+#include <thread>
 
 namespace voxedit {
 
@@ -94,6 +97,26 @@ TEST_F(SceneManagerTest, testNewScene) {
 	EXPECT_TRUE(newScene(true, "newscene", voxel::Region{0, 1}));
 }
 
+TEST_F(SceneManagerTest, testAutoSaveMeshFormat) {
+	if (!_supported) {
+		return;
+	}
+	// the autosave task occupies the only worker of the thread pool
+	ASSERT_EQ(1u, _testApp->threadPool().size());
+	core::Var::getSafe(cfg::VoxEditAutoSaveSeconds)->setVal("0");
+	testSetVoxel(testMins(), 1);
+	ASSERT_TRUE(save("autosave-scenemanagertest.obj"));
+	testSetVoxel(testMaxs(), 2);
+	autosave();
+	ASSERT_TRUE(isAutoSaving());
+	for (int i = 0; i < 3000 && isAutoSaving(); ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		finishAutoSave(false);
+	}
+	ASSERT_FALSE(isAutoSaving()) << "The autosave of the mesh format dead locked";
+	EXPECT_FALSE(autoSaveFailed());
+}
+
 TEST_F(SceneManagerTest, testUndoRedoModification) {
 	if (!_supported) {
 		return;